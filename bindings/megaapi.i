@@ -346,6 +346,8 @@ extern "C" jint JNIEXPORT JNICALL JNI_OnLoad(JavaVM *jvm, void *reserved)
 %ignore mega::MegaApi::createForeignFolderNode;
 %ignore mega::MegaListener::onSyncStateChanged;
 %ignore mega::MegaListener::onSyncFileStateChanged;
+%ignore mega::MegaListener::onSyncFileStatesChanged;
+%ignore mega::MegaSyncFileStateList;
 %ignore mega::MegaTransfer::getListener;
 %ignore mega::MegaRequest::getListener;
 %ignore mega::MegaHashSignature;
@@ -359,6 +361,8 @@ extern "C" jint JNIEXPORT JNICALL JNI_OnLoad(JavaVM *jvm, void *reserved)
 %newobject mega::MegaNode::copy;
 %newobject mega::MegaNodeList::copy;
 %newobject mega::MegaChildrenList::copy;
+%newobject mega::MegaNodeInfoList::copy;
+%newobject mega::MegaChildrenPage::copy;
 %newobject mega::MegaShare::copy;
 %newobject mega::MegaShareList::copy;
 %newobject mega::MegaUser::copy;
@@ -391,6 +395,8 @@ extern "C" jint JNIEXPORT JNICALL JNI_OnLoad(JavaVM *jvm, void *reserved)
 %newobject mega::MegaApi::getTransferByTag;
 %newobject mega::MegaApi::getChildTransfers;
 %newobject mega::MegaApi::getChildren;
+%newobject mega::MegaApi::getChildrenInfo;
+%newobject mega::MegaApi::getChildrenPage;
 %newobject mega::MegaApi::getChildNode;
 %newobject mega::MegaApi::getParentNode;
 %newobject mega::MegaApi::getNodePath;
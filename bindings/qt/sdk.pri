@@ -54,6 +54,11 @@ SOURCES += src/attrmap.cpp \
     src/sync.cpp \
     src/transfer.cpp \
     src/transferslot.cpp \
+    src/fingerprintcache.cpp \
+    src/exclusionmatcher.cpp \
+    src/dirscanner.cpp \
+    src/networktelemetry.cpp \
+    src/bandwidthscheduler.cpp \
     src/treeproc.cpp \
     src/user.cpp \
     src/useralerts.cpp \
@@ -471,6 +476,11 @@ HEADERS  += include/mega.h \
             include/mega/heartbeats.h \
             include/mega/transfer.h \
             include/mega/transferslot.h \
+            include/mega/fingerprintcache.h \
+            include/mega/exclusionmatcher.h \
+            include/mega/dirscanner.h \
+            include/mega/networktelemetry.h \
+            include/mega/bandwidthscheduler.h \
             include/mega/treeproc.h \
             include/mega/types.h \
             include/mega/user.h \
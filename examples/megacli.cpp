@@ -5639,7 +5639,7 @@ void exec_apiurl(autocomplete::ACState& s)
     }
     else if (s.words.size() == 3 || s.words.size() == 2)
     {
-        if (s.words[1].s.size() < 8 || s.words[1].s.substr(0, 8) != "https://")
+        if (s.words[1].s.compare(0, 8, "https://") && s.words[1].s.compare(0, 7, "http://"))  // http: local test servers
         {
             s.words[1].s = "https://" + s.words[1].s;
         }
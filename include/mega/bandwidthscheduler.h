@@ -0,0 +1,151 @@
+/**
+ * @file mega/bandwidthscheduler.h
+ * @brief Hierarchical token-bucket scheduler for transfer bandwidth
+ *
+ * (c) 2013-2014 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#ifndef MEGA_BANDWIDTHSCHEDULER_H
+#define MEGA_BANDWIDTHSCHEDULER_H 1
+
+#include "types.h"
+
+namespace mega {
+
+// Per-transfer scheduling state.  Owned by the Transfer, registered with the
+// scheduler while the transfer has an active TransferSlot.
+struct MEGA_API BandwidthFlow
+{
+    transferclass_t bwclass = TRANSFERCLASS_INTERACTIVE;
+
+    // relative share of its class' bandwidth (>= 1)
+    unsigned weight = 1;
+
+    // set while counted in the scheduler's per-class weight sums
+    bool active = false;
+
+    // fair-share bucket, only used while the class is capped
+    m_off_t tokens = 0;
+    dstime lastrefill = 0;
+};
+
+// Bandwidth is organised as a two-level hierarchy per direction:
+//  - a root bucket with the total rate for the direction (0 = unlimited)
+//  - one class (interactive, sync, backup, streaming) below it, each with a
+//    guaranteed minimum rate and a ceiling rate (0 = none)
+// Within a class, transfers share the capped rate proportionally to their weights.
+// When the root is exhausted, classes may only exceed it up to their guaranteed
+// minimum, and spare bandwidth is lent to classes in priority order
+// (interactive, streaming, sync, backup).
+//
+// Admission happens per HTTP request (chunk) in TransferSlot::doio rather than
+// by pausing cURL callbacks.  Buckets may go into debt by one request, so large
+// chunks are admitted and paid for afterwards.
+class MEGA_API BandwidthScheduler
+{
+public:
+    // max burst accumulated by an idle bucket (ds worth of its rate)
+    static const dstime BURST_DS = 10;
+
+    // upper bound for the retry hint, so other connections of a waiting slot keep being serviced
+    static const dstime MAX_WAIT_DS = 5;
+
+    // smallest request size suggested when a flow is rate limited
+    static const m_off_t MIN_REQUEST_SIZE = 128 * 1024;
+
+    // set guaranteed minimum and ceiling for a class (bytes per second, 0 = none)
+    void setclasslimits(direction_t, transferclass_t, m_off_t minbps, m_off_t maxbps);
+    void getclasslimits(direction_t, transferclass_t, m_off_t& minbps, m_off_t& maxbps) const;
+
+    // set the total rate for a direction (bytes per second, 0 = unlimited)
+    void settotallimit(direction_t, m_off_t bps);
+    m_off_t gettotallimit(direction_t) const;
+
+    // true if any limit is configured for the direction
+    bool limited(direction_t) const;
+
+    // (de)register a flow while its transfer is active
+    void activate(direction_t, BandwidthFlow&);
+    void deactivate(direction_t, BandwidthFlow&);
+
+    // move a flow to a different class and/or weight, at runtime
+    void reclassify(direction_t, BandwidthFlow&, transferclass_t, unsigned weight);
+
+    // decide whether a request of `bytes` can be posted now; charges the buckets if so
+    bool admit(direction_t, BandwidthFlow&, m_off_t bytes, dstime now);
+
+    // charge `bytes` that moved without admit(), for flows that can't pace their requests
+    // (streams read each range with a single request): they still use up the budget
+    // of their class and of the direction, which the other flows are paced against
+    void consume(direction_t, BandwidthFlow&, m_off_t bytes, dstime now);
+
+    // ds to wait before asking again after a rejected admit()
+    dstime retryin(direction_t, const BandwidthFlow&) const;
+
+    // suggested max request size for the flow (0 = no suggestion)
+    m_off_t requestsizelimit(direction_t, const BandwidthFlow&) const;
+
+    // number of admitted / delayed requests since startup
+    uint64_t admitted[2] = { 0, 0 };
+    uint64_t delayed[2] = { 0, 0 };
+
+    BandwidthScheduler();
+
+private:
+    struct TokenBucket
+    {
+        m_off_t rate = 0;   // bytes per second, 0 = unlimited
+        m_off_t level = 0;
+        dstime last = 0;
+
+        void refill(dstime now);
+        void charge(m_off_t bytes);
+    };
+
+    struct ClassState
+    {
+        TokenBucket assured;   // guaranteed minimum rate
+        TokenBucket ceil;      // maximum rate
+        unsigned totalweight = 0;
+        unsigned flows = 0;
+        dstime laststarved = 0;  // last time a request was delayed by the root bucket
+        bool starved = false;
+    };
+
+    struct DirectionState
+    {
+        TokenBucket root;
+        ClassState classes[NUM_TRANSFERCLASSES];
+    };
+
+    DirectionState mDirections[2];
+
+    // rate a class is capped at (own ceiling, else total), 0 = uncapped
+    m_off_t classcap(const DirectionState&, transferclass_t) const;
+
+    // fair share of a flow within its class, 0 = not limited
+    m_off_t flowshare(const DirectionState&, const BandwidthFlow&) const;
+
+    // is a higher priority class waiting for root bandwidth?
+    bool higherpriorityblocked(const DirectionState&, transferclass_t, dstime now) const;
+
+    static int priorityof(transferclass_t);
+};
+
+} // namespace
+
+#endif
@@ -616,7 +616,12 @@ private:
     NodeHandle targethandle;
     Completion mResultFunction;
 
+    // tags of the completed uploads put together by this command, one per node
+    // (see MegaClient::putnodesbatch()), whose results are notified one by one
+    vector<int> mUploadTags;
+
     void removePendingDBRecordsAndTempFiles();
+    void notifyresult(const Error&, vector<NewNode>&, bool targetOverride);
 
 public:
     bool procresult(Result) override;
@@ -0,0 +1,146 @@
+/**
+ * @file mega/dirscanner.h
+ * @brief Multi-threaded directory tree traversal
+ *
+ * (c) 2013-2014 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#ifndef MEGA_DIRSCANNER_H
+#define MEGA_DIRSCANNER_H 1
+
+#include <condition_variable>
+#include <thread>
+
+#include "filesystem.h"
+
+namespace mega {
+
+// metadata of a folder entry, as obtained while listing the folder
+struct MEGA_API ScannedEntry
+{
+    LocalPath name;
+    nodetype_t type = TYPE_UNKNOWN;
+    m_off_t size = 0;
+    m_time_t mtime = 0;
+    m_time_t ctime = 0;
+    handle fsid = UNDEF;
+    bool fsidvalid = false;
+    bool isSymLink = false;
+
+    // false if the entry was listed but could not be opened
+    bool valid = false;
+
+    // fill a FileAccess as if it had been opened
+    void setmetadata(FileAccess&) const;
+};
+
+struct MEGA_API ScannedFolder
+{
+    LocalPath path;
+    vector<ScannedEntry> entries;
+};
+
+// Walks a directory tree with a pool of threads, listing each folder and
+// reading the metadata of its entries.  Folders are listed in depth-first
+// order, entries in the order they were listed, as Sync::scan() goes through
+// them.  Completed folders are kept until they are taken, up to
+// MAX_BUFFERED_ENTRIES entries; past that, the workers only list the folders
+// that come before some buffered one in that order, so that they never wait
+// for the consumer to take a folder that it only needs later.
+class MEGA_API ParallelDirScanner
+{
+public:
+    static const size_t MAX_BUFFERED_ENTRIES = 262144;
+
+    struct Stats
+    {
+        uint64_t folders = 0;
+        uint64_t entries = 0;
+        uint64_t failedFolders = 0;
+    };
+
+    // `waiter` (optional) is notified whenever a folder has been completed
+    ParallelDirScanner(FileSystemAccess&, Waiter*, unsigned threads, bool followSymlinks);
+    ~ParallelDirScanner();
+
+    // walk the tree below `root`; folders for which `prune` returns true are not listed
+    void start(const LocalPath& root, std::function<bool(const LocalPath&)> prune = nullptr);
+
+    // listing of `path` if already completed.  Otherwise nullptr, and the
+    // listing is discarded when it completes (its subfolders are still walked)
+    unique_ptr<ScannedFolder> take(const LocalPath& path);
+
+    // any completed folder, if there is one
+    unique_ptr<ScannedFolder> next();
+
+    // block until a folder completes or the walk ends; false if the walk has ended
+    bool wait();
+
+    // the walk has ended (every folder has been listed)
+    bool done() const;
+
+    // stop the workers as soon as possible
+    void cancel();
+
+    Stats stats() const;
+
+private:
+    FileSystemAccess& mFsAccess;
+    Waiter* mWaiter;
+    unsigned mThreadCount;
+    bool mFollowSymlinks;
+    std::function<bool(const LocalPath&)> mPrune;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mWorkCv;
+    std::condition_variable mResultCv;
+
+    // position of a folder in the depth-first order: index of each folder in the listing of its parent
+    typedef vector<unsigned> Order;
+
+    struct Completed
+    {
+        Order order;
+        unique_ptr<ScannedFolder> folder;
+    };
+
+    map<Order, LocalPath> mPending;
+    map<LocalPath, Completed> mCompleted;
+    set<Order> mBufferedOrder;
+    set<LocalPath> mDiscard;
+    size_t mBuffered = 0;
+    unsigned mActive = 0;
+    bool mCancelled = false;
+    bool mStarted = false;
+    Stats mStats;
+
+    std::vector<std::thread> mThreads;
+
+    bool finished() const { return mStarted && mPending.empty() && !mActive; }
+
+    // the next pending folder may be listed now
+    bool canList() const;
+
+    unique_ptr<ScannedFolder> remove(map<LocalPath, Completed>::iterator);
+
+    void workerLoop();
+    unique_ptr<ScannedFolder> list(const LocalPath& path, const Order& order, map<Order, LocalPath>& subfolders);
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @file mega/exclusionmatcher.h
+ * @brief Compiled sync exclusion rules
+ *
+ * (c) 2013-2014 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#ifndef MEGA_EXCLUSIONMATCHER_H
+#define MEGA_EXCLUSIONMATCHER_H 1
+
+#include <unordered_set>
+
+#include "filesystem.h"
+
+namespace mega {
+
+// `*` and `?` wildcard match of a UTF-8 string (`?` matches a single byte)
+bool MEGA_API wildcardMatch(const char* str, const char* pattern);
+
+// Exclusion rules of the syncs, compiled once per change so that checking a path
+// needs neither a pass over every rule nor, for ASCII names, any string conversion.
+//
+// Name rules apply to each path component below the sync root.  Path rules exclude
+// the path and everything below it; the ones with wildcards are matched against the
+// whole path instead.  All rules are expected in normalized UTF-8.
+class MEGA_API ExclusionMatcher
+{
+public:
+    void set(const vector<string>& names, const vector<string>& paths, const FileSystemAccess&);
+    void clear();
+
+    // whether `path` (`root` itself or a path below it) is excluded
+    bool excluded(const LocalPath& root, const LocalPath& path, const FileSystemAccess&) const;
+
+private:
+    // name rules, by kind
+    std::unordered_set<string> mNames;                      // literal
+    map<size_t, std::unordered_set<string>> mNamePrefixes;  // "literal*", by length
+    map<size_t, std::unordered_set<string>> mNameSuffixes;  // "*literal", by length
+    vector<string> mNamePatterns;                           // any other
+
+    // path rules: literal ones in the platform encoding, sorted and compared
+    // as LocalPath::isContainingPathOf() does, and the ones with wildcards
+    vector<LocalPath> mPaths;
+    vector<string> mPathPatterns;
+
+    bool nameExcluded(const string& name) const;
+    static bool containsPrefix(const vector<LocalPath>& sorted, const LocalPath& path, size_t length);
+};
+
+} // namespace
+
+#endif
@@ -97,6 +97,7 @@ class MEGA_API LocalPath
     friend class GfxProcFreeImage;
     friend struct FileSystemAccess;
     friend int computeReversePathMatchScore(const LocalPath& path1, const LocalPath& path2, const FileSystemAccess& fsaccess);
+    friend class ExclusionMatcher;
 #ifdef USE_ROTATIVEPERFORMANCELOGGER
     friend class RotativePerformanceLoggerLoggingThread;
 #endif
@@ -278,6 +279,10 @@ struct MEGA_API FileAccess
     // mtime of a file opened for reading
     m_time_t mtime = 0;
 
+    // inode change time (POSIX) or creation time (Windows), tells a file apart from
+    // a later one that reuses its fsid
+    m_time_t ctime = 0;
+
     // local filesystem record id (survives renames & moves)
     handle fsid = 0;
     bool fsidvalid = false;
@@ -400,25 +405,44 @@ struct Notification
     LocalPath path;
     LocalNode* localnode = nullptr;
 
+    // left in the queue, but replaced by a later notification (NotificationDeque only)
+    bool superseded = false;
+
     Notification() {}
     Notification(dstime ts, const LocalPath& p, LocalNode* ln)
         : timestamp(ts), path(p), localnode(ln)
         {}
 };
 
+// Notifications are coalesced as they are queued: a repeated one supersedes the
+// pending one and goes to the back with the latest timestamp (so the queue stays
+// in timestamp order for the SCANNING_DELAY_DS debounce), and those below a folder
+// with a pending rescan (an immediate notification with an empty path) are dropped.
 struct NotificationDeque : ThreadSafeDeque<Notification>
 {
-    void replaceLocalNodePointers(LocalNode* check, LocalNode* newvalue)
-    {
-        std::lock_guard<std::mutex> g(m);
-        for (auto& n : mNotifications)
-        {
-            if (n.localnode == check)
-            {
-                n.localnode = newvalue;
-            }
-        }
-    }
+    bool peekFront(Notification&);
+    bool popFront(Notification&);
+    void unpopFront(const Notification&);
+    void pushBack(Notification&&);
+    bool empty();
+    size_t size();
+
+    void replaceLocalNodePointers(LocalNode* check, LocalNode* newvalue);
+
+    // how many notifications were merged or dropped so far
+    uint64_t coalesced();
+
+private:
+    typedef std::pair<LocalNode*, LocalPath> Key;
+
+    // the entry pending for each key (deque elements don't move on push/pop at the ends)
+    map<Key, Notification*> mPending;
+
+    size_t mSuperseded = 0;
+    uint64_t mCoalesced = 0;
+
+    void supersede(map<Key, Notification*>::iterator);
+    void popSuperseded();
 };
 
 #ifdef ENABLE_SYNC
@@ -0,0 +1,94 @@
+/**
+ * @file mega/fingerprintcache.h
+ * @brief Persistent cache of local file fingerprints
+ *
+ * (c) 2013-2014 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#ifndef MEGA_FINGERPRINTCACHE_H
+#define MEGA_FINGERPRINTCACHE_H 1
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "filefingerprint.h"
+
+namespace mega {
+
+class DbTable;
+
+// Fingerprints of local files by filesystem id, so that a file whose fsid, size,
+// mtime and ctime did not change is not read again to fingerprint it (e.g. when a
+// sync is started without its LocalNode cache).  Records are checked when they are
+// looked up rather than pruned, as fsids may be reused by files created while the
+// sync wasn't running.  Thread safe, as the worker threads fingerprinting sync
+// files consult it too; persisted by the client thread.
+class MEGA_API LocalFingerprintCache
+{
+public:
+    // as FileFingerprint::genfingerprint() for the file open in `fa`, only
+    // reading it if its fingerprint is not cached (or it has no fsid)
+    bool genfingerprint(FileFingerprint& fp, FileAccess* fa, bool ignoremtime = false);
+
+    bool lookup(handle fsid, m_off_t size, m_time_t mtime, m_time_t ctime, FileFingerprint& fp);
+    void add(handle fsid, m_time_t ctime, const FileFingerprint& fp);
+
+    // the file with that fsid is gone, and its fsid could be reused by a new file
+    void remove(handle fsid);
+
+    // loads the records of `table`, and writes there the changes since the last save()
+    void load(DbTable& table, SymmCipher& key);
+    void save(DbTable& table, SymmCipher& key);
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entries = 0;
+    };
+    Stats stats();
+
+private:
+    struct Record : public Cacheable
+    {
+        handle fsid = UNDEF;
+        m_time_t ctime = 0;
+        FileFingerprint fingerprint;
+
+        bool serialize(string*) override;
+        static bool unserialize(const string&, Record&);
+    };
+
+    std::mutex mMutex;
+    std::unordered_map<handle, Record> mRecords;
+
+    // added or updated since the last save()
+    set<handle> mUnsaved;
+
+    // rows of the records removed since the last save()
+    set<uint32_t> mDeleted;
+
+    void erase(std::unordered_map<handle, Record>::iterator);
+
+    uint64_t mHits = 0;
+    uint64_t mMisses = 0;
+};
+
+} // namespace
+
+#endif
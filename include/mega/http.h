@@ -27,6 +27,7 @@
 #include "waiter.h"
 #include "backofftimer.h"
 #include "utils.h"
+#include "networktelemetry.h"
 
 #ifndef _WIN32
 #include <sys/types.h>
@@ -181,6 +182,9 @@ struct MEGA_API HttpIO : public EventTrigger
     m_off_t uploadSpeed;
     void updateuploadspeed(m_off_t size = 0);
 
+    // timings of completed requests, per channel and per host
+    NetworkTelemetry telemetry;
+
     // data receive timeout (ds)
     static const int NETWORKTIMEOUT;
 
@@ -225,6 +229,10 @@ struct MEGA_API HttpIO : public EventTrigger
 
     virtual bool cacheresolvedurls(const std::vector<string>&, std::vector<string>&&) { return false; }
 
+    // resolve the host of a storage URL and open up to `connections` idle connections to it,
+    // so that the first transfer requests skip DNS, TCP and TLS setup (0 connections: DNS only)
+    virtual bool preconnect(direction_t, const string&, unsigned) { return false; }
+
     HttpIO();
     virtual ~HttpIO() { }
 };
@@ -281,6 +289,12 @@ struct MEGA_API HttpReq
     // identify different channels from different MegaClients etc in the log
     string logname;
 
+    // traffic class for network telemetry
+    netchannel_t channel = NETCHANNEL_OTHER;
+
+    // the previous attempt failed or was aborted, so this one is a retry (for network telemetry)
+    bool retry = false;
+
     // set url and content type for subsequent requests
     void setreq(const char*, contenttype_t);
 
@@ -416,7 +430,7 @@ struct MEGA_API HttpReqXfer : public HttpReq
 
     virtual void prepare(const char*, SymmCipher*, uint64_t, m_off_t, m_off_t) = 0;
 
-    HttpReqXfer() : HttpReq(true), size(0) { }
+    HttpReqXfer(netchannel_t c) : HttpReq(true), size(0) { channel = c; }
 };
 
 // file chunk upload
@@ -428,6 +442,7 @@ struct MEGA_API HttpReqUL : public HttpReqXfer
 
     m_off_t transferred(MegaClient*);
 
+    HttpReqUL() : HttpReqXfer(NETCHANNEL_PUT) { }
     ~HttpReqUL() { }
 };
 
@@ -446,6 +461,7 @@ struct MEGA_API HttpReqDL : public HttpReqXfer
 // file attribute get
 struct MEGA_API HttpReqGetFA : public HttpReq
 {
+    HttpReqGetFA() { channel = NETCHANNEL_FA; }
     ~HttpReqGetFA() { }
 };
 } // namespace
@@ -105,6 +105,29 @@ struct MEGA_API JSON
 
 };
 
+// tracks the nesting of a JSON object that is received in pieces, to tell how much of it can
+// be parsed already: complete top-level members, and complete elements of top-level arrays
+class MEGA_API JSONStreamScanner
+{
+public:
+    // scan the data received so far (`len` bytes from the first unconsumed one) and
+    // return the offset up to which it can be parsed
+    size_t scan(const char* data, size_t len);
+
+    // the first `len` bytes have been parsed and dropped
+    void consume(size_t len);
+
+    void reset();
+
+private:
+    size_t mScanned = 0;
+    size_t mSafe = 0;
+    int mDepth = 0;
+    bool mInTopArray = false;
+    bool mInString = false;
+    bool mEscaped = false;
+};
+
 class MEGA_API JSONWriter
 {
 public:
@@ -276,6 +276,10 @@ struct MEGA_API MegaApp
     virtual void syncupdate_local_lockretry(bool) { }
     virtual void syncupdate_treestate(const SyncConfig &, const LocalPath&, treestate_t, nodetype_t) { }
 
+    // all the treestates of a sync changed in a cycle, instead of syncupdate_treestate(),
+    // if Syncs::mTreeStateBatched
+    virtual void syncupdate_treestates(const SyncConfig&, const vector<pair<LocalPath, treestate_t>>&) { }
+
     // sync filename filter
     virtual bool sync_syncable(Sync*, const char*, LocalPath&, Node*)
     {
@@ -287,6 +291,18 @@ struct MEGA_API MegaApp
         return true;
     }
 
+    // same, when the type and size of the item are already known (TYPE_UNKNOWN if not)
+    virtual bool sync_syncable(Sync* sync, const char* name, LocalPath& localpath, nodetype_t, m_off_t)
+    {
+        return sync_syncable(sync, name, localpath);
+    }
+
+    // whether the filter above uses the size, so that the scan gets it for each item
+    virtual bool sync_syncable_needs_size()
+    {
+        return false;
+    }
+
     // after a root node of a sync changed its path
     virtual void syncupdate_remote_root_changed(const SyncConfig &) { }
 
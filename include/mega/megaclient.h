@@ -226,6 +226,10 @@ public:
     }
 
     bool mActionsPerformed;
+
+    // whether to recurse into folders already linked on both sides
+    // (otherwise, only the changed folders are examined)
+    bool mRecursive = true;
 }; // SyncdownContext
 
 class MEGA_API MegaClient
@@ -496,6 +500,10 @@ public:
     // start/stop/pause file transfer
     bool startxfer(direction_t, File*, DBTableTransactionCommitter&, bool skipdupes = false, bool startfirst = false, bool donotpersist = false);
     void stopxfer(File* f, DBTableTransactionCommitter* committer);
+
+    // FileFingerprint::genfingerprint() for the local file at `path`, open in
+    // `fa`, from the fingerprint cache of the sync containing it, if any
+    bool genfingerprint(FileFingerprint& fp, FileAccess* fa, const LocalPath& path);
     void pausexfers(direction_t, bool pause, bool hard, DBTableTransactionCommitter& committer);
 
     // maximum number of connections per transfer
@@ -552,6 +560,13 @@ public:
     // send files/folders to user
     void putnodes(const char*, vector<NewNode>&&, int tag);
 
+    // put a completed upload in its target folder, together with the other uploads
+    // to that folder that complete until the next cs request can be sent
+    void putnodesbatch(NodeHandle, putsource_t, int tag, unique_ptr<NewNode>);
+
+    // send the batched uploads (a putnodes per target folder)
+    void putnodesflush();
+
     // attach file attribute to upload or node handle
     void putfa(NodeOrUploadHandle, fatype, SymmCipher*, int tag, std::unique_ptr<string>);
 
@@ -885,6 +900,12 @@ public:
     // get max upload speed
     m_off_t getmaxuploadspeed();
 
+    // set guaranteed/maximum rates (bytes per second) of a bandwidth class, or the total when bwclass is NUM_TRANSFERCLASSES
+    void setbandwidthlimits(direction_t d, int bwclass, m_off_t minbps, m_off_t maxbps);
+
+    // move a transfer to a different bandwidth class and/or weight
+    error settransferbandwidthclass(Transfer* t, transferclass_t bwclass, unsigned weight);
+
     // get the handle of the older version for a NewNode
     handle getovhandle(Node *parent, string *name);
 
@@ -1071,6 +1092,9 @@ private:
     // maximum number of concurrent transfers (uploads or downloads)
     static const unsigned MAXTRANSFERS;
 
+    // maximum number of queued transfers to open connections for in advance
+    static const unsigned MAXPRECONNECTLOOKAHEAD;
+
     // maximum number of queued putfa before halting the upload queue
     static const int MAXQUEUEDFA;
 
@@ -1273,6 +1297,20 @@ public:
     bool insca;
     bool insca_notlast;
 
+    // process action packets while the sc response arrives, rather than once it's complete
+    bool scstreaming = false;
+
+    // state of a streamed sc response: jsonsc only points into it while procsc() runs, as
+    // the buffer keeps growing, and the parsed part is dropped from it (see parkscstream())
+    JSONStreamScanner scstreamscanner;
+    bool scstreamstarted = false;
+    bool scstreamstalled = false;
+    bool scstreamwaiting = false;
+    const char* scstreamlimit = nullptr;
+
+    // arrival of the current sc response, and of the oldest action packet not notified yet
+    std::chrono::steady_clock::time_point scfirstdata, scnotifysince;
+
     // no two interrelated client instances should ever have the same sessionid
     char sessionid[10];
 
@@ -1342,9 +1380,21 @@ public:
     // waiting for the completion of a putnodes
     pendingfiles_map pendingfiles;
 
+    // completed uploads waiting to be put, by target folder (see putnodesbatch())
+    struct UploadBatch
+    {
+        vector<unique_ptr<NewNode>> newnodes;
+        vector<int> tags;
+    };
+    map<pair<NodeHandle, putsource_t>, UploadBatch> uploadbatches;
+    void putnodesbatchsend(NodeHandle, putsource_t, UploadBatch&);
+
     // transfer tslots
     transferslot_list tslots;
 
+    // paces the requests of the tslots according to per-class rates and weights
+    BandwidthScheduler bandwidthScheduler;
+
     // keep track of next transfer slot timeout
     BackoffTimerGroupTracker transferSlotsBackoff;
 
@@ -1477,9 +1527,20 @@ public:
     // app scanstate flag
     bool syncscanstate;
 
-    // scan required flag
+    // scan required flag (a full syncdown() pass of all the syncs)
     bool syncdownrequired;
 
+    // remote folders whose children changed (collected in notifypurge()),
+    // and whether a syncdown() of only them is required
+    set<NodeHandle> syncdownfolders;
+    bool syncdownchanged = false;
+
+    // a full pass is still run every so often, as a consistency check
+    dstime syncdownfullds = 0;
+    static const dstime SYNCDOWN_FULL_INTERVAL_DS;
+    bool syncdownpending() const { return syncdownrequired || syncdownchanged; }
+    bool syncdownchangedfolders(Sync*, const set<NodeHandle>&);
+
     bool syncuprequired;
 
     // block local fs updates processing while locked ops are in progress
@@ -1644,6 +1705,8 @@ public:
     void handleauth(handle, byte*);
 
     bool procsc();
+    bool resumescstream();
+    bool parkscstream();
 
     // API warnings
     void warn(const char*);
@@ -1902,9 +1965,12 @@ public:
         CodeCounter::ScopeStats dispatchTransfers = { "dispatchTransfers" };
         CodeCounter::ScopeStats csResponseProcessingTime = { "cs batch response processing" };
         CodeCounter::ScopeStats scProcessingTime = { "sc processing" };
+        CodeCounter::ScopeStats syncdownFull = { "syncdown full" };
+        CodeCounter::ScopeStats syncdownChanged = { "syncdown changed folders" };
         uint64_t transferStarts = 0, transferFinishes = 0;
         uint64_t transferTempErrors = 0, transferFails = 0;
         uint64_t prepwaitImmediate = 0, prepwaitZero = 0, prepwaitHttpio = 0, prepwaitFsaccess = 0, nonzeroWait = 0;
+        uint64_t scStreamedResponses = 0, scNotifications = 0, scNotifyLatencyMs = 0, scNotifyLatencyMaxMs = 0;
         CodeCounter::DurationSum csRequestWaitTime;
         CodeCounter::DurationSum transfersActiveTime;
         std::string report(bool reset, HttpIO* httpio, Waiter* waiter, const RequestDispatcher& reqs);
@@ -0,0 +1,122 @@
+/**
+ * @file mega/networktelemetry.h
+ * @brief Per-channel and per-host statistics of completed HTTP requests
+ *
+ * (c) 2013-2014 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#ifndef MEGA_NETWORKTELEMETRY_H
+#define MEGA_NETWORKTELEMETRY_H 1
+
+#include "types.h"
+
+namespace mega {
+
+class JSONWriter;
+
+// timings of one completed request, in microseconds from its start (-1: not available)
+struct MEGA_API NetworkTiming
+{
+    int64_t dns = -1;           // name resolution
+    int64_t connect = -1;       // TCP connect (not including dns)
+    int64_t tls = -1;           // TLS handshake (not including connect)
+    int64_t ttfb = -1;          // until the first byte of the response
+    int64_t total = -1;
+
+    m_off_t bytesIn = 0;
+    m_off_t bytesOut = 0;
+
+    // a new connection was opened for this request
+    bool newConnection = false;
+
+    bool failed = false;
+
+    // sent again after a failed or aborted attempt
+    bool retry = false;
+};
+
+// durations in log2 buckets of microseconds: bucket i holds [2^i, 2^(i+1)), bucket 0 also 0
+class MEGA_API LatencyHistogram
+{
+public:
+    static const int BUCKETS = 32;
+
+    void add(int64_t us);
+    void reset();
+
+    uint64_t count() const { return mCount; }
+    int64_t max() const { return mMax; }
+    int64_t mean() const;
+
+    // upper bound of the bucket that holds the given fraction (0..1) of the samples
+    int64_t percentile(double p) const;
+
+    void tojson(JSONWriter&, const char* name) const;
+
+private:
+    uint64_t mBuckets[BUCKETS] = {};
+    uint64_t mCount = 0;
+    int64_t mSum = 0;
+    int64_t mMax = 0;
+};
+
+// aggregate of the requests of a channel or a host
+struct MEGA_API NetworkStats
+{
+    uint64_t requests = 0;
+    uint64_t failures = 0;
+    uint64_t retries = 0;
+    uint64_t newConnections = 0;
+    m_off_t bytesIn = 0;
+    m_off_t bytesOut = 0;
+
+    LatencyHistogram dns, connect, tls, ttfb, total;
+
+    void add(const NetworkTiming&);
+    void tojson(JSONWriter&) const;
+};
+
+// Collected by the HttpIO as requests complete.  Only accessed from the thread
+// that runs the client (with the client's mutex held by API callers).
+class MEGA_API NetworkTelemetry
+{
+public:
+    // hosts beyond this are aggregated under "*"
+    static const size_t MAXHOSTS = 128;
+
+    NetworkTelemetry();
+
+    void record(netchannel_t, const string& host, const NetworkTiming&);
+    void reset();
+
+    const NetworkStats& channel(netchannel_t c) const { return mChannels[c]; }
+    const map<string, NetworkStats>& hosts() const { return mHosts; }
+
+    // {"since":<seconds>,"channels":{"cs":{...},...},"hosts":{"<host>":{...},...}}
+    string tojson() const;
+
+    static const char* channelname(netchannel_t);
+
+private:
+    NetworkStats mChannels[NUM_NETCHANNELS];
+    map<string, NetworkStats> mHosts;
+    m_time_t mSince;
+};
+
+} // namespace
+
+#endif
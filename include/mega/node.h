@@ -300,6 +300,56 @@ inline bool Node::keyApplied() const
 
 
 #ifdef ENABLE_SYNC
+// A localnode_map that is only allocated when the first entry is added, as
+// most LocalNodes are files, without children (or short names).  Once
+// allocated it is kept, so that iterators stay valid while entries are
+// erased, as with a plain map.
+class MEGA_API LocalNodeChildren
+{
+public:
+    typedef localnode_map::iterator iterator;
+    typedef localnode_map::const_iterator const_iterator;
+
+    iterator begin() { return map().begin(); }
+    iterator end() { return map().end(); }
+    const_iterator begin() const { return map().begin(); }
+    const_iterator end() const { return map().end(); }
+
+    iterator find(const LocalPath* name) { return map().find(name); }
+    size_t size() const { return mMap ? mMap->size() : 0; }
+    bool empty() const { return !mMap || mMap->empty(); }
+
+    LocalNode*& operator[](const LocalPath* name)
+    {
+        if (!mMap)
+        {
+            mMap.reset(new localnode_map);
+        }
+        return (*mMap)[name];
+    }
+
+    void erase(const LocalPath* name)
+    {
+        if (mMap)
+        {
+            mMap->erase(name);
+        }
+    }
+
+private:
+    std::unique_ptr<localnode_map> mMap;
+
+    localnode_map& map() { return mMap ? *mMap : emptyMap(); }
+    const localnode_map& map() const { return mMap ? *mMap : emptyMap(); }
+
+    // (never modified: lookups in it always fail)
+    static localnode_map& emptyMap()
+    {
+        static localnode_map empty;
+        return empty;
+    }
+};
+
 struct MEGA_API LocalNode : public File
 {
     class Sync* sync = nullptr;
@@ -317,12 +367,12 @@ struct MEGA_API LocalNode : public File
     bool slocalname_in_db = false;
 
     // children by name
-    localnode_map children;
+    LocalNodeChildren children;
 
     // for botched filesystems with legacy secondary ("short") names
     // Filesystem notifications could arrive with long or short names, and we need to recognise which LocalNode corresponds.
     std::unique_ptr<LocalPath> slocalname;   // null means either the entry has no shortname or it's the same as the (normal) longname
-    localnode_map schildren;
+    LocalNodeChildren schildren;
 
     // local filesystem node ID (inode...) for rename/move detection
     handle fsid = mega::UNDEF;
@@ -362,13 +412,17 @@ struct MEGA_API LocalNode : public File
 
         // set after the cloud node is created
         bool needsRescan : 1;
+
+        // the fingerprint is being computed by a worker thread
+        bool fingerprinting : 1;
     };
 
     // current subtree sync state: current and displayed
     treestate_t ts = TREESTATE_NONE;
     treestate_t dts = TREESTATE_NONE;
 
-    // update sync state all the way to the root node
+    // update sync state (the parents are updated up to the root node, and the
+    // app informed, once per exec() by Sync::flushtreestates())
     void treestate(treestate_t = TREESTATE_NONE);
 
     // check the current state (only useful for folders)
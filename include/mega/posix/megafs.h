@@ -61,6 +61,45 @@ struct MEGA_API PosixDirAccess : public DirAccess
     virtual ~PosixDirAccess();
 };
 
+#ifdef USE_FANOTIFY
+// Filesystem-wide notifications reporting the parent directory and name of each
+// changed entry (Linux 5.9+).  Marking costs the same regardless of the size of
+// the tree, but needs CAP_SYS_ADMIN: without it, open() fails and inotify is used.
+class MEGA_API Fanotify
+{
+public:
+    // for read(): the entry at `path` was created, deleted, moved or written
+    typedef std::function<void(const string& path, uint64_t mask)> Callback;
+
+    bool open();
+    int fd() const { return mFd; }
+
+    // watch the whole filesystem containing `path` (marks are shared by reference)
+    bool mark(const LocalPath& path, uint64_t& fsid);
+    void unmark(uint64_t fsid);
+    bool marked(uint64_t fsid) const { return mMarks.count(fsid) > 0; }
+
+    // delivers the pending events to `f`.  false on queue overflow (events lost)
+    bool read(const Callback& f);
+
+    ~Fanotify();
+
+private:
+    struct Mark
+    {
+        int mountfd;        // to resolve handles with open_by_handle_at()
+        unsigned refs;
+    };
+
+    int mFd = -1;
+    map<uint64_t, Mark> mMarks;
+
+    // the directory handle resolved last, as events come in bursts per directory
+    string mLastHandle;
+    string mLastPath;
+};
+#endif
+
 class MEGA_API PosixFileSystemAccess : public FileSystemAccess
 {
 public:
@@ -78,6 +117,15 @@ public:
     string lastname;
 #endif
 
+#ifdef USE_FANOTIFY
+    // used by the syncs on filesystems it could mark, instead of inotify
+    Fanotify fanotify;
+
+#ifdef ENABLE_SYNC
+    int checkfanotifyevents();
+#endif
+#endif
+
 #ifdef USE_IOS
     static char *appbasepath;
 #endif
@@ -204,6 +252,16 @@ public:
     bool fsstableids() const override;
 
     PosixDirNotify(const LocalPath&, const LocalPath&, Sync* s);
+    ~PosixDirNotify();
+
+#ifdef USE_FANOTIFY
+    // set if the whole filesystem is watched, so that no folder needs a watch
+    bool fanotify = false;
+    uint64_t fanotifyfsid = 0;
+
+    // the sync root as reported in events (with symlinks resolved)
+    string fanotifyroot;
+#endif
 };
 #endif
 
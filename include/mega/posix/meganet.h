@@ -110,6 +110,38 @@ protected:
     std::map<string, CurlDNSEntry> dnscache;
     int pkpErrors;
 
+    // connections opened in advance to storage hosts (see preconnect())
+    // cURL keeps them in the connection cache of curlm[d] once the HEAD request
+    // that opened them is done, this only tracks how many should be there
+    struct PreconnectHost
+    {
+        string scheme[2];
+        int port[2] = { 0, 0 };
+        bool resolving = false;
+        unsigned pending[2] = { 0, 0 };     // to be opened once the host is resolved
+        unsigned inflight[2] = { 0, 0 };    // being opened
+        std::deque<dstime> idle[2];         // opened and not claimed by a request yet
+    };
+    std::map<string, PreconnectHost> preconnecthosts;
+    struct PreconnectRequest
+    {
+        CurlHttpIO* httpio;
+        string hostname;
+        direction_t d;
+        curl_slist* headers;
+    };
+    std::map<CURL*, PreconnectRequest> preconnecting;
+    void launchpreconnects(const string& hostname);
+    void finishpreconnect(CURL*, bool ok);
+    void claimpreconnect(CurlHttpContext*);
+
+    // drop idle connections that are too old, and the host when nothing is left
+    void prunepreconnecthost(std::map<string, PreconnectHost>::iterator);
+
+    // collect cURL's timings of a finished request into the telemetry
+    void recordtelemetry(CURL*, HttpReq*);
+    void droppreconnects();
+
     void send_pending_requests();
     void drop_pending_requests();
 
@@ -120,6 +152,7 @@ protected:
 
     static int socket_callback(CURL *e, curl_socket_t s, int what, void *userp, void *socketp, direction_t d);
     static int sockopt_callback(void *clientp, curl_socket_t curlfd, curlsocktype purpose);
+    static int preconnect_sockopt_callback(void *clientp, curl_socket_t curlfd, curlsocktype purpose);
     static int api_socket_callback(CURL *e, curl_socket_t s, int what, void *userp, void *socketp);
     static int download_socket_callback(CURL *e, curl_socket_t s, int what, void *userp, void *socketp);
     static int upload_socket_callback(CURL *e, curl_socket_t s, int what, void *userp, void *socketp);
@@ -155,6 +188,7 @@ protected:
 #ifdef MEGA_USE_C_ARES
     static void proxy_ready_callback(void*, int, int, struct hostent*);
     static void ares_completed_callback(void*, int, int, struct hostent*);
+    static void preconnect_dns_callback(void*, int, int, struct hostent*);
 #endif
 
     static void send_request(CurlHttpContext*);
@@ -233,6 +267,18 @@ public:
 
     bool cacheresolvedurls(const std::vector<string>& urls, std::vector<string>&& ips) override;
 
+    bool preconnect(direction_t d, const string& url, unsigned connections) override;
+
+    // max idle connections opened in advance per host and direction
+    static const unsigned MAX_PRECONNECTS_PER_HOST;
+
+    // connections opened in advance are considered gone after this time (ds)
+    static const dstime PRECONNECT_IDLE_DS;
+
+    // connections opened in advance / reused by a request afterwards without connecting
+    unsigned preconnectsopened[2] = { 0, 0 };
+    unsigned preconnectsclaimed[2] = { 0, 0 };
+
     CurlHttpIO();
     ~CurlHttpIO();
 
@@ -274,6 +320,9 @@ struct MEGA_API CurlHttpContext
 #ifdef MEGA_USE_C_ARES
     int ares_pending;
 #endif
+
+    // expected to reuse a connection opened in advance
+    bool preconnected = false;
 };
 
 struct MEGA_API CurlDNSEntry
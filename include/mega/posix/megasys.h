@@ -111,6 +111,10 @@
     #include <sys/inotify.h>
 #endif
 
+#ifdef USE_FANOTIFY
+    #include <sys/fanotify.h>
+#endif
+
 #include <sys/select.h>
 
 #include <curl/curl.h>
@@ -23,7 +23,7 @@
 #define WAIT_CLASS PosixWaiter
 
 #include "mega/waiter.h"
-#include <mutex>
+#include <atomic>
 
 #ifndef USE_POLL
     #define MEGA_FD_ZERO FD_ZERO
@@ -80,8 +80,7 @@ struct PosixWaiter : public Waiter
 
 protected:
     int m_pipe[2];
-    std::mutex mMutex;
-    bool alreadyNotified = false;
+    std::atomic<bool> alreadyNotified{false};
 };
 } // namespace
 
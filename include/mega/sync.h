@@ -23,6 +23,8 @@
 #define MEGA_SYNC_H 1
 
 #include "db.h"
+#include "dirscanner.h"
+#include "fingerprintcache.h"
 
 #ifdef ENABLE_SYNC
 
@@ -213,6 +215,23 @@ private:
 using SyncCompletionFunction =
   std::function<void(UnifiedSync*, const SyncError&, error)>;
 
+// fingerprint of a sync file, computed on a worker thread (see Sync::requestfingerprint)
+struct SyncFingerprintJob
+{
+    LocalNode* node;
+    LocalPath path;
+
+    // starts as the node's current fingerprint
+    FileFingerprint fingerprint;
+    bool changed = false;
+
+    // the node was added by the scan that requested the fingerprint
+    bool newnode = false;
+
+    // set on the client thread if the node goes away or is fingerprinted again
+    std::atomic<bool> cancelled{false};
+};
+
 class MEGA_API Sync
 {
 public:
@@ -266,6 +285,15 @@ public:
     // Caches all synchronized LocalNode
     void cachenodes();
 
+    // LocalNodes whose treestate changed, and folders whose children's did,
+    // since the last flushtreestates()
+    set<LocalNode*> treestatechanged;
+    set<LocalNode*> treestatefolders;
+
+    // brings the folders' treestates up to date, and informs the app of the
+    // latest state of each LocalNode that changed
+    void flushtreestates();
+
     // change state, signal to application
     void changestate(syncstate_t, SyncError newSyncError, bool newEnableFlag, bool notifyApp);
 
@@ -275,11 +303,33 @@ public:
     // process and remove one directory notification queue item from *notify
     dstime procscanq(int);
 
+    // notifications coalesced by dirnotify's queues, as last logged
+    uint64_t coalescedlogged = 0;
+
     // recursively look for vanished child nodes and delete them
     void deletemissing(LocalNode*);
 
     // scan specific path
-    LocalNode* checkpath(LocalNode*, LocalPath*, string* const, dstime*, bool wejustcreatedthisfolder, DirAccess* iteratingDir);
+    // (`scanned`: metadata already read by the prescan, used instead of opening the path during initialization)
+    // (`deferfingerprint`: file contents are fingerprinted by a worker thread, see requestfingerprint())
+    LocalNode* checkpath(LocalNode*, LocalPath*, string* const, dstime*, bool wejustcreatedthisfolder, DirAccess* iteratingDir, const ScannedEntry* scanned = nullptr, bool deferfingerprint = false);
+
+    // fingerprints being computed on the client's worker threads, and those completed
+    // but not yet applied.  Until then, the LocalNode keeps its previous fingerprint
+    // and is flagged as `fingerprinting`
+    map<LocalNode*, shared_ptr<SyncFingerprintJob>> fingerprintjobs;
+    shared_ptr<ThreadSafeDeque<shared_ptr<SyncFingerprintJob>>> fingerprintsdone = std::make_shared<ThreadSafeDeque<shared_ptr<SyncFingerprintJob>>>();
+    void requestfingerprint(LocalNode*, const LocalPath&, bool newnode);
+    void cancelfingerprint(LocalNode*);
+
+    // apply the completed fingerprints as checkpath() would have, returns true if any was applied
+    bool procfingerprints();
+
+    // fingerprints not yet applied
+    size_t pendingfingerprints() const { return fingerprintjobs.size(); }
+
+    // whether procscanq() should stop queueing fingerprints until some complete
+    bool fingerprintbacklog() const { return fingerprintjobs.size() >= MAX_PENDING_FINGERPRINTS; }
 
     m_off_t localbytes = 0;
     unsigned localnodes[2]{};
@@ -295,6 +345,22 @@ public:
     // LocalNode
     bool scan(LocalPath*, FileAccess*);
 
+    // background listing of the sync tree while its initial scan is in progress,
+    // so that scan() finds folders already listed
+    unique_ptr<ParallelDirScanner> prescan;
+    void startprescan(const LocalPath& root);
+    void endprescan();
+
+    // the prescan listed each folder before it was watched, so once the initial scan
+    // ends the tree is listed again, and what changed in between is notified
+    unique_ptr<ParallelDirScanner> verifyscan;
+
+    // compare the folders listed again with their LocalNodes, returns true if any change was found
+    bool procverifyscan();
+
+    // when the initial scan started, for the throughput logged when it ends
+    std::chrono::steady_clock::time_point initialscanstart;
+
     // rescan sequence number (incremented when a full rescan or a new
     // notification batch starts)
     int scanseqno = 0;
@@ -309,6 +375,13 @@ public:
     // state cache table
     unique_ptr<DbTable> statecachetable;
 
+    // fingerprints of the files in the sync, shared with the worker threads
+    // (its table outlives disablements, unlike the state cache: it is only
+    // removed with the sync)
+    shared_ptr<LocalFingerprintCache> fingerprintcache;
+    unique_ptr<DbTable> fingerprinttable;
+    static string fingerprinttablename(handle backupId, handle me);
+
     // move file or folder to localdebris
     bool movetolocaldebris(LocalPath& localpath);
 
@@ -347,6 +420,9 @@ public:
     static const int FILE_UPDATE_DELAY_DS;
     static const int FILE_UPDATE_MAX_DELAY_SECS;
     static const dstime RECENT_VERSION_INTERVAL_SECS;
+    static const unsigned PRESCAN_THREADS;
+    static const size_t MAX_PENDING_FINGERPRINTS;
+    static const unsigned SCANNING_BATCH_MS;
 
     // Change state to (DISABLED, BACKUP_MODIFIED).
     // Always returns false.
@@ -548,6 +624,7 @@ struct Syncs
     unsigned numSyncs();    // includes non-running syncs, but configured
     Sync* firstRunningSync();
     Sync* runningSyncByBackupId(handle backupId) const;
+    Sync* runningSyncContainingPath(const LocalPath& path) const;
     SyncConfig* syncConfigByBackupId(handle backupId) const;
 
     void forEachUnifiedSync(std::function<void(UnifiedSync&)> f);
@@ -593,6 +670,16 @@ struct Syncs
     // for quick lock free reference by MegaApiImpl::syncPathState (don't slow down windows explorer)
     bool isEmpty = true;
 
+    // only inform the app of the treestate changes of folders
+    bool mTreeStateFoldersOnly = false;
+
+    // inform the app of the treestate changes of each sync at once
+    bool mTreeStateBatched = false;
+
+    // treestate changes, and the ones the app was informed of
+    uint64_t mTreeStateChanges = 0;
+    uint64_t mTreeStateNotifications = 0;
+
     unique_ptr<BackupMonitor> mHeartBeatMonitor;
 
     /**
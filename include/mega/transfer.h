@@ -27,6 +27,7 @@
 #include "http.h"
 #include "command.h"
 #include "raid.h"
+#include "bandwidthscheduler.h"
 
 namespace mega {
 
@@ -127,6 +128,12 @@ struct MEGA_API Transfer : public FileFingerprint
     // downloads can have 6 for raid, 1 for non-raid.  Uploads always have 1
     std::vector<string> tempurls;
 
+    // temp URL as requested, with the alternative port applied if enabled
+    string posturl(const string& tempurl) const;
+
+    // open connections to the storage hosts in advance (just one per host if the transfer is still queued)
+    void preconnect(bool queued = false);
+
     // context of the async fopen operation
     AsyncIOContext* asyncopencontext;
 
@@ -139,6 +146,9 @@ struct MEGA_API Transfer : public FileFingerprint
     // state of the transfer
     transferstate_t state;
 
+    // bandwidth class and weight, see BandwidthScheduler
+    BandwidthFlow bwflow;
+
     bool skipserialization;
 
     Transfer(MegaClient*, direction_t);
@@ -233,6 +243,9 @@ struct MEGA_API DirectReadSlot
     m_off_t speed;
     m_off_t meanSpeed;
 
+    // streaming class, see BandwidthScheduler::consume()
+    BandwidthFlow bwflow;
+
     bool doio();
 
     DirectReadSlot(DirectRead*);
@@ -81,6 +81,14 @@ struct MEGA_API TransferSlot
 
     dstime starttime, lastdata;
 
+    // last time the bandwidth scheduler held back every request, with none in flight
+    // (that doesn't count towards XFERTIMEOUT, unlike a lack of data with requests in flight)
+    dstime lastthrottled = 0;
+
+    // time to first byte (ms) from the first request posted until data flows, -1 if not known yet
+    std::chrono::steady_clock::time_point firstrequesttime;
+    int64_t ttfb = -1;
+
     SpeedController speedController;
     m_off_t speed, meanSpeed;
 
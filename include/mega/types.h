@@ -626,6 +626,14 @@ typedef enum { TRANSFERSTATE_NONE = 0, TRANSFERSTATE_QUEUED, TRANSFERSTATE_ACTIV
                TRANSFERSTATE_RETRYING, TRANSFERSTATE_COMPLETING, TRANSFERSTATE_COMPLETED,
                TRANSFERSTATE_CANCELLED, TRANSFERSTATE_FAILED } transferstate_t;
 
+// bandwidth scheduling class of a transfer (see BandwidthScheduler)
+typedef enum { TRANSFERCLASS_INTERACTIVE = 0, TRANSFERCLASS_SYNC, TRANSFERCLASS_BACKUP,
+               TRANSFERCLASS_STREAMING, NUM_TRANSFERCLASSES } transferclass_t;
+
+// traffic class of an HttpReq, for network telemetry (see NetworkTelemetry)
+typedef enum { NETCHANNEL_CS = 0, NETCHANNEL_SC, NETCHANNEL_GET, NETCHANNEL_PUT,
+               NETCHANNEL_FA, NETCHANNEL_OTHER, NUM_NETCHANNELS } netchannel_t;
+
 
 // FIXME: use forward_list instad (C++11)
 typedef list<HttpReqCommandPutFA*> putfa_list;
@@ -22,6 +22,7 @@
 #ifndef MEGA_UTILS_H
 #define MEGA_UTILS_H 1
 
+#include <atomic>
 #include <type_traits>
 #include <condition_variable>
 #include <thread>
@@ -556,6 +557,9 @@ struct MegaClientAsyncQueue
     void push(std::function<void(SymmCipher&)> f, bool discardable);
     void clearDiscardable();
 
+    // false if jobs are executed synchronously by push()
+    bool threaded() const { return !mThreads.empty(); }
+
     MegaClientAsyncQueue(Waiter& w, unsigned threadCount);
     ~MegaClientAsyncQueue();
 
@@ -642,6 +646,151 @@ public:
 
 };
 
+// Bounded lock-free queue for any number of producers and a single consumer (D. Vyukov's
+// bounded queue).  Producers never block each other nor the consumer: tryPush() fails
+// when the queue is full instead.  tryPop() must only be called by one thread at a time.
+template<class T>
+class BoundedMpscQueue
+{
+public:
+    // capacity must be a power of two
+    explicit BoundedMpscQueue(size_t capacity)
+        : mCells(new Cell[capacity])
+        , mMask(capacity - 1)
+    {
+        assert(capacity >= 2 && !(capacity & mMask));
+        for (size_t i = 0; i < capacity; i++)
+        {
+            mCells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(T t)
+    {
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell& cell = mCells[pos & mMask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t dif = intptr_t(seq) - intptr_t(pos);
+            if (!dif)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.value = std::move(t);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (dif < 0)
+            {
+                return false;  // full, the consumer hasn't taken the value of the previous round
+            }
+            else
+            {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // position is the number of values pushed before this one, counting from 1
+    bool tryPop(T& t, size_t* position = nullptr)
+    {
+        Cell& cell = mCells[mDequeuePos & mMask];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (intptr_t(seq) - intptr_t(mDequeuePos + 1) < 0)
+        {
+            return false;  // empty, or the next value isn't completely pushed yet
+        }
+
+        t = std::move(cell.value);
+        cell.sequence.store(mDequeuePos + mMask + 1, std::memory_order_release);
+        if (position)
+        {
+            *position = mDequeuePos + 1;
+        }
+        mDequeuePos++;
+        return true;
+    }
+
+    // pops every value whose push started before this call, in order, waiting for the
+    // pushes still in progress (tryPop() stops at the first of them, even if later ones
+    // have finished)
+    template<class F>
+    void popPushed(F f)
+    {
+        size_t end = pushed();
+        T t;
+        size_t position;
+        while (mDequeuePos < end)
+        {
+            if (tryPop(t, &position))
+            {
+                f(std::move(t), position);
+            }
+            else
+            {
+                // a producer between claiming its cell and publishing the value
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // values pushed so far, including those not popped yet and those still being pushed
+    size_t pushed() const
+    {
+        return mEnqueuePos.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> mCells;
+    const size_t mMask;
+
+    // padded to different cache lines, so that producers and consumer don't invalidate each other's
+    // (not alignas, which would need the aligned operator new of C++17 for the owners)
+    std::atomic<size_t> mEnqueuePos{0};
+    char mPadding[64];
+    size_t mDequeuePos = 0;
+};
+
+// Reader/writer lock, as std::shared_mutex (C++17): any number of threads can hold it
+// shared, or a single one exclusively.  Waiting writers take precedence over new
+// readers, so that frequent readers can't keep a writer waiting indefinitely.
+class MEGA_API SharedMutex
+{
+public:
+    void lock();
+    bool try_lock();
+    void unlock();
+    void lock_shared();
+    void unlock_shared();
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    unsigned mReaders = 0;
+    unsigned mWaitingWriters = 0;
+    bool mWriter = false;
+};
+
+class MEGA_API SharedLockGuard
+{
+public:
+    explicit SharedLockGuard(SharedMutex& m) : mMutex(m) { mMutex.lock_shared(); }
+    ~SharedLockGuard() { mMutex.unlock_shared(); }
+
+    MEGA_DISABLE_COPY_MOVE(SharedLockGuard)
+
+private:
+    SharedMutex& mMutex;
+};
+
 template<typename CharT>
 struct UnicodeCodepointIteratorTraits;
 
@@ -72,6 +72,10 @@ class MegaScheduledCopy;
 class MegaSync;
 class MegaStringList;
 class MegaNodeList;
+class MegaNodeInfoList;
+class MegaNodeChangeList;
+class MegaSyncFileStateList;
+class MegaChildrenPage;
 class MegaUserList;
 class MegaUserAlertList;
 class MegaContactRequestList;
@@ -2531,6 +2535,255 @@ public:
     virtual MegaNodeList* getFileList();
 };
 
+/**
+ * @brief Compact list with the main properties of many nodes
+ *
+ * Unlike a MegaNodeList, it doesn't contain a MegaNode object per node, but a snapshot of
+ * the properties needed to display them (e.g. the rows of a folder view), so it is much
+ * cheaper to get for big folders. Use MegaApi::getNodeByHandle to get the complete MegaNode
+ * of any of them when needed.
+ *
+ * The values of the getters for positions out of range are the ones of a missing node
+ * (INVALID_HANDLE, MegaNode::TYPE_UNKNOWN, NULL, -1 or false).
+ *
+ * Objects of this class are immutable.
+ *
+ * @see MegaApi::getChildrenInfo
+ */
+class MegaNodeInfoList
+{
+public:
+    virtual ~MegaNodeInfoList();
+    virtual MegaNodeInfoList *copy() const;
+
+    /**
+     * @brief Returns the number of nodes in the list
+     * @return Number of nodes in the list
+     */
+    virtual int size() const;
+
+    /**
+     * @brief Returns the handle of the node at the position i
+     * @param i Position of the node in the list
+     * @return Handle of the node
+     */
+    virtual MegaHandle getHandle(int i) const;
+
+    /**
+     * @brief Returns the handle of the parent of the node at the position i
+     * @param i Position of the node in the list
+     * @return Handle of the parent of the node, or INVALID_HANDLE if it has no parent
+     */
+    virtual MegaHandle getParentHandle(int i) const;
+
+    /**
+     * @brief Returns the type of the node at the position i
+     * @param i Position of the node in the list
+     * @return Type of the node, as returned by MegaNode::getType
+     */
+    virtual int getType(int i) const;
+
+    /**
+     * @brief Returns the name of the node at the position i
+     *
+     * The MegaNodeInfoList retains the ownership of the returned string. It will be only
+     * valid until the MegaNodeInfoList is deleted.
+     *
+     * @param i Position of the node in the list
+     * @return Name of the node
+     */
+    virtual const char *getName(int i) const;
+
+    /**
+     * @brief Returns the size of the node at the position i
+     * @param i Position of the node in the list
+     * @return Size of the node, as returned by MegaNode::getSize
+     */
+    virtual int64_t getSize(int i) const;
+
+    /**
+     * @brief Returns the creation time of the node at the position i
+     * @param i Position of the node in the list
+     * @return Creation time of the node (in seconds since the epoch)
+     */
+    virtual int64_t getCreationTime(int i) const;
+
+    /**
+     * @brief Returns the modification time of the file at the position i
+     * @param i Position of the node in the list
+     * @return Modification time of the file (in seconds since the epoch), or 0 for folders
+     */
+    virtual int64_t getModificationTime(int i) const;
+
+    /**
+     * @brief Returns the label of the node at the position i
+     * @param i Position of the node in the list
+     * @return Label of the node, as returned by MegaNode::getLabel
+     */
+    virtual int getLabel(int i) const;
+
+    /**
+     * @brief Returns true if the node at the position i is marked as favourite
+     * @param i Position of the node in the list
+     * @return True if the node is marked as favourite
+     */
+    virtual bool isFavourite(int i) const;
+
+    /**
+     * @brief Returns true if the node at the position i has an associated thumbnail
+     * @param i Position of the node in the list
+     * @return True if the node has an associated thumbnail
+     */
+    virtual bool hasThumbnail(int i) const;
+
+    /**
+     * @brief Returns true if the node at the position i has an associated preview
+     * @param i Position of the node in the list
+     * @return True if the node has an associated preview
+     */
+    virtual bool hasPreview(int i) const;
+};
+
+/**
+ * @brief Compact list with the changes of many nodes
+ *
+ * Unlike the MegaNodeList received by MegaGlobalListener::onNodesUpdate, it doesn't contain
+ * a MegaNode object per changed node, but its handle, the handle of its parent and the changes,
+ * so it's cheap to build even when many nodes change at once. Use MegaApi::getNodeByHandle to
+ * get the complete MegaNode of any of them when needed.
+ *
+ * If requested with MegaApi::setNodeChangeNotifications, the new values of some of the changed
+ * properties are included too. Otherwise, or if those properties didn't change, their getters
+ * return the values of a missing node.
+ *
+ * The values of the getters for positions out of range are the ones of a missing node
+ * (INVALID_HANDLE, 0, MegaNode::TYPE_UNKNOWN, NULL or -1).
+ *
+ * Objects of this class are immutable.
+ *
+ * @see MegaGlobalListener::onNodeChanges
+ */
+class MegaNodeChangeList
+{
+public:
+    virtual ~MegaNodeChangeList();
+    virtual MegaNodeChangeList *copy() const;
+
+    /**
+     * @brief Returns the number of nodes in the list
+     * @return Number of nodes in the list
+     */
+    virtual int size() const;
+
+    /**
+     * @brief Returns the handle of the node at the position i
+     * @param i Position of the node in the list
+     * @return Handle of the node
+     */
+    virtual MegaHandle getHandle(int i) const;
+
+    /**
+     * @brief Returns the handle of the parent of the node at the position i
+     *
+     * For moved nodes, it's the handle of the new parent.
+     *
+     * @param i Position of the node in the list
+     * @return Handle of the parent of the node, or INVALID_HANDLE if it has no parent
+     */
+    virtual MegaHandle getParentHandle(int i) const;
+
+    /**
+     * @brief Returns the changes of the node at the position i
+     * @param i Position of the node in the list
+     * @return Bit field with the changes of the node, as returned by MegaNode::getChanges
+     */
+    virtual int getChanges(int i) const;
+
+    /**
+     * @brief Returns the type of the node at the position i
+     * @param i Position of the node in the list
+     * @return Type of the node, as returned by MegaNode::getType
+     */
+    virtual int getType(int i) const;
+
+    /**
+     * @brief Returns the name of the node at the position i, if it's new or its attributes changed
+     *
+     * The MegaNodeChangeList retains the ownership of the returned string. It will be only
+     * valid until the MegaNodeChangeList is deleted.
+     *
+     * @param i Position of the node in the list
+     * @return Name of the node, or NULL if it wasn't included
+     */
+    virtual const char *getName(int i) const;
+
+    /**
+     * @brief Returns the size of the node at the position i, if it's new
+     * @param i Position of the node in the list
+     * @return Size of the node, as returned by MegaNode::getSize, or -1 if it wasn't included
+     */
+    virtual int64_t getSize(int i) const;
+
+    /**
+     * @brief Returns the modification time of the file at the position i, if it's new
+     * @param i Position of the node in the list
+     * @return Modification time of the file (in seconds since the epoch), or -1 if it wasn't included
+     */
+    virtual int64_t getModificationTime(int i) const;
+
+    /**
+     * @brief Returns true if this is the last list of a set of changes
+     *
+     * The changes notified at once are split in lists of up to the size passed to
+     * MegaApi::setNodeChangeNotifications, and delivered with consecutive calls to
+     * MegaGlobalListener::onNodeChanges. This is the last of them.
+     *
+     * @return True if this is the last list of the set of changes
+     */
+    virtual bool isLast() const;
+};
+
+/**
+ * @brief Page of the children of a folder, in a given order
+ *
+ * A MegaChildrenPage has the ownership of the MegaNodeList that it contains, so it will be
+ * only valid until the MegaChildrenPage is deleted.
+ *
+ * Objects of this class are immutable.
+ *
+ * @see MegaApi::getChildrenPage
+ */
+class MegaChildrenPage
+{
+public:
+    virtual ~MegaChildrenPage();
+    virtual MegaChildrenPage *copy() const;
+
+    /**
+     * @brief Returns the children in the page
+     *
+     * The MegaChildrenPage retains the ownership of the returned list.
+     *
+     * @return Children in the page
+     */
+    virtual MegaNodeList *getNodes() const;
+
+    /**
+     * @brief Returns the cursor to get the next page with MegaApi::getChildrenPage
+     *
+     * The MegaChildrenPage retains the ownership of the returned value.
+     *
+     * @return Cursor of the next page, or NULL if this is the last one
+     */
+    virtual const char *getNextCursor() const;
+
+    /**
+     * @brief Returns the number of children of the folder when the page was taken
+     * @return Number of children of the folder
+     */
+    virtual int getTotalSize() const;
+};
+
 /**
  * @brief List of MegaUser objects
  *
@@ -3161,7 +3414,11 @@ class MegaRequest
             TYPE_LOAD_EXTERNAL_DRIVE_BACKUPS                                = 139,
             TYPE_CLOSE_EXTERNAL_DRIVE_BACKUPS                               = 140,
             TYPE_GET_DOWNLOAD_URLS                                          = 141,
-            TOTAL_OF_REQUEST_TYPES                                          = 142,
+            TYPE_SET_TRANSFER_BANDWIDTH_CLASS                               = 142,
+            TYPE_SEARCH                                                     = 143,
+            TYPE_GET_CHILDREN                                               = 144,
+            TYPE_EXPORT_NODE_TREE                                           = 145,
+            TOTAL_OF_REQUEST_TYPES                                          = 146,
         };
 
         virtual ~MegaRequest();
@@ -3928,6 +4185,20 @@ class MegaRequest
          * @return MegaHandle list
          */
         virtual MegaHandleList* getMegaHandleList() const;
+
+        /**
+         * @brief Returns a list of nodes
+         *
+         * The SDK retains the ownership of the returned value. It will be valid until
+         * the MegaRequest object is deleted.
+         *
+         * This value is valid for these requests in onRequestUpdate:
+         * - MegaApi::searchAsync - The next page of results
+         * - MegaApi::getChildrenAsync - The next page of children
+         *
+         * @return List of nodes
+         */
+        virtual MegaNodeList* getMegaNodeList() const;
 };
 
 /**
@@ -4058,6 +4329,14 @@ class MegaTransfer
             MOVE_TYPE_BOTTOM
         };
 
+        enum {
+            BANDWIDTH_CLASS_ALL = -1,
+            BANDWIDTH_CLASS_INTERACTIVE = 0,
+            BANDWIDTH_CLASS_SYNC = 1,
+            BANDWIDTH_CLASS_BACKUP = 2,
+            BANDWIDTH_CLASS_STREAMING = 3
+        };
+
         virtual ~MegaTransfer();
 
         /**
@@ -4264,6 +4543,17 @@ class MegaTransfer
          */
         virtual long long getMeanSpeed() const;
 
+        /**
+         * @brief Returns the time to first byte of this transfer (in milliseconds)
+         *
+         * It's the time elapsed between the first request to the storage servers and the
+         * first data flowing through it, so it includes the DNS resolution and connection
+         * setup unless the SDK could connect in advance.
+         *
+         * @return Time to first byte of this transfer, or -1 if it's not known yet
+         */
+        virtual long long getTimeToFirstByte() const;
+
         /**
 		 * @brief Returns the number of bytes transferred since the previous callback
 		 * @return Number of bytes transferred since the previous callback
@@ -5471,6 +5761,53 @@ class MegaSyncList
         virtual void addSync(MegaSync* sync);
 };
 
+/**
+ * @brief List with the new sync states of the files and folders of a sync
+ *
+ * It has the states that changed in an iteration of the SDK thread, delivered at once
+ * with MegaListener::onSyncFileStatesChanged instead of a call to
+ * MegaListener::onSyncFileStateChanged per file or folder, if enabled with
+ * MegaApi::setSyncStateNotificationsBatched.
+ *
+ * The values of the getters for positions out of range are NULL and MegaApi::STATE_NONE.
+ *
+ * Objects of this class are immutable.
+ *
+ * @see MegaListener::onSyncFileStatesChanged
+ */
+class MegaSyncFileStateList
+{
+public:
+    virtual ~MegaSyncFileStateList();
+    virtual MegaSyncFileStateList *copy() const;
+
+    /**
+     * @brief Returns the number of files and folders in the list
+     * @return Number of files and folders in the list
+     */
+    virtual int size() const;
+
+    /**
+     * @brief Returns the local path of the file or folder at the position i
+     *
+     * It's encoded as the localPath parameter of MegaListener::onSyncFileStateChanged.
+     *
+     * The MegaSyncFileStateList retains the ownership of the returned string. It will be only
+     * valid until the MegaSyncFileStateList is deleted.
+     *
+     * @param i Position of the file or folder in the list
+     * @return Local path of the file or folder
+     */
+    virtual const std::string *getLocalPath(int i) const;
+
+    /**
+     * @brief Returns the new state of the file or folder at the position i
+     * @param i Position of the file or folder in the list
+     * @return New state, as the newState parameter of MegaListener::onSyncFileStateChanged
+     */
+    virtual int getState(int i) const;
+};
+
 
 
 #endif
@@ -6305,6 +6642,21 @@ class MegaTransferListener
          */
         virtual void onTransferUpdate(MegaApi *api, MegaTransfer *transfer);
 
+        /**
+         * @brief This function is called to inform about the progress of many transfers at once
+         *
+         * It's only called if the updates are batched with MegaApi::setTransferUpdatePolicy,
+         * instead of onTransferUpdate, with the latest state of all the transfers that changed
+         * in an iteration of the SDK thread. The transfers that already finished are not included.
+         *
+         * The SDK retains the ownership of the transfers parameter.
+         * Don't use it after this functions returns.
+         *
+         * @param api MegaApi object that started the transfers
+         * @param transfers Information about the transfers
+         */
+        virtual void onTransfersUpdate(MegaApi *api, MegaTransferList *transfers);
+
         /**
          * @brief This function is called when there is a temporary error processing a transfer
          *
@@ -6497,6 +6849,24 @@ class MegaGlobalListener
          */
         virtual void onNodesUpdate(MegaApi* api, MegaNodeList *nodes);
 
+        /**
+         * @brief This function is called with the changes of the nodes in the account, if enabled
+         *
+         * It's only called if enabled with MegaApi::setNodeChangeNotifications, instead of
+         * onNodesUpdate with the list of changed nodes. When the full account is reloaded,
+         * onNodesUpdate is still called with NULL.
+         *
+         * The changes notified at once can be split in several consecutive calls, and
+         * MegaNodeChangeList::isLast is true in the last of them.
+         *
+         * The SDK retains the ownership of the MegaNodeChangeList in the second parameter. It will be
+         * valid until this function returns. If you want to save it, use MegaNodeChangeList::copy.
+         *
+         * @param api MegaApi object connected to the account
+         * @param changes Changes of the nodes
+         */
+        virtual void onNodeChanges(MegaApi* api, MegaNodeChangeList *changes);
+
         /**
          * @brief This function is called when the account has been updated (confirmed/upgraded/downgraded)
          *
@@ -6835,6 +7205,21 @@ class MegaListener
          */
         virtual void onTransferUpdate(MegaApi *api, MegaTransfer *transfer);
 
+        /**
+         * @brief This function is called to inform about the progress of many transfers at once
+         *
+         * It's only called if the updates are batched with MegaApi::setTransferUpdatePolicy,
+         * instead of onTransferUpdate, with the latest state of all the transfers that changed
+         * in an iteration of the SDK thread. The transfers that already finished are not included.
+         *
+         * The SDK retains the ownership of the transfers parameter.
+         * Don't use it after this functions returns.
+         *
+         * @param api MegaApi object that started the transfers
+         * @param transfers Information about the transfers
+         */
+        virtual void onTransfersUpdate(MegaApi *api, MegaTransferList *transfers);
+
         /**
          * @brief This function is called when there is a temporary error processing a transfer
          *
@@ -6896,6 +7281,24 @@ class MegaListener
          */
         virtual void onNodesUpdate(MegaApi* api, MegaNodeList *nodes);
 
+        /**
+         * @brief This function is called with the changes of the nodes in the account, if enabled
+         *
+         * It's only called if enabled with MegaApi::setNodeChangeNotifications, instead of
+         * onNodesUpdate with the list of changed nodes. When the full account is reloaded,
+         * onNodesUpdate is still called with NULL.
+         *
+         * The changes notified at once can be split in several consecutive calls, and
+         * MegaNodeChangeList::isLast is true in the last of them.
+         *
+         * The SDK retains the ownership of the MegaNodeChangeList in the second parameter. It will be
+         * valid until this function returns. If you want to save it, use MegaNodeChangeList::copy.
+         *
+         * @param api MegaApi object connected to the account
+         * @param changes Changes of the nodes
+         */
+        virtual void onNodeChanges(MegaApi* api, MegaNodeChangeList *changes);
+
         /**
          * @brief This function is called when the account has been updated (confirmed/upgraded/downgraded)
          *
@@ -6955,6 +7358,22 @@ class MegaListener
      */
     virtual void onSyncFileStateChanged(MegaApi *api, MegaSync *sync, std::string *localPath, int newState);
 
+    /**
+     * @brief This function is called with the states of the synced files and folders that changed
+     *
+     * It's only called if enabled with MegaApi::setSyncStateNotificationsBatched, instead of
+     * MegaListener::onSyncFileStateChanged, once per sync and iteration of the SDK thread.
+     *
+     * The SDK retains the ownership of the sync and states parameters.
+     * Don't use them after this functions returns. If you want to save the list, use
+     * MegaSyncFileStateList::copy.
+     *
+     * @param api MegaApi object that is synchronizing files
+     * @param sync MegaSync object that manages the files and folders
+     * @param states New states of the files and folders that changed
+     */
+    virtual void onSyncFileStatesChanged(MegaApi *api, MegaSync *sync, MegaSyncFileStateList *states);
+
     /**
      * @brief This callback will be called when a sync is added
      *
@@ -12818,6 +13237,50 @@ class MegaApi
          */
         void startDownloadWithTopPriority(MegaNode* node, const char* localPath, const char *appData, MegaTransferListener *listener = NULL);
 
+        /**
+         * @brief Upload many files as a single transfer
+         *
+         * The files are transferred as with MegaApi::startUpload, but apps get a single
+         * MegaTransfer for all of them, with the total size and progress of the batch. It
+         * finishes when all the files have finished, with MegaError::API_EINCOMPLETE if any
+         * of them failed or the batch was cancelled.
+         *
+         * The transfers of the files are created as the batch progresses, so starting a batch
+         * of a million files is about as cheap as copying its paths. They are only reported to the
+         * listener of this function, not to the listeners registered with MegaApi::addListener
+         * or MegaApi::addTransferListener.
+         *
+         * If the arguments aren't valid, the batch finishes with MegaError::API_EARGS.
+         *
+         * @param localPaths Local paths of the files
+         * @param parents Parent nodes in the MEGA account, either one for each file or a single one for all of them
+         * @param listener MegaTransferListener to track this transfer and the transfers of its files
+         */
+        void startUploads(MegaStringList *localPaths, MegaHandleList *parents, MegaTransferListener *listener = NULL);
+
+        /**
+         * @brief Download many files as a single transfer
+         *
+         * The files are transferred as with MegaApi::startDownload, but apps get a single
+         * MegaTransfer for all of them, with the total size and progress of the batch. It
+         * finishes when all the files have finished, with MegaError::API_EINCOMPLETE if any
+         * of them failed or the batch was cancelled.
+         *
+         * The transfers of the files are created as the batch progresses, so starting a batch
+         * of a million files is about as cheap as copying its handles. They are only reported to the
+         * listener of this function, not to the listeners registered with MegaApi::addListener
+         * or MegaApi::addTransferListener.
+         *
+         * If the arguments aren't valid, the batch finishes with MegaError::API_EARGS.
+         *
+         * @param nodes Handles of the files in the MEGA account
+         * @param localPaths Destination paths, either one for each file or a single one for all of them
+         * If a path is a local folder, it must end with a '\' or '/' character and the file name
+         * in MEGA will be used to store the file inside that folder, like in MegaApi::startDownload.
+         * @param listener MegaTransferListener to track this transfer and the transfers of its files
+         */
+        void startDownloads(MegaHandleList *nodes, MegaStringList *localPaths, MegaTransferListener *listener = NULL);
+
         /**
          * @brief Start an streaming download for a file in MEGA
          *
@@ -13073,6 +13536,54 @@ class MegaApi
          */
         void moveTransferBeforeByTag(int transferTag, int prevTransferTag, MegaRequestListener *listener = NULL);
 
+        /**
+         * @brief Move a transfer to a different bandwidth class
+         *
+         * Active transfers are paced by a bandwidth scheduler that groups them in classes:
+         * - MegaTransfer::BANDWIDTH_CLASS_INTERACTIVE = 0 (default for transfers started by the app)
+         * - MegaTransfer::BANDWIDTH_CLASS_SYNC = 1 (default for transfers started by syncs)
+         * - MegaTransfer::BANDWIDTH_CLASS_BACKUP = 2 (default for uploads of backups)
+         * - MegaTransfer::BANDWIDTH_CLASS_STREAMING = 3 (used by MegaApi::startStreaming and the
+         * HTTP/FTP servers; streams can't be held back, but the bandwidth that they use is taken
+         * from the limits that the other classes are paced against)
+         *
+         * When the bandwidth of a class is limited (see MegaApi::setBandwidthClassLimits),
+         * its transfers share it proportionally to their weights.
+         *
+         * The change is applied immediately, also to transfers in progress, and it's kept
+         * when the transfers are resumed in a later session.
+         *
+         * The associated request type with this request is MegaRequest::TYPE_SET_TRANSFER_BANDWIDTH_CLASS
+         * Valid data in the MegaRequest object received on callbacks:
+         * - MegaRequest::getTransferTag - Returns the tag of the transfer
+         * - MegaRequest::getNumber - Returns the bandwidth class
+         * - MegaRequest::getParamType - Returns the weight
+         *
+         * @param transfer Transfer to reclassify
+         * @param bandwidthClass New bandwidth class for the transfer
+         * @param weight Relative share of the transfer within its class (>= 1)
+         * @param listener MegaRequestListener to track this request
+         */
+        void setTransferBandwidthClass(MegaTransfer *transfer, int bandwidthClass, int weight = 1, MegaRequestListener *listener = NULL);
+
+        /**
+         * @brief Move a transfer to a different bandwidth class
+         *
+         * The associated request type with this request is MegaRequest::TYPE_SET_TRANSFER_BANDWIDTH_CLASS
+         * Valid data in the MegaRequest object received on callbacks:
+         * - MegaRequest::getTransferTag - Returns the tag of the transfer
+         * - MegaRequest::getNumber - Returns the bandwidth class
+         * - MegaRequest::getParamType - Returns the weight
+         *
+         * @see MegaApi::setTransferBandwidthClass
+         *
+         * @param transferTag Tag of the transfer to reclassify
+         * @param bandwidthClass New bandwidth class for the transfer
+         * @param weight Relative share of the transfer within its class (>= 1)
+         * @param listener MegaRequestListener to track this request
+         */
+        void setTransferBandwidthClassByTag(int transferTag, int bandwidthClass, int weight = 1, MegaRequestListener *listener = NULL);
+
         /**
          * @brief Cancel the transfer with a specific tag
          *
@@ -13236,6 +13747,52 @@ class MegaApi
          */
         void setMaxConnections(int connections, MegaRequestListener* listener = NULL);
 
+        /**
+         * @brief Limit the progress updates of transfers reported to the app
+         *
+         * By default, MegaListener::onTransferUpdate and MegaTransferListener::onTransferUpdate
+         * are called for every progress update of every transfer. With many concurrent transfers,
+         * that can be thousands of callbacks per second.
+         *
+         * With a policy, the progress of a transfer is only reported when at least \c minIntervalMs
+         * milliseconds passed since its previous report, or when it transferred at least \c minBytes
+         * since then. A value of 0 disables each condition, and the default policy (0, 0) reports
+         * every update. The latest progress of a transfer that stops progressing is still reported
+         * once \c minIntervalMs passed, or after one second when only \c minBytes is set. The start,
+         * the changes of state and the end of transfers are always reported immediately.
+         *
+         * The interval is measured in tenths of a second, the resolution of the timers of the SDK,
+         * so it's rounded up to them.
+         *
+         * If \c batched is true, the global listeners receive the updates of all the transfers that
+         * changed in each iteration of the SDK thread in a single call to MegaListener::onTransfersUpdate
+         * or MegaTransferListener::onTransfersUpdate, instead of one call to onTransferUpdate per
+         * transfer. The listeners passed to the functions that start the transfers still receive
+         * onTransferUpdate for their transfer.
+         *
+         * The effect of the policy can be checked with MegaApi::getTransferUpdateStats.
+         *
+         * @param minIntervalMs Minimum time between two progress updates of a transfer, in milliseconds
+         * @param minBytes Minimum bytes transferred between two progress updates of a transfer
+         * @param batched True to deliver the updates to the global listeners in batches
+         */
+        void setTransferUpdatePolicy(int minIntervalMs, long long minBytes, bool batched = false);
+
+        /**
+         * @brief Get statistics about the progress updates of transfers reported to the app
+         *
+         * The statistics are returned as a JSON object, with the number of progress "updates"
+         * of transfers, the ones "suppressed" by MegaApi::setTransferUpdatePolicy, the transfer
+         * updates "notified" to the app and the number of "batches" delivered with
+         * MegaListener::onTransfersUpdate and MegaTransferListener::onTransfersUpdate.
+         * They are collected since the MegaApi object was created.
+         *
+         * The caller takes the ownership of the returned value.
+         *
+         * @return JSON object with the statistics
+         */
+        char *getTransferUpdateStats();
+
         /**
          * @brief Set the transfer method for downloads
          *
@@ -13312,6 +13869,30 @@ class MegaApi
          */
         bool setMaxUploadSpeed(long long bpslimit);
 
+        /**
+         * @brief Set the bandwidth limits of a bandwidth class
+         *
+         * Each class has a guaranteed minimum rate, that it can use even when the total
+         * limit is exhausted, and a maximum rate. Spare bandwidth up to the total limit is
+         * given to classes in priority order: interactive, streaming, sync and backup.
+         *
+         * Use MegaTransfer::BANDWIDTH_CLASS_ALL as bandwidthClass to set the total limit
+         * for the direction (only maxBps is used in that case).
+         *
+         * Limits are applied per HTTP request of each transfer, independently of
+         * MegaApi::setMaxDownloadSpeed and MegaApi::setMaxUploadSpeed, which still cap
+         * the network layer.
+         *
+         * A value <= 0 means no guarantee / unlimited speed
+         *
+         * @param direction MegaTransfer::TYPE_DOWNLOAD or MegaTransfer::TYPE_UPLOAD
+         * @param bandwidthClass Bandwidth class (MegaTransfer::BANDWIDTH_CLASS_*)
+         * @param minBps Guaranteed rate in bytes per second
+         * @param maxBps Maximum rate in bytes per second
+         * @return true if the limits were applied, false if the parameters are invalid
+         */
+        bool setBandwidthClassLimits(int direction, int bandwidthClass, long long minBps, long long maxBps);
+
         /**
          * @brief Get the maximum download speed in bytes per second
          *
@@ -14178,6 +14759,73 @@ class MegaApi
          */
         long long getNumLocalNodes();
 
+        /**
+         * @brief Get statistics about the cache of local file fingerprints of the syncs
+         *
+         * Files whose filesystem id, size and modification time didn't change since
+         * they were fingerprinted are not read again to check them. The cache of each
+         * sync is kept while the sync is disabled, and is deleted with the sync.
+         *
+         * The statistics are returned as a JSON object, with the "hits", "misses" and
+         * "entries" of all the running syncs, and the same stats for each of them in
+         * "syncs", identified by their backup id in "id". They are collected since each
+         * sync was started.
+         *
+         * The caller takes the ownership of the returned value.
+         *
+         * @return JSON object with the statistics
+         */
+        char *getSyncFingerprintCacheStats();
+
+        /**
+         * @brief Only report the sync state changes of folders
+         *
+         * The sync state of a folder summarizes the states of the files inside it, so
+         * apps that only display the state of folders can avoid one call to
+         * MegaGlobalListener::onSyncFileStateChanged and MegaListener::onSyncFileStateChanged
+         * per transferred file with this option. MegaApi::syncPathState still returns
+         * the state of files.
+         *
+         * In any case, the changes are reported once per iteration of the SDK thread,
+         * with the latest state of each file/folder that changed, and the states of
+         * the folders are updated up to the sync root once per iteration too.
+         *
+         * The default value is false.
+         *
+         * @param foldersOnly True to only report the state changes of folders
+         */
+        void setSyncStateNotificationsFoldersOnly(bool foldersOnly);
+
+        /**
+         * @brief Report the sync state changes of each sync at once
+         *
+         * With this option enabled, the listeners receive the state changes of the files and
+         * folders of each sync in a MegaSyncFileStateList with MegaListener::onSyncFileStatesChanged,
+         * once per iteration of the SDK thread, instead of a call to
+         * MegaListener::onSyncFileStateChanged per file or folder. It can be combined with
+         * MegaApi::setSyncStateNotificationsFoldersOnly.
+         *
+         * The default value is false.
+         *
+         * @param batched True to receive the state changes with MegaListener::onSyncFileStatesChanged
+         */
+        void setSyncStateNotificationsBatched(bool batched);
+
+        /**
+         * @brief Get statistics about the sync state changes reported to the app
+         *
+         * The statistics are returned as a JSON object, with the number of state "changes"
+         * of the local files and folders of the syncs, the ones "notified" to the app and
+         * the ones "avoided", because they were superseded in the same iteration of the
+         * SDK thread or excluded by MegaApi::setSyncStateNotificationsFoldersOnly.
+         * They are collected since the MegaApi object was created.
+         *
+         * The caller takes the ownership of the returned value.
+         *
+         * @return JSON object with the statistics
+         */
+        char *getSyncStateNotificationStats();
+
         /**
          * @brief Get the path if the file/folder that is blocking the sync engine
          *
@@ -14625,6 +15273,250 @@ class MegaApi
          */
         MegaNodeList* getChildren(MegaNodeList *parentNodes, int order = 1);
 
+        /**
+         * @brief Get the main properties of all children of a MegaNode
+         *
+         * This function is equivalent to MegaApi::getChildren, but it returns a compact
+         * snapshot of the properties needed to display the children instead of a MegaNode
+         * object per child, so it's much faster and takes much less memory for big folders.
+         *
+         * If the parent node doesn't exist or it isn't a folder, this function
+         * returns an empty list
+         *
+         * You take the ownership of the returned value
+         *
+         * @param parent Parent node
+         * @param order Order for the returned list, as for MegaApi::getChildren
+         * @return List with the properties of all child nodes
+         */
+        MegaNodeInfoList* getChildrenInfo(MegaNode *parent, int order = 1);
+
+        /**
+         * @brief Serve node queries from other threads without waiting for the SDK thread
+         *
+         * The SDK thread keeps its lock while it processes transfers, requests and changes
+         * in the account, so the functions that query the nodes can take a while to return
+         * when it's busy. With this option enabled, the SDK keeps a copy of the nodes that
+         * it updates with each batch of changes notified by MegaGlobalListener::onNodesUpdate,
+         * and the following functions use it instead, so any number of threads can call them
+         * at the same time, only waiting while a batch of changes is applied:
+         *
+         * - MegaApi::getNodeByHandle
+         * - MegaApi::getParentNode
+         * - MegaApi::getNumChildren, MegaApi::getNumChildFiles and MegaApi::getNumChildFolders
+         * - MegaApi::getChildren(MegaNode *, int) with MegaApi::ORDER_NONE, MegaApi::ORDER_DEFAULT_ASC
+         * or MegaApi::ORDER_DEFAULT_DESC
+         *
+         * The results include the changes notified so far. Calls made from the callbacks of the
+         * SDK (and from the SDK thread in general) don't use the copy, as it could still lack the
+         * changes being notified (e.g. a node renamed by a request is updated in the copy soon after
+         * MegaRequestListener::onRequestFinish). The copy takes memory in proportion to the
+         * number of nodes of the account.
+         *
+         * While MegaApi::searchAsync or MegaApi::getChildrenAsync are traversing the copy,
+         * new changes are applied once they finish, and until then these functions behave
+         * as with this option disabled.
+         *
+         * The default value is false.
+         *
+         * @param enable True to serve node queries from the copy of the nodes
+         */
+        void setConcurrentNodeQueries(bool enable);
+
+        /**
+         * @brief Notify the changes of the nodes as compact lists, in batches
+         *
+         * By default, MegaGlobalListener::onNodesUpdate and MegaListener::onNodesUpdate receive
+         * a MegaNode object for each changed node, in a single call. When many nodes change at
+         * once (e.g. a folder with many files is moved), building those objects takes long, and
+         * so does processing them in a single callback.
+         *
+         * With this option enabled, the global listeners receive the changes in MegaNodeChangeList
+         * objects with MegaGlobalListener::onNodeChanges and MegaListener::onNodeChanges instead,
+         * in consecutive calls of up to \c batchSize nodes each. Each entry only contains the handle
+         * of the node, the handle of its parent and the changes, and optionally the new values of
+         * its name, size and modification time when they changed.
+         *
+         * The default value is false.
+         *
+         * @param enable True to notify the changes of the nodes as compact lists
+         * @param batchSize Maximum number of nodes per call (at least 1)
+         * @param changedFields True to include the new values of the name, size and modification time
+         */
+        void setNodeChangeNotifications(bool enable, int batchSize = 10000, bool changedFields = false);
+
+        /**
+         * @brief Get a page of the children of a MegaNode
+         *
+         * This function returns the same children as MegaApi::getChildren, in the same order,
+         * but only the page of them that starts at the cursor. The sorted list of children is
+         * kept for the next pages, until the children of the folder change, so browsing a big
+         * folder only takes time in proportion to the size of each page.
+         *
+         * If the children change between pages, the next page starts after the last child of
+         * the previous one in the new order, or at the same position if that child is gone.
+         *
+         * If the parent node doesn't exist or it isn't a folder, the page is empty.
+         *
+         * You take the ownership of the returned value
+         *
+         * @param parent Parent node
+         * @param order Order of the children, as for MegaApi::getChildren
+         * @param cursor NULL for the first page, or the value of MegaChildrenPage::getNextCursor
+         * of the previous one
+         * @param pageSize Maximum number of children in the page
+         * @return Page of children
+         */
+        MegaChildrenPage* getChildrenPage(MegaNode *parent, int order, const char *cursor, int pageSize);
+
+        /**
+         * @brief Search nodes by name in the background, receiving the results in pages
+         *
+         * This function finds the same nodes as MegaApi::search(MegaNode*, const char*, MegaCancelToken*, bool, int),
+         * but on a thread of its own and in a copy of the nodes like the one described in
+         * MegaApi::setConcurrentNodeQueries (created with the first request, if that option
+         * is disabled), so neither the app nor the transfers and other requests wait for it.
+         * All the results come from the same version of the nodes, as notified so far by
+         * MegaGlobalListener::onNodesUpdate.
+         *
+         * Each page of results is received in MegaRequestListener::onRequestUpdate, with
+         * MegaApi::ORDER_NONE as soon as it is found. With other orders, once all the results
+         * have been found and sorted.
+         *
+         * The associated request type with this request is MegaRequest::TYPE_SEARCH
+         * Valid data in the MegaRequest object received on callbacks:
+         * - MegaRequest::getNodeHandle - Returns the handle of the node to search in
+         * - MegaRequest::getText - Returns the search string
+         * - MegaRequest::getFlag - Returns true if the search is recursive
+         * - MegaRequest::getParamType - Returns the order
+         * - MegaRequest::getNumber - Returns the maximum number of nodes per page
+         *
+         * Valid data in the MegaRequest object received in onRequestUpdate:
+         * - MegaRequest::getMegaNodeList - Returns the page of results
+         * - MegaRequest::getTransferredBytes - Returns the number of results received so far
+         * - MegaRequest::getTotalBytes - Returns the number of results, or -1 if still unknown
+         *
+         * Valid data in the MegaRequest object received in onRequestFinish when the error code
+         * is MegaError::API_OK:
+         * - MegaRequest::getTotalBytes - Returns the number of results
+         *
+         * On the onRequestFinish error, the error code associated to the MegaError can be:
+         * - MegaError::API_EARGS - The search string is missing, or the order or the page size
+         * are not supported
+         * - MegaError::API_ENOENT - The node doesn't exist
+         * - MegaError::API_EINCOMPLETE - The search was cancelled, or interrupted because the
+         * nodes were reloaded
+         *
+         * @param node Node to search in, recursively or not, or NULL to search the whole
+         * account as MegaApi::search(const char*, MegaCancelToken*, int)
+         * @param searchString Search string. The search is case-insensitive
+         * @param cancelToken MegaCancelToken to stop the search at any time, or NULL. It must
+         * be valid until the request finishes
+         * @param recursive True to search in the whole tree of the node, false to search in
+         * its children only
+         * @param order MegaApi::ORDER_NONE, MegaApi::ORDER_DEFAULT_ASC, MegaApi::ORDER_DEFAULT_DESC,
+         * MegaApi::ORDER_ALPHABETICAL_ASC or MegaApi::ORDER_ALPHABETICAL_DESC
+         * @param pageSize Maximum number of nodes in each page
+         * @param listener MegaRequestListener to track this request
+         */
+        void searchAsync(MegaNode *node, const char *searchString, MegaCancelToken *cancelToken, bool recursive = true, int order = ORDER_NONE, int pageSize = 1000, MegaRequestListener *listener = NULL);
+
+        /**
+         * @brief Get the children of a node in the background, receiving them in pages
+         *
+         * As MegaApi::searchAsync, for the children of a folder as MegaApi::getChildren
+         * returns them.
+         *
+         * The associated request type with this request is MegaRequest::TYPE_GET_CHILDREN
+         * Valid data in the MegaRequest object received on callbacks:
+         * - MegaRequest::getNodeHandle - Returns the handle of the parent node
+         * - MegaRequest::getParamType - Returns the order
+         * - MegaRequest::getNumber - Returns the maximum number of nodes per page
+         *
+         * Valid data in the MegaRequest object received in onRequestUpdate:
+         * - MegaRequest::getMegaNodeList - Returns the page of children
+         * - MegaRequest::getTransferredBytes - Returns the number of children received so far
+         * - MegaRequest::getTotalBytes - Returns the number of children, or -1 if still unknown
+         *
+         * Valid data in the MegaRequest object received in onRequestFinish when the error code
+         * is MegaError::API_OK:
+         * - MegaRequest::getTotalBytes - Returns the number of children
+         *
+         * On the onRequestFinish error, the error code associated to the MegaError can be:
+         * - MegaError::API_EARGS - The parent is missing, or the order or the page size are
+         * not supported
+         * - MegaError::API_ENOENT - The parent doesn't exist
+         * - MegaError::API_EINCOMPLETE - The listing was cancelled, or interrupted because the
+         * nodes were reloaded
+         *
+         * @param parent Parent node
+         * @param order Order of the children, as for MegaApi::searchAsync
+         * @param cancelToken MegaCancelToken to stop the listing at any time, or NULL. It must
+         * be valid until the request finishes
+         * @param pageSize Maximum number of nodes in each page
+         * @param listener MegaRequestListener to track this request
+         */
+        void getChildrenAsync(MegaNode *parent, int order = 1, MegaCancelToken *cancelToken = NULL, int pageSize = 1000, MegaRequestListener *listener = NULL);
+
+        /**
+         * @brief Write a snapshot of the whole node tree to a local file
+         *
+         * The file is meant to be memory-mapped by other processes and read without parsing.
+         * It holds the decrypted metadata of every node of the account at the time the request
+         * is processed, with the nodes sorted by handle, in fixed-width columns followed by the
+         * heap of their names. Numbers are in the byte order of the device, little-endian in all
+         * the supported platforms.
+         *
+         * The header, of 64 bytes:
+         * - 8 bytes: "MEGANTS" and a null character
+         * - uint32: version of the format, currently 1
+         * - uint32: size of the header, the offset of the first column
+         * - uint64: number of nodes, N
+         * - uint64: size of the heap of names
+         * - int64: time of the snapshot, in seconds since the epoch
+         * - 16 bytes: sequence number of the tree, as the server sends it, padded with null characters
+         * - 8 bytes: reserved
+         *
+         * Then the columns, each with N values, in this order and each padded with zeros to a
+         * multiple of 8 bytes:
+         * - uint64: handle of the node
+         * - uint64: handle of its parent, or INVALID_HANDLE for the root nodes
+         * - int64: size of the file, or -1 for folders
+         * - int64: modification time of the file, in its fingerprint
+         * - int64: creation time of the node
+         * - 4 x int32: CRC of the file, in its fingerprint
+         * - uint64: offset of the name in the heap
+         * - uint32: length of the name, in bytes
+         * - uint8: type of the node, as MegaNode::getType
+         * - uint8: flags, 0x01 if the fingerprint is valid, 0x02 if the node was decrypted
+         *
+         * And the heap, with the names in UTF-8, each followed by a null character. Nodes without
+         * a name, like the root nodes, have an empty one.
+         *
+         * The snapshot is written to a temporary file in the same folder, which replaces the one
+         * in localPath only when it is complete, so readers never see a partial file.
+         *
+         * The nodes are copied in memory when the request is processed, and the file is written
+         * by a worker thread, so other requests aren't blocked while it's being written.
+         *
+         * The associated request type with this request is MegaRequest::TYPE_EXPORT_NODE_TREE
+         * Valid data in the MegaRequest object received on callbacks:
+         * - MegaRequest::getFile - Returns the path of the file
+         *
+         * Valid data in the MegaRequest object received in onRequestFinish when the error code
+         * is MegaError::API_OK:
+         * - MegaRequest::getNumber - Returns the number of nodes in the snapshot
+         *
+         * On the onRequestFinish error, the error code associated to the MegaError can be:
+         * - MegaError::API_EARGS - The path is missing
+         * - MegaError::API_EACCESS - The nodes aren't loaded yet
+         * - MegaError::API_EWRITE - The file couldn't be written
+         *
+         * @param localPath Path of the file
+         * @param listener MegaRequestListener to track this request
+         */
+        void exportNodeTree(const char *localPath, MegaRequestListener *listener = NULL);
+
         /**
          * @brief Get all versions of a file
          * @param node Node to check
@@ -16499,6 +17391,56 @@ class MegaApi
          */
         bool areGfxFeaturesDisabled();
 
+        /**
+         * @brief Process action packets while they are being received
+         *
+         * By default, each response of the server-client channel is received completely
+         * before the changes that it contains are applied. When this feature is enabled,
+         * changes are applied (and MegaListener::onNodesUpdate is called) as soon as they
+         * arrive, which reduces latency and memory usage for big responses, i.e. after
+         * large remote changes.
+         *
+         * The local state is still committed only when each response has been completed.
+         * With syncs enabled, a response with node deletions is processed completely from
+         * the first deletion on, since a deletion may be part of a move.
+         *
+         * @param enable True to process action packets while they are being received
+         */
+        void setStreamingActionPackets(bool enable);
+
+        /**
+         * @brief Get statistics about the network requests completed by the SDK
+         *
+         * The statistics are collected since the creation of the MegaApi object or the
+         * last call to MegaApi::resetNetworkTelemetry. They are returned as a JSON object:
+         * - "since": Unix timestamp when the collection started
+         * - "channels": stats for each kind of traffic with at least one request:
+         *   "cs" (API commands), "sc" (server-client channel), "get" (downloads and
+         *   streaming), "put" (uploads), "fa" (file attributes) and "other"
+         * - "hosts": stats for each host. Hosts above 128 are aggregated under "*"
+         *
+         * The stats of a channel or host are: "requests", "failures", "retries" (requests
+         * sent again after a failed or aborted attempt), "connections"
+         * (requests that opened a new connection), "in" and "out" (bytes received and sent)
+         * and histograms for the phases of the requests: "dns", "connect", "tls" (only
+         * for new connections), "ttfb" (until the first byte of the response, only for
+         * successful requests) and "total". Each histogram has the number of samples "n"
+         * and, if there is any, "mean", "p50", "p90", "p99" and "max", in microseconds.
+         * Percentiles are approximate (rounded up to the next power of two).
+         *
+         * Statistics are only available with the cURL network layer.
+         *
+         * The caller takes the ownership of the returned value.
+         *
+         * @return JSON object with the statistics
+         */
+        char *getNetworkTelemetry();
+
+        /**
+         * @brief Discard the statistics returned by MegaApi::getNetworkTelemetry
+         */
+        void resetNetworkTelemetry();
+
         /**
          * @brief Change the API URL
          *
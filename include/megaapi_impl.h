@@ -30,6 +30,7 @@
 #include "megaapi.h"
 
 #include "mega/heartbeats.h"
+#include "mega/exclusionmatcher.h"
 
 #define CRON_USE_LOCAL_TIME 1
 #include "mega/mega_ccronexpr.h"
@@ -246,9 +247,12 @@ protected:
     std::set<MegaTransferPrivate*> subTransfers;
     int mIncompleteTransfers = { 0 };
     MegaErrorPrivate mLastError = { API_OK };
+
+    // cancels the queued and ongoing subtransfers, returns how many were in progress
+    long long cancelSubTransfers();
 };
 
-class MegaFolderUploadController : public MegaRequestListener, public MegaTransferListener, public MegaRecursiveOperation
+class MegaFolderUploadController : public MegaTransferListener, public MegaRecursiveOperation
 {
 public:
     MegaFolderUploadController(MegaApiImpl *megaApi, MegaTransferPrivate *transfer);
@@ -256,20 +260,68 @@ public:
     void cancel() override;
 
 protected:
-    void onFolderAvailable(MegaHandle handle);
+    void onFolderAvailable(MegaHandle handle, LocalPath localPath);
     void checkCompletion();
 
-    std::list<LocalPath> pendingFolders;
+    // adds the local folder and its subfolders to `newnodes`, parent-first
+    // (up to MAX_NEWNODES, the rest are created once their parent exists)
+    void addFolderTree(vector<NewNode>& newnodes, LocalPath& localPath, const string& name, handle parent);
+
+    // creates the folders in a single putnodes, and then uploads the contents
+    // of each of `localPaths`, the folders of `newnodes` without parent
+    void createFolders(MegaHandle parent, vector<NewNode>&& newnodes, vector<LocalPath>&& localPaths);
+
+    // putnodes in flight
+    int pendingFolders = 0;
+
+    // (expires with the controller, for the putnodes in flight)
+    shared_ptr<bool> mAlive = std::make_shared<bool>(true);
 
 public:
-    void onRequestFinish(MegaApi* api, MegaRequest *request, MegaError *e) override;
     void onTransferStart(MegaApi *api, MegaTransfer *transfer) override;
     void onTransferUpdate(MegaApi *api, MegaTransfer *transfer) override;
     void onTransferFinish(MegaApi* api, MegaTransfer *transfer, MegaError *e) override;
-    ~MegaFolderUploadController();
 };
 
 
+// files of MegaApi::startUploads and MegaApi::startDownloads, with a single local path
+// or handle when it's the same for all of them
+struct TransferBatch
+{
+    vector<string> localPaths;
+    vector<handle> handles;  // parents of uploads, nodes of downloads
+
+    size_t size() const { return std::max(localPaths.size(), handles.size()); }
+    const string& localPath(size_t i) const { return localPaths[localPaths.size() == 1 ? 0 : i]; }
+    handle nodeHandle(size_t i) const { return handles[handles.size() == 1 ? 0 : i]; }
+};
+
+// transfers the files of a TransferBatch as subtransfers of a single transfer, creating
+// up to MAX_PENDING of them at a time, and more as they finish
+class MegaTransferBatchController : public MegaTransferListener, public MegaRecursiveOperation
+{
+public:
+    MegaTransferBatchController(MegaApiImpl *megaApi, MegaTransferPrivate *transfer);
+    void start(MegaNode* node) override;
+    void cancel() override;
+
+    static const int MAX_PENDING = 1000;
+
+protected:
+    void startNext();
+    void checkCompletion();
+
+    shared_ptr<TransferBatch> mBatch;
+
+    // position of the next file to transfer
+    size_t mNext = 0;
+
+public:
+    void onTransferStart(MegaApi *api, MegaTransfer *transfer) override;
+    void onTransferUpdate(MegaApi *api, MegaTransfer *transfer) override;
+    void onTransferFinish(MegaApi* api, MegaTransfer *transfer, MegaError *e) override;
+};
+
 class MegaScheduledCopyController : public MegaScheduledCopy, public MegaRequestListener, public MegaTransferListener
 {
 public:
@@ -711,6 +763,7 @@ class MegaTransferPrivate : public MegaTransfer, public Cacheable
 		void setTag(int tag);
 		void setSpeed(long long speed);
         void setMeanSpeed(long long meanSpeed);
+        void setTimeToFirstByte(long long ttfb);
 		void setDeltaSize(long long deltaSize);
         void setUpdateTime(int64_t updateTime);
         void setPublicNode(MegaNode *publicNode, bool copyChildren = false);
@@ -750,6 +803,7 @@ class MegaTransferPrivate : public MegaTransfer, public Cacheable
         int getTag() const override;
         long long getSpeed() const override;
         long long getMeanSpeed() const override;
+        long long getTimeToFirstByte() const override;
         long long getDeltaSize() const override;
         int64_t getUpdateTime() const override;
         virtual MegaNode *getPublicNode() const;
@@ -787,6 +841,14 @@ class MegaTransferPrivate : public MegaTransfer, public Cacheable
         void setDoNotStopSubTransfers(bool doNotStopSubTransfers);
         bool getDoNotStopSubTransfers() const;
 
+        // files of a transfer started by MegaApi::startUploads or MegaApi::startDownloads
+        void setBatch(shared_ptr<TransferBatch> batch);
+        const shared_ptr<TransferBatch>& getBatch() const;
+
+        // subtransfers of those, only reported to their own listener
+        void setBatchItem(bool batchItem);
+        bool isBatchItem() const;
+
         bool isRecursive() const { return recursiveOperation.get() != nullptr; }
 
 protected:
@@ -806,6 +868,7 @@ protected:
             bool backupTransfer : 1;
             bool foreignOverquota : 1;
             bool forceNewUpload : 1;
+            bool batchItem : 1;
         };
 
         int64_t startTime;
@@ -815,6 +878,7 @@ protected:
         long long totalBytes;
         long long speed;
         long long meanSpeed;
+        long long timeToFirstByte;
         long long deltaSize;
         long long notificationNumber;
         MegaHandle nodeHandle;
@@ -837,6 +901,7 @@ protected:
         int folderTransferTag;
         const char* appData;
         unique_ptr<MegaRecursiveOperation> recursiveOperation;
+        shared_ptr<TransferBatch> mBatch;
         bool mTargetOverride;
 };
 
@@ -1088,6 +1153,20 @@ class MegaSyncListPrivate : public MegaSyncList
         int s;
 };
 
+class MegaSyncFileStateListPrivate : public MegaSyncFileStateList
+{
+    public:
+        MegaSyncFileStateListPrivate(const vector<pair<LocalPath, treestate_t>>& changes);
+        MegaSyncFileStateList *copy() const override;
+        int size() const override;
+        const string *getLocalPath(int i) const override;
+        int getState(int i) const override;
+
+    protected:
+        vector<string> paths;
+        vector<int> states;
+};
+
 #endif
 
 
@@ -1194,6 +1273,10 @@ class MegaRequestPrivate : public MegaRequest
         void setMegaBackgroundMediaUploadPtr(MegaBackgroundMediaUpload *);  // non-owned pointer
         void setMegaStringList(MegaStringList* stringList);
         void setMegaHandleList(const vector<handle> &handles);
+        MegaNodeList* getMegaNodeList() const override;
+        void setMegaNodeList(unique_ptr<MegaNodeList> nodeList);
+        MegaCancelToken *getCancelToken() const;
+        void setCancelToken(MegaCancelToken *cancelToken);  // non-owned pointer
 
         MegaScheduledCopyListener *getBackupListener() const;
         void setBackupListener(MegaScheduledCopyListener *value);
@@ -1247,6 +1330,8 @@ protected:
         MegaBackgroundMediaUpload* backgroundMediaUpload;  // non-owned pointer
         unique_ptr<MegaStringList> mStringList;
         unique_ptr<MegaHandleList> mHandleList;
+        unique_ptr<MegaNodeList> mNodeList;
+        MegaCancelToken* cancelToken;  // non-owned pointer
 
     private:
         unique_ptr<MegaBannerListPrivate> mBannerList;
@@ -1710,6 +1795,9 @@ class MegaNodeListPrivate : public MegaNodeList
         MegaNodeListPrivate();
         MegaNodeListPrivate(node_vector& v);
         MegaNodeListPrivate(Node** newlist, int size);
+
+        // takes the ownership of the nodes
+        MegaNodeListPrivate(vector<unique_ptr<MegaNode>>&& nodes);
         MegaNodeListPrivate(const MegaNodeListPrivate *nodeList, bool copyChildren = false);
         virtual ~MegaNodeListPrivate();
         MegaNodeList *copy() const override;
@@ -1741,6 +1829,339 @@ class MegaChildrenListsPrivate : public MegaChildrenLists
         unique_ptr<MegaNodeList> files;
 };
 
+// the properties of each node are kept in a fixed size entry, and all the
+// names in a single buffer, so that the list takes a few allocations
+class MegaNodeInfoListPrivate : public MegaNodeInfoList
+{
+    public:
+        MegaNodeInfoListPrivate(Node** nodes, size_t count);
+        MegaNodeInfoList *copy() const override;
+        int size() const override;
+        MegaHandle getHandle(int i) const override;
+        MegaHandle getParentHandle(int i) const override;
+        int getType(int i) const override;
+        const char *getName(int i) const override;
+        int64_t getSize(int i) const override;
+        int64_t getCreationTime(int i) const override;
+        int64_t getModificationTime(int i) const override;
+        int getLabel(int i) const override;
+        bool isFavourite(int i) const override;
+        bool hasThumbnail(int i) const override;
+        bool hasPreview(int i) const override;
+
+    protected:
+        struct Entry
+        {
+            handle nodehandle;
+            handle parenthandle;
+            m_off_t size;
+            m_time_t ctime;
+            m_time_t mtime;
+
+            // offset of the name in `names`
+            size_t name;
+
+            signed char type;
+            signed char label;
+            bool favourite;
+            bool thumbnail;
+            bool preview;
+        };
+
+        const Entry* entry(int i) const;
+
+        vector<Entry> entries;
+        string names;
+};
+
+// as MegaNodeInfoListPrivate, with the changed properties only
+class MegaNodeChangeListPrivate : public MegaNodeChangeList
+{
+    public:
+        MegaNodeChangeListPrivate(Node** nodes, size_t count, bool changedFields, bool last);
+        MegaNodeChangeList *copy() const override;
+        int size() const override;
+        MegaHandle getHandle(int i) const override;
+        MegaHandle getParentHandle(int i) const override;
+        int getChanges(int i) const override;
+        int getType(int i) const override;
+        const char *getName(int i) const override;
+        int64_t getSize(int i) const override;
+        int64_t getModificationTime(int i) const override;
+        bool isLast() const override;
+
+    protected:
+        struct Entry
+        {
+            handle nodehandle;
+            handle parenthandle;
+            m_off_t size;
+            m_time_t mtime;
+
+            // offset of the name in `names`, or string::npos if not included
+            size_t name;
+
+            int changes;
+            signed char type;
+        };
+
+        const Entry* entry(int i) const;
+
+        vector<Entry> entries;
+        string names;
+        bool last;
+};
+
+// Natural ordering of names: case insensitive, with numbers compared by value and before
+// other characters. Returns 0 if i==j, <0 if i goes first, >0 if j goes first.
+int naturalsorting_compare(const char *i, const char *j);
+
+// A key per name that orders as naturalsorting_compare() when compared byte by byte,
+// so that big sorts by name do the parsing of each name only once
+string naturalsorting_key(const char *name);
+
+// Copies of the nodes of the account, updated by the SDK thread with each batch of
+// changes notified to the app, so that other threads can query them without waiting
+// for sdkMutex (held by the SDK thread while it processes transfers, action packets...).
+// Readers only wait while a batch is applied, as the copies are made beforehand.
+// The SDK thread doesn't wait for readers either: while a long traversal is running,
+// the batches are kept pending until it ends (see current()), and the last reader
+// applies them.
+class MegaNodeReplica
+{
+    public:
+        // (SDK thread, with sdkMutex locked)
+        void rebuild(MegaClient& client);
+        void update(Node** nodes, int count);
+        void clear();
+
+        // false while there are batches pending
+        bool current() const;
+
+        // (any thread) applies the pending batches, waiting for the readers
+        void applyPending();
+
+        // (any thread) as the MegaApi methods, for the tree as of the last update;
+        // getChildren() returns NULL for the orders that it doesn't support
+        MegaNode* getNodeByHandle(handle h);
+        MegaNode* getParentNode(handle h);
+        int getNumChildren(handle h, int type);
+        MegaNodeList* getChildren(handle h, int order);
+
+        // (any thread) calls `f` with the nodes below `h` (or all of them for UNDEF), from
+        // the same version of the tree, until it returns false. False if `h` is unknown.
+        bool forEachNode(handle h, bool recursive, const std::function<bool(MegaNode&)>& f);
+
+    protected:
+        struct Entry
+        {
+            // (NULL if only the children of the node have been added yet)
+            unique_ptr<MegaNode> node;
+            set<handle> children;
+        };
+
+        struct Batch
+        {
+            vector<handle> removed;
+            vector<unique_ptr<MegaNode>> updated;
+        };
+
+        // shared lock of the readers, which apply the pending batches once there are no others
+        class ReadLock
+        {
+            public:
+                ReadLock(MegaNodeReplica& replica);
+                ~ReadLock();
+
+            private:
+                MegaNodeReplica& mReplica;
+        };
+
+        // applies the pending batches, unless there are readers
+        void tryApplyPending();
+        void applyAll();
+
+        void apply(Batch& batch);
+        void add(unique_ptr<MegaNode> node);
+        void remove(handle h);
+        MegaNode* find(handle h) const;
+
+        SharedMutex mMutex;
+        std::unordered_map<handle, Entry> mEntries;
+
+        // batches not applied yet, in order
+        std::mutex mPendingMutex;
+        std::deque<Batch> mPending;
+        std::atomic<bool> mCurrent{ true };
+};
+
+// Runs the queries of MegaApi::searchAsync and MegaApi::getChildrenAsync on a thread of
+// its own, against a MegaNodeReplica, so that neither sdkMutex nor the SDK thread wait
+// for the traversals. The pages of results are handed back to the SDK thread, which
+// notifies them.
+class NodeQueryWorker
+{
+    public:
+        struct Query
+        {
+            // (not accessed by the worker)
+            MegaRequestPrivate* request = nullptr;
+
+            // the children of `node` only, or the nodes below it (UNDEF: all) whose name
+            // contains `search`
+            bool search = false;
+            handle node = UNDEF;
+            string name;
+            bool recursive = true;
+            int order = MegaApi::ORDER_NONE;
+            size_t pageSize = 0;
+            MegaCancelToken* cancelToken = nullptr;
+        };
+
+        struct Result
+        {
+            MegaRequestPrivate* request = nullptr;
+            unique_ptr<MegaNodeList> page;  // (NULL in the last one)
+            bool finished = false;
+            error e = API_OK;
+            long long delivered = 0;        // nodes in this and the previous pages
+            long long total = -1;           // nodes in all the pages, when known
+        };
+
+        // `notify` is called from the worker when there are results to pop()
+        NodeQueryWorker(MegaNodeReplica& replica, std::function<void()> notify);
+        ~NodeQueryWorker();
+
+        // (SDK thread)
+        void push(Query query);
+        bool pop(Result& result);
+
+        // (SDK thread) drops the queued queries and their results, stopping the one running
+        void discard();
+
+        // (SDK thread) stops the running query, which finishes with API_EINCOMPLETE, so that
+        // the replica can be cleared or rebuilt without waiting for its traversal
+        void interrupt();
+
+    protected:
+        void loop();
+        void run(const Query& query, uint64_t generation);
+        bool deliver(Result result, uint64_t generation);
+
+        MegaNodeReplica& mReplica;
+        std::function<void()> mNotify;
+
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::deque<pair<Query, uint64_t>> mQueries;
+        std::deque<Result> mResults;
+        bool mRunning = false;
+        bool mExit = false;
+
+        // incremented by discard(), to tell the running query and its results apart
+        std::atomic<uint64_t> mGeneration{ 0 };
+
+        // set by interrupt() while a query runs, until it ends
+        std::atomic<bool> mInterrupted{ false };
+
+        std::thread mThread;
+};
+
+class MegaChildrenPagePrivate : public MegaChildrenPage
+{
+    public:
+        MegaChildrenPagePrivate();
+        MegaChildrenPagePrivate(unique_ptr<MegaNodeList> nodes, string nextCursor, int totalSize);
+        MegaChildrenPage *copy() const override;
+        MegaNodeList *getNodes() const override;
+        const char *getNextCursor() const override;
+        int getTotalSize() const override;
+
+    protected:
+        unique_ptr<MegaNodeList> nodes;
+        string nextCursor;
+        int totalSize;
+};
+
+// Sorted children of the folders recently paged through with MegaApi::getChildrenPage,
+// dropped when the children change (SDK thread, with sdkMutex locked)
+class SortedChildrenCache
+{
+    public:
+        // the children of `parent`, sorted as for MegaApi::getChildren
+        node_vector& get(MegaClient& client, Node* parent, int order);
+
+        // drops the lists affected by the changes in `nodes` (all of them if NULL),
+        // before the removed ones are deleted
+        void invalidate(Node** nodes, int count);
+        void clear();
+
+        // position of the first child of the page that `cursor` points to
+        static size_t resume(const node_vector& children, const char* cursor);
+        static string cursor(const node_vector& children, size_t position);
+
+        static const size_t MAX_FOLDERS = 8;
+
+    protected:
+        struct Entry
+        {
+            handle parent;
+            int order;
+            node_vector children;
+
+            // handles of the children, in handle order, to find the lists a node is in
+            vector<handle> members;
+        };
+
+        // most recently used first
+        std::list<Entry> mEntries;
+};
+
+// Columnar file with the metadata of all the nodes, as described in MegaApi::exportNodeTree.
+// The columns are copied from MegaClient::nodes with sdkMutex locked, and written without it.
+class NodeTreeSnapshot
+{
+    public:
+        static const char MAGIC[8];
+        static const uint32_t VERSION = 1;
+        static const uint32_t HEADER_SIZE = 64;
+
+        // offsets of the columns for `count` nodes, and of the heap of names after them
+        struct Layout
+        {
+            explicit Layout(uint64_t count);
+
+            uint64_t handles, parents, sizes, mtimes, ctimes, crcs;
+            uint64_t nameOffsets, nameLengths, types, flags;
+            uint64_t heap;
+        };
+
+        // the content of the file, one entry per node in handle order
+        struct Columns
+        {
+            vector<uint64_t> handles, parents, nameOffsets;
+            vector<int64_t> sizes, mtimes, ctimes;
+            vector<std::array<int32_t, 4>> crcs;
+            vector<uint32_t> nameLengths;
+            vector<uint8_t> types, flags;
+            string heap;
+            string scsn;
+        };
+
+        // single pass over the nodes (SDK thread, with sdkMutex locked)
+        static void collect(const MegaClient& client, Columns& columns);
+
+        // writes a temporary file next to `path` and renames it when complete (any thread)
+        static error write(FileSystemAccess& fsaccess, const Columns& columns, const LocalPath& path);
+
+        // both of the above
+        static error write(MegaClient& client, const LocalPath& path, uint64_t* count = nullptr);
+
+    protected:
+        // rows written at once to each column
+        static const size_t CHUNK = 8192;
+};
+
 class MegaUserListPrivate : public MegaUserList
 {
 	public:
@@ -2049,12 +2470,18 @@ private:
 };
 
 //Thread safe request queue
+//Requests are pushed without locks and moved in batches to the deque the SDK thread pops from,
+//which is guarded by the mutex. Producers only take it when the lock-free part is full.
 class RequestQueue
 {
     protected:
+        BoundedMpscQueue<MegaRequestPrivate *> pushed;
         std::deque<MegaRequestPrivate *> requests;
         std::mutex mutex;
 
+        // moves the pushed requests to the deque, with the mutex locked
+        void drain();
+
     public:
         RequestQueue();
         void push(MegaRequestPrivate *request);
@@ -2066,17 +2493,21 @@ class RequestQueue
 };
 
 
-//Thread safe transfer queue
+//Thread safe transfer queue, lock-free for producers like RequestQueue
 class TransferQueue
 {
     protected:
+        BoundedMpscQueue<MegaTransferPrivate *> pushed;
         std::deque<MegaTransferPrivate *> transfers;
-        std::mutex mutex;
-        int lastPushedTransferTag = 0;
+        std::recursive_mutex mutex;
+
+        // moves the pushed transfers to the deque, with the mutex locked
+        void drain();
 
     public:
         TransferQueue();
         void push(MegaTransferPrivate *transfer);
+        void push(std::vector<MegaTransferPrivate *>& transfers);
         void push_front(MegaTransferPrivate *transfer);
         MegaTransferPrivate * pop();
 
@@ -2360,6 +2791,13 @@ class MegaApiImpl : public MegaApp
         void startUploadForSupport(const char *localPath, bool isSourceTemporary, FileSystemType fsType, MegaTransferListener *listener=NULL);
         void startDownload(MegaNode* node, const char* localPath, MegaTransferListener *listener = NULL);
         void startDownload(bool startFirst, MegaNode *node, const char* target, int folderTransferTag, const char *appData, MegaTransferListener *listener);
+        void startUploads(MegaStringList *localPaths, MegaHandleList *parents, MegaTransferListener *listener = NULL);
+        void startDownloads(MegaHandleList *nodes, MegaStringList *localPaths, MegaTransferListener *listener = NULL);
+
+        // creates the transfers without queueing them, for startTransfers
+        MegaTransferPrivate* createUploadTransfer(bool startFirst, const char* localPath, MegaHandle parentHandle, const char* fileName, const char* targetUser, int64_t mtime, int folderTransferTag, bool isBackup, const char *appData, bool isSourceFileTemporary, bool forceNewUpload, FileSystemType fsType, MegaTransferListener *listener);
+        MegaTransferPrivate* createDownloadTransfer(bool startFirst, MegaNode *node, const char* target, int folderTransferTag, const char *appData, MegaTransferListener *listener);
+        void startTransfers(vector<MegaTransferPrivate*>& transfers);
         void startStreaming(MegaNode* node, m_off_t startPos, m_off_t size, MegaTransferListener *listener);
         void setStreamingMinimumRate(int bytesPerSecond);
         void retryTransfer(MegaTransfer *transfer, MegaTransferListener *listener = NULL);
@@ -2373,13 +2811,17 @@ class MegaApiImpl : public MegaApp
         void moveTransferToFirst(int transferTag, MegaRequestListener *listener = NULL);
         void moveTransferToLast(int transferTag, MegaRequestListener *listener = NULL);
         void moveTransferBefore(int transferTag, int prevTransferTag, MegaRequestListener *listener = NULL);
+        void setTransferBandwidthClass(int transferTag, int bandwidthClass, int weight, MegaRequestListener *listener = NULL);
         bool areTransfersPaused(int direction);
         void setUploadLimit(int bpslimit);
         void setMaxConnections(int direction, int connections, MegaRequestListener* listener = NULL);
+        void setTransferUpdatePolicy(int minIntervalMs, long long minBytes, bool batched);
+        char *getTransferUpdateStats();
         void setDownloadMethod(int method);
         void setUploadMethod(int method);
         bool setMaxDownloadSpeed(m_off_t bpslimit);
         bool setMaxUploadSpeed(m_off_t bpslimit);
+        bool setBandwidthClassLimits(int direction, int bandwidthClass, m_off_t minBps, m_off_t maxBps);
         int getMaxDownloadSpeed();
         int getMaxUploadSpeed();
         int getCurrentDownloadSpeed();
@@ -2426,10 +2868,15 @@ class MegaApiImpl : public MegaApp
         bool moveToLocalDebris(const char *path);
         string getLocalPath(MegaNode *node);
         long long getNumLocalNodes();
+        char *getSyncFingerprintCacheStats();
+        void setSyncStateNotificationsFoldersOnly(bool foldersOnly);
+        void setSyncStateNotificationsBatched(bool batched);
+        char *getSyncStateNotificationStats();
         bool isSyncable(const char *path, long long size);
         bool isInsideSync(MegaNode *node);
         bool is_syncable(Sync*, const char*, const LocalPath&);
         bool is_syncable(long long size);
+        void updateSyncExclusions();
         int isNodeSyncable(MegaNode *megaNode);
         bool isIndexing();
         bool isSyncing();
@@ -2468,6 +2915,13 @@ class MegaApiImpl : public MegaApp
         int getNumChildFolders(MegaNode* parent);
         MegaNodeList* getChildren(MegaNode *parent, int order);
         MegaNodeList* getChildren(MegaNodeList *parentNodes, int order);
+        MegaNodeInfoList* getChildrenInfo(MegaNode *parent, int order);
+        void setConcurrentNodeQueries(bool enable);
+        void setNodeChangeNotifications(bool enable, int batchSize, bool changedFields);
+        MegaChildrenPage* getChildrenPage(MegaNode *parent, int order, const char *cursor, int pageSize);
+        void searchAsync(MegaNode *node, const char *searchString, MegaCancelToken *cancelToken, bool recursive, int order, int pageSize, MegaRequestListener *listener = NULL);
+        void exportNodeTree(const char *localPath, MegaRequestListener *listener = NULL);
+        void getChildrenAsync(MegaNode *parent, int order, MegaCancelToken *cancelToken, int pageSize, MegaRequestListener *listener = NULL);
         MegaNodeList* getVersions(MegaNode *node);
         int getNumVersions(MegaNode *node);
         bool hasVersions(MegaNode *node);
@@ -2578,6 +3032,9 @@ class MegaApiImpl : public MegaApp
 
         void disableGfxFeatures(bool disable);
         bool areGfxFeaturesDisabled();
+        void setStreamingActionPackets(bool enable);
+        char *getNetworkTelemetry();
+        void resetNetworkTelemetry();
 
         void changeApiUrl(const char *apiURL, bool disablepkp = false);
 
@@ -2798,6 +3255,7 @@ class MegaApiImpl : public MegaApp
         void fireOnTransferStart(MegaTransferPrivate *transfer);
         void fireOnTransferFinish(MegaTransferPrivate *transfer, unique_ptr<MegaErrorPrivate> e, DBTableTransactionCommitter& committer);
         void fireOnTransferUpdate(MegaTransferPrivate *transfer);
+        void fireOnTransfersUpdate();
         void fireOnTransferTemporaryError(MegaTransferPrivate *transfer, unique_ptr<MegaErrorPrivate> e);
         map<int, MegaTransferPrivate *> transferMap;
         map<int, MegaTransferPrivate *> folderTransferMap; //transferMap includes these, added for speedup
@@ -2839,6 +3297,7 @@ protected:
         void fireOnUsersUpdate(MegaUserList *users);
         void fireOnUserAlertsUpdate(MegaUserAlertList *alerts);
         void fireOnNodesUpdate(MegaNodeList *nodes);
+        void fireOnNodeChanges(MegaNodeChangeList *changes);
         void fireOnAccountUpdate();
         void fireOnContactRequestsUpdate(MegaContactRequestList *requests);
         void fireOnReloadNeeded();
@@ -2852,14 +3311,24 @@ protected:
         void fireOnSyncEnabled(MegaSyncPrivate *sync);
         void fireonSyncDeleted(MegaSyncPrivate *sync);
         void fireOnFileSyncStateChanged(MegaSyncPrivate *sync, string *localPath, int newState);
+        void fireOnFileSyncStatesChanged(MegaSyncPrivate *sync, MegaSyncFileStateList *states);
 #endif
 
 #ifdef ENABLE_CHAT
         void fireOnChatsUpdate(MegaTextChatList *chats);
 #endif
 
+        // progress of a transfer reported to the app, see MegaApi::setTransferUpdatePolicy
+        struct TransferProgress
+        {
+            m_off_t transferredBytes;
+            m_off_t speed;
+            m_off_t meanSpeed;
+        };
+
         void processTransferPrepare(Transfer *t, MegaTransferPrivate *transfer);
         void processTransferUpdate(Transfer *tr, MegaTransferPrivate *transfer);
+        void processTransferProgress(MegaTransferPrivate *transfer, direction_t type, const TransferProgress& progress);
         void processTransferComplete(Transfer *tr, MegaTransferPrivate *transfer);
         void processTransferFailed(Transfer *tr, MegaTransferPrivate *transfer, const Error &e, dstime timeleft);
         void processTransferRemoved(Transfer *tr, MegaTransferPrivate *transfer, const Error &e);
@@ -2912,6 +3381,21 @@ protected:
         long long totalDownloadBytes;
         long long totalUploadBytes;
         long long notificationNumber;
+
+        // progress updates of transfers, see MegaApi::setTransferUpdatePolicy
+        dstime mTransferUpdateInterval = 0;
+        m_off_t mTransferUpdateBytes = 0;
+        // progress held back by a policy with bytes only is reported after this time anyway (ds)
+        static const dstime TRANSFER_UPDATE_FALLBACK_DS = 10;
+        dstime transferUpdateTimeout() const;
+        bool mTransferUpdatesBatched = false;
+        map<int, TransferProgress> mSuppressedTransferUpdates;  // latest progress not reported yet, by tag
+        set<int> mBatchedTransferUpdates;       // tags of transfers for the next onTransfersUpdate
+        uint64_t mTransferUpdates = 0;
+        uint64_t mTransferUpdatesSuppressed = 0;
+        uint64_t mTransferUpdatesNotified = 0;
+        uint64_t mTransferUpdateBatches = 0;
+
         set<MegaRequestListener *> requestListeners;
         set<MegaTransferListener *> transferListeners;
         set<MegaScheduledCopyListener *> backupListeners;
@@ -2926,11 +3410,37 @@ protected:
         retryreason_t waitingRequest;
         vector<string> excludedNames;
         vector<string> excludedPaths;
+        ExclusionMatcher syncExclusions;    // compiled from excludedNames and excludedPaths
         long long syncLowerSizeLimit;
         long long syncUpperSizeLimit;
         std::recursive_timed_mutex sdkMutex;
         using SdkMutexGuard = std::unique_lock<std::recursive_timed_mutex>;   // (equivalent to typedef)
         std::atomic<bool> syncPathStateLockTimeout{ false };
+
+        // node queries served without sdkMutex, see MegaApi::setConcurrentNodeQueries
+        MegaNodeReplica mNodeReplica;
+        std::atomic<bool> mNodeReplicaEnabled{ false };
+        std::atomic<std::thread::id> mSdkThreadId;
+        bool useNodeReplica() const;
+
+        // runs MegaApi::searchAsync and getChildrenAsync on the replica, once requested
+        unique_ptr<NodeQueryWorker> mNodeQueries;
+
+        // snapshots of MegaApi::exportNodeTree written by the worker threads of the client
+        struct NodeTreeSnapshotResult
+        {
+            int tag;
+            error e;
+            uint64_t count;
+        };
+        shared_ptr<ThreadSafeDeque<NodeTreeSnapshotResult>> mNodeTreeSnapshots = std::make_shared<ThreadSafeDeque<NodeTreeSnapshotResult>>();
+
+        // see MegaApi::setNodeChangeNotifications
+        bool mNodeChangeNotifications = false;
+        size_t mNodeChangeBatchSize = 10000;
+        bool mNodeChangeFields = false;
+
+        SortedChildrenCache mSortedChildren;
         MegaTransferPrivate *currentTransfer;
         MegaRequestPrivate *activeRequest;
         MegaTransferPrivate *activeTransfer;
@@ -3182,8 +3692,11 @@ protected:
 
         void syncupdate_scanning(bool scanning) override;
         void syncupdate_treestate(const SyncConfig &, const LocalPath&, treestate_t, nodetype_t) override;
+        void syncupdate_treestates(const SyncConfig&, const vector<pair<LocalPath, treestate_t>>&) override;
         bool sync_syncable(Sync *, const char*, LocalPath&, Node *) override;
         bool sync_syncable(Sync *, const char*, LocalPath&) override;
+        bool sync_syncable(Sync *, const char*, LocalPath&, nodetype_t, m_off_t) override;
+        bool sync_syncable_needs_size() override;
 
         void syncupdate_local_lockretry(bool) override;
 
@@ -3231,7 +3744,12 @@ protected:
 
         void sendPendingScRequest();
         void sendPendingRequests();
+        void notifyNodeQueryResults();
+        void notifyNodeTreeSnapshots();
+        void waitForTransferUpdates();
+        void flushTransferUpdates();
         unsigned sendPendingTransfers();
+        error startTransferBatch(MegaTransferPrivate *transfer, int nextTag);
         void updateBackups();
 
         //Internal
@@ -0,0 +1,366 @@
+/**
+ * @file bandwidthscheduler.cpp
+ * @brief Hierarchical token-bucket scheduler for transfer bandwidth
+ *
+ * (c) 2013-2014 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/bandwidthscheduler.h"
+#include "mega/logging.h"
+
+namespace mega {
+
+const dstime BandwidthScheduler::BURST_DS;
+const dstime BandwidthScheduler::MAX_WAIT_DS;
+const m_off_t BandwidthScheduler::MIN_REQUEST_SIZE;
+
+void BandwidthScheduler::TokenBucket::refill(dstime now)
+{
+    if (rate && now > last)
+    {
+        level = std::min<m_off_t>(level + rate * (now - last) / 10, rate * BURST_DS / 10);
+    }
+    last = now;
+}
+
+void BandwidthScheduler::TokenBucket::charge(m_off_t bytes)
+{
+    if (rate)
+    {
+        level -= bytes;
+    }
+}
+
+BandwidthScheduler::BandwidthScheduler()
+{
+}
+
+void BandwidthScheduler::setclasslimits(direction_t d, transferclass_t c, m_off_t minbps, m_off_t maxbps)
+{
+    if ((d != GET && d != PUT) || c < 0 || c >= NUM_TRANSFERCLASSES)
+    {
+        return;
+    }
+
+    ClassState& cs = mDirections[d].classes[c];
+    cs.assured.rate = std::max<m_off_t>(minbps, 0);
+    cs.ceil.rate = std::max<m_off_t>(maxbps, 0);
+    if (cs.ceil.rate && cs.assured.rate > cs.ceil.rate)
+    {
+        cs.assured.rate = cs.ceil.rate;
+    }
+    cs.assured.level = std::min<m_off_t>(cs.assured.level, 0);
+    cs.ceil.level = std::min<m_off_t>(cs.ceil.level, 0);
+
+    LOG_debug << "Bandwidth class " << c << " (" << d << ") limits: min " << cs.assured.rate << " max " << cs.ceil.rate;
+}
+
+void BandwidthScheduler::getclasslimits(direction_t d, transferclass_t c, m_off_t& minbps, m_off_t& maxbps) const
+{
+    minbps = maxbps = 0;
+    if ((d == GET || d == PUT) && c >= 0 && c < NUM_TRANSFERCLASSES)
+    {
+        minbps = mDirections[d].classes[c].assured.rate;
+        maxbps = mDirections[d].classes[c].ceil.rate;
+    }
+}
+
+void BandwidthScheduler::settotallimit(direction_t d, m_off_t bps)
+{
+    if (d != GET && d != PUT)
+    {
+        return;
+    }
+
+    TokenBucket& root = mDirections[d].root;
+    root.rate = std::max<m_off_t>(bps, 0);
+    root.level = std::min<m_off_t>(root.level, 0);
+
+    LOG_debug << "Bandwidth total limit (" << d << "): " << root.rate;
+}
+
+m_off_t BandwidthScheduler::gettotallimit(direction_t d) const
+{
+    return (d == GET || d == PUT) ? mDirections[d].root.rate : 0;
+}
+
+bool BandwidthScheduler::limited(direction_t d) const
+{
+    if (d != GET && d != PUT)
+    {
+        return false;
+    }
+
+    const DirectionState& ds = mDirections[d];
+    if (ds.root.rate)
+    {
+        return true;
+    }
+
+    for (const ClassState& cs : ds.classes)
+    {
+        if (cs.ceil.rate)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BandwidthScheduler::activate(direction_t d, BandwidthFlow& flow)
+{
+    if ((d != GET && d != PUT) || flow.active)
+    {
+        return;
+    }
+
+    ClassState& cs = mDirections[d].classes[flow.bwclass];
+    cs.totalweight += flow.weight;
+    cs.flows++;
+    flow.tokens = 0;
+    flow.lastrefill = 0;
+    flow.active = true;
+}
+
+void BandwidthScheduler::deactivate(direction_t d, BandwidthFlow& flow)
+{
+    if ((d != GET && d != PUT) || !flow.active)
+    {
+        return;
+    }
+
+    ClassState& cs = mDirections[d].classes[flow.bwclass];
+    assert(cs.totalweight >= flow.weight && cs.flows);
+    cs.totalweight -= flow.weight;
+    cs.flows--;
+    if (!cs.flows)
+    {
+        cs.starved = false;
+    }
+    flow.active = false;
+}
+
+void BandwidthScheduler::reclassify(direction_t d, BandwidthFlow& flow, transferclass_t c, unsigned weight)
+{
+    bool wasactive = flow.active;
+    if (wasactive)
+    {
+        deactivate(d, flow);
+    }
+
+    flow.bwclass = c;
+    flow.weight = std::max(weight, 1u);
+
+    if (wasactive)
+    {
+        activate(d, flow);
+    }
+}
+
+int BandwidthScheduler::priorityof(transferclass_t c)
+{
+    switch (c)
+    {
+        case TRANSFERCLASS_INTERACTIVE: return 0;
+        case TRANSFERCLASS_STREAMING:   return 1;
+        case TRANSFERCLASS_SYNC:        return 2;
+        case TRANSFERCLASS_BACKUP:      return 3;
+        default:                        return NUM_TRANSFERCLASSES;
+    }
+}
+
+m_off_t BandwidthScheduler::classcap(const DirectionState& ds, transferclass_t c) const
+{
+    const ClassState& cs = ds.classes[c];
+    if (cs.ceil.rate && ds.root.rate)
+    {
+        return std::min(cs.ceil.rate, ds.root.rate);
+    }
+    return cs.ceil.rate ? cs.ceil.rate : ds.root.rate;
+}
+
+m_off_t BandwidthScheduler::flowshare(const DirectionState& ds, const BandwidthFlow& flow) const
+{
+    const ClassState& cs = ds.classes[flow.bwclass];
+    m_off_t cap = classcap(ds, flow.bwclass);
+    if (!cap || !flow.active || cs.totalweight <= flow.weight)
+    {
+        // uncapped, or the only flow in its class: the class/root buckets are enough
+        return 0;
+    }
+    return std::max<m_off_t>(cap * flow.weight / cs.totalweight, 1);
+}
+
+bool BandwidthScheduler::higherpriorityblocked(const DirectionState& ds, transferclass_t c, dstime now) const
+{
+    for (int i = 0; i < NUM_TRANSFERCLASSES; i++)
+    {
+        const ClassState& other = ds.classes[i];
+        if (priorityof(transferclass_t(i)) < priorityof(c)
+                && other.flows && other.starved
+                && now - other.laststarved <= 2 * MAX_WAIT_DS)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BandwidthScheduler::admit(direction_t d, BandwidthFlow& flow, m_off_t bytes, dstime now)
+{
+    if (d != GET && d != PUT)
+    {
+        return true;
+    }
+
+    if (!limited(d))
+    {
+        admitted[d]++;
+        return true;
+    }
+
+    DirectionState& ds = mDirections[d];
+    ClassState& cs = ds.classes[flow.bwclass];
+
+    ds.root.refill(now);
+    cs.assured.refill(now);
+    cs.ceil.refill(now);
+
+    // weighted fair share within the class
+    m_off_t share = flowshare(ds, flow);
+    if (share)
+    {
+        if (now > flow.lastrefill)
+        {
+            flow.tokens = std::min<m_off_t>(flow.tokens + share * (now - flow.lastrefill) / 10, share * BURST_DS / 10);
+        }
+        flow.lastrefill = now;
+
+        if (flow.tokens < 0)
+        {
+            delayed[d]++;
+            return false;
+        }
+    }
+
+    // class ceiling
+    if (cs.ceil.rate && cs.ceil.level < 0)
+    {
+        delayed[d]++;
+        return false;
+    }
+
+    // within its guaranteed minimum a class does not depend on the root bucket
+    bool guaranteed = cs.assured.rate && cs.assured.level >= 0;
+    if (!guaranteed)
+    {
+        if (ds.root.rate && ds.root.level < 0)
+        {
+            cs.starved = true;
+            cs.laststarved = now;
+            delayed[d]++;
+            return false;
+        }
+
+        // spare bandwidth goes to higher priority classes first
+        if (higherpriorityblocked(ds, flow.bwclass, now))
+        {
+            delayed[d]++;
+            return false;
+        }
+    }
+
+    cs.starved = false;
+
+    if (share)
+    {
+        flow.tokens -= bytes;
+    }
+    cs.ceil.charge(bytes);
+    cs.assured.charge(bytes);
+    ds.root.charge(bytes);
+
+    admitted[d]++;
+    return true;
+}
+
+void BandwidthScheduler::consume(direction_t d, BandwidthFlow& flow, m_off_t bytes, dstime now)
+{
+    if ((d != GET && d != PUT) || !limited(d))
+    {
+        return;
+    }
+
+    DirectionState& ds = mDirections[d];
+    ClassState& cs = ds.classes[flow.bwclass];
+
+    ds.root.refill(now);
+    cs.assured.refill(now);
+    cs.ceil.refill(now);
+
+    cs.ceil.charge(bytes);
+    cs.assured.charge(bytes);
+    ds.root.charge(bytes);
+}
+
+dstime BandwidthScheduler::retryin(direction_t d, const BandwidthFlow& flow) const
+{
+    if (d != GET && d != PUT)
+    {
+        return 0;
+    }
+
+    const DirectionState& ds = mDirections[d];
+    const ClassState& cs = ds.classes[flow.bwclass];
+
+    // time for the most indebted bucket to get back to zero
+    m_off_t wait = 1;
+    m_off_t share = flowshare(ds, flow);
+    if (share && flow.tokens < 0)
+    {
+        wait = std::max<m_off_t>(wait, -flow.tokens * 10 / share);
+    }
+    if (cs.ceil.rate && cs.ceil.level < 0)
+    {
+        wait = std::max<m_off_t>(wait, -cs.ceil.level * 10 / cs.ceil.rate);
+    }
+    if (ds.root.rate && ds.root.level < 0)
+    {
+        wait = std::max<m_off_t>(wait, -ds.root.level * 10 / ds.root.rate);
+    }
+    return dstime(std::min<m_off_t>(wait, MAX_WAIT_DS));
+}
+
+m_off_t BandwidthScheduler::requestsizelimit(direction_t d, const BandwidthFlow& flow) const
+{
+    if (!limited(d))
+    {
+        return 0;
+    }
+
+    const DirectionState& ds = mDirections[d];
+    m_off_t rate = flowshare(ds, flow);
+    if (!rate)
+    {
+        rate = classcap(ds, flow.bwclass);
+    }
+
+    // about two seconds of data per request, so admissions stay smooth
+    return rate ? std::max<m_off_t>(rate * 2, MIN_REQUEST_SIZE) : 0;
+}
+
+} // namespace
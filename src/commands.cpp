@@ -36,6 +36,7 @@ namespace mega {
 HttpReqCommandPutFA::HttpReqCommandPutFA(NodeOrUploadHandle cth, fatype ctype, bool usehttps, int ctag, std::unique_ptr<string> cdata)
     : data(move(cdata))
 {
+    channel = NETCHANNEL_FA;
     cmd("ufa");
     arg("s", data->size());
 
@@ -402,6 +403,9 @@ bool CommandPutFile::procresult(Result r)
                     tslot->transfer->tempurls = tempurls;
                     tslot->transferbuf.setIsRaid(tslot->transfer, tempurls, tslot->transfer->pos, tslot->maxRequestSize);
                     tslot->starttime = tslot->lastdata = client->waiter->ds;
+
+                    // connect while the first chunk is read and encrypted
+                    tslot->transfer->preconnect();
                     tslot->progress();
                 }
                 else
@@ -1086,33 +1090,84 @@ CommandPutNodes::CommandPutNodes(MegaClient* client, NodeHandle th,
 // add new nodes and handle->node handle mapping
 void CommandPutNodes::removePendingDBRecordsAndTempFiles()
 {
-    pendingdbid_map::iterator it = client->pendingtcids.find(tag);
-    if (it != client->pendingtcids.end())
+    vector<int> tags = mUploadTags.empty() ? vector<int>(1, tag) : mUploadTags;
+
+    for (int t : tags)
     {
-        if (client->tctable)
+        pendingdbid_map::iterator it = client->pendingtcids.find(t);
+        if (it != client->pendingtcids.end())
         {
-            client->mTctableRequestCommitter->beginOnce();
-            vector<uint32_t> &ids = it->second;
-            for (unsigned int i = 0; i < ids.size(); i++)
+            if (client->tctable)
             {
-                if (ids[i])
+                client->mTctableRequestCommitter->beginOnce();
+                vector<uint32_t> &ids = it->second;
+                for (unsigned int i = 0; i < ids.size(); i++)
                 {
-                    client->tctable->del(ids[i]);
+                    if (ids[i])
+                    {
+                        client->tctable->del(ids[i]);
+                    }
                 }
             }
+            client->pendingtcids.erase(it);
         }
-        client->pendingtcids.erase(it);
+        pendingfiles_map::iterator pit = client->pendingfiles.find(t);
+        if (pit != client->pendingfiles.end())
+        {
+            vector<LocalPath> &pfs = pit->second;
+            for (unsigned int i = 0; i < pfs.size(); i++)
+            {
+                client->fsaccess->unlinklocal(pfs[i]);
+            }
+            client->pendingfiles.erase(pit);
+        }
+    }
+}
+
+// notify the result to the completion function or the app (once per upload
+// if several were put together, each with the tag of its transfer)
+void CommandPutNodes::notifyresult(const Error& e, vector<NewNode>& nodes, bool targetOverride)
+{
+    if (mUploadTags.empty())
+    {
+        if (mResultFunction) mResultFunction(e, type, nodes, targetOverride);
+        else client->app->putnodes_result(e, type, nodes, targetOverride);
+        return;
     }
-    pendingfiles_map::iterator pit = client->pendingfiles.find(tag);
-    if (pit != client->pendingfiles.end())
+
+    int restag = client->restag;
+
+    for (size_t i = 0; i < mUploadTags.size() && i < nn.size(); i++)
     {
-        vector<LocalPath> &pfs = pit->second;
-        for (unsigned int i = 0; i < pfs.size(); i++)
+        vector<NewNode> added;
+        Error ue = e;
+        bool overridden = false;
+
+        if (!e)
         {
-            client->fsaccess->unlinklocal(pfs[i]);
+            if (nn[i].added)
+            {
+                added.resize(1);
+                added[0].type = nn[i].type;
+                added[0].nodehandle = nn[i].nodehandle;
+                added[0].added = true;
+                added[0].mAddedHandle = nn[i].mAddedHandle;
+
+                Node* n = client->nodebyhandle(nn[i].mAddedHandle);
+                overridden = n && n->parenthandle != targethandle.as8byte();
+            }
+            else
+            {
+                ue = API_ENOENT;
+            }
         }
-        client->pendingfiles.erase(pit);
+
+        client->restag = mUploadTags[i];
+        if (mResultFunction) mResultFunction(ue, type, added, overridden);
+        else client->app->putnodes_result(ue, type, added, overridden);
     }
+
+    client->restag = restag;
 }
 
 bool CommandPutNodes::procresult(Result r)
@@ -1148,8 +1203,7 @@ bool CommandPutNodes::procresult(Result r)
 
             vector<NewNode> emptyVec;
 
-            if (mResultFunction) mResultFunction(r.errorOrOK(), type, emptyVec, false);
-            else client->app->putnodes_result(r.errorOrOK(), type, emptyVec);
+            notifyresult(r.errorOrOK(), emptyVec, false);
 
             for (size_t i = 0; i < nn.size(); i++)
             {
@@ -1164,9 +1218,7 @@ bool CommandPutNodes::procresult(Result r)
 #endif
             if (source == PUTNODES_APP)
             {
-                if (mResultFunction) mResultFunction(r.errorOrOK(), type, nn, false);
-                else client->app->putnodes_result(r.errorOrOK(), type, nn);
-
+                notifyresult(r.errorOrOK(), nn, false);
                 return true;
             }
 #ifdef ENABLE_SYNC
@@ -1235,8 +1287,7 @@ bool CommandPutNodes::procresult(Result r)
 #ifdef ENABLE_SYNC
     if (source == PUTNODES_SYNC)
     {
-        if (mResultFunction) mResultFunction(e, type, nn, targetOverride);
-        else client->app->putnodes_result(e, type, nn, targetOverride);
+        notifyresult(e, nn, targetOverride);
 
         client->putnodes_sync_result(e, nn);
     }
@@ -1259,8 +1310,7 @@ bool CommandPutNodes::procresult(Result r)
 #endif
         auto ec = (!e && empty) ? API_ENOENT : static_cast<error>(e);
 
-        if (mResultFunction) mResultFunction(ec, type, nn, targetOverride);
-        else client->app->putnodes_result((!e && empty) ? API_ENOENT : static_cast<error>(e), type, nn, targetOverride);
+        notifyresult(ec, nn, targetOverride);
     }
 #ifdef ENABLE_SYNC
     else
@@ -0,0 +1,303 @@
+/**
+ * @file dirscanner.cpp
+ * @brief Multi-threaded directory tree traversal
+ *
+ * (c) 2013-2014 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/dirscanner.h"
+#include "mega/logging.h"
+
+namespace mega {
+
+const size_t ParallelDirScanner::MAX_BUFFERED_ENTRIES;
+
+void ScannedEntry::setmetadata(FileAccess& fa) const
+{
+    fa.type = type;
+    fa.size = size;
+    fa.mtime = mtime;
+    fa.ctime = ctime;
+    fa.fsid = fsid;
+    fa.fsidvalid = fsidvalid;
+    fa.mIsSymLink = isSymLink;
+    fa.retry = false;
+}
+
+ParallelDirScanner::ParallelDirScanner(FileSystemAccess& fsaccess, Waiter* waiter, unsigned threads, bool followSymlinks)
+    : mFsAccess(fsaccess)
+    , mWaiter(waiter)
+    , mThreadCount(std::max(threads, 1u))
+    , mFollowSymlinks(followSymlinks)
+{
+}
+
+ParallelDirScanner::~ParallelDirScanner()
+{
+    cancel();
+    for (auto& t : mThreads)
+    {
+        t.join();
+    }
+}
+
+void ParallelDirScanner::start(const LocalPath& root, std::function<bool(const LocalPath&)> prune)
+{
+    assert(!mStarted);
+    mPrune = std::move(prune);
+
+    {
+        std::lock_guard<std::mutex> g(mMutex);
+        mPending.emplace(Order(), root);
+        mStarted = true;
+    }
+
+    for (unsigned i = mThreadCount; i--; )
+    {
+        try
+        {
+            mThreads.emplace_back([this]() { workerLoop(); });
+        }
+        catch (std::system_error& e)
+        {
+            LOG_err << "Failed to start directory scan thread: " << e.what();
+            break;
+        }
+    }
+
+    if (mThreads.empty())
+    {
+        // nothing will ever complete
+        cancel();
+    }
+}
+
+unique_ptr<ScannedFolder> ParallelDirScanner::take(const LocalPath& path)
+{
+    std::lock_guard<std::mutex> g(mMutex);
+
+    auto it = mCompleted.find(path);
+    if (it == mCompleted.end())
+    {
+        if (!finished() && !mCancelled)
+        {
+            mDiscard.insert(path);
+        }
+        return nullptr;
+    }
+
+    return remove(it);
+}
+
+unique_ptr<ScannedFolder> ParallelDirScanner::next()
+{
+    std::lock_guard<std::mutex> g(mMutex);
+
+    if (mCompleted.empty())
+    {
+        return nullptr;
+    }
+
+    return remove(mCompleted.begin());
+}
+
+unique_ptr<ScannedFolder> ParallelDirScanner::remove(map<LocalPath, Completed>::iterator it)
+{
+    unique_ptr<ScannedFolder> folder = std::move(it->second.folder);
+    mBufferedOrder.erase(it->second.order);
+    mCompleted.erase(it);
+    mBuffered -= folder->entries.size();
+    mWorkCv.notify_all();
+    return folder;
+}
+
+bool ParallelDirScanner::canList() const
+{
+    if (mPending.empty())
+    {
+        return false;
+    }
+
+    // with the buffer full, only what the consumer needs before the last buffered folder
+    return mBuffered < MAX_BUFFERED_ENTRIES
+        || (!mBufferedOrder.empty() && mPending.begin()->first < *mBufferedOrder.rbegin());
+}
+
+bool ParallelDirScanner::wait()
+{
+    std::unique_lock<std::mutex> g(mMutex);
+    mResultCv.wait(g, [this]() { return !mCompleted.empty() || finished() || mCancelled; });
+    return !mCompleted.empty();
+}
+
+bool ParallelDirScanner::done() const
+{
+    std::lock_guard<std::mutex> g(mMutex);
+    return finished() || mCancelled;
+}
+
+void ParallelDirScanner::cancel()
+{
+    {
+        std::lock_guard<std::mutex> g(mMutex);
+        mCancelled = true;
+    }
+    mWorkCv.notify_all();
+    mResultCv.notify_all();
+}
+
+ParallelDirScanner::Stats ParallelDirScanner::stats() const
+{
+    std::lock_guard<std::mutex> g(mMutex);
+    return mStats;
+}
+
+void ParallelDirScanner::workerLoop()
+{
+    for (;;)
+    {
+        LocalPath path;
+        Order order;
+        {
+            std::unique_lock<std::mutex> g(mMutex);
+            mWorkCv.wait(g, [this]()
+            {
+                return mCancelled || finished() || canList();
+            });
+
+            if (mCancelled || finished())
+            {
+                break;
+            }
+
+            order = mPending.begin()->first;
+            path = std::move(mPending.begin()->second);
+            mPending.erase(mPending.begin());
+            mActive++;
+        }
+
+        map<Order, LocalPath> subfolders;
+        unique_ptr<ScannedFolder> folder = list(path, order, subfolders);
+
+        {
+            std::lock_guard<std::mutex> g(mMutex);
+            mActive--;
+
+            mPending.insert(std::make_move_iterator(subfolders.begin()), std::make_move_iterator(subfolders.end()));
+
+            if (folder)
+            {
+                mStats.folders++;
+                mStats.entries += folder->entries.size();
+
+                if (!mDiscard.erase(path))
+                {
+                    mBuffered += folder->entries.size();
+                    mBufferedOrder.insert(order);
+                    Completed& completed = mCompleted[path];
+                    completed.order = std::move(order);
+                    completed.folder = std::move(folder);
+                }
+            }
+            else
+            {
+                mStats.failedFolders++;
+                mDiscard.erase(path);
+            }
+
+            if (finished())
+            {
+                mDiscard.clear();
+            }
+        }
+
+        // new work or the end of the walk for the other workers, a result for the consumer
+        mWorkCv.notify_all();
+        mResultCv.notify_all();
+
+        if (mWaiter)
+        {
+            mWaiter->notify();
+        }
+    }
+
+    mWorkCv.notify_all();
+    mResultCv.notify_all();
+}
+
+unique_ptr<ScannedFolder> ParallelDirScanner::list(const LocalPath& path, const Order& order, map<Order, LocalPath>& subfolders)
+{
+    LocalPath folderPath = path;
+    unique_ptr<DirAccess> da(mFsAccess.newdiraccess());
+
+    if (!da->dopen(&folderPath, nullptr, false))
+    {
+        LOG_debug << "Unable to list folder: " << folderPath.toPath();
+        return nullptr;
+    }
+
+    unique_ptr<ScannedFolder> folder(new ScannedFolder);
+    folder->path = path;
+
+    LocalPath name;
+    nodetype_t type;
+    while (da->dnext(folderPath, name, mFollowSymlinks, &type))
+    {
+        ScopedLengthRestore restoreLen(folderPath);
+        folderPath.appendWithSeparator(name, false);
+
+        folder->entries.emplace_back();
+        ScannedEntry& entry = folder->entries.back();
+        entry.name = std::move(name);
+        entry.type = type;
+
+        // reuses the metadata that the directory iteration just obtained
+        auto fa = mFsAccess.newfileaccess(mFollowSymlinks);
+        if (fa->fopen(folderPath, false, false, da.get()))
+        {
+            entry.type = fa->type;
+            entry.size = fa->size;
+            entry.mtime = fa->mtime;
+            entry.ctime = fa->ctime;
+            entry.fsid = fa->fsid;
+            entry.fsidvalid = fa->fsidvalid;
+            entry.isSymLink = fa->mIsSymLink;
+            entry.valid = true;
+        }
+
+        if (entry.type == FOLDERNODE && !entry.isSymLink && !(mPrune && mPrune(folderPath)))
+        {
+            Order suborder = order;
+            suborder.push_back(unsigned(folder->entries.size() - 1));
+            subfolders.emplace(std::move(suborder), folderPath);
+        }
+
+        // check every so often, huge folders take a while
+        if (!(folder->entries.size() & 1023))
+        {
+            std::lock_guard<std::mutex> g(mMutex);
+            if (mCancelled)
+            {
+                return nullptr;
+            }
+        }
+    }
+
+    return folder;
+}
+
+} // namespace
@@ -0,0 +1,303 @@
+/**
+ * @file exclusionmatcher.cpp
+ * @brief Compiled sync exclusion rules
+ *
+ * (c) 2013-2014 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/exclusionmatcher.h"
+#include "mega/utils.h"
+
+namespace mega {
+
+namespace {
+
+template<class S>
+bool isAscii(const S& s, size_t begin, size_t end)
+{
+    typedef typename std::make_unsigned<typename S::value_type>::type unit;
+
+    for (; begin < end; begin++)
+    {
+        if (static_cast<unit>(s[begin]) >= 0x80)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// (ASCII only)
+template<class S>
+string narrow(const S& s, size_t begin, size_t end)
+{
+    string result(end - begin, '\0');
+    for (size_t i = 0; begin < end; i++, begin++)
+    {
+        result[i] = static_cast<char>(s[begin]);
+    }
+    return result;
+}
+
+// compares `lhs` with the first `length` units of `rhs`, as LocalPath::isContainingPathOf() does
+template<class S>
+int compareprefix(const S& lhs, const S& rhs, size_t length)
+{
+    size_t common = std::min(lhs.size(), length);
+    if (int result = Utils::pcasecmp(lhs, rhs, common))
+    {
+        return result;
+    }
+    return lhs.size() < length ? -1 : lhs.size() > length ? 1 : 0;
+}
+
+} // namespace
+
+bool wildcardMatch(const char *pszString, const char *pszMatch)
+//  cf. http://www.planet-source-code.com/vb/scripts/ShowCode.asp?txtCodeId=1680&lngWId=3
+{
+    const char *cp = nullptr;
+    const char *mp = nullptr;
+
+    while ((*pszString) && (*pszMatch != '*'))
+    {
+        if ((*pszMatch != *pszString) && (*pszMatch != '?'))
+        {
+            return false;
+        }
+        pszMatch++;
+        pszString++;
+    }
+
+    while (*pszString)
+    {
+        if (*pszMatch == '*')
+        {
+            if (!*++pszMatch)
+            {
+                return true;
+            }
+            mp = pszMatch;
+            cp = pszString + 1;
+        }
+        else if ((*pszMatch == *pszString) || (*pszMatch == '?'))
+        {
+            pszMatch++;
+            pszString++;
+        }
+        else
+        {
+            pszMatch = mp;
+            pszString = cp++;
+        }
+    }
+    while (*pszMatch == '*')
+    {
+        pszMatch++;
+    }
+    return !*pszMatch;
+}
+
+void ExclusionMatcher::set(const vector<string>& names, const vector<string>& paths, const FileSystemAccess& fsaccess)
+{
+    clear();
+
+    for (const string& name : names)
+    {
+        size_t wildcard = name.find_first_of("*?");
+
+        if (wildcard == string::npos)
+        {
+            mNames.insert(name);
+        }
+        else if (wildcard == name.size() - 1 && name.back() == '*')
+        {
+            mNamePrefixes[wildcard].insert(name.substr(0, wildcard));
+        }
+        else if (!wildcard && name[0] == '*' && name.find_first_of("*?", 1) == string::npos)
+        {
+            mNameSuffixes[name.size() - 1].insert(name.substr(1));
+        }
+        else
+        {
+            mNamePatterns.push_back(name);
+        }
+    }
+
+    for (const string& path : paths)
+    {
+        bool wildcards = path.find_first_of("*?") != string::npos;
+
+        // (the full path is compared in UTF-8 for these, as it may not be normalized on disk)
+        if (wildcards || !isAscii(path, 0, path.size()))
+        {
+            mPathPatterns.push_back(path);
+        }
+
+        if (!wildcards)
+        {
+            mPaths.push_back(LocalPath::fromPath(path, fsaccess));
+        }
+    }
+
+    std::sort(mPaths.begin(), mPaths.end(), [](const LocalPath& lhs, const LocalPath& rhs)
+    {
+        return compareprefix(lhs.localpath, rhs.localpath, rhs.localpath.size()) < 0;
+    });
+}
+
+void ExclusionMatcher::clear()
+{
+    mNames.clear();
+    mNamePrefixes.clear();
+    mNameSuffixes.clear();
+    mNamePatterns.clear();
+    mPaths.clear();
+    mPathPatterns.clear();
+}
+
+bool ExclusionMatcher::excluded(const LocalPath& root, const LocalPath& path, const FileSystemAccess& fsaccess) const
+{
+    const auto& p = path.localpath;
+
+    // any excluded path containing this one?
+    if (!mPaths.empty())
+    {
+        if (containsPrefix(mPaths, path, p.size()))
+        {
+            return true;
+        }
+
+        for (size_t i = 0; i < p.size(); i++)
+        {
+            // (rules can end with a separator)
+            if (p[i] == LocalPath::localPathSeparator
+                && (containsPrefix(mPaths, path, i) || containsPrefix(mPaths, path, i + 1)))
+            {
+                return true;
+            }
+        }
+    }
+
+    if (!mPathPatterns.empty())
+    {
+        string utf8 = isAscii(p, 0, p.size()) ? narrow(p, 0, p.size()) : path.toPath(fsaccess);
+
+        for (const string& pattern : mPathPatterns)
+        {
+            if (wildcardMatch(utf8.c_str(), pattern.c_str()))
+            {
+                return true;
+            }
+        }
+    }
+
+    // any excluded name below the root?
+    size_t begin;
+    if (!root.isContainingPathOf(path, &begin))
+    {
+        return false;
+    }
+
+    while (begin < p.size())
+    {
+        size_t end = p.find(LocalPath::localPathSeparator, begin);
+        if (end == p.npos)
+        {
+            end = p.size();
+        }
+
+        if (end > begin)
+        {
+            string name;
+            if (isAscii(p, begin, end))
+            {
+                // the UTF-8 representation, without a conversion
+                name = narrow(p, begin, end);
+            }
+            else
+            {
+                LocalPath component;
+                component.localpath = p.substr(begin, end - begin);
+                name = component.toPath(fsaccess);
+            }
+
+            if (nameExcluded(name))
+            {
+                return true;
+            }
+        }
+
+        begin = end + 1;
+    }
+
+    return false;
+}
+
+bool ExclusionMatcher::nameExcluded(const string& name) const
+{
+    if (mNames.count(name))
+    {
+        return true;
+    }
+
+    for (const auto& prefixes : mNamePrefixes)
+    {
+        if (prefixes.first > name.size())
+        {
+            break;
+        }
+        if (prefixes.second.count(name.substr(0, prefixes.first)))
+        {
+            return true;
+        }
+    }
+
+    for (const auto& suffixes : mNameSuffixes)
+    {
+        if (suffixes.first > name.size())
+        {
+            break;
+        }
+        if (suffixes.second.count(name.substr(name.size() - suffixes.first)))
+        {
+            return true;
+        }
+    }
+
+    for (const string& pattern : mNamePatterns)
+    {
+        if (wildcardMatch(name.c_str(), pattern.c_str()))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ExclusionMatcher::containsPrefix(const vector<LocalPath>& sorted, const LocalPath& path, size_t length)
+{
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), length, [&path](const LocalPath& rule, size_t length)
+    {
+        return compareprefix(rule.localpath, path.localpath, length) < 0;
+    });
+
+    return it != sorted.end() && !compareprefix(it->localpath, path.localpath, length);
+}
+
+} // namespace
@@ -290,8 +290,8 @@ void File::completed(Transfer* t, LocalNode* l)
     assert(!transfer || t == transfer);
     if (t->type == PUT)
     {
-        vector<NewNode> newnodes(1);
-        NewNode* newnode = &newnodes[0];
+        // (allocated, as the sync's LocalNode links to it until it is put)
+        unique_ptr<NewNode> newnode(new NewNode);
 
         // build new node
         newnode->source = NEW_UPLOAD;
@@ -309,7 +309,7 @@ void File::completed(Transfer* t, LocalNode* l)
 #ifdef ENABLE_SYNC
         if (l)
         {
-            l->newnode.crossref(newnode, l);
+            l->newnode.crossref(newnode.get(), l);
             newnode->syncid = l->syncid;
         }
 #endif
@@ -332,6 +332,8 @@ void File::completed(Transfer* t, LocalNode* l)
         if (targetuser.size())
         {
             // drop file into targetuser's inbox
+            vector<NewNode> newnodes;
+            newnodes.push_back(move(*newnode));
             t->client->putnodes(targetuser.c_str(), move(newnodes), tag);
         }
         else
@@ -359,8 +361,6 @@ void File::completed(Transfer* t, LocalNode* l)
                         newnode->ovhandle = l->node->nodehandle;
                     }
                 }
-
-                t->client->syncadding++;
             }
 #endif
             if (!t->client->versions_disabled && ISUNDEF(newnode->ovhandle))
@@ -368,17 +368,13 @@ void File::completed(Transfer* t, LocalNode* l)
                 newnode->ovhandle = t->client->getovhandle(t->client->nodeByHandle(th), &name);
             }
 
-            t->client->reqs.add(new CommandPutNodes(t->client,
-                                                    th, NULL,
-                                                    move(newnodes),
-                                                    tag,
+            t->client->putnodesbatch(th,
 #ifdef ENABLE_SYNC
-                                                    l ? PUTNODES_SYNC : PUTNODES_APP,
+                                     l ? PUTNODES_SYNC : PUTNODES_APP,
 #else
-                                                    PUTNODES_APP,
+                                     PUTNODES_APP,
 #endif
-                                                    nullptr,
-                                                    nullptr));
+                                     tag, move(newnode));
         }
     }
 }
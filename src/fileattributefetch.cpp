@@ -30,6 +30,7 @@ FileAttributeFetchChannel::FileAttributeFetchChannel(MegaClient* client)
 {
     req.binary = true;
     req.status = REQ_READY;
+    req.channel = NETCHANNEL_FA;
     urltime = 0;
     fahref = UNDEF;
     inbytes = 0;
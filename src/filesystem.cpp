@@ -556,6 +556,146 @@ void DirNotify::notify(notifyqueue q, LocalNode* l, LocalPath&& path, bool immed
 
 }
 
+bool NotificationDeque::peekFront(Notification& n)
+{
+    std::lock_guard<std::mutex> g(m);
+    popSuperseded();
+    if (!mNotifications.empty())
+    {
+        n = mNotifications.front();
+        return true;
+    }
+    return false;
+}
+
+bool NotificationDeque::popFront(Notification& n)
+{
+    std::lock_guard<std::mutex> g(m);
+    popSuperseded();
+    if (!mNotifications.empty())
+    {
+        Notification& front = mNotifications.front();
+
+        auto it = mPending.find(Key(front.localnode, front.path));
+        if (it != mPending.end() && it->second == &front)
+        {
+            mPending.erase(it);
+        }
+
+        n = std::move(front);
+        mNotifications.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void NotificationDeque::unpopFront(const Notification& n)
+{
+    std::lock_guard<std::mutex> g(m);
+    mNotifications.push_front(n);
+
+    // (if queued again meanwhile, the later one stays pending)
+    mPending.emplace(Key(n.localnode, n.path), &mNotifications.front());
+}
+
+void NotificationDeque::pushBack(Notification&& n)
+{
+    std::lock_guard<std::mutex> g(m);
+
+    if (n.localnode && !n.path.empty())
+    {
+        auto it = mPending.find(Key(n.localnode, LocalPath()));
+        if (it != mPending.end() && !it->second->timestamp)
+        {
+            // the folder will be rescanned anyway
+            mCoalesced++;
+            return;
+        }
+    }
+
+    auto it = mPending.find(Key(n.localnode, n.path));
+    if (it != mPending.end())
+    {
+        mCoalesced++;
+
+        if (!it->second->timestamp)
+        {
+            // already to be processed immediately
+            return;
+        }
+
+        supersede(it);
+    }
+
+    if (n.localnode && n.path.empty() && !n.timestamp)
+    {
+        // a folder rescan covers everything pending below it
+        for (it = mPending.lower_bound(Key(n.localnode, LocalPath()));
+             it != mPending.end() && it->first.first == n.localnode; )
+        {
+            mCoalesced++;
+            supersede(it++);
+        }
+    }
+
+    mNotifications.push_back(std::move(n));
+
+    Notification& back = mNotifications.back();
+    mPending[Key(back.localnode, back.path)] = &back;
+}
+
+bool NotificationDeque::empty()
+{
+    return !size();
+}
+
+size_t NotificationDeque::size()
+{
+    std::lock_guard<std::mutex> g(m);
+    return mNotifications.size() - mSuperseded;
+}
+
+void NotificationDeque::replaceLocalNodePointers(LocalNode* check, LocalNode* newvalue)
+{
+    std::lock_guard<std::mutex> g(m);
+    for (auto& n : mNotifications)
+    {
+        if (n.localnode == check && !n.superseded)
+        {
+            auto it = mPending.find(Key(n.localnode, n.path));
+            if (it != mPending.end() && it->second == &n)
+            {
+                mPending.erase(it);
+            }
+
+            n.localnode = newvalue;
+            mPending.emplace(Key(n.localnode, n.path), &n);
+        }
+    }
+}
+
+uint64_t NotificationDeque::coalesced()
+{
+    std::lock_guard<std::mutex> g(m);
+    return mCoalesced;
+}
+
+void NotificationDeque::supersede(map<Key, Notification*>::iterator it)
+{
+    it->second->superseded = true;
+    mSuperseded++;
+    mPending.erase(it);
+}
+
+void NotificationDeque::popSuperseded()
+{
+    while (!mNotifications.empty() && mNotifications.front().superseded)
+    {
+        mNotifications.pop_front();
+        mSuperseded--;
+    }
+}
+
 // default: no fingerprint
 fsfp_t DirNotify::fsfingerprint() const
 {
@@ -0,0 +1,241 @@
+/**
+ * @file fingerprintcache.cpp
+ * @brief Persistent cache of local file fingerprints
+ *
+ * (c) 2013-2014 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/fingerprintcache.h"
+#include "mega/db.h"
+#include "mega/filesystem.h"
+#include "mega/utils.h"
+#include "mega/logging.h"
+
+namespace mega {
+
+namespace {
+
+// record type in the fingerprint tables (0 is reserved for unencrypted records)
+const uint32_t CACHEDFINGERPRINT = 1;
+
+} // namespace
+
+bool LocalFingerprintCache::genfingerprint(FileFingerprint& fp, FileAccess* fa, bool ignoremtime)
+{
+    FileFingerprint cached;
+
+    if (!fa->fsidvalid || fa->type != FILENODE)
+    {
+        return fp.genfingerprint(fa, ignoremtime);
+    }
+
+    if (!lookup(fa->fsid, fa->size, fa->mtime, fa->ctime, cached))
+    {
+        bool changed = fp.genfingerprint(fa, ignoremtime);
+
+        // (the size is -1 if the file could not be read)
+        if (fp.isvalid && fp.size == fa->size)
+        {
+            add(fa->fsid, fa->ctime, fp);
+        }
+        return changed;
+    }
+
+    // as FileFingerprint::genfingerprint() would have updated `fp`
+    bool changed = false;
+
+    if (fp.mtime != cached.mtime)
+    {
+        fp.mtime = cached.mtime;
+        changed = !ignoremtime;
+    }
+
+    if (fp.size != cached.size)
+    {
+        fp.size = cached.size;
+        changed = true;
+    }
+
+    if (fp.crc != cached.crc)
+    {
+        fp.crc = cached.crc;
+        changed = true;
+    }
+
+    if (!fp.isvalid)
+    {
+        fp.isvalid = true;
+        changed = true;
+    }
+
+    return changed;
+}
+
+bool LocalFingerprintCache::lookup(handle fsid, m_off_t size, m_time_t mtime, m_time_t ctime, FileFingerprint& fp)
+{
+    std::lock_guard<std::mutex> g(mMutex);
+
+    // a new file with a reused fsid rarely has the same size and mtime, and never the same ctime
+    auto it = mRecords.find(fsid);
+    if (it == mRecords.end()
+        || it->second.fingerprint.size != size
+        || it->second.fingerprint.mtime != mtime
+        || it->second.ctime != ctime)
+    {
+        mMisses++;
+        return false;
+    }
+
+    mHits++;
+    fp = it->second.fingerprint;
+    return true;
+}
+
+void LocalFingerprintCache::add(handle fsid, m_time_t ctime, const FileFingerprint& fp)
+{
+    std::lock_guard<std::mutex> g(mMutex);
+
+    Record& record = mRecords[fsid];
+    record.fsid = fsid;
+    record.ctime = ctime;
+    record.fingerprint = fp;
+    mUnsaved.insert(fsid);
+}
+
+void LocalFingerprintCache::remove(handle fsid)
+{
+    std::lock_guard<std::mutex> g(mMutex);
+
+    auto it = mRecords.find(fsid);
+    if (it != mRecords.end())
+    {
+        erase(it);
+    }
+}
+
+void LocalFingerprintCache::erase(std::unordered_map<handle, Record>::iterator it)
+{
+    if (it->second.dbid)
+    {
+        mDeleted.insert(it->second.dbid);
+    }
+    mUnsaved.erase(it->first);
+    mRecords.erase(it);
+}
+
+void LocalFingerprintCache::load(DbTable& table, SymmCipher& key)
+{
+    std::lock_guard<std::mutex> g(mMutex);
+
+    uint32_t id;
+    string data;
+    unsigned failed = 0;
+
+    table.rewind();
+    while (table.next(&id, &data, &key))
+    {
+        Record record;
+        if (!Record::unserialize(data, record))
+        {
+            failed++;
+            continue;
+        }
+
+        record.dbid = id;
+        mRecords[record.fsid] = record;
+    }
+
+    LOG_debug << "Fingerprints loaded: " << mRecords.size() << (failed ? " Failed: " + std::to_string(failed) : string());
+}
+
+void LocalFingerprintCache::save(DbTable& table, SymmCipher& key)
+{
+    std::lock_guard<std::mutex> g(mMutex);
+
+    if (mUnsaved.empty() && mDeleted.empty())
+    {
+        return;
+    }
+
+    table.begin();
+    for (uint32_t dbid : mDeleted)
+    {
+        table.del(dbid);
+    }
+    for (handle fsid : mUnsaved)
+    {
+        // (the record keeps its dbid, so the row is updated the next time)
+        table.put(CACHEDFINGERPRINT, &mRecords[fsid], &key);
+    }
+    table.commit();
+
+    LOG_verbose << "Fingerprints saved: " << mUnsaved.size() << "  Deleted: " << mDeleted.size();
+    mUnsaved.clear();
+    mDeleted.clear();
+}
+
+LocalFingerprintCache::Stats LocalFingerprintCache::stats()
+{
+    std::lock_guard<std::mutex> g(mMutex);
+
+    Stats s;
+    s.hits = mHits;
+    s.misses = mMisses;
+    s.entries = mRecords.size();
+    return s;
+}
+
+bool LocalFingerprintCache::Record::serialize(string* d)
+{
+    CacheableWriter w(*d);
+    w.serializehandle(fsid);
+    w.serializei64(fingerprint.size);
+    w.serializei64(fingerprint.mtime);
+    w.serializebinary(reinterpret_cast<byte*>(fingerprint.crc.data()), sizeof fingerprint.crc);
+    w.serializeexpansionflags(true);
+    w.serializei64(ctime);
+    return true;
+}
+
+bool LocalFingerprintCache::Record::unserialize(const string& d, Record& record)
+{
+    CacheableReader r(d);
+    int64_t size;
+    int64_t mtime;
+    int64_t ctime = 0;
+    unsigned char expansions[8];
+
+    // (records without ctime never match, and are replaced as their files are fingerprinted)
+    if (!r.unserializehandle(record.fsid)
+        || !r.unserializei64(size)
+        || !r.unserializei64(mtime)
+        || !r.unserializebinary(reinterpret_cast<byte*>(record.fingerprint.crc.data()), sizeof record.fingerprint.crc)
+        || !r.unserializeexpansionflags(expansions, 1)
+        || (expansions[0] && !r.unserializei64(ctime)))
+    {
+        LOG_err << "Fingerprint record unserialization failed";
+        return false;
+    }
+
+    record.fingerprint.size = size;
+    record.fingerprint.mtime = mtime;
+    record.fingerprint.isvalid = true;
+    record.ctime = ctime;
+    return true;
+}
+
+} // namespace
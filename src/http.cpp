@@ -457,6 +457,12 @@ void HttpReq::disconnect()
 {
     if (httpio)
     {
+        if (status == REQ_INFLIGHT)
+        {
+            // aborted, for example after a timeout, and usually sent again
+            retry = true;
+        }
+
         httpio->cancel(this);
         httpio = NULL;
         init();
@@ -666,7 +672,8 @@ m_off_t HttpReq::transferred(MegaClient*)
 }
 
 HttpReqDL::HttpReqDL()
-    : dlpos(0)
+    : HttpReqXfer(NETCHANNEL_GET)
+    , dlpos(0)
     , buffer_released(false)
 {
 }
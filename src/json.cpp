@@ -1009,5 +1009,78 @@ string JSONWriter::escape(const char* data, size_t length) const
     return result;
 }
 
+size_t JSONStreamScanner::scan(const char* data, size_t len)
+{
+    for (; mScanned < len; mScanned++)
+    {
+        char c = data[mScanned];
+
+        if (mInString)
+        {
+            if (mEscaped)
+            {
+                mEscaped = false;
+            }
+            else if (c == '\\')
+            {
+                mEscaped = true;
+            }
+            else if (c == '"')
+            {
+                mInString = false;
+            }
+            continue;
+        }
+
+        switch (c)
+        {
+            case '"':
+                mInString = true;
+                break;
+
+            case '{':
+            case '[':
+                if (++mDepth == 2)
+                {
+                    mInTopArray = c == '[';
+                }
+                break;
+
+            case '}':
+            case ']':
+                if (--mDepth == 2 && mInTopArray)
+                {
+                    // end of an element of a top-level array
+                    mSafe = mScanned + 1;
+                }
+                break;
+
+            case ',':
+                if (mDepth == 1)
+                {
+                    // end of a top-level member (parsing skips the separator)
+                    mSafe = mScanned;
+                }
+                break;
+        }
+    }
+
+    return mSafe;
+}
+
+void JSONStreamScanner::consume(size_t len)
+{
+    assert(len <= mSafe);
+    mScanned -= len;
+    mSafe -= len;
+}
+
+void JSONStreamScanner::reset()
+{
+    mScanned = mSafe = 0;
+    mDepth = 0;
+    mInTopArray = mInString = mEscaped = false;
+}
+
 } // namespace
 
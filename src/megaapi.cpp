@@ -1066,6 +1066,11 @@ MegaHandleList* MegaRequest::getMegaHandleList() const
     return nullptr;
 }
 
+MegaNodeList* MegaRequest::getMegaNodeList() const
+{
+    return nullptr;
+}
+
 MegaTransfer::~MegaTransfer() { }
 
 MegaTransfer *MegaTransfer::copy()
@@ -1178,6 +1183,11 @@ long long MegaTransfer::getMeanSpeed() const
     return 0;
 }
 
+long long MegaTransfer::getTimeToFirstByte() const
+{
+    return -1;
+}
+
 long long MegaTransfer::getDeltaSize() const
 {
 	return 0;
@@ -1575,6 +1585,8 @@ void MegaTransferListener::onTransferFinish(MegaApi*, MegaTransfer *, MegaError*
 { }
 void MegaTransferListener::onTransferUpdate(MegaApi *, MegaTransfer *)
 { }
+void MegaTransferListener::onTransfersUpdate(MegaApi *, MegaTransferList *)
+{ }
 bool MegaTransferListener::onTransferData(MegaApi *, MegaTransfer *, char *, size_t)
 { return true; }
 void MegaTransferListener::onTransferTemporaryError(MegaApi *, MegaTransfer *, MegaError*)
@@ -1647,6 +1659,8 @@ void MegaGlobalListener::onUserAlertsUpdate(MegaApi *api, MegaUserAlertList *ale
 { }
 void MegaGlobalListener::onNodesUpdate(MegaApi *, MegaNodeList *)
 { }
+void MegaGlobalListener::onNodeChanges(MegaApi *, MegaNodeChangeList *)
+{ }
 void MegaGlobalListener::onAccountUpdate(MegaApi *)
 { }
 void MegaGlobalListener::onContactRequestsUpdate(MegaApi *, MegaContactRequestList *)
@@ -1675,6 +1689,8 @@ void MegaListener::onTransferFinish(MegaApi *, MegaTransfer *, MegaError *)
 { }
 void MegaListener::onTransferUpdate(MegaApi *, MegaTransfer *)
 { }
+void MegaListener::onTransfersUpdate(MegaApi *, MegaTransferList *)
+{ }
 void MegaListener::onTransferTemporaryError(MegaApi *, MegaTransfer *, MegaError *)
 { }
 void MegaListener::onUsersUpdate(MegaApi *, MegaUserList *)
@@ -1683,6 +1699,8 @@ void MegaListener::onUserAlertsUpdate(MegaApi *, MegaUserAlertList *)
 { }
 void MegaListener::onNodesUpdate(MegaApi *, MegaNodeList *)
 { }
+void MegaListener::onNodeChanges(MegaApi *, MegaNodeChangeList *)
+{ }
 void MegaListener::onAccountUpdate(MegaApi *)
 { }
 void MegaListener::onContactRequestsUpdate(MegaApi *, MegaContactRequestList *)
@@ -1697,6 +1715,8 @@ void MegaGlobalListener::onGlobalSyncStateChanged(MegaApi *)
 { }
 void MegaListener::onSyncFileStateChanged(MegaApi *, MegaSync *, string *, int)
 { }
+void MegaListener::onSyncFileStatesChanged(MegaApi *, MegaSync *, MegaSyncFileStateList *)
+{ }
 void MegaListener::onSyncAdded(MegaApi *, MegaSync *, int additionState)
 { }
 void MegaListener::onSyncDisabled(MegaApi *, MegaSync *)
@@ -3039,6 +3059,16 @@ void MegaApi::setMaxConnections(int connections, MegaRequestListener *listener)
     pImpl->setMaxConnections(-1,  connections, listener);
 }
 
+void MegaApi::setTransferUpdatePolicy(int minIntervalMs, long long minBytes, bool batched)
+{
+    pImpl->setTransferUpdatePolicy(minIntervalMs, minBytes, batched);
+}
+
+char *MegaApi::getTransferUpdateStats()
+{
+    return pImpl->getTransferUpdateStats();
+}
+
 void MegaApi::setDownloadMethod(int method)
 {
     pImpl->setDownloadMethod(method);
@@ -3069,6 +3099,11 @@ bool MegaApi::setMaxUploadSpeed(long long bpslimit)
     return pImpl->setMaxUploadSpeed(bpslimit);
 }
 
+bool MegaApi::setBandwidthClassLimits(int direction, int bandwidthClass, long long minBps, long long maxBps)
+{
+    return pImpl->setBandwidthClassLimits(direction, bandwidthClass, minBps, maxBps);
+}
+
 int MegaApi::getCurrentDownloadSpeed()
 {
     return pImpl->getCurrentDownloadSpeed();
@@ -3244,6 +3279,16 @@ void MegaApi::startDownloadWithTopPriority(MegaNode *node, const char *localPath
     pImpl->startDownload(true, node, localPath, 0, appData, listener);
 }
 
+void MegaApi::startUploads(MegaStringList *localPaths, MegaHandleList *parents, MegaTransferListener *listener)
+{
+    pImpl->startUploads(localPaths, parents, listener);
+}
+
+void MegaApi::startDownloads(MegaHandleList *nodes, MegaStringList *localPaths, MegaTransferListener *listener)
+{
+    pImpl->startDownloads(nodes, localPaths, listener);
+}
+
 void MegaApi::cancelTransfer(MegaTransfer *t, MegaRequestListener *listener)
 {
     pImpl->cancelTransfer(t, listener);
@@ -3304,6 +3349,16 @@ void MegaApi::moveTransferBeforeByTag(int transferTag, int prevTransferTag, Mega
     pImpl->moveTransferBefore(transferTag, prevTransferTag, listener);
 }
 
+void MegaApi::setTransferBandwidthClass(MegaTransfer *transfer, int bandwidthClass, int weight, MegaRequestListener *listener)
+{
+    pImpl->setTransferBandwidthClass(transfer ? transfer->getTag() : 0, bandwidthClass, weight, listener);
+}
+
+void MegaApi::setTransferBandwidthClassByTag(int transferTag, int bandwidthClass, int weight, MegaRequestListener *listener)
+{
+    pImpl->setTransferBandwidthClass(transferTag, bandwidthClass, weight, listener);
+}
+
 void MegaApi::cancelTransferByTag(int transferTag, MegaRequestListener *listener)
 {
     pImpl->cancelTransferByTag(transferTag, listener);
@@ -3472,6 +3527,26 @@ long long MegaApi::getNumLocalNodes()
     return pImpl->getNumLocalNodes();
 }
 
+char *MegaApi::getSyncFingerprintCacheStats()
+{
+    return pImpl->getSyncFingerprintCacheStats();
+}
+
+void MegaApi::setSyncStateNotificationsFoldersOnly(bool foldersOnly)
+{
+    pImpl->setSyncStateNotificationsFoldersOnly(foldersOnly);
+}
+
+void MegaApi::setSyncStateNotificationsBatched(bool batched)
+{
+    pImpl->setSyncStateNotificationsBatched(batched);
+}
+
+char *MegaApi::getSyncStateNotificationStats()
+{
+    return pImpl->getSyncStateNotificationStats();
+}
+
 char *MegaApi::getBlockedPath()
 {
     return pImpl->getBlockedPath();
@@ -3863,6 +3938,21 @@ bool MegaApi::areGfxFeaturesDisabled()
     return pImpl->areGfxFeaturesDisabled();
 }
 
+void MegaApi::setStreamingActionPackets(bool enable)
+{
+    pImpl->setStreamingActionPackets(enable);
+}
+
+char *MegaApi::getNetworkTelemetry()
+{
+    return pImpl->getNetworkTelemetry();
+}
+
+void MegaApi::resetNetworkTelemetry()
+{
+    pImpl->resetNetworkTelemetry();
+}
+
 void MegaApi::changeApiUrl(const char *apiURL, bool disablepkp)
 {
     pImpl->changeApiUrl(apiURL, disablepkp);
@@ -4194,6 +4284,41 @@ MegaNodeList *MegaApi::getChildren(MegaNodeList *parentNodes, int order)
     return pImpl->getChildren(parentNodes, order);
 }
 
+MegaNodeInfoList *MegaApi::getChildrenInfo(MegaNode* p, int order)
+{
+    return pImpl->getChildrenInfo(p, order);
+}
+
+void MegaApi::setConcurrentNodeQueries(bool enable)
+{
+    pImpl->setConcurrentNodeQueries(enable);
+}
+
+void MegaApi::setNodeChangeNotifications(bool enable, int batchSize, bool changedFields)
+{
+    pImpl->setNodeChangeNotifications(enable, batchSize, changedFields);
+}
+
+MegaChildrenPage *MegaApi::getChildrenPage(MegaNode* p, int order, const char *cursor, int pageSize)
+{
+    return pImpl->getChildrenPage(p, order, cursor, pageSize);
+}
+
+void MegaApi::searchAsync(MegaNode *node, const char *searchString, MegaCancelToken *cancelToken, bool recursive, int order, int pageSize, MegaRequestListener *listener)
+{
+    pImpl->searchAsync(node, searchString, cancelToken, recursive, order, pageSize, listener);
+}
+
+void MegaApi::getChildrenAsync(MegaNode *parent, int order, MegaCancelToken *cancelToken, int pageSize, MegaRequestListener *listener)
+{
+    pImpl->getChildrenAsync(parent, order, cancelToken, pageSize, listener);
+}
+
+void MegaApi::exportNodeTree(const char *localPath, MegaRequestListener *listener)
+{
+    pImpl->exportNodeTree(localPath, listener);
+}
+
 MegaNodeList *MegaApi::getVersions(MegaNode *node)
 {
     return pImpl->getVersions(node);
@@ -6026,6 +6151,31 @@ void MegaSyncList::addSync(MegaSync *sync)
 
 }
 
+MegaSyncFileStateList::~MegaSyncFileStateList()
+{
+
+}
+
+MegaSyncFileStateList *MegaSyncFileStateList::copy() const
+{
+    return NULL;
+}
+
+int MegaSyncFileStateList::size() const
+{
+    return 0;
+}
+
+const string *MegaSyncFileStateList::getLocalPath(int) const
+{
+    return NULL;
+}
+
+int MegaSyncFileStateList::getState(int) const
+{
+    return MegaApi::STATE_NONE;
+}
+
 #endif
 
 
@@ -6695,6 +6845,156 @@ MegaNodeList *MegaChildrenLists::getFolderList()
     return NULL;
 }
 
+MegaNodeInfoList::~MegaNodeInfoList()
+{
+
+}
+
+MegaNodeInfoList *MegaNodeInfoList::copy() const
+{
+    return NULL;
+}
+
+int MegaNodeInfoList::size() const
+{
+    return 0;
+}
+
+MegaHandle MegaNodeInfoList::getHandle(int) const
+{
+    return INVALID_HANDLE;
+}
+
+MegaHandle MegaNodeInfoList::getParentHandle(int) const
+{
+    return INVALID_HANDLE;
+}
+
+int MegaNodeInfoList::getType(int) const
+{
+    return MegaNode::TYPE_UNKNOWN;
+}
+
+const char *MegaNodeInfoList::getName(int) const
+{
+    return NULL;
+}
+
+int64_t MegaNodeInfoList::getSize(int) const
+{
+    return -1;
+}
+
+int64_t MegaNodeInfoList::getCreationTime(int) const
+{
+    return -1;
+}
+
+int64_t MegaNodeInfoList::getModificationTime(int) const
+{
+    return -1;
+}
+
+int MegaNodeInfoList::getLabel(int) const
+{
+    return MegaNode::NODE_LBL_UNKNOWN;
+}
+
+bool MegaNodeInfoList::isFavourite(int) const
+{
+    return false;
+}
+
+bool MegaNodeInfoList::hasThumbnail(int) const
+{
+    return false;
+}
+
+bool MegaNodeInfoList::hasPreview(int) const
+{
+    return false;
+}
+
+MegaNodeChangeList::~MegaNodeChangeList()
+{
+
+}
+
+MegaNodeChangeList *MegaNodeChangeList::copy() const
+{
+    return NULL;
+}
+
+int MegaNodeChangeList::size() const
+{
+    return 0;
+}
+
+MegaHandle MegaNodeChangeList::getHandle(int) const
+{
+    return INVALID_HANDLE;
+}
+
+MegaHandle MegaNodeChangeList::getParentHandle(int) const
+{
+    return INVALID_HANDLE;
+}
+
+int MegaNodeChangeList::getChanges(int) const
+{
+    return 0;
+}
+
+int MegaNodeChangeList::getType(int) const
+{
+    return MegaNode::TYPE_UNKNOWN;
+}
+
+const char *MegaNodeChangeList::getName(int) const
+{
+    return NULL;
+}
+
+int64_t MegaNodeChangeList::getSize(int) const
+{
+    return -1;
+}
+
+int64_t MegaNodeChangeList::getModificationTime(int) const
+{
+    return -1;
+}
+
+bool MegaNodeChangeList::isLast() const
+{
+    return true;
+}
+
+MegaChildrenPage::~MegaChildrenPage()
+{
+
+}
+
+MegaChildrenPage *MegaChildrenPage::copy() const
+{
+    return NULL;
+}
+
+MegaNodeList *MegaChildrenPage::getNodes() const
+{
+    return NULL;
+}
+
+const char *MegaChildrenPage::getNextCursor() const
+{
+    return NULL;
+}
+
+int MegaChildrenPage::getTotalSize() const
+{
+    return 0;
+}
+
 MegaAchievementsDetails::~MegaAchievementsDetails()
 {
 
@@ -225,6 +225,57 @@ MegaNodePrivate::MegaNodePrivate(MegaNode *node)
     }
 }
 
+// MegaNode::CHANGE_TYPE_* bit field of the changes of a node
+static int nodeChanges(const Node *node)
+{
+    int changed = 0;
+    if(node->changed.attrs)
+    {
+        changed |= MegaNode::CHANGE_TYPE_ATTRIBUTES;
+    }
+    if(node->changed.ctime)
+    {
+        changed |= MegaNode::CHANGE_TYPE_TIMESTAMP;
+    }
+    if(node->changed.fileattrstring)
+    {
+        changed |= MegaNode::CHANGE_TYPE_FILE_ATTRIBUTES;
+    }
+    if(node->changed.inshare)
+    {
+        changed |= MegaNode::CHANGE_TYPE_INSHARE;
+    }
+    if(node->changed.outshares)
+    {
+        changed |= MegaNode::CHANGE_TYPE_OUTSHARE;
+    }
+    if(node->changed.pendingshares)
+    {
+        changed |= MegaNode::CHANGE_TYPE_PENDINGSHARE;
+    }
+    if(node->changed.owner)
+    {
+        changed |= MegaNode::CHANGE_TYPE_OWNER;
+    }
+    if(node->changed.parent)
+    {
+        changed |= MegaNode::CHANGE_TYPE_PARENT;
+    }
+    if(node->changed.removed)
+    {
+        changed |= MegaNode::CHANGE_TYPE_REMOVED;
+    }
+    if(node->changed.publiclink)
+    {
+        changed |= MegaNode::CHANGE_TYPE_PUBLIC_LINK;
+    }
+    if(node->changed.newnode)
+    {
+        changed |= MegaNode::CHANGE_TYPE_NEW;
+    }
+    return changed;
+}
+
 MegaNodePrivate::MegaNodePrivate(Node *node)
 : MegaNode()
 {
@@ -418,51 +469,7 @@ MegaNodePrivate::MegaNodePrivate(Node *node)
     this->fileattrstring = node->fileattrstring;
     this->nodekey = node->nodekeyUnchecked();
 
-    this->changed = 0;
-    if(node->changed.attrs)
-    {
-        this->changed |= MegaNode::CHANGE_TYPE_ATTRIBUTES;
-    }
-    if(node->changed.ctime)
-    {
-        this->changed |= MegaNode::CHANGE_TYPE_TIMESTAMP;
-    }
-    if(node->changed.fileattrstring)
-    {
-        this->changed |= MegaNode::CHANGE_TYPE_FILE_ATTRIBUTES;
-    }
-    if(node->changed.inshare)
-    {
-        this->changed |= MegaNode::CHANGE_TYPE_INSHARE;
-    }
-    if(node->changed.outshares)
-    {
-        this->changed |= MegaNode::CHANGE_TYPE_OUTSHARE;
-    }
-    if(node->changed.pendingshares)
-    {
-        this->changed |= MegaNode::CHANGE_TYPE_PENDINGSHARE;
-    }
-    if(node->changed.owner)
-    {
-        this->changed |= MegaNode::CHANGE_TYPE_OWNER;
-    }
-    if(node->changed.parent)
-    {
-        this->changed |= MegaNode::CHANGE_TYPE_PARENT;
-    }
-    if(node->changed.removed)
-    {
-        this->changed |= MegaNode::CHANGE_TYPE_REMOVED;
-    }
-    if(node->changed.publiclink)
-    {
-        this->changed |= MegaNode::CHANGE_TYPE_PUBLIC_LINK;
-    }
-    if(node->changed.newnode)
-    {
-        this->changed |= MegaNode::CHANGE_TYPE_NEW;
-    }
+    this->changed = nodeChanges(node);
 
     this->thumbnailAvailable = (node->hasfileattribute(0) != 0);
     this->previewAvailable = (node->hasfileattribute(1) != 0);
@@ -1173,110 +1180,19 @@ byte *EncryptFilePieceByChunks::nextbuffer(unsigned bufsize)
 
 #ifdef ENABLE_SYNC
 
-bool WildcardMatch(const char *pszString, const char *pszMatch)
-//  cf. http://www.planet-source-code.com/vb/scripts/ShowCode.asp?txtCodeId=1680&lngWId=3
+bool MegaApiImpl::is_syncable(Sync *sync, const char *, const LocalPath& localpath)
 {
-    const char *cp = nullptr;
-    const char *mp = nullptr;
-
-    while ((*pszString) && (*pszMatch != '*'))
-    {
-        if ((*pszMatch != *pszString) && (*pszMatch != '?'))
-        {
-            return false;
-        }
-        pszMatch++;
-        pszString++;
-    }
-
-    while (*pszString)
-    {
-        if (*pszMatch == '*')
-        {
-            if (!*++pszMatch)
-            {
-                return true;
-            }
-            mp = pszMatch;
-            cp = pszString + 1;
-        }
-        else if ((*pszMatch == *pszString) || (*pszMatch == '?'))
-        {
-            pszMatch++;
-            pszString++;
-        }
-        else
-        {
-            pszMatch = mp;
-            pszString = cp++;
-        }
-    }
-    while (*pszMatch == '*')
-    {
-        pszMatch++;
-    }
-    return !*pszMatch;
+    return !syncExclusions.excluded(sync->localroot->localname, localpath, *fsAccess);
 }
 
-bool MegaApiImpl::is_syncable(Sync *sync, const char *, const LocalPath& localpath)
+void MegaApiImpl::updateSyncExclusions()
 {
-    // Is this path excluded by any path filters?
-    if (!excludedPaths.empty())
-    {
-        // Translate current path into something we can match.
-        auto temp = localpath.toPath(*fsAccess);
+    vector<string> names = excludedNames;
 
-        // Is this path excluded by any path filters?
-        for (const auto& xpath : excludedPaths)
-        {
-            auto xp = LocalPath::fromPath(xpath, *fsAccess);
+    // Skip these system files on OS X.
+    names.push_back("Icon\x0d");
 
-            if (xp.isContainingPathOf(localpath))
-            {
-                return false;
-            }
-
-            if (WildcardMatch(temp.c_str(), xpath.c_str()))
-            {
-                return false;
-            }
-        }
-    }
-
-    // Check whether any path components are excluded.
-    auto path = localpath;
-
-    // Convenience.
-    const auto& root = sync->localroot->localname;
-
-    while (root.isContainingPathOf(path) && path != root)
-    {
-        // Where does this component's name start?
-        auto nameIndex = path.getLeafnameByteIndex(*fsAccess);
-
-        // Extract component's name.
-        auto name = path.subpathFrom(nameIndex).toPath(*fsAccess);
-
-        // Skip these system files on OS X.
-        if (name == "Icon\x0d")
-        {
-            return false;
-        }
-
-        // Is this component's name excluded by any filename filters?
-        for (const auto& xname : excludedNames)
-        {
-            if (WildcardMatch(name.c_str(), xname.c_str()))
-            {
-                return false;
-            }
-        }
-
-        // Climb to the next component.
-        path.truncate(nameIndex - 1);
-    }
-
-    return true;
+    syncExclusions.set(names, excludedPaths, *fsAccess);
 }
 
 bool MegaApiImpl::is_syncable(long long size)
@@ -2326,11 +2242,13 @@ MegaTransferPrivate::MegaTransferPrivate(int type, MegaTransferListener *listene
     this->startFirst = false;
     this->backupTransfer = false;
     this->foreignOverquota = false;
+    this->batchItem = false;
     this->folderTransferTag = 0;
     this->appData = NULL;
     this->state = STATE_NONE;
     this->priority = 0;
     this->meanSpeed = 0;
+    this->timeToFirstByte = -1;
     this->notificationNumber = 0;
 }
 
@@ -2364,6 +2282,7 @@ MegaTransferPrivate::MegaTransferPrivate(const MegaTransferPrivate *transfer)
     this->setFileName(transfer->getFileName());
     this->setSpeed(transfer->getSpeed());
     this->setMeanSpeed(transfer->getMeanSpeed());
+    this->setTimeToFirstByte(transfer->getTimeToFirstByte());
     this->setDeltaSize(transfer->getDeltaSize());
     this->setUpdateTime(transfer->getUpdateTime());
     this->setPublicNode(transfer->getPublicNode());
@@ -2375,6 +2294,7 @@ MegaTransferPrivate::MegaTransferPrivate(const MegaTransferPrivate *transfer)
     this->setBackupTransfer(transfer->isBackupTransfer());
     this->setForeignOverquota(transfer->isForeignOverquota());
     this->setForceNewUpload(transfer->isForceNewUpload());
+    this->setBatchItem(transfer->isBatchItem());
     this->setLastError(transfer->lastError.get());
     this->setFolderTransferTag(transfer->getFolderTransferTag());
     this->setAppData(transfer->getAppData());
@@ -2411,6 +2331,11 @@ long long MegaTransferPrivate::getMeanSpeed() const
     return meanSpeed;
 }
 
+long long MegaTransferPrivate::getTimeToFirstByte() const
+{
+    return timeToFirstByte;
+}
+
 long long MegaTransferPrivate::getDeltaSize() const
 {
     return deltaSize;
@@ -2824,6 +2749,11 @@ void MegaTransferPrivate::setMeanSpeed(long long meanSpeed)
     this->meanSpeed = meanSpeed;
 }
 
+void MegaTransferPrivate::setTimeToFirstByte(long long ttfb)
+{
+    this->timeToFirstByte = ttfb;
+}
+
 void MegaTransferPrivate::setDeltaSize(long long deltaSize)
 {
     this->deltaSize = deltaSize;
@@ -2966,6 +2896,26 @@ bool MegaTransferPrivate::getDoNotStopSubTransfers() const
     return mDoNotStopSubTransfers;
 }
 
+void MegaTransferPrivate::setBatch(shared_ptr<TransferBatch> batch)
+{
+    mBatch = move(batch);
+}
+
+const shared_ptr<TransferBatch>& MegaTransferPrivate::getBatch() const
+{
+    return mBatch;
+}
+
+void MegaTransferPrivate::setBatchItem(bool batchItem)
+{
+    this->batchItem = batchItem;
+}
+
+bool MegaTransferPrivate::isBatchItem() const
+{
+    return batchItem;
+}
+
 void MegaTransferPrivate::setPath(const char* path)
 {
     if(this->path) delete [] this->path;
@@ -3297,6 +3247,7 @@ MegaRequestPrivate::MegaRequestPrivate(int type, MegaRequestListener *listener)
     folderInfo = NULL;
     settings = NULL;
     backgroundMediaUpload = NULL;
+    cancelToken = NULL;
 }
 
 MegaRequestPrivate::MegaRequestPrivate(MegaRequestPrivate *request)
@@ -3370,6 +3321,8 @@ MegaRequestPrivate::MegaRequestPrivate(MegaRequestPrivate *request)
     this->backgroundMediaUpload = NULL;
     this->mBannerList.reset(request->mBannerList ? request->mBannerList->copy() : nullptr);
     this->mHandleList.reset(request->mHandleList ? request->mHandleList->copy() : nullptr);
+    this->mNodeList.reset(request->mNodeList ? request->mNodeList->copy() : nullptr);
+    this->cancelToken = NULL;
 }
 
 AccountDetails *MegaRequestPrivate::getAccountDetails() const
@@ -3534,6 +3487,28 @@ void MegaRequestPrivate::setMegaHandleList(const vector<handle> &handles)
     mHandleList.reset(new MegaHandleListPrivate(handles));
 }
 
+MegaNodeList* MegaRequestPrivate::getMegaNodeList() const
+{
+    return mNodeList.get();
+}
+
+void MegaRequestPrivate::setMegaNodeList(unique_ptr<MegaNodeList> nodeList)
+{
+    mNodeList = std::move(nodeList);
+}
+
+MegaCancelToken *MegaRequestPrivate::getCancelToken() const
+{
+    // non-owned pointer
+    return cancelToken;
+}
+
+void MegaRequestPrivate::setCancelToken(MegaCancelToken *cancelToken)
+{
+    // non-owned pointer
+    this->cancelToken = cancelToken;
+}
+
 MegaScheduledCopyListener *MegaRequestPrivate::getBackupListener() const
 {
     return backupListener;
@@ -4063,6 +4038,10 @@ const char *MegaRequestPrivate::getRequestString() const
         case TYPE_LOAD_EXTERNAL_DRIVE_BACKUPS: return "LOAD_EXTERNAL_DRIVE_BACKUPS";
         case TYPE_CLOSE_EXTERNAL_DRIVE_BACKUPS: return "CLOSE_EXTERNAL_DRIVE_BACKUPS";
         case TYPE_GET_DOWNLOAD_URLS: return "GET_DOWNLOAD_URLS";
+        case TYPE_SET_TRANSFER_BANDWIDTH_CLASS: return "SET_TRANSFER_BANDWIDTH_CLASS";
+        case TYPE_SEARCH: return "SEARCH";
+        case TYPE_GET_CHILDREN: return "GET_CHILDREN";
+        case TYPE_EXPORT_NODE_TREE: return "EXPORT_NODE_TREE";
     }
     return "UNKNOWN";
 }
@@ -4405,6 +4384,16 @@ MegaNodeListPrivate::MegaNodeListPrivate(Node** newlist, int size)
         list[i] = MegaNodePrivate::fromNode(newlist[i]);
 }
 
+MegaNodeListPrivate::MegaNodeListPrivate(vector<unique_ptr<MegaNode>>&& nodes)
+{
+    list = NULL; s = static_cast<int>(nodes.size());
+    if (!s) return;
+
+    list = new MegaNode*[s];
+    for (int i = 0; i < s; i++)
+        list[i] = nodes[size_t(i)].release();
+}
+
 MegaNodeListPrivate::MegaNodeListPrivate(const MegaNodeListPrivate *nodeList, bool copyChildren)
 {
     s = nodeList->size();
@@ -5353,6 +5342,10 @@ void MegaApiImpl::init(MegaApi *api, const char *appKey, MegaGfxProcessor* proce
     fsAccess = new MegaFileSystemAccess(fseventsfd);
 #endif
 
+#ifdef ENABLE_SYNC
+    updateSyncExclusions();
+#endif
+
     dbAccess = nullptr;
     if (basePath)
     {
@@ -5412,6 +5405,9 @@ MegaApiImpl::~MegaApiImpl()
     assert(backupsMap.empty());
     assert(transferMap.empty());
 
+    // (it notifies the waiter)
+    mNodeQueries.reset();
+
     delete gfxAccess;
     delete fsAccess;
     delete waiter;
@@ -6461,6 +6457,8 @@ MegaProxy *MegaApiImpl::getAutoProxySettings()
 
 void MegaApiImpl::loop()
 {
+    mSdkThreadId = std::this_thread::get_id();
+
 #if defined(WINDOWS_PHONE)
     // Workaround to get the IP of valid DNS servers on Windows Phone/iOS
     string servers;
@@ -6486,6 +6484,10 @@ void MegaApiImpl::loop()
     {
         sdkMutex.lock();
         int r = client->preparewait();
+        if (!r)
+        {
+            waitForTransferUpdates();
+        }
         sdkMutex.unlock();
         if (!r)
         {
@@ -6505,6 +6507,8 @@ void MegaApiImpl::loop()
             }
             sendPendingRequests();
             sendPendingScRequest();
+            notifyNodeQueryResults();
+            notifyNodeTreeSnapshots();
             if (threadExit)
             {
                 break;
@@ -6512,6 +6516,7 @@ void MegaApiImpl::loop()
 
             sdkMutex.lock();
             client->exec();
+            flushTransferUpdates();
             sdkMutex.unlock();
         }
     }
@@ -7714,6 +7719,12 @@ void MegaApiImpl::abortPendingActions(error preverror)
     }
     backupsMap.clear();
 
+    // -- Node queries in progress (their requests are finished below) --
+    if (mNodeQueries)
+    {
+        mNodeQueries->discard();
+    }
+
     // -- CS Requests in progress --
     deque<MegaRequestPrivate*> requests;
     for (auto requestPair : requestMap)
@@ -7948,6 +7959,16 @@ void MegaApiImpl::moveTransferBefore(int transferTag, int prevTransferTag, MegaR
     waiter->notify();
 }
 
+void MegaApiImpl::setTransferBandwidthClass(int transferTag, int bandwidthClass, int weight, MegaRequestListener *listener)
+{
+    MegaRequestPrivate *request = new MegaRequestPrivate(MegaRequest::TYPE_SET_TRANSFER_BANDWIDTH_CLASS, listener);
+    request->setTransferTag(transferTag);
+    request->setNumber(bandwidthClass);
+    request->setParamType(weight);
+    requestQueue.push(request);
+    waiter->notify();
+}
+
 bool MegaApiImpl::areTransfersPaused(int direction)
 {
     if(direction != MegaTransfer::TYPE_DOWNLOAD && direction != MegaTransfer::TYPE_UPLOAD)
@@ -7984,6 +8005,32 @@ void MegaApiImpl::setMaxConnections(int direction, int connections, MegaRequestL
     waiter->notify();
 }
 
+void MegaApiImpl::setTransferUpdatePolicy(int minIntervalMs, long long minBytes, bool batched)
+{
+    SdkMutexGuard g(sdkMutex);
+    mTransferUpdateInterval = minIntervalMs > 0 ? dstime((minIntervalMs + 99) / 100) : 0;
+    mTransferUpdateBytes = minBytes > 0 ? minBytes : 0;
+    mTransferUpdatesBatched = batched;
+
+    // the suppressed updates are reported according to the new policy
+    waiter->notify();
+}
+
+char *MegaApiImpl::getTransferUpdateStats()
+{
+    SdkMutexGuard g(sdkMutex);
+
+    JSONWriter w;
+    w.beginobject();
+    w.arg("updates", m_off_t(mTransferUpdates));
+    w.arg("suppressed", m_off_t(mTransferUpdatesSuppressed));
+    w.arg("notified", m_off_t(mTransferUpdatesNotified));
+    w.arg("batches", m_off_t(mTransferUpdateBatches));
+    w.endobject();
+
+    return MegaApi::strdup(w.getstring().c_str());
+}
+
 void MegaApiImpl::setDownloadMethod(int method)
 {
     switch(method)
@@ -8056,6 +8103,23 @@ bool MegaApiImpl::setMaxUploadSpeed(m_off_t bpslimit)
     return result;
 }
 
+bool MegaApiImpl::setBandwidthClassLimits(int direction, int bandwidthClass, m_off_t minBps, m_off_t maxBps)
+{
+    if ((direction != MegaTransfer::TYPE_DOWNLOAD && direction != MegaTransfer::TYPE_UPLOAD)
+            || bandwidthClass < MegaTransfer::BANDWIDTH_CLASS_ALL
+            || bandwidthClass > MegaTransfer::BANDWIDTH_CLASS_STREAMING)
+    {
+        return false;
+    }
+
+    int bwclass = (bandwidthClass == MegaTransfer::BANDWIDTH_CLASS_ALL) ? NUM_TRANSFERCLASSES : bandwidthClass;
+
+    SdkMutexGuard g(sdkMutex);
+    client->setbandwidthlimits(direction == MegaTransfer::TYPE_DOWNLOAD ? GET : PUT, bwclass, minBps, maxBps);
+    waiter->notify();
+    return true;
+}
+
 int MegaApiImpl::getMaxDownloadSpeed()
 {
     return int(client->getmaxdownloadspeed());
@@ -8432,7 +8496,7 @@ void MegaApiImpl::startTimer( int64_t period, MegaRequestListener *listener)
     waiter->notify();
 }
 
-void MegaApiImpl::startUpload(bool startFirst, const char *localPath, MegaNode *parent, const char *fileName, const char *targetUser, int64_t mtime, int folderTransferTag, bool isBackup, const char *appData, bool isSourceFileTemporary, bool forceNewUpload, FileSystemType fsType, MegaTransferListener *listener)
+MegaTransferPrivate* MegaApiImpl::createUploadTransfer(bool startFirst, const char *localPath, MegaHandle parentHandle, const char *fileName, const char *targetUser, int64_t mtime, int folderTransferTag, bool isBackup, const char *appData, bool isSourceFileTemporary, bool forceNewUpload, FileSystemType fsType, MegaTransferListener *listener)
 {
     if (fsType == FS_UNKNOWN && localPath)
     {
@@ -8450,9 +8514,9 @@ void MegaApiImpl::startUpload(bool startFirst, const char *localPath, MegaNode *
         transfer->setPath(path.data());
     }
 
-    if(parent)
+    if (parentHandle != INVALID_HANDLE)
     {
-        transfer->setParentHandle(parent->getHandle());
+        transfer->setParentHandle(parentHandle);
     }
 
     if (targetUser)
@@ -8485,7 +8549,12 @@ void MegaApiImpl::startUpload(bool startFirst, const char *localPath, MegaNode *
     }
 
     transfer->setForceNewUpload(forceNewUpload);
+    return transfer;
+}
 
+void MegaApiImpl::startUpload(bool startFirst, const char *localPath, MegaNode *parent, const char *fileName, const char *targetUser, int64_t mtime, int folderTransferTag, bool isBackup, const char *appData, bool isSourceFileTemporary, bool forceNewUpload, FileSystemType fsType, MegaTransferListener *listener)
+{
+    MegaTransferPrivate* transfer = createUploadTransfer(startFirst, localPath, parent ? parent->getHandle() : INVALID_HANDLE, fileName, targetUser, mtime, folderTransferTag, isBackup, appData, isSourceFileTemporary, forceNewUpload, fsType, listener);
     transferQueue.push(transfer);
     waiter->notify();
 }
@@ -8507,7 +8576,7 @@ void MegaApiImpl::startUploadForSupport(const char *localPath, bool isSourceTemp
     return startUpload(true, localPath, nullptr, nullptr, "pGTOqu7_Fek", -1, 0, false, nullptr, isSourceTemporary, false, fsType, listener);
 }
 
-void MegaApiImpl::startDownload(bool startFirst, MegaNode *node, const char* localPath, int folderTransferTag, const char *appData, MegaTransferListener *listener)
+MegaTransferPrivate* MegaApiImpl::createDownloadTransfer(bool startFirst, MegaNode *node, const char* localPath, int folderTransferTag, const char *appData, MegaTransferListener *listener)
 {
     MegaTransferPrivate* transfer = new MegaTransferPrivate(MegaTransfer::TYPE_DOWNLOAD, listener);
 
@@ -8549,6 +8618,12 @@ void MegaApiImpl::startDownload(bool startFirst, MegaNode *node, const char* loc
         transfer->setFolderTransferTag(folderTransferTag);
     }
 
+    return transfer;
+}
+
+void MegaApiImpl::startDownload(bool startFirst, MegaNode *node, const char* localPath, int folderTransferTag, const char *appData, MegaTransferListener *listener)
+{
+    MegaTransferPrivate* transfer = createDownloadTransfer(startFirst, node, localPath, folderTransferTag, appData, listener);
     transferQueue.push(transfer);
     waiter->notify();
 }
@@ -8556,6 +8631,87 @@ void MegaApiImpl::startDownload(bool startFirst, MegaNode *node, const char* loc
 void MegaApiImpl::startDownload(MegaNode *node, const char* localFolder, MegaTransferListener *listener)
 { startDownload(false, node, localFolder, 0, NULL, listener); }
 
+void MegaApiImpl::startUploads(MegaStringList *localPaths, MegaHandleList *parents, MegaTransferListener *listener)
+{
+    auto batch = std::make_shared<TransferBatch>();
+    size_t paths = localPaths ? size_t(localPaths->size()) : 0;
+    size_t handles = parents ? size_t(parents->size()) : 0;
+
+    // either one parent for all the files or one for each of them
+    if (paths && (handles == 1 || handles == paths))
+    {
+        batch->localPaths.reserve(paths);
+        for (size_t i = 0; i < paths; i++)
+        {
+            const char* path = localPaths->get(int(i));
+            batch->localPaths.push_back(path ? path : "");
+        }
+
+        batch->handles.reserve(handles);
+        for (size_t i = 0; i < handles; i++)
+        {
+            batch->handles.push_back(parents->get(unsigned(i)));
+        }
+    }
+
+    MegaTransferPrivate* transfer = new MegaTransferPrivate(MegaTransfer::TYPE_UPLOAD, listener);
+    transfer->setFileName("");
+    if (batch->handles.size() == 1)
+    {
+        transfer->setParentHandle(batch->handles[0]);
+    }
+    transfer->setMaxRetries(maxRetries);
+    transfer->setBatch(std::move(batch));
+
+    transferQueue.push(transfer);
+    waiter->notify();
+}
+
+void MegaApiImpl::startDownloads(MegaHandleList *nodes, MegaStringList *localPaths, MegaTransferListener *listener)
+{
+    auto batch = std::make_shared<TransferBatch>();
+    size_t handles = nodes ? size_t(nodes->size()) : 0;
+    size_t paths = localPaths ? size_t(localPaths->size()) : 0;
+
+    // either one local path for all the nodes or one for each of them
+    if (handles && (paths == 1 || paths == handles))
+    {
+        batch->handles.reserve(handles);
+        for (size_t i = 0; i < handles; i++)
+        {
+            batch->handles.push_back(nodes->get(unsigned(i)));
+        }
+
+        batch->localPaths.reserve(paths);
+        for (size_t i = 0; i < paths; i++)
+        {
+            const char* path = localPaths->get(int(i));
+            batch->localPaths.push_back(path ? path : "");
+        }
+    }
+
+    MegaTransferPrivate* transfer = new MegaTransferPrivate(MegaTransfer::TYPE_DOWNLOAD, listener);
+    transfer->setFileName("");
+    if (batch->localPaths.size() == 1)
+    {
+        transfer->setParentPath(batch->localPaths[0].c_str());
+    }
+    transfer->setMaxRetries(maxRetries);
+    transfer->setBatch(std::move(batch));
+
+    transferQueue.push(transfer);
+    waiter->notify();
+}
+
+void MegaApiImpl::startTransfers(vector<MegaTransferPrivate*>& transfers)
+{
+    if (!transfers.empty())
+    {
+        transferQueue.push(transfers);
+        waiter->notify();
+    }
+}
+
 void MegaApiImpl::cancelTransfer(MegaTransfer *t, MegaRequestListener *listener)
 {
     MegaRequestPrivate *request = new MegaRequestPrivate(MegaRequest::TYPE_CANCEL_TRANSFER, listener);
@@ -9006,6 +9162,7 @@ void MegaApiImpl::setExcludedNames(vector<string> *excludedNames)
     if (!excludedNames)
     {
         this->excludedNames.clear();
+        updateSyncExclusions();
         sdkMutex.unlock();
         return;
     }
@@ -9025,6 +9182,7 @@ void MegaApiImpl::setExcludedNames(vector<string> *excludedNames)
             LOG_warn << "Invalid excluded name: " << excludedNames->at(i);
         }
     }
+    updateSyncExclusions();
     sdkMutex.unlock();
 }
 
@@ -9034,6 +9192,7 @@ void MegaApiImpl::setExcludedPaths(vector<string> *excludedPaths)
     if (!excludedPaths)
     {
         this->excludedPaths.clear();
+        updateSyncExclusions();
         sdkMutex.unlock();
         return;
     }
@@ -9059,6 +9218,7 @@ void MegaApiImpl::setExcludedPaths(vector<string> *excludedPaths)
             LOG_warn << "Invalid excluded path: " << excludedPaths->at(i);
         }
     }
+    updateSyncExclusions();
     sdkMutex.unlock();
 }
 
@@ -9095,6 +9255,70 @@ long long MegaApiImpl::getNumLocalNodes()
     return client->totalLocalNodes;
 }
 
+char *MegaApiImpl::getSyncFingerprintCacheStats()
+{
+    SdkMutexGuard g(sdkMutex);
+
+    LocalFingerprintCache::Stats total;
+    JSONWriter syncs;
+
+    client->syncs.forEachRunningSync([&](Sync* sync)
+    {
+        LocalFingerprintCache::Stats stats = sync->fingerprintcache->stats();
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.entries += stats.entries;
+
+        syncs.beginobject();
+        syncs.arg("id", sync->getConfig().getBackupId(), sizeof(handle));
+        syncs.arg("hits", m_off_t(stats.hits));
+        syncs.arg("misses", m_off_t(stats.misses));
+        syncs.arg("entries", m_off_t(stats.entries));
+        syncs.endobject();
+    });
+
+    JSONWriter w;
+    w.beginobject();
+    w.arg("hits", m_off_t(total.hits));
+    w.arg("misses", m_off_t(total.misses));
+    w.arg("entries", m_off_t(total.entries));
+    w.beginarray("syncs");
+    w.appendraw(syncs.getstring().c_str());
+    w.endarray();
+    w.endobject();
+
+    return MegaApi::strdup(w.getstring().c_str());
+}
+
+void MegaApiImpl::setSyncStateNotificationsFoldersOnly(bool foldersOnly)
+{
+    SdkMutexGuard g(sdkMutex);
+    client->syncs.mTreeStateFoldersOnly = foldersOnly;
+}
+
+void MegaApiImpl::setSyncStateNotificationsBatched(bool batched)
+{
+    SdkMutexGuard g(sdkMutex);
+    client->syncs.mTreeStateBatched = batched;
+}
+
+char *MegaApiImpl::getSyncStateNotificationStats()
+{
+    SdkMutexGuard g(sdkMutex);
+
+    uint64_t changes = client->syncs.mTreeStateChanges;
+    uint64_t notified = client->syncs.mTreeStateNotifications;
+
+    JSONWriter w;
+    w.beginobject();
+    w.arg("changes", m_off_t(changes));
+    w.arg("notified", m_off_t(notified));
+    w.arg("avoided", m_off_t(changes > notified ? changes - notified : 0));
+    w.endobject();
+
+    return MegaApi::strdup(w.getstring().c_str());
+}
+
 bool MegaApiImpl::isSyncable(const char *path, long long size)
 {
     if (!path)
@@ -11546,6 +11770,24 @@ bool MegaApiImpl::areGfxFeaturesDisabled()
     return !client->gfx || client->gfxdisabled;
 }
 
+void MegaApiImpl::setStreamingActionPackets(bool enable)
+{
+    SdkMutexGuard g(sdkMutex);
+    client->scstreaming = enable;
+}
+
+char *MegaApiImpl::getNetworkTelemetry()
+{
+    SdkMutexGuard g(sdkMutex);
+    return MegaApi::strdup(httpio->telemetry.tojson().c_str());
+}
+
+void MegaApiImpl::resetNetworkTelemetry()
+{
+    SdkMutexGuard g(sdkMutex);
+    httpio->telemetry.reset();
+}
+
 const char *MegaApiImpl::getUserAgent()
 {
     return client->useragent.c_str();
@@ -12532,6 +12774,23 @@ void MegaApiImpl::transfer_update(Transfer *t)
             return;
         }
 
+        mTransferUpdates++;
+
+        if ((mTransferUpdateInterval || mTransferUpdateBytes)
+                && t->slot
+                && transfer->getState() == t->state
+                && transfer->getPriority() == t->priority
+                && t->slot->progressreported != t->size
+                && (!mTransferUpdateInterval || int64_t(Waiter::ds) - transfer->getUpdateTime() < int64_t(mTransferUpdateInterval))
+                && (!mTransferUpdateBytes || t->slot->progressreported - transfer->getTransferredBytes() < mTransferUpdateBytes))
+        {
+            // progress within the limits of the update policy, reported later by flushTransferUpdates()
+            // unless the transfer makes more progress, changes or finishes before
+            mSuppressedTransferUpdates[transfer->getTag()] = { t->slot->progressreported, t->slot->speed, t->slot->meanSpeed };
+            mTransferUpdatesSuppressed++;
+            continue;
+        }
+
         processTransferUpdate(t, transfer);
     }
 }
@@ -13349,6 +13608,15 @@ void MegaApiImpl::syncupdate_treestate(const SyncConfig &config, const LocalPath
     }
 }
 
+void MegaApiImpl::syncupdate_treestates(const SyncConfig &config, const vector<pair<LocalPath, treestate_t>>& changes)
+{
+    if (auto megaSync = cachedMegaSyncPrivateByBackupId(config))
+    {
+        MegaSyncFileStateListPrivate states(changes);
+        fireOnFileSyncStatesChanged(megaSync, &states);
+    }
+}
+
 bool MegaApiImpl::sync_syncable(Sync *sync, const char *name, LocalPath& localpath, Node *node)
 {
     if (!sync || (node->type == FILENODE && !is_syncable(node->size)))
@@ -13356,10 +13624,7 @@ bool MegaApiImpl::sync_syncable(Sync *sync, const char *name, LocalPath& localpa
         return false;
     }
 
-    sdkMutex.unlock();
-    bool result = is_syncable(sync, name, localpath);
-    sdkMutex.lock();
-    return result;
+    return is_syncable(sync, name, localpath);
 }
 
 bool MegaApiImpl::sync_syncable(Sync *sync, const char *name, LocalPath& localpath)
@@ -13377,10 +13642,27 @@ bool MegaApiImpl::sync_syncable(Sync *sync, const char *name, LocalPath& localpa
         }
     }
 
-    sdkMutex.unlock();
-    bool result = is_syncable(sync, name, localpath);
-    sdkMutex.lock();
-    return result;
+    return is_syncable(sync, name, localpath);
+}
+
+bool MegaApiImpl::sync_syncable(Sync *sync, const char *name, LocalPath& localpath, nodetype_t type, m_off_t size)
+{
+    if (type == TYPE_UNKNOWN)
+    {
+        return sync_syncable(sync, name, localpath);
+    }
+
+    if (!sync || (type == FILENODE && !is_syncable(size)))
+    {
+        return false;
+    }
+
+    return is_syncable(sync, name, localpath);
+}
+
+bool MegaApiImpl::sync_syncable_needs_size()
+{
+    return syncLowerSizeLimit || syncUpperSizeLimit;
 }
 
 void MegaApiImpl::sync_removed(const SyncConfig& config)
@@ -13581,6 +13863,16 @@ void MegaApiImpl::unlinkversions_result(error e)
 
 void MegaApiImpl::fetchnodes_result(const Error &e)
 {
+    // (the nodes loaded from the local cache are not notified)
+    if (e == API_OK && (mNodeReplicaEnabled || mNodeQueries))
+    {
+        if (mNodeQueries)
+        {
+            mNodeQueries->interrupt();
+        }
+        mNodeReplica.rebuild(*client);
+    }
+
     MegaRequestPrivate* request = NULL;
     if (!client->restag)
     {
@@ -14253,6 +14545,14 @@ void MegaApiImpl::copysession_result(string *session, error e)
 
 void MegaApiImpl::clearing()
 {
+    // (otherwise the clear waits for the traversal of a running query)
+    if (mNodeQueries)
+    {
+        mNodeQueries->interrupt();
+    }
+    mNodeReplica.clear();
+    mSortedChildren.clear();
+
 #ifdef ENABLE_SYNC
     mCachedMegaSyncPrivate.reset();
 #endif
@@ -14629,6 +14929,7 @@ void MegaApiImpl::logout_result(error e)
         mTimezones = NULL;
 
 #ifdef ENABLE_SYNC
+        updateSyncExclusions();
         mCachedMegaSyncPrivate.reset();
 #endif
     }
@@ -14851,6 +15152,33 @@ void MegaApiImpl::nodes_updated(Node** n, int count)
         return;
     }
 
+    mSortedChildren.invalidate(n, count);
+
+    // before the listeners, so that they find the changes if they query them
+    if (mNodeReplicaEnabled || mNodeQueries)
+    {
+        if (n)
+        {
+            mNodeReplica.update(n, count);
+        }
+        else
+        {
+            mNodeReplica.rebuild(*client);
+        }
+    }
+
+    if (n && mNodeChangeNotifications)
+    {
+        // compact lists of bounded size instead of a MegaNode object per node
+        for (size_t i = 0; i < size_t(count); i += mNodeChangeBatchSize)
+        {
+            size_t batch = std::min(mNodeChangeBatchSize, size_t(count) - i);
+            MegaNodeChangeListPrivate changes(n + i, batch, mNodeChangeFields, i + batch == size_t(count));
+            fireOnNodeChanges(&changes);
+        }
+        return;
+    }
+
     MegaNodeList *nodeList = NULL;
     if (n != NULL)
     {
@@ -16308,14 +16636,17 @@ void MegaApiImpl::fireOnTransferStart(MegaTransferPrivate *transfer)
     notificationNumber++;
     transfer->setNotificationNumber(notificationNumber);
 
-    for(set<MegaTransferListener *>::iterator it = transferListeners.begin(); it != transferListeners.end() ;)
+    if (!transfer->isBatchItem())
     {
-        (*it++)->onTransferStart(api, transfer);
-    }
+        for(set<MegaTransferListener *>::iterator it = transferListeners.begin(); it != transferListeners.end() ;)
+        {
+            (*it++)->onTransferStart(api, transfer);
+        }
 
-    for(set<MegaListener *>::iterator it = listeners.begin(); it != listeners.end() ;)
-    {
-        (*it++)->onTransferStart(api, transfer);
+        for(set<MegaListener *>::iterator it = listeners.begin(); it != listeners.end() ;)
+        {
+            (*it++)->onTransferStart(api, transfer);
+        }
     }
 
     MegaTransferListener* listener = transfer->getListener();
@@ -16350,14 +16681,17 @@ void MegaApiImpl::fireOnTransferFinish(MegaTransferPrivate *transfer, unique_ptr
         LOG_info << "Transfer (" << transfer->getTransferString() << ") finished. File: " << transfer->getFileName();
     }
 
-    for(set<MegaTransferListener *>::iterator it = transferListeners.begin(); it != transferListeners.end() ;)
+    if (!transfer->isBatchItem())
     {
-        (*it++)->onTransferFinish(api, transfer, e.get());
-    }
+        for(set<MegaTransferListener *>::iterator it = transferListeners.begin(); it != transferListeners.end() ;)
+        {
+            (*it++)->onTransferFinish(api, transfer, e.get());
+        }
 
-    for(set<MegaListener *>::iterator it = listeners.begin(); it != listeners.end() ;)
-    {
-        (*it++)->onTransferFinish(api, transfer, e.get());
+        for(set<MegaListener *>::iterator it = listeners.begin(); it != listeners.end() ;)
+        {
+            (*it++)->onTransferFinish(api, transfer, e.get());
+        }
     }
 
     MegaTransferListener* listener = transfer->getListener();
@@ -16386,14 +16720,17 @@ void MegaApiImpl::fireOnTransferTemporaryError(MegaTransferPrivate *transfer, un
 
     transfer->setNumRetry(transfer->getNumRetry() + 1);
 
-    for(set<MegaTransferListener *>::iterator it = transferListeners.begin(); it != transferListeners.end() ;)
+    if (!transfer->isBatchItem())
     {
-        (*it++)->onTransferTemporaryError(api, transfer, e.get());
-    }
+        for(set<MegaTransferListener *>::iterator it = transferListeners.begin(); it != transferListeners.end() ;)
+        {
+            (*it++)->onTransferTemporaryError(api, transfer, e.get());
+        }
 
-    for(set<MegaListener *>::iterator it = listeners.begin(); it != listeners.end() ;)
-    {
-        (*it++)->onTransferTemporaryError(api, transfer, e.get());
+        for(set<MegaListener *>::iterator it = listeners.begin(); it != listeners.end() ;)
+        {
+            (*it++)->onTransferTemporaryError(api, transfer, e.get());
+        }
     }
 
     MegaTransferListener* listener = transfer->getListener();
@@ -16416,15 +16753,28 @@ void MegaApiImpl::fireOnTransferUpdate(MegaTransferPrivate *transfer)
     activeTransfer = transfer;
     notificationNumber++;
     transfer->setNotificationNumber(notificationNumber);
+    mTransferUpdatesNotified++;
 
-    for(set<MegaTransferListener *>::iterator it = transferListeners.begin(); it != transferListeners.end() ;)
+    if (transfer->isBatchItem())
     {
-        (*it++)->onTransferUpdate(api, transfer);
+        // only the controller of the batch gets its files, below
     }
-
-    for(set<MegaListener *>::iterator it = listeners.begin(); it != listeners.end() ;)
+    else if (mTransferUpdatesBatched)
     {
-        (*it++)->onTransferUpdate(api, transfer);
+        // the global listeners get the latest state with the next fireOnTransfersUpdate()
+        mBatchedTransferUpdates.insert(transfer->getTag());
+    }
+    else
+    {
+        for(set<MegaTransferListener *>::iterator it = transferListeners.begin(); it != transferListeners.end() ;)
+        {
+            (*it++)->onTransferUpdate(api, transfer);
+        }
+
+        for(set<MegaListener *>::iterator it = listeners.begin(); it != listeners.end() ;)
+        {
+            (*it++)->onTransferUpdate(api, transfer);
+        }
     }
 
     MegaTransferListener* listener = transfer->getListener();
@@ -16436,6 +16786,38 @@ void MegaApiImpl::fireOnTransferUpdate(MegaTransferPrivate *transfer)
     activeTransfer = NULL;
 }
 
+void MegaApiImpl::fireOnTransfersUpdate()
+{
+    vector<MegaTransfer*> transfers;
+    for (int tag : mBatchedTransferUpdates)
+    {
+        // the finished ones were already reported by fireOnTransferFinish()
+        if (MegaTransferPrivate* transfer = getMegaTransferPrivate(tag))
+        {
+            transfers.push_back(transfer);
+        }
+    }
+    mBatchedTransferUpdates.clear();
+
+    if (transfers.empty())
+    {
+        return;
+    }
+
+    mTransferUpdateBatches++;
+    MegaTransferListPrivate list(transfers.data(), int(transfers.size()));
+
+    for(set<MegaTransferListener *>::iterator it = transferListeners.begin(); it != transferListeners.end() ;)
+    {
+        (*it++)->onTransfersUpdate(api, &list);
+    }
+
+    for(set<MegaListener *>::iterator it = listeners.begin(); it != listeners.end() ;)
+    {
+        (*it++)->onTransfersUpdate(api, &list);
+    }
+}
+
 bool MegaApiImpl::fireOnTransferData(MegaTransferPrivate *transfer)
 {
     activeTransfer = transfer;
@@ -16517,6 +16899,18 @@ void MegaApiImpl::fireOnNodesUpdate(MegaNodeList *nodes)
     activeNodes = NULL;
 }
 
+void MegaApiImpl::fireOnNodeChanges(MegaNodeChangeList *changes)
+{
+    for(set<MegaGlobalListener *>::iterator it = globalListeners.begin(); it != globalListeners.end() ;)
+    {
+        (*it++)->onNodeChanges(api, changes);
+    }
+    for(set<MegaListener *>::iterator it = listeners.begin(); it != listeners.end() ;)
+    {
+        (*it++)->onNodeChanges(api, changes);
+    }
+}
+
 void MegaApiImpl::fireOnAccountUpdate()
 {
     for(set<MegaGlobalListener *>::iterator it = globalListeners.begin(); it != globalListeners.end() ;)
@@ -16625,6 +17019,15 @@ void MegaApiImpl::fireOnFileSyncStateChanged(MegaSyncPrivate *sync, string *loca
     }
 }
 
+void MegaApiImpl::fireOnFileSyncStatesChanged(MegaSyncPrivate *sync, MegaSyncFileStateList *states)
+{
+    assert(sync->getBackupId() != INVALID_HANDLE);
+    for(set<MegaListener *>::iterator it = listeners.begin(); it != listeners.end() ;)
+    {
+        (*it++)->onSyncFileStatesChanged(api, sync, states);
+    }
+}
+
 #endif
 
 void MegaApiImpl::fireOnBackupStateChanged(MegaScheduledCopyController *backup)
@@ -16754,23 +17157,13 @@ void MegaApiImpl::processTransferPrepare(Transfer *t, MegaTransferPrivate *trans
 void MegaApiImpl::processTransferUpdate(Transfer *tr, MegaTransferPrivate *transfer)
 {
     dstime currentTime = Waiter::ds;
+    mSuppressedTransferUpdates.erase(transfer->getTag());
     if (tr->slot)
     {
-        m_off_t prevTransferredBytes = transfer->getTransferredBytes();
-        m_off_t deltaSize = tr->slot->progressreported - prevTransferredBytes;
-        transfer->setStartTime(currentTime);
-        transfer->setTransferredBytes(tr->slot->progressreported);
-        transfer->setDeltaSize(deltaSize);
-        transfer->setSpeed(tr->slot->speed);
-        transfer->setMeanSpeed(tr->slot->meanSpeed);
-
-        if (tr->type == GET)
+        processTransferProgress(transfer, tr->type, { tr->slot->progressreported, tr->slot->speed, tr->slot->meanSpeed });
+        if (tr->slot->ttfb >= 0)
         {
-            totalDownloadedBytes += deltaSize;
-        }
-        else
-        {
-            totalUploadedBytes += deltaSize;
+            transfer->setTimeToFirstByte(tr->slot->ttfb);
         }
     }
     else
@@ -16786,6 +17179,86 @@ void MegaApiImpl::processTransferUpdate(Transfer *tr, MegaTransferPrivate *trans
     fireOnTransferUpdate(transfer);
 }
 
+void MegaApiImpl::processTransferProgress(MegaTransferPrivate *transfer, direction_t type, const TransferProgress& progress)
+{
+    m_off_t deltaSize = progress.transferredBytes - transfer->getTransferredBytes();
+    transfer->setStartTime(Waiter::ds);
+    transfer->setTransferredBytes(progress.transferredBytes);
+    transfer->setDeltaSize(deltaSize);
+    transfer->setSpeed(progress.speed);
+    transfer->setMeanSpeed(progress.meanSpeed);
+
+    if (type == GET)
+    {
+        totalDownloadedBytes += deltaSize;
+    }
+    else
+    {
+        totalUploadedBytes += deltaSize;
+    }
+}
+
+void MegaApiImpl::waitForTransferUpdates()
+{
+    if (!mBatchedTransferUpdates.empty())
+    {
+        client->waiter->maxds = 0;
+        return;
+    }
+
+    // wake up in time to report the progress of transfers that stopped progressing
+    dstime timeout = transferUpdateTimeout();
+    for (auto& suppressed : mSuppressedTransferUpdates)
+    {
+        MegaTransferPrivate* transfer = getMegaTransferPrivate(suppressed.first);
+        dstime due = transfer ? dstime(transfer->getUpdateTime()) + timeout : Waiter::ds;
+        dstime wait = due > Waiter::ds ? due - Waiter::ds : 0;
+        if (wait < client->waiter->maxds)
+        {
+            client->waiter->maxds = wait;
+        }
+    }
+}
+
+dstime MegaApiImpl::transferUpdateTimeout() const
+{
+    if (!mTransferUpdateInterval && !mTransferUpdateBytes)
+    {
+        // no policy anymore, report what was held back right away
+        return 0;
+    }
+
+    // otherwise the progress of a stalled transfer would only be reported when it finishes
+    return mTransferUpdateInterval ? mTransferUpdateInterval : TRANSFER_UPDATE_FALLBACK_DS;
+}
+
+void MegaApiImpl::flushTransferUpdates()
+{
+    dstime timeout = transferUpdateTimeout();
+    for (auto it = mSuppressedTransferUpdates.begin(); it != mSuppressedTransferUpdates.end(); )
+    {
+        MegaTransferPrivate* transfer = getMegaTransferPrivate(it->first);
+        if (!transfer)
+        {
+            it = mSuppressedTransferUpdates.erase(it);
+            continue;
+        }
+
+        if (Waiter::ds < transfer->getUpdateTime() + timeout)
+        {
+            ++it;
+            continue;
+        }
+
+        processTransferProgress(transfer, transfer->getType() == MegaTransfer::TYPE_DOWNLOAD ? GET : PUT, it->second);
+        transfer->setUpdateTime(Waiter::ds);
+        it = mSuppressedTransferUpdates.erase(it);
+        fireOnTransferUpdate(transfer);
+    }
+
+    fireOnTransfersUpdate();
+}
+
 void MegaApiImpl::processTransferComplete(Transfer *tr, MegaTransferPrivate *transfer)
 {
     dstime currentTime = Waiter::ds;
@@ -16797,6 +17270,10 @@ void MegaApiImpl::processTransferComplete(Transfer *tr, MegaTransferPrivate *tra
     transfer->setDeltaSize(deltaSize);
     transfer->setSpeed(tr->slot ? tr->slot->speed : 0);
     transfer->setMeanSpeed(tr->slot ? tr->slot->meanSpeed : 0);
+    if (tr->slot && tr->slot->ttfb >= 0)
+    {
+        transfer->setTimeToFirstByte(tr->slot->ttfb);
+    }
 
     if (tr->type == GET)
     {
@@ -17066,6 +17543,64 @@ int naturalsorting_compare (const char *i, const char *j)
     return 0;
 }
 
+string naturalsorting_key(const char *name)
+{
+    static uint64_t maxNumber = (ULONG_MAX - 57) / 10; // as in naturalsorting_compare()
+
+    string key;
+    key.reserve(strlen(name) + 8);
+
+    // big endian, after its length in bytes, so that bigger values go after
+    auto appendNumber = [&key](uint64_t value)
+    {
+        char bytes[sizeof(value)];
+        char length = 0;
+        for (; value; value >>= 8)
+        {
+            bytes[int(length++)] = char(value & 0xFF);
+        }
+        key.push_back(length);
+        while (length)
+        {
+            key.push_back(bytes[int(--length)]);
+        }
+    };
+
+    while (*name)
+    {
+        if (isDigit(name))
+        {
+            // the same value and overflow count that naturalsorting_compare() compares
+            uint64_t number = 0;
+            unsigned int overflow_count = 0;
+            while (*name && isDigit(name))
+            {
+                number = number * 10 + (*name - 48);
+                ++name;
+
+                if (number >= maxNumber)
+                {
+                    number -= maxNumber;
+                    overflow_count++;
+                }
+            }
+
+            // numbers go before any other character
+            key.push_back('\1');
+            appendNumber(overflow_count);
+            appendNumber(number);
+        }
+        else
+        {
+            // characters below the digits are moved up by one, so that none of them is 0x01
+            unsigned char c = static_cast<unsigned char>(tolower(static_cast<unsigned char>(*name++)));
+            key.push_back(char(c < '0' ? c + 1 : c));
+        }
+    }
+
+    return key;
+}
+
 std::function<bool (Node*, Node*)> MegaApiImpl::getComparatorFunction(int order, MegaClient& mc)
 {
     switch (order)
@@ -17098,6 +17633,40 @@ std::function<bool (Node*, Node*)> MegaApiImpl::getComparatorFunction(int order,
 
 void MegaApiImpl::sortByComparatorFunction(node_vector& v, int order, MegaClient& mc)
 {
+    if (order == MegaApi::ORDER_DEFAULT_ASC || order == MegaApi::ORDER_DEFAULT_DESC
+            || order == MegaApi::ORDER_ALPHABETICAL_ASC || order == MegaApi::ORDER_ALPHABETICAL_DESC)
+    {
+        // as nodeComparatorDefaultASC/DESC, but parsing each name once instead of in every comparison
+        struct KeyedNode
+        {
+            Node* node;
+            string key;
+        };
+
+        vector<KeyedNode> keyed;
+        keyed.reserve(v.size());
+        for (Node* n : v)
+        {
+            keyed.push_back(KeyedNode{n, naturalsorting_key(n->displayname())});
+        }
+
+        bool ascending = order == MegaApi::ORDER_DEFAULT_ASC || order == MegaApi::ORDER_ALPHABETICAL_ASC;
+        std::sort(keyed.begin(), keyed.end(), [ascending](const KeyedNode& i, const KeyedNode& j)
+        {
+            if (i.node->type != j.node->type)
+            {
+                return i.node->type > j.node->type;
+            }
+            return ascending ? i.key < j.key : j.key < i.key;
+        });
+
+        for (size_t i = 0; i < keyed.size(); i++)
+        {
+            v[i] = keyed[i].node;
+        }
+        return;
+    }
+
     if (auto f = getComparatorFunction(order, mc))
     {
         std::sort(v.begin(), v.end(), f);
@@ -17557,6 +18126,11 @@ int MegaApiImpl::getNumChildren(MegaNode* p)
         return 0;
     }
 
+    if (useNodeReplica())
+    {
+        return mNodeReplica.getNumChildren(p->getHandle(), MegaNode::TYPE_UNKNOWN);
+    }
+
     sdkMutex.lock();
     Node *parent = client->nodebyhandle(p->getHandle());
     if (!parent || parent->type == FILENODE)
@@ -17578,6 +18152,11 @@ int MegaApiImpl::getNumChildFiles(MegaNode* p)
         return 0;
     }
 
+    if (useNodeReplica())
+    {
+        return mNodeReplica.getNumChildren(p->getHandle(), MegaNode::TYPE_FILE);
+    }
+
     sdkMutex.lock();
     Node *parent = client->nodebyhandle(p->getHandle());
     if (!parent || parent->type == FILENODE)
@@ -17604,6 +18183,11 @@ int MegaApiImpl::getNumChildFolders(MegaNode* p)
         return 0;
     }
 
+    if (useNodeReplica())
+    {
+        return mNodeReplica.getNumChildren(p->getHandle(), MegaNode::TYPE_FOLDER);
+    }
+
     sdkMutex.lock();
     Node *parent = client->nodebyhandle(p->getHandle());
     if (!parent || parent->type == FILENODE)
@@ -17631,6 +18215,14 @@ MegaNodeList *MegaApiImpl::getChildren(MegaNode* p, int order)
         return new MegaNodeListPrivate();
     }
 
+    if (useNodeReplica())
+    {
+        if (MegaNodeList* children = mNodeReplica.getChildren(p->getHandle(), order))
+        {
+            return children;
+        }
+    }
+
     node_vector childrenNodes;
 
     SdkMutexGuard guard(sdkMutex);
@@ -17643,10 +18235,7 @@ MegaNodeList *MegaApiImpl::getChildren(MegaNode* p, int order)
         {
             childrenNodes.push_back(*it++);
         }
-        if (std::function<bool(Node*, Node*)> comparatorFunction = getComparatorFunction(order, *client))
-        {
-            std::sort(childrenNodes.begin(), childrenNodes.end(), comparatorFunction);
-        }
+        sortByComparatorFunction(childrenNodes, order, *client);
     }
     return new MegaNodeListPrivate(childrenNodes.data(), int(childrenNodes.size()));
 }
@@ -17677,12 +18266,168 @@ MegaNodeList *MegaApiImpl::getChildren(MegaNodeList *parentNodes, int order)
     }
 
     // sort all the children together
-    if (std::function<bool(Node*, Node*)> comparatorFunction = getComparatorFunction(order, *client))
+    sortByComparatorFunction(childrenNodes, order, *client);
+
+    return new MegaNodeListPrivate(childrenNodes.data(), int(childrenNodes.size()));
+}
+
+bool MegaApiImpl::useNodeReplica() const
+{
+    // the replica is updated in nodes_updated(), after the changes to the tree, so the SDK thread
+    // (request callbacks, folder transfer controllers...) keeps reading the nodes from the client
+    return mNodeReplicaEnabled && mNodeReplica.current() && std::this_thread::get_id() != mSdkThreadId.load();
+}
+
+void MegaApiImpl::setConcurrentNodeQueries(bool enable)
+{
+    SdkMutexGuard guard(sdkMutex);
+
+    if (enable && !mNodeReplicaEnabled)
+    {
+        if (!mNodeQueries)
+        {
+            mNodeReplica.rebuild(*client);
+        }
+        mNodeReplicaEnabled = true;
+    }
+    else if (!enable && mNodeReplicaEnabled)
     {
-        std::sort(childrenNodes.begin(), childrenNodes.end(), comparatorFunction);
+        mNodeReplicaEnabled = false;
+        if (!mNodeQueries)
+        {
+            mNodeReplica.clear();
+        }
     }
+}
 
-    return new MegaNodeListPrivate(childrenNodes.data(), int(childrenNodes.size()));
+void MegaApiImpl::setNodeChangeNotifications(bool enable, int batchSize, bool changedFields)
+{
+    SdkMutexGuard guard(sdkMutex);
+    mNodeChangeNotifications = enable;
+    mNodeChangeBatchSize = size_t(std::max(1, batchSize));
+    mNodeChangeFields = changedFields;
+}
+
+void MegaApiImpl::searchAsync(MegaNode *node, const char *searchString, MegaCancelToken *cancelToken, bool recursive, int order, int pageSize, MegaRequestListener *listener)
+{
+    MegaRequestPrivate *request = new MegaRequestPrivate(MegaRequest::TYPE_SEARCH, listener);
+    request->setNodeHandle(node ? node->getHandle() : INVALID_HANDLE);
+    request->setText(searchString);
+    request->setCancelToken(cancelToken);
+    request->setFlag(recursive);
+    request->setParamType(order);
+    request->setNumber(pageSize);
+    requestQueue.push(request);
+    waiter->notify();
+}
+
+void MegaApiImpl::exportNodeTree(const char *localPath, MegaRequestListener *listener)
+{
+    MegaRequestPrivate *request = new MegaRequestPrivate(MegaRequest::TYPE_EXPORT_NODE_TREE, listener);
+    request->setFile(localPath);
+    requestQueue.push(request);
+    waiter->notify();
+}
+
+void MegaApiImpl::getChildrenAsync(MegaNode *parent, int order, MegaCancelToken *cancelToken, int pageSize, MegaRequestListener *listener)
+{
+    MegaRequestPrivate *request = new MegaRequestPrivate(MegaRequest::TYPE_GET_CHILDREN, listener);
+    request->setNodeHandle(parent ? parent->getHandle() : INVALID_HANDLE);
+    request->setCancelToken(cancelToken);
+    request->setParamType(order);
+    request->setNumber(pageSize);
+    requestQueue.push(request);
+    waiter->notify();
+}
+
+void MegaApiImpl::notifyNodeQueryResults()
+{
+    if (!mNodeQueries)
+    {
+        return;
+    }
+
+    SdkMutexGuard g(sdkMutex);
+
+    NodeQueryWorker::Result result;
+    while (mNodeQueries->pop(result))
+    {
+        MegaRequestPrivate* request = result.request;
+        request->setMegaNodeList(std::move(result.page));
+        request->setTransferredBytes(result.delivered);
+        request->setTotalBytes(result.total);
+
+        if (result.finished)
+        {
+            fireOnRequestFinish(request, make_unique<MegaErrorPrivate>(result.e));
+        }
+        else
+        {
+            fireOnRequestUpdate(request);
+        }
+    }
+}
+
+void MegaApiImpl::notifyNodeTreeSnapshots()
+{
+    if (mNodeTreeSnapshots->empty())
+    {
+        return;
+    }
+
+    SdkMutexGuard g(sdkMutex);
+
+    NodeTreeSnapshotResult result;
+    while (mNodeTreeSnapshots->popFront(result))
+    {
+        // the request is gone if it was aborted by a logout meanwhile
+        auto it = requestMap.find(result.tag);
+        if (it == requestMap.end() || !it->second || it->second->getType() != MegaRequest::TYPE_EXPORT_NODE_TREE)
+        {
+            continue;
+        }
+
+        MegaRequestPrivate* request = it->second;
+        if (!result.e)
+        {
+            request->setNumber(static_cast<long long>(result.count));
+        }
+        fireOnRequestFinish(request, make_unique<MegaErrorPrivate>(result.e));
+    }
+}
+
+MegaChildrenPage *MegaApiImpl::getChildrenPage(MegaNode* p, int order, const char *cursor, int pageSize)
+{
+    SdkMutexGuard guard(sdkMutex);
+
+    Node *parent = p ? client->nodebyhandle(p->getHandle()) : nullptr;
+    if (!parent || parent->type == FILENODE || pageSize <= 0)
+    {
+        return new MegaChildrenPagePrivate();
+    }
+
+    node_vector& children = mSortedChildren.get(*client, parent, order);
+    size_t start = cursor ? SortedChildrenCache::resume(children, cursor) : 0;
+    size_t end = std::min(children.size(), start + size_t(pageSize));
+
+    return new MegaChildrenPagePrivate(unique_ptr<MegaNodeList>(new MegaNodeListPrivate(children.data() + start, int(end - start))),
+                                       end < children.size() ? SortedChildrenCache::cursor(children, end) : string(),
+                                       int(children.size()));
+}
+
+MegaNodeInfoList *MegaApiImpl::getChildrenInfo(MegaNode* p, int order)
+{
+    node_vector childrenNodes;
+
+    SdkMutexGuard guard(sdkMutex);
+
+    Node *parent = p ? client->nodebyhandle(p->getHandle()) : nullptr;
+    if (parent && parent->type != FILENODE)
+    {
+        childrenNodes.assign(parent->children.begin(), parent->children.end());
+        sortByComparatorFunction(childrenNodes, order, *client);
+    }
+    return new MegaNodeInfoListPrivate(childrenNodes.data(), childrenNodes.size());
 }
 
 MegaNodeList *MegaApiImpl::getVersions(MegaNode *node)
@@ -17807,11 +18552,8 @@ MegaChildrenLists *MegaApiImpl::getFileFolderChildren(MegaNode *p, int order)
             folders.push_back(n);
         }
     }
-    if (std::function<bool(Node*, Node*)> comparatorFunction = getComparatorFunction(order, *client))
-    {
-        std::sort(files.begin(), files.end(), comparatorFunction);
-        std::sort(folders.begin(), folders.end(), comparatorFunction);
-    }
+    sortByComparatorFunction(files, order, *client);
+    sortByComparatorFunction(folders, order, *client);
 
     auto fileList = make_unique<MegaNodeListPrivate>(files.data(), int(files.size()));
     auto folderList = make_unique<MegaNodeListPrivate>(folders.data(), int(folders.size()));
@@ -18001,6 +18743,10 @@ char *MegaApiImpl::getSdkFingerprintFromMegaFingerprint(const char *megaFingerpr
 MegaNode* MegaApiImpl::getParentNode(MegaNode* n)
 {
     if(!n) return NULL;
+    if (useNodeReplica())
+    {
+        return mNodeReplica.getParentNode(n->getHandle());
+    }
 
     sdkMutex.lock();
     Node *node = client->nodebyhandle(n->getHandle());
@@ -18063,6 +18809,11 @@ MegaNode* MegaApiImpl::getNodeByPath(const char *path, MegaNode* node)
 MegaNode* MegaApiImpl::getNodeByHandle(handle handle)
 {
     if(handle == UNDEF) return NULL;
+    if (useNodeReplica())
+    {
+        return mNodeReplica.getNodeByHandle(handle);
+    }
+
     sdkMutex.lock();
     MegaNode *result = MegaNodePrivate::fromNode(client->nodebyhandle(handle));
     sdkMutex.unlock();
@@ -18105,6 +18856,12 @@ unsigned MegaApiImpl::sendPendingTransfers()
         {
             case MegaTransfer::TYPE_UPLOAD:
             {
+                if (transfer->getBatch())
+                {
+                    e = startTransferBatch(transfer, nextTag);
+                    break;
+                }
+
                 const char* localPath = transfer->getPath();
                 const char* fileName = transfer->getFileName();
                 int64_t mtime = transfer->getTime();
@@ -18310,6 +19067,12 @@ unsigned MegaApiImpl::sendPendingTransfers()
             }
             case MegaTransfer::TYPE_DOWNLOAD:
             {
+                if (transfer->getBatch())
+                {
+                    e = startTransferBatch(transfer, nextTag);
+                    break;
+                }
+
                 Node *node = NULL;
                 MegaNode *publicNode = transfer->getPublicNode();
                 const char *parentPath = transfer->getParentPath();
@@ -18579,6 +19342,20 @@ unsigned MegaApiImpl::sendPendingTransfers()
     return count;
 }
 
+error MegaApiImpl::startTransferBatch(MegaTransferPrivate *transfer, int nextTag)
+{
+    if (!transfer->getBatch()->size())
+    {
+        return API_EARGS;
+    }
+
+    transferMap[nextTag] = transfer;
+    folderTransferMap[nextTag] = transfer;
+    transfer->setTag(nextTag);
+    transfer->startRecursiveOperation(make_unique<MegaTransferBatchController>(this, transfer), nullptr);
+    return API_OK;
+}
+
 void MegaApiImpl::removeRecursively(const char *path)
 {
 #ifndef _WIN32
@@ -21079,6 +21856,111 @@ void MegaApiImpl::sendPendingRequests()
             break;
         }
 
+        case MegaRequest::TYPE_SET_TRANSFER_BANDWIDTH_CLASS:
+        {
+            int transferTag = request->getTransferTag();
+            int bandwidthClass = int(request->getNumber());
+            int weight = request->getParamType();
+
+            if (!transferTag || weight < 1
+                    || bandwidthClass < MegaTransfer::BANDWIDTH_CLASS_INTERACTIVE
+                    || bandwidthClass > MegaTransfer::BANDWIDTH_CLASS_STREAMING)
+            {
+                e = API_EARGS;
+                break;
+            }
+
+            MegaTransferPrivate* megaTransfer = getMegaTransferPrivate(transferTag);
+            if (!megaTransfer)
+            {
+                e = API_ENOENT;
+                break;
+            }
+
+            Transfer *transfer = megaTransfer->getTransfer();
+            if (!transfer)
+            {
+                e = API_ENOENT;
+                break;
+            }
+
+            e = client->settransferbandwidthclass(transfer, transferclass_t(bandwidthClass), unsigned(weight));
+            if (!e)
+            {
+                fireOnRequestFinish(request, make_unique<MegaErrorPrivate>(API_OK));
+            }
+            break;
+        }
+
+        case MegaRequest::TYPE_SEARCH:
+        case MegaRequest::TYPE_GET_CHILDREN:
+        {
+            NodeQueryWorker::Query query;
+            query.request = request;
+            query.search = request->getType() == MegaRequest::TYPE_SEARCH;
+            query.node = request->getNodeHandle() != INVALID_HANDLE ? request->getNodeHandle() : UNDEF;
+            query.name = request->getText() ? request->getText() : "";
+            query.recursive = query.search && request->getFlag();
+            query.order = request->getParamType();
+            query.cancelToken = request->getCancelToken();
+
+            if ((query.search && !request->getText()) || (!query.search && query.node == UNDEF)
+                    || request->getNumber() <= 0 || request->getNumber() > INT_MAX
+                    || (query.order != MegaApi::ORDER_NONE
+                        && query.order != MegaApi::ORDER_DEFAULT_ASC && query.order != MegaApi::ORDER_DEFAULT_DESC
+                        && query.order != MegaApi::ORDER_ALPHABETICAL_ASC && query.order != MegaApi::ORDER_ALPHABETICAL_DESC))
+            {
+                e = API_EARGS;
+                break;
+            }
+            query.pageSize = size_t(request->getNumber());
+
+            if (!mNodeQueries)
+            {
+                if (!mNodeReplicaEnabled)
+                {
+                    mNodeReplica.rebuild(*client);
+                }
+                mNodeQueries.reset(new NodeQueryWorker(mNodeReplica, [this]() { waiter->notify(); }));
+            }
+
+            // finished by notifyNodeQueryResults()
+            mNodeQueries->push(std::move(query));
+            break;
+        }
+
+        case MegaRequest::TYPE_EXPORT_NODE_TREE:
+        {
+            if (!request->getFile())
+            {
+                e = API_EARGS;
+                break;
+            }
+
+            if (client->nodes.empty())
+            {
+                e = API_EACCESS;
+                break;
+            }
+
+            // copied here, so that no changes are applied meanwhile, and written by a worker
+            // thread without sdkMutex (finished by notifyNodeTreeSnapshots())
+            auto columns = std::make_shared<NodeTreeSnapshot::Columns>();
+            NodeTreeSnapshot::collect(*client, *columns);
+
+            FileSystemAccess* fsaccess = client->fsaccess;
+            LocalPath path = LocalPath::fromPath(request->getFile(), *fsAccess);
+            int tag = request->getTag();
+            auto done = mNodeTreeSnapshots;
+
+            client->mAsyncQueue.push([columns, fsaccess, path, tag, done](SymmCipher&)
+            {
+                error e = NodeTreeSnapshot::write(*fsaccess, *columns, path);
+                done->pushBack(NodeTreeSnapshotResult{ tag, e, columns->handles.size() });
+            }, false);
+            break;
+        }
+
         case MegaRequest::TYPE_SET_MAX_CONNECTIONS:
         {
             int direction = request->getParamType();
@@ -23394,47 +24276,74 @@ void TreeProcCopy::proc(MegaClient* client, Node* n)
     else nc++;
 }
 
+// capacity of the lock-free part of the queues, they take more requests and transfers
+// than that, waiting for the lock while the lock-free part is full
+static const size_t PUSHED_QUEUE_CAPACITY = 4096;
+
 int TransferQueue::getLastPushedTag() const
 {
-    return lastPushedTransferTag;
+    return int(pushed.pushed());
 }
 
 TransferQueue::TransferQueue()
+    : pushed(PUSHED_QUEUE_CAPACITY)
 {
 }
 
+void TransferQueue::drain()
+{
+    pushed.popPushed([this](MegaTransferPrivate *transfer, size_t position)
+    {
+        // assigned here, so that it's in the order of the queue even with concurrent pushes
+        transfer->setPlaceInQueue(static_cast<long long>(position));
+        transfers.push_back(transfer);
+    });
+}
+
 void TransferQueue::push(MegaTransferPrivate *transfer)
 {
-    mutex.lock();
-    transfers.push_back(transfer);
-    transfer->setPlaceInQueue(++lastPushedTransferTag);
-    mutex.unlock();
+    while (!pushed.tryPush(transfer))
+    {
+        std::lock_guard<std::recursive_mutex> g(mutex);
+        drain();
+    }
+}
+
+void TransferQueue::push(vector<MegaTransferPrivate *>& transfers)
+{
+    for (MegaTransferPrivate* transfer : transfers)
+    {
+        push(transfer);
+    }
 }
 
 void TransferQueue::push_front(MegaTransferPrivate *transfer)
 {
-    mutex.lock();
+    std::lock_guard<std::recursive_mutex> g(mutex);
+    drain();
     transfers.push_front(transfer);
-    mutex.unlock();
 }
 
 MegaTransferPrivate *TransferQueue::pop()
 {
-    mutex.lock();
-    if(transfers.empty())
+    std::lock_guard<std::recursive_mutex> g(mutex);
+    if (transfers.empty())
     {
-        mutex.unlock();
-        return NULL;
+        drain();
+        if (transfers.empty())
+        {
+            return NULL;
+        }
     }
     MegaTransferPrivate *transfer = transfers.front();
     transfers.pop_front();
-    mutex.unlock();
     return transfer;
 }
 
 std::vector<MegaTransferPrivate *> TransferQueue::popUpTo(int lastQueuedTransfer, int direction)
 {
-    std::lock_guard<std::mutex> g(mutex);
+    std::lock_guard<std::recursive_mutex> g(mutex);
+    drain();
     std::vector<MegaTransferPrivate*> toret;
     for (auto it = transfers.begin(); it != transfers.end();)
     {
@@ -23459,26 +24368,32 @@ std::vector<MegaTransferPrivate *> TransferQueue::popUpTo(int lastQueuedTransfer
 
 void TransferQueue::removeWithFolderTag(int folderTag, std::function<void(MegaTransferPrivate *)> callback)
 {
-    for (auto it = transfers.begin(); it != transfers.end();)
+    std::lock_guard<std::recursive_mutex> g(mutex);
+    drain();
+
+    // by position, as the callback can push other transfers (the mutex is recursive for that)
+    for (size_t i = 0; i < transfers.size();)
     {
-        if ((*it)->getFolderTransferTag() == folderTag)
+        MegaTransferPrivate *transfer = transfers[i];
+        if (transfer->getFolderTransferTag() == folderTag)
         {
+            transfers.erase(transfers.begin() + i);
             if (callback)
             {
-                callback(*it);
+                callback(transfer);
             }
-            it = transfers.erase(it);
         }
         else
         {
-            it++;
+            i++;
         }
     }
 }
 
 void TransferQueue::removeListener(MegaTransferListener *listener)
 {
-    mutex.lock();
+    std::lock_guard<std::recursive_mutex> g(mutex);
+    drain();
 
     std::deque<MegaTransferPrivate *>::iterator it = transfers.begin();
     while(it != transfers.end())
@@ -23488,58 +24403,71 @@ void TransferQueue::removeListener(MegaTransferListener *listener)
             transfer->setListener(NULL);
         it++;
     }
-
-    mutex.unlock();
 }
 
 RequestQueue::RequestQueue()
+    : pushed(PUSHED_QUEUE_CAPACITY)
+{
+}
+
+void RequestQueue::drain()
 {
+    pushed.popPushed([this](MegaRequestPrivate *request, size_t)
+    {
+        requests.push_back(request);
+    });
 }
 
 void RequestQueue::push(MegaRequestPrivate *request)
 {
-    mutex.lock();
-    requests.push_back(request);
-    mutex.unlock();
+    while (!pushed.tryPush(request))
+    {
+        std::lock_guard<std::mutex> g(mutex);
+        drain();
+    }
 }
 
 void RequestQueue::push_front(MegaRequestPrivate *request)
 {
-    mutex.lock();
+    std::lock_guard<std::mutex> g(mutex);
+    drain();
     requests.push_front(request);
-    mutex.unlock();
 }
 
 MegaRequestPrivate *RequestQueue::pop()
 {
-    mutex.lock();
-    if(requests.empty())
+    std::lock_guard<std::mutex> g(mutex);
+    if (requests.empty())
     {
-        mutex.unlock();
-        return NULL;
+        drain();
+        if (requests.empty())
+        {
+            return NULL;
+        }
     }
     MegaRequestPrivate *request = requests.front();
     requests.pop_front();
-    mutex.unlock();
     return request;
 }
 
 MegaRequestPrivate *RequestQueue::front()
 {
-    mutex.lock();
-    if(requests.empty())
+    std::lock_guard<std::mutex> g(mutex);
+    if (requests.empty())
     {
-        mutex.unlock();
-        return NULL;
+        drain();
+        if (requests.empty())
+        {
+            return NULL;
+        }
     }
-    MegaRequestPrivate *request = requests.front();
-    mutex.unlock();
-    return request;
+    return requests.front();
 }
 
 void RequestQueue::removeListener(MegaRequestListener *listener)
 {
-    mutex.lock();
+    std::lock_guard<std::mutex> g(mutex);
+    drain();
 
     std::deque<MegaRequestPrivate *>::iterator it = requests.begin();
     while(it != requests.end())
@@ -23549,13 +24477,12 @@ void RequestQueue::removeListener(MegaRequestListener *listener)
             request->setListener(NULL);
         it++;
     }
-
-    mutex.unlock();
 }
 
 void RequestQueue::removeListener(MegaScheduledCopyListener *listener)
 {
-    mutex.lock();
+    std::lock_guard<std::mutex> g(mutex);
+    drain();
 
     std::deque<MegaRequestPrivate *>::iterator it = requests.begin();
     while(it != requests.end())
@@ -23565,8 +24492,6 @@ void RequestQueue::removeListener(MegaScheduledCopyListener *listener)
             request->setBackupListener(NULL);
         it++;
     }
-
-    mutex.unlock();
 }
 
 MegaHashSignatureImpl::MegaHashSignatureImpl(const char *base64Key)
@@ -24716,6 +25641,38 @@ void MegaSyncListPrivate::addSync(MegaSync *sync)
         delete [] copyList;
     }
 }
+
+MegaSyncFileStateListPrivate::MegaSyncFileStateListPrivate(const vector<pair<LocalPath, treestate_t>>& changes)
+{
+    paths.reserve(changes.size());
+    states.reserve(changes.size());
+
+    for (auto& change : changes)
+    {
+        paths.push_back(change.first.platformEncoded());
+        states.push_back(int(change.second));
+    }
+}
+
+MegaSyncFileStateList *MegaSyncFileStateListPrivate::copy() const
+{
+    return new MegaSyncFileStateListPrivate(*this);
+}
+
+int MegaSyncFileStateListPrivate::size() const
+{
+    return int(states.size());
+}
+
+const string *MegaSyncFileStateListPrivate::getLocalPath(int i) const
+{
+    return i >= 0 && i < size() ? &paths[size_t(i)] : NULL;
+}
+
+int MegaSyncFileStateListPrivate::getState(int i) const
+{
+    return i >= 0 && i < size() ? states[size_t(i)] : int(MegaApi::STATE_NONE);
+}
 #endif
 
 
@@ -24996,57 +25953,8 @@ bool MegaTreeProcCopy::processMegaNode(MegaNode *n)
     return true;
 }
 
-MegaFolderUploadController::MegaFolderUploadController(MegaApiImpl *megaApi, MegaTransferPrivate *transfer)
+long long MegaRecursiveOperation::cancelSubTransfers()
 {
-    this->megaApi = megaApi;
-    this->client = megaApi->getMegaClient();
-    this->transfer = transfer;
-    this->listener = transfer->getListener();
-    this->recursive = 0;
-    this->pendingTransfers = 0;
-    this->tag = transfer->getTag();
-}
-
-void MegaFolderUploadController::start(MegaNode*)
-{
-    transfer->setFolderTransferTag(-1);
-    transfer->setStartTime(Waiter::ds);
-    transfer->setState(MegaTransfer::STATE_QUEUED);
-    megaApi->fireOnTransferStart(transfer);
-
-    const char *name = transfer->getFileName();
-    MegaNode *parent = megaApi->getNodeByHandle(transfer->getParentHandle());
-    if(!parent)
-    {
-        transfer->setState(MegaTransfer::STATE_FAILED);
-        DBTableTransactionCommitter committer(client->tctable);
-        megaApi->fireOnTransferFinish(transfer, make_unique<MegaErrorPrivate>(API_EARGS), committer);
-    }
-    else
-    {
-        auto localpath = LocalPath::fromPath(transfer->getPath(), *client->fsaccess);
-        MegaNode *child = megaApi->getChildNode(parent, name);
-
-        if(!child || !child->isFolder())
-        {
-            pendingFolders.push_back(localpath);
-            megaApi->createFolder(name, parent, this);
-        }
-        else
-        {
-            pendingFolders.push_front(localpath);
-            onFolderAvailable(child->getHandle());
-        }
-
-        delete child;
-        delete parent;
-    }
-}
-
-void MegaFolderUploadController::cancel()
-{
-    cancelled = true; //we dont want to further checkcompletion, and produce multile fireOnTransferFinish -> multiple deletions
-
     //remove subtransfers from pending transferQueue
     megaApi->cancelPendingTransfersByFolderTag(tag);
 
@@ -25134,19 +26042,78 @@ void MegaFolderUploadController::cancel()
         cancelledSubTransfers++;
     }
 
+    return cancelledSubTransfers;
+}
+
+MegaFolderUploadController::MegaFolderUploadController(MegaApiImpl *megaApi, MegaTransferPrivate *transfer)
+{
+    this->megaApi = megaApi;
+    this->client = megaApi->getMegaClient();
+    this->transfer = transfer;
+    this->listener = transfer->getListener();
+    this->recursive = 0;
+    this->pendingTransfers = 0;
+    this->tag = transfer->getTag();
+}
+
+void MegaFolderUploadController::start(MegaNode*)
+{
+    transfer->setFolderTransferTag(-1);
+    transfer->setStartTime(Waiter::ds);
+    transfer->setState(MegaTransfer::STATE_QUEUED);
+    megaApi->fireOnTransferStart(transfer);
+
+    const char *name = transfer->getFileName();
+    MegaNode *parent = megaApi->getNodeByHandle(transfer->getParentHandle());
+    if(!parent)
+    {
+        transfer->setState(MegaTransfer::STATE_FAILED);
+        DBTableTransactionCommitter committer(client->tctable);
+        megaApi->fireOnTransferFinish(transfer, make_unique<MegaErrorPrivate>(API_EARGS), committer);
+    }
+    else
+    {
+        auto localpath = LocalPath::fromPath(transfer->getPath(), *client->fsaccess);
+        MegaNode *child = megaApi->getChildNode(parent, name);
+
+        if(!child || !child->isFolder())
+        {
+            // the whole tree of folders is created first, in as few putnodes as possible
+            vector<NewNode> newnodes;
+            addFolderTree(newnodes, localpath, name, UNDEF);
+            createFolders(parent->getHandle(), move(newnodes), vector<LocalPath>(1, localpath));
+        }
+        else
+        {
+            onFolderAvailable(child->getHandle(), localpath);
+        }
+
+        delete child;
+        delete parent;
+    }
+}
+
+void MegaFolderUploadController::cancel()
+{
+    cancelled = true; //we dont want to further checkcompletion, and produce multile fireOnTransferFinish -> multiple deletions
+
+    long long cancelledSubTransfers = cancelSubTransfers();
+
     LOG_verbose << " MegaFolderUploadController, cancelled subTransfers = " << cancelledSubTransfers;
 
     transfer = nullptr;  // no final callback for this one since it is being destroyed now
 }
 
-void MegaFolderUploadController::onFolderAvailable(MegaHandle handle)
+void MegaFolderUploadController::onFolderAvailable(MegaHandle handle, LocalPath localPath)
 {
     recursive++;
-    auto localPath = pendingFolders.front();
-    pendingFolders.pop_front();
 
     MegaNode *parent = megaApi->getNodeByHandle(handle);
 
+    // subfolders to create (with theirs), in a single putnodes
+    vector<NewNode> newnodes;
+    vector<LocalPath> newFolders;
+
     LocalPath localname;
     DirAccess* da;
     da = client->fsaccess->newdiraccess();
@@ -25171,19 +26138,30 @@ void MegaFolderUploadController::onFolderAvailable(MegaHandle handle)
                 MegaNode *child = megaApi->getChildNode(parent, name.c_str());
                 if(!child || !child->isFolder())
                 {
-                    pendingFolders.push_back(localPath);
-                    megaApi->createFolder(name.c_str(), parent, this);
+                    newFolders.push_back(localPath);
+                    addFolderTree(newnodes, localPath, name, UNDEF);
+
+                    if (newnodes.size() >= MegaClient::MAX_NEWNODES)
+                    {
+                        createFolders(handle, move(newnodes), move(newFolders));
+                        newnodes.clear();
+                        newFolders.clear();
+                    }
                 }
                 else
                 {
-                    pendingFolders.push_front(localPath);
-                    onFolderAvailable(child->getHandle());
+                    onFolderAvailable(child->getHandle(), localPath);
                 }
                 delete child;
             }
         }
     }
 
+    if (!newnodes.empty())
+    {
+        createFolders(handle, move(newnodes), move(newFolders));
+    }
+
     delete da;
     delete parent;
     recursive--;
@@ -25191,36 +26169,94 @@ void MegaFolderUploadController::onFolderAvailable(MegaHandle handle)
     checkCompletion();
 }
 
-void MegaFolderUploadController::checkCompletion()
+void MegaFolderUploadController::addFolderTree(vector<NewNode>& newnodes, LocalPath& localPath, const string& name, handle parent)
 {
-    if (!cancelled && !recursive && !pendingFolders.size() && !pendingTransfers)
+    newnodes.emplace_back();
+    client->putnodes_prepareOneFolder(&newnodes.back(), name);
+
+    // (any value unique in the putnodes will do)
+    handle h = newnodes.size();
+    newnodes.back().nodehandle = h;
+    newnodes.back().parenthandle = parent;
+
+    unique_ptr<DirAccess> da(client->fsaccess->newdiraccess());
+    if (!da->dopen(&localPath, NULL, false))
     {
-        LOG_debug << "Folder transfer finished - " << transfer->getTransferredBytes() << " of " << transfer->getTotalBytes();
-        transfer->setState(MegaTransfer::STATE_COMPLETED);
-        transfer->setLastError(&mLastError);
-        DBTableTransactionCommitter committer(client->tctable);
-        megaApi->fireOnTransferFinish(transfer, make_unique<MegaErrorPrivate>(!mIncompleteTransfers ? API_OK : API_EINCOMPLETE), committer);
+        return;
     }
-}
 
-void MegaFolderUploadController::onRequestFinish(MegaApi *, MegaRequest *request, MegaError *e)
-{
-    int type = request->getType();
-    int errorCode = e->getErrorCode();
+    FileSystemType fsType = client->fsaccess->getlocalfstype(localPath);
+    LocalPath localname;
+    nodetype_t dirEntryType;
 
-    if (type == MegaRequest::TYPE_CREATE_FOLDER)
+    while (newnodes.size() < MegaClient::MAX_NEWNODES
+           && da->dnext(localPath, localname, client->followsymlinks, &dirEntryType))
     {
-        if (!errorCode)
+        if (dirEntryType == FOLDERNODE)
         {
-            onFolderAvailable(request->getNodeHandle());
+            ScopedLengthRestore restoreLen(localPath);
+            localPath.appendWithSeparator(localname, false);
+            addFolderTree(newnodes, localPath, localname.toName(*client->fsaccess, fsType), h);
         }
-        else
+    }
+}
+
+void MegaFolderUploadController::createFolders(MegaHandle parent, vector<NewNode>&& newnodes, vector<LocalPath>&& localPaths)
+{
+    LOG_debug << "Folder transfer creating " << newnodes.size() << " folders";
+
+    pendingFolders++;
+    weak_ptr<bool> alive = mAlive;
+
+    client->putnodes(NodeHandle().set6byte(parent), move(newnodes), nullptr, client->nextreqtag(),
+        [this, alive, localPaths](const Error& e, targettype_t, vector<NewNode>& nn, bool)
         {
-            pendingFolders.pop_front();
-            mLastError = *e;
-            mIncompleteTransfers++;
+            if (alive.expired())
+            {
+                return;
+            }
+
+            pendingFolders--;
+
+            if (e)
+            {
+                mLastError = MegaErrorPrivate(e);
+                mIncompleteTransfers += int(localPaths.size());
+                checkCompletion();
+                return;
+            }
+
+            // each folder's subfolders exist now, and are found by onFolderAvailable()
+            size_t i = 0;
+            for (auto& newnode : nn)
+            {
+                if (ISUNDEF(newnode.parenthandle) && i < localPaths.size())
+                {
+                    if (newnode.added)
+                    {
+                        onFolderAvailable(newnode.mAddedHandle, localPaths[i]);
+                    }
+                    else
+                    {
+                        mIncompleteTransfers++;
+                    }
+                    i++;
+                }
+            }
+
             checkCompletion();
-        }
+        });
+}
+
+void MegaFolderUploadController::checkCompletion()
+{
+    if (!cancelled && !recursive && !pendingFolders && !pendingTransfers)
+    {
+        LOG_debug << "Folder transfer finished - " << transfer->getTransferredBytes() << " of " << transfer->getTotalBytes();
+        transfer->setState(MegaTransfer::STATE_COMPLETED);
+        transfer->setLastError(&mLastError);
+        DBTableTransactionCommitter committer(client->tctable);
+        megaApi->fireOnTransferFinish(transfer, make_unique<MegaErrorPrivate>(!mIncompleteTransfers ? API_OK : API_EINCOMPLETE), committer);
     }
 }
 
@@ -25276,14 +26312,6 @@ void MegaFolderUploadController::onTransferFinish(MegaApi *, MegaTransfer *t, Me
     }
 }
 
-MegaFolderUploadController::~MegaFolderUploadController()
-{
-    //we dettach this as request listener: could be pending create folder req finish
-    megaApi->removeRequestListener(this);
-
-    //we shouldn't need to dettach as transfer listener: all listened transfer should have been cancelled/completed
-}
-
 MegaScheduledCopyController::MegaScheduledCopyController(MegaApiImpl *megaApi, int tag, int folderTransferTag, handle parenthandle, const char* filename, bool attendPastBackups, const char *speriod, int64_t period, int maxBackups)
 {
     LOG_info << "Registering backup for folder " << filename << " period=" << period << " speriod=" << speriod << " Number-of-Backups=" << maxBackups;
@@ -26455,91 +27483,7 @@ void MegaFolderDownloadController::cancel()
 {
     cancelled = true; //we dont want to further checkcompletion, and produce multile fireOnTransferFinish -> multiple deletions
 
-    //remove subtransfers from pending transferQueue
-    megaApi->cancelPendingTransfersByFolderTag(tag);
-
-    //remove ongoing subtransfers
-    long long cancelledSubTransfers = 0;
-
-    std::unique_ptr<DBTableTransactionCommitter> insideCommiter;
-    DBTableTransactionCommitter *committer = client->tctable ? client->tctable->getTransactionCommitter() : nullptr;
-    if (!committer)
-    {
-        insideCommiter.reset(new DBTableTransactionCommitter(client->tctable));
-        committer = insideCommiter.get();
-    }
-
-    while (!subTransfers.empty())
-    {
-        auto subTransfer = *subTransfers.begin();
-
-        Transfer *transfer = subTransfer->getTransfer();
-        if (!transfer)
-        {
-            LOG_warn << "Subtransfer without attached Transfer for folder transfer: " << subTransfer->getFileName();
-
-            subTransfer->setState(MegaTransfer::STATE_CANCELLED);
-            megaApi->fireOnTransferFinish(subTransfer, make_unique<MegaErrorPrivate>(API_EINCOMPLETE), *committer);
-
-            continue;
-        }
-
-#ifdef _WIN32
-        if (transfer->type == GET)
-            RemoveHiddenFileAttribute(transfer->localfilename);
-#endif
-
-        MegaErrorPrivate megaError(API_EINCOMPLETE);
-        subTransfer->setLastError(&megaError);
-
-        bool found = false;
-        bool fireSubTransferFinish = false;
-        file_list files = transfer->files;
-        file_list::iterator iterator = files.begin();
-        while (iterator != files.end())
-        {
-            File *file = *iterator;
-            iterator++;
-            if (file->tag == subTransfer->getTag())
-            {
-                found = true;
-                if (!file->syncxfer)
-                {
-                    if (!this->transfer->getDoNotStopSubTransfers())
-                    {
-                        client->stopxfer(file, committer);
-                    }
-                    else
-                    {
-                        //firing onTransferFinished without stopping (to preserve cache)
-                        subTransfer->setState(MegaTransfer::STATE_FAILED);
-                        fireSubTransferFinish = true;
-                    }
-                }
-                else
-                {
-                    LOG_err << "Sync subtransfer found for folder transfer: " << subTransfer->getFileName();
-                    assert(false);
-                }
-                break;
-            }
-        }
-
-        if (!found)
-        {
-            LOG_warn << "No file found for subtransfer: " << subTransfer->getFileName();
-
-            subTransfer->setState(MegaTransfer::STATE_CANCELLED);
-            fireSubTransferFinish = true;
-        }
-
-        if (fireSubTransferFinish)
-        {
-            megaApi->fireOnTransferFinish(subTransfer, make_unique<MegaErrorPrivate>(API_EINCOMPLETE), *committer);
-        }
-
-        cancelledSubTransfers++;
-    }
+    long long cancelledSubTransfers = cancelSubTransfers();
 
     LOG_verbose << "MegaFolderDownloadController, cancelled subTransfers = " << cancelledSubTransfers;
 
@@ -26696,6 +27640,134 @@ void MegaFolderDownloadController::onTransferFinish(MegaApi *, MegaTransfer *t,
     }
 }
 
+MegaTransferBatchController::MegaTransferBatchController(MegaApiImpl *megaApi, MegaTransferPrivate *transfer)
+{
+    this->megaApi = megaApi;
+    this->client = megaApi->getMegaClient();
+    this->transfer = transfer;
+    this->listener = transfer->getListener();
+    this->recursive = 0;
+    this->pendingTransfers = 0;
+    this->tag = transfer->getTag();
+    this->mBatch = transfer->getBatch();
+}
+
+void MegaTransferBatchController::start(MegaNode*)
+{
+    transfer->setFolderTransferTag(-1);
+    transfer->setStartTime(Waiter::ds);
+    transfer->setState(MegaTransfer::STATE_QUEUED);
+    megaApi->fireOnTransferStart(transfer);
+
+    LOG_debug << "Transfer batch started - " << mBatch->size() << " files";
+    startNext();
+}
+
+void MegaTransferBatchController::startNext()
+{
+    // the subtransfers are created as others finish, so the per-file state of a big batch
+    // is never created all at once
+    vector<MegaTransferPrivate*> transfers;
+    while (!cancelled && mNext < mBatch->size() && pendingTransfers < MAX_PENDING)
+    {
+        const string& localPath = mBatch->localPath(mNext);
+        MegaTransferPrivate* t;
+        if (transfer->getType() == MegaTransfer::TYPE_UPLOAD)
+        {
+            t = megaApi->createUploadTransfer(false, localPath.c_str(), mBatch->nodeHandle(mNext), nullptr, nullptr, -1, tag, false, nullptr, false, false, FS_UNKNOWN, this);
+        }
+        else
+        {
+            t = megaApi->createDownloadTransfer(false, nullptr, localPath.size() ? localPath.c_str() : nullptr, tag, nullptr, this);
+            t->setNodeHandle(mBatch->nodeHandle(mNext));
+        }
+        t->setBatchItem(true);
+        transfers.push_back(t);
+
+        pendingTransfers++;
+        mNext++;
+    }
+
+    megaApi->startTransfers(transfers);
+}
+
+void MegaTransferBatchController::cancel()
+{
+    cancelled = true; //we dont want to further checkcompletion, and produce multile fireOnTransferFinish -> multiple deletions
+
+    long long cancelledSubTransfers = cancelSubTransfers();
+
+    LOG_verbose << "MegaTransferBatchController, cancelled subTransfers = " << cancelledSubTransfers
+                << ", not started = " << (mBatch->size() - mNext);
+
+    transfer = nullptr;  // no final callback for this one since it is being destroyed now
+}
+
+void MegaTransferBatchController::checkCompletion()
+{
+    if (!cancelled && mNext == mBatch->size() && !pendingTransfers)
+    {
+        LOG_debug << "Transfer batch finished - " << transfer->getTransferredBytes() << " of " << transfer->getTotalBytes();
+        transfer->setState(MegaTransfer::STATE_COMPLETED);
+        transfer->setLastError(&mLastError);
+        DBTableTransactionCommitter committer(client->tctable);
+        megaApi->fireOnTransferFinish(transfer, make_unique<MegaErrorPrivate>(!mIncompleteTransfers ? API_OK : API_EINCOMPLETE), committer);
+    }
+}
+
+void MegaTransferBatchController::onTransferStart(MegaApi *, MegaTransfer *t)
+{
+    subTransfers.insert(static_cast<MegaTransferPrivate*>(t));
+    assert(transfer);
+    if (transfer)
+    {
+        transfer->setState(t->getState());
+        transfer->setPriority(t->getPriority());
+        transfer->setTotalBytes(transfer->getTotalBytes() + t->getTotalBytes());
+        transfer->setUpdateTime(Waiter::ds);
+        megaApi->fireOnTransferUpdate(transfer);
+    }
+}
+
+void MegaTransferBatchController::onTransferUpdate(MegaApi *, MegaTransfer *t)
+{
+    assert(transfer);
+    if (transfer)
+    {
+        transfer->setState(t->getState());
+        transfer->setPriority(t->getPriority());
+        transfer->setTransferredBytes(transfer->getTransferredBytes() + t->getDeltaSize());
+        transfer->setUpdateTime(Waiter::ds);
+        transfer->setSpeed(t->getSpeed());
+        transfer->setMeanSpeed(t->getMeanSpeed());
+        megaApi->fireOnTransferUpdate(transfer);
+    }
+}
+
+void MegaTransferBatchController::onTransferFinish(MegaApi *, MegaTransfer *t, MegaError *e)
+{
+    subTransfers.erase(static_cast<MegaTransferPrivate*>(t));
+    pendingTransfers--;
+    assert(transfer);
+    if (transfer)
+    {
+        transfer->setState(MegaTransfer::STATE_ACTIVE);
+        transfer->setPriority(t->getPriority());
+        transfer->setTransferredBytes(transfer->getTransferredBytes() + t->getDeltaSize());
+        transfer->setUpdateTime(Waiter::ds);
+        transfer->setSpeed(t->getSpeed());
+        transfer->setMeanSpeed(t->getMeanSpeed());
+        megaApi->fireOnTransferUpdate(transfer);
+        if (e->getErrorCode())
+        {
+            mLastError = *e;
+            mIncompleteTransfers++;
+        }
+        startNext();
+        checkCompletion();
+    }
+}
+
 #ifdef HAVE_LIBUV
 StreamingBuffer::StreamingBuffer()
 {
@@ -32951,6 +34023,1055 @@ MegaChildrenListsPrivate::MegaChildrenListsPrivate()
 {
 }
 
+MegaNodeInfoListPrivate::MegaNodeInfoListPrivate(Node** nodes, size_t count)
+{
+    static const nameid favid = AttrMap::string2nameid("fav");
+    static const nameid lblid = AttrMap::string2nameid("lbl");
+
+    entries.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Node* node = nodes[i];
+        Entry& e = entries[i];
+
+        e.nodehandle = node->nodehandle;
+        e.parenthandle = node->parent ? node->parent->nodehandle : INVALID_HANDLE;
+        e.size = node->size;
+        e.ctime = node->ctime;
+        e.mtime = node->mtime;
+        e.type = static_cast<signed char>(node->type);
+        e.thumbnail = node->hasfileattribute(GfxProc::THUMBNAIL) != 0;
+        e.preview = node->hasfileattribute(GfxProc::PREVIEW) != 0;
+
+        // as MegaNodePrivate, ignoring invalid values
+        attr_map::const_iterator it = node->attrs.map.find(favid);
+        e.favourite = it != node->attrs.map.end() && std::atoi(it->second.c_str()) == 1;
+
+        it = node->attrs.map.find(lblid);
+        int lbl = it != node->attrs.map.end() ? std::atoi(it->second.c_str()) : LBL_UNKNOWN;
+        e.label = static_cast<signed char>(lbl < LBL_RED || lbl > LBL_GREY ? LBL_UNKNOWN : lbl);
+
+        e.name = names.size();
+        names.append(node->displayname());
+        names.push_back('\0');
+    }
+}
+
+MegaNodeInfoList *MegaNodeInfoListPrivate::copy() const
+{
+    return new MegaNodeInfoListPrivate(*this);
+}
+
+int MegaNodeInfoListPrivate::size() const
+{
+    return int(entries.size());
+}
+
+const MegaNodeInfoListPrivate::Entry* MegaNodeInfoListPrivate::entry(int i) const
+{
+    return i >= 0 && size_t(i) < entries.size() ? &entries[size_t(i)] : nullptr;
+}
+
+MegaHandle MegaNodeInfoListPrivate::getHandle(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->nodehandle : INVALID_HANDLE;
+}
+
+MegaHandle MegaNodeInfoListPrivate::getParentHandle(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->parenthandle : INVALID_HANDLE;
+}
+
+int MegaNodeInfoListPrivate::getType(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->type : int(MegaNode::TYPE_UNKNOWN);
+}
+
+const char *MegaNodeInfoListPrivate::getName(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? names.c_str() + e->name : NULL;
+}
+
+int64_t MegaNodeInfoListPrivate::getSize(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->size : -1;
+}
+
+int64_t MegaNodeInfoListPrivate::getCreationTime(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->ctime : -1;
+}
+
+int64_t MegaNodeInfoListPrivate::getModificationTime(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->mtime : -1;
+}
+
+int MegaNodeInfoListPrivate::getLabel(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->label : int(MegaNode::NODE_LBL_UNKNOWN);
+}
+
+bool MegaNodeInfoListPrivate::isFavourite(int i) const
+{
+    const Entry* e = entry(i);
+    return e && e->favourite;
+}
+
+bool MegaNodeInfoListPrivate::hasThumbnail(int i) const
+{
+    const Entry* e = entry(i);
+    return e && e->thumbnail;
+}
+
+bool MegaNodeInfoListPrivate::hasPreview(int i) const
+{
+    const Entry* e = entry(i);
+    return e && e->preview;
+}
+
+MegaNodeChangeListPrivate::MegaNodeChangeListPrivate(Node** nodes, size_t count, bool changedFields, bool last)
+    : last(last)
+{
+    entries.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Node* node = nodes[i];
+        Entry& e = entries[i];
+
+        e.nodehandle = node->nodehandle;
+        e.parenthandle = node->parent ? node->parent->nodehandle : INVALID_HANDLE;
+        e.changes = nodeChanges(node);
+        e.type = static_cast<signed char>(node->type);
+        e.size = -1;
+        e.mtime = -1;
+        e.name = string::npos;
+
+        if (changedFields && (e.changes & (MegaNode::CHANGE_TYPE_NEW | MegaNode::CHANGE_TYPE_ATTRIBUTES)))
+        {
+            e.name = names.size();
+            names.append(node->displayname());
+            names.push_back('\0');
+        }
+
+        if (changedFields && (e.changes & MegaNode::CHANGE_TYPE_NEW))
+        {
+            e.size = node->size;
+            e.mtime = node->mtime;
+        }
+    }
+}
+
+MegaNodeChangeList *MegaNodeChangeListPrivate::copy() const
+{
+    return new MegaNodeChangeListPrivate(*this);
+}
+
+int MegaNodeChangeListPrivate::size() const
+{
+    return int(entries.size());
+}
+
+const MegaNodeChangeListPrivate::Entry* MegaNodeChangeListPrivate::entry(int i) const
+{
+    return i >= 0 && size_t(i) < entries.size() ? &entries[size_t(i)] : nullptr;
+}
+
+MegaHandle MegaNodeChangeListPrivate::getHandle(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->nodehandle : INVALID_HANDLE;
+}
+
+MegaHandle MegaNodeChangeListPrivate::getParentHandle(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->parenthandle : INVALID_HANDLE;
+}
+
+int MegaNodeChangeListPrivate::getChanges(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->changes : 0;
+}
+
+int MegaNodeChangeListPrivate::getType(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->type : int(MegaNode::TYPE_UNKNOWN);
+}
+
+const char *MegaNodeChangeListPrivate::getName(int i) const
+{
+    const Entry* e = entry(i);
+    return e && e->name != string::npos ? names.c_str() + e->name : NULL;
+}
+
+int64_t MegaNodeChangeListPrivate::getSize(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->size : -1;
+}
+
+int64_t MegaNodeChangeListPrivate::getModificationTime(int i) const
+{
+    const Entry* e = entry(i);
+    return e ? e->mtime : -1;
+}
+
+bool MegaNodeChangeListPrivate::isLast() const
+{
+    return last;
+}
+
+// as MegaApiImpl::nodeComparatorDefaultASC/DESC: folders first, then by name
+static void sortMegaNodesByName(vector<MegaNode*>& nodes, bool ascending)
+{
+    vector<pair<string, MegaNode*>> keyed;
+    keyed.reserve(nodes.size());
+    for (MegaNode* node : nodes)
+    {
+        keyed.emplace_back(naturalsorting_key(node->getName()), node);
+    }
+
+    std::sort(keyed.begin(), keyed.end(), [ascending](const pair<string, MegaNode*>& i, const pair<string, MegaNode*>& j)
+    {
+        if (i.second->getType() != j.second->getType())
+        {
+            return i.second->getType() > j.second->getType();
+        }
+        return ascending ? i.first < j.first : j.first < i.first;
+    });
+
+    for (size_t i = 0; i < keyed.size(); i++)
+    {
+        nodes[i] = keyed[i].second;
+    }
+}
+
+void MegaNodeReplica::rebuild(MegaClient& client)
+{
+    // (the replaced entries are deleted once the lock is released)
+    std::unordered_map<handle, Entry> entries;
+    entries.reserve(client.nodes.size());
+
+    for (auto& it : client.nodes)
+    {
+        Node* n = it.second;
+        entries[n->nodehandle].node.reset(MegaNodePrivate::fromNode(n));
+        if (n->parent)
+        {
+            entries[n->parent->nodehandle].children.insert(n->nodehandle);
+        }
+    }
+
+    // (pending batches are older than the nodes copied)
+    std::lock_guard<std::mutex> pg(mPendingMutex);
+    std::lock_guard<SharedMutex> g(mMutex);
+    mEntries.swap(entries);
+    mPending.clear();
+    mCurrent = true;
+}
+
+void MegaNodeReplica::update(Node** nodes, int count)
+{
+    Batch batch;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (nodes[i]->changed.removed)
+        {
+            batch.removed.push_back(nodes[i]->nodehandle);
+        }
+        else
+        {
+            batch.updated.emplace_back(MegaNodePrivate::fromNode(nodes[i]));
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> g(mPendingMutex);
+        mPending.push_back(std::move(batch));
+        mCurrent = false;
+    }
+
+    // (otherwise, applied by the last reader when it ends)
+    tryApplyPending();
+}
+
+void MegaNodeReplica::clear()
+{
+    std::unordered_map<handle, Entry> entries;
+
+    std::lock_guard<std::mutex> pg(mPendingMutex);
+    std::lock_guard<SharedMutex> g(mMutex);
+    mEntries.swap(entries);
+    mPending.clear();
+    mCurrent = true;
+}
+
+bool MegaNodeReplica::current() const
+{
+    return mCurrent;
+}
+
+void MegaNodeReplica::applyPending()
+{
+    std::lock_guard<std::mutex> pg(mPendingMutex);
+    if (mPending.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<SharedMutex> g(mMutex);
+    applyAll();
+}
+
+void MegaNodeReplica::tryApplyPending()
+{
+    std::lock_guard<std::mutex> pg(mPendingMutex);
+    if (mPending.empty() || !mMutex.try_lock())
+    {
+        return;
+    }
+
+    applyAll();
+    mMutex.unlock();
+}
+
+void MegaNodeReplica::applyAll()
+{
+    for (auto& pending : mPending)
+    {
+        apply(pending);
+    }
+    mPending.clear();
+    mCurrent = true;
+}
+
+MegaNodeReplica::ReadLock::ReadLock(MegaNodeReplica& replica)
+    : mReplica(replica)
+{
+    mReplica.mMutex.lock_shared();
+}
+
+MegaNodeReplica::ReadLock::~ReadLock()
+{
+    mReplica.mMutex.unlock_shared();
+
+    // (a batch that arrived meanwhile couldn't be applied, the last reader does it)
+    if (!mReplica.mCurrent)
+    {
+        mReplica.tryApplyPending();
+    }
+}
+
+void MegaNodeReplica::apply(Batch& batch)
+{
+    for (handle h : batch.removed)
+    {
+        remove(h);
+    }
+
+    for (auto& node : batch.updated)
+    {
+        add(std::move(node));
+    }
+}
+
+void MegaNodeReplica::add(unique_ptr<MegaNode> node)
+{
+    handle h = node->getHandle();
+    handle parent = node->getParentHandle();
+
+    // (references to the entries are not invalidated by the insertion of others)
+    Entry& e = mEntries[h];
+
+    if (e.node && e.node->getParentHandle() != parent)
+    {
+        auto it = mEntries.find(e.node->getParentHandle());
+        if (it != mEntries.end())
+        {
+            it->second.children.erase(h);
+        }
+    }
+
+    if (parent != INVALID_HANDLE)
+    {
+        mEntries[parent].children.insert(h);
+    }
+
+    e.node = std::move(node);
+}
+
+void MegaNodeReplica::remove(handle h)
+{
+    auto it = mEntries.find(h);
+    if (it == mEntries.end())
+    {
+        return;
+    }
+
+    if (it->second.node)
+    {
+        auto parent = mEntries.find(it->second.node->getParentHandle());
+        if (parent != mEntries.end())
+        {
+            parent->second.children.erase(h);
+            if (!parent->second.node && parent->second.children.empty())
+            {
+                mEntries.erase(parent);
+            }
+        }
+    }
+
+    // (its children are removed too, in the same or a later batch)
+    it->second.node.reset();
+    if (it->second.children.empty())
+    {
+        mEntries.erase(it);
+    }
+}
+
+MegaNode* MegaNodeReplica::find(handle h) const
+{
+    auto it = mEntries.find(h);
+    return it != mEntries.end() ? it->second.node.get() : NULL;
+}
+
+MegaNode* MegaNodeReplica::getNodeByHandle(handle h)
+{
+    ReadLock g(*this);
+    MegaNode* node = find(h);
+    return node ? node->copy() : NULL;
+}
+
+MegaNode* MegaNodeReplica::getParentNode(handle h)
+{
+    ReadLock g(*this);
+    MegaNode* node = find(h);
+    MegaNode* parent = node ? find(node->getParentHandle()) : NULL;
+    return parent ? parent->copy() : NULL;
+}
+
+int MegaNodeReplica::getNumChildren(handle h, int type)
+{
+    ReadLock g(*this);
+
+    auto it = mEntries.find(h);
+    if (it == mEntries.end() || !it->second.node || it->second.node->getType() == MegaNode::TYPE_FILE)
+    {
+        return 0;
+    }
+
+    if (type == MegaNode::TYPE_UNKNOWN)
+    {
+        return int(it->second.children.size());
+    }
+
+    // as MegaApi::getNumChildFolders(), anything but files for TYPE_FOLDER
+    int count = 0;
+    for (handle child : it->second.children)
+    {
+        MegaNode* node = find(child);
+        if (node && (node->getType() == MegaNode::TYPE_FILE) == (type == MegaNode::TYPE_FILE))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+MegaNodeList* MegaNodeReplica::getChildren(handle h, int order)
+{
+    if (order != MegaApi::ORDER_NONE && order != MegaApi::ORDER_DEFAULT_ASC && order != MegaApi::ORDER_DEFAULT_DESC)
+    {
+        return NULL;
+    }
+
+    vector<unique_ptr<MegaNode>> children;
+
+    {
+        ReadLock g(*this);
+
+        auto it = mEntries.find(h);
+        if (it != mEntries.end() && it->second.node && it->second.node->getType() != MegaNode::TYPE_FILE)
+        {
+            vector<MegaNode*> nodes;
+            nodes.reserve(it->second.children.size());
+            for (handle child : it->second.children)
+            {
+                if (MegaNode* node = find(child))
+                {
+                    nodes.push_back(node);
+                }
+            }
+
+            if (order != MegaApi::ORDER_NONE)
+            {
+                sortMegaNodesByName(nodes, order == MegaApi::ORDER_DEFAULT_ASC);
+            }
+
+            children.reserve(nodes.size());
+            for (MegaNode* node : nodes)
+            {
+                children.emplace_back(node->copy());
+            }
+        }
+    }
+
+    return new MegaNodeListPrivate(std::move(children));
+}
+
+bool MegaNodeReplica::forEachNode(handle h, bool recursive, const std::function<bool(MegaNode&)>& f)
+{
+    ReadLock g(*this);
+
+    if (h == UNDEF)
+    {
+        for (auto& it : mEntries)
+        {
+            if (it.second.node && !f(*it.second.node))
+            {
+                break;
+            }
+        }
+        return true;
+    }
+
+    auto it = mEntries.find(h);
+    if (it == mEntries.end() || !it->second.node)
+    {
+        return false;
+    }
+
+    // depth first, without recursion as trees can be deep
+    vector<const set<handle>*> pending(1, &it->second.children);
+    while (!pending.empty())
+    {
+        const set<handle>* children = pending.back();
+        pending.pop_back();
+
+        for (handle child : *children)
+        {
+            auto c = mEntries.find(child);
+            if (c == mEntries.end() || !c->second.node)
+            {
+                continue;
+            }
+
+            if (!f(*c->second.node))
+            {
+                return true;
+            }
+
+            if (recursive && !c->second.children.empty())
+            {
+                pending.push_back(&c->second.children);
+            }
+        }
+    }
+    return true;
+}
+
+NodeQueryWorker::NodeQueryWorker(MegaNodeReplica& replica, std::function<void()> notify)
+    : mReplica(replica)
+    , mNotify(std::move(notify))
+    , mThread([this]() { loop(); })
+{
+}
+
+NodeQueryWorker::~NodeQueryWorker()
+{
+    {
+        std::lock_guard<std::mutex> g(mMutex);
+        mExit = true;
+        mGeneration++;
+    }
+    mCondition.notify_all();
+    mThread.join();
+}
+
+void NodeQueryWorker::push(Query query)
+{
+    {
+        std::lock_guard<std::mutex> g(mMutex);
+        mQueries.emplace_back(std::move(query), mGeneration.load());
+    }
+    mCondition.notify_all();
+}
+
+bool NodeQueryWorker::pop(Result& result)
+{
+    std::lock_guard<std::mutex> g(mMutex);
+    if (mResults.empty())
+    {
+        return false;
+    }
+
+    result = std::move(mResults.front());
+    mResults.pop_front();
+    return true;
+}
+
+void NodeQueryWorker::discard()
+{
+    std::unique_lock<std::mutex> g(mMutex);
+    mGeneration++;
+    mQueries.clear();
+    mResults.clear();
+
+    // (the running query stops at the next node, without results)
+    mCondition.wait(g, [this]() { return !mRunning; });
+}
+
+void NodeQueryWorker::interrupt()
+{
+    std::lock_guard<std::mutex> g(mMutex);
+
+    // (the queued queries run against the cleared or rebuilt replica)
+    if (mRunning)
+    {
+        mInterrupted = true;
+    }
+}
+
+void NodeQueryWorker::loop()
+{
+    std::unique_lock<std::mutex> g(mMutex);
+
+    for (;;)
+    {
+        mCondition.wait(g, [this]() { return mExit || !mQueries.empty(); });
+        if (mExit)
+        {
+            return;
+        }
+
+        pair<Query, uint64_t> query = std::move(mQueries.front());
+        mQueries.pop_front();
+        mRunning = true;
+
+        g.unlock();
+        run(query.first, query.second);
+
+        // the batches that arrived during the traversal
+        mReplica.applyPending();
+        g.lock();
+
+        mRunning = false;
+        mInterrupted = false;
+        mCondition.notify_all();
+    }
+}
+
+void NodeQueryWorker::run(const Query& query, uint64_t generation)
+{
+    Result last;
+    last.request = query.request;
+    last.finished = true;
+
+    auto cancelled = [&]()
+    {
+        return mGeneration != generation || mInterrupted || (query.cancelToken && query.cancelToken->isCancelled());
+    };
+
+    auto matches = [&](MegaNode& node)
+    {
+        // (as SearchTreeProcessor: files and folders, but not the root nodes)
+        return !query.search
+                || (node.getType() <= MegaNode::TYPE_FOLDER && node.getName() && strcasestr(node.getName(), query.name.c_str()));
+    };
+
+    // pages are delivered as the nodes are found, unless they have to be sorted first
+    bool sorted = query.order != MegaApi::ORDER_NONE;
+    vector<unique_ptr<MegaNode>> page;
+    vector<MegaNode*> found;
+
+    auto deliverPage = [&]()
+    {
+        last.delivered += static_cast<long long>(page.size());
+
+        Result result;
+        result.request = query.request;
+        result.page.reset(new MegaNodeListPrivate(std::move(page)));
+        result.delivered = last.delivered;
+        result.total = last.total;
+        page.clear();
+        return deliver(std::move(result), generation);
+    };
+
+    bool exists = mReplica.forEachNode(query.node, query.recursive, [&](MegaNode& node)
+    {
+        if (cancelled())
+        {
+            return false;
+        }
+
+        if (!matches(node))
+        {
+            return true;
+        }
+
+        if (sorted)
+        {
+            found.push_back(node.copy());
+            return true;
+        }
+
+        page.emplace_back(node.copy());
+        return page.size() < query.pageSize || deliverPage();
+    });
+
+    if (sorted)
+    {
+        // (the sort runs without the lock)
+        sortMegaNodesByName(found, query.order == MegaApi::ORDER_DEFAULT_ASC || query.order == MegaApi::ORDER_ALPHABETICAL_ASC);
+        last.total = static_cast<long long>(found.size());
+
+        size_t i = 0;
+        for (; i < found.size() && !cancelled(); i++)
+        {
+            page.emplace_back(found[i]);
+            if (page.size() == query.pageSize && !deliverPage())
+            {
+                i++;
+                break;
+            }
+        }
+
+        for (; i < found.size(); i++)
+        {
+            delete found[i];
+        }
+    }
+
+    if (!cancelled() && !page.empty())
+    {
+        deliverPage();
+    }
+
+    if (!exists)
+    {
+        last.e = API_ENOENT;
+    }
+    else if (cancelled())
+    {
+        last.e = API_EINCOMPLETE;
+    }
+    else
+    {
+        last.total = last.delivered;
+    }
+
+    deliver(std::move(last), generation);
+}
+
+bool NodeQueryWorker::deliver(Result result, uint64_t generation)
+{
+    {
+        std::lock_guard<std::mutex> g(mMutex);
+        if (mGeneration != generation)
+        {
+            return false;
+        }
+        mResults.push_back(std::move(result));
+    }
+
+    mNotify();
+    return true;
+}
+
+MegaChildrenPagePrivate::MegaChildrenPagePrivate()
+    : nodes(new MegaNodeListPrivate())
+    , totalSize(0)
+{
+}
+
+MegaChildrenPagePrivate::MegaChildrenPagePrivate(unique_ptr<MegaNodeList> nodes, string nextCursor, int totalSize)
+    : nodes(std::move(nodes))
+    , nextCursor(std::move(nextCursor))
+    , totalSize(totalSize)
+{
+}
+
+MegaChildrenPage *MegaChildrenPagePrivate::copy() const
+{
+    return new MegaChildrenPagePrivate(unique_ptr<MegaNodeList>(nodes->copy()), nextCursor, totalSize);
+}
+
+MegaNodeList *MegaChildrenPagePrivate::getNodes() const
+{
+    return nodes.get();
+}
+
+const char *MegaChildrenPagePrivate::getNextCursor() const
+{
+    return nextCursor.empty() ? NULL : nextCursor.c_str();
+}
+
+int MegaChildrenPagePrivate::getTotalSize() const
+{
+    return totalSize;
+}
+
+node_vector& SortedChildrenCache::get(MegaClient& client, Node* parent, int order)
+{
+    for (auto it = mEntries.begin(); it != mEntries.end(); it++)
+    {
+        if (it->parent == parent->nodehandle && it->order == order)
+        {
+            mEntries.splice(mEntries.begin(), mEntries, it);
+            return mEntries.front().children;
+        }
+    }
+
+    Entry e;
+    e.parent = parent->nodehandle;
+    e.order = order;
+    e.children.assign(parent->children.begin(), parent->children.end());
+    MegaApiImpl::sortByComparatorFunction(e.children, order, client);
+
+    e.members.reserve(e.children.size());
+    for (Node* n : e.children)
+    {
+        e.members.push_back(n->nodehandle);
+    }
+    std::sort(e.members.begin(), e.members.end());
+
+    mEntries.push_front(std::move(e));
+    if (mEntries.size() > MAX_FOLDERS)
+    {
+        mEntries.pop_back();
+    }
+    return mEntries.front().children;
+}
+
+void SortedChildrenCache::invalidate(Node** nodes, int count)
+{
+    if (!nodes)
+    {
+        clear();
+        return;
+    }
+
+    for (auto it = mEntries.begin(); it != mEntries.end(); )
+    {
+        bool affected = false;
+        for (int i = 0; i < count && !affected; i++)
+        {
+            // added, renamed or moved into the folder, or moved out of it or removed
+            Node* n = nodes[i];
+            affected = n->nodehandle == it->parent
+                    || (n->parent && n->parent->nodehandle == it->parent)
+                    || std::binary_search(it->members.begin(), it->members.end(), n->nodehandle);
+        }
+
+        if (affected)
+        {
+            it = mEntries.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+void SortedChildrenCache::clear()
+{
+    mEntries.clear();
+}
+
+size_t SortedChildrenCache::resume(const node_vector& children, const char* cursor)
+{
+    // "<position>.<handle of the last child of the previous page>"
+    char* end = nullptr;
+    size_t position = size_t(strtoull(cursor, &end, 10));
+    handle last = 0;
+    if (!end || *end != '.' || Base64::atob(end + 1, (byte*)&last, MegaClient::NODEHANDLE) != MegaClient::NODEHANDLE)
+    {
+        return 0;
+    }
+
+    if (position && position <= children.size() && children[position - 1]->nodehandle == last)
+    {
+        return position;
+    }
+
+    // the children changed since the previous page
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        if (children[i]->nodehandle == last)
+        {
+            return i + 1;
+        }
+    }
+    return std::min(position, children.size());
+}
+
+string SortedChildrenCache::cursor(const node_vector& children, size_t position)
+{
+    assert(position && position <= children.size());
+    return std::to_string(position) + "." + Base64Str<MegaClient::NODEHANDLE>(children[position - 1]->nodehandle).chars;
+}
+
+const char NodeTreeSnapshot::MAGIC[8] = { 'M', 'E', 'G', 'A', 'N', 'T', 'S', 0 };
+
+// each column padded to a multiple of 8 bytes, so that all of them are aligned
+static uint64_t nextColumn(uint64_t& offset, uint64_t count, uint64_t width)
+{
+    uint64_t column = offset;
+    offset += (count * width + 7) / 8 * 8;
+    return column;
+}
+
+NodeTreeSnapshot::Layout::Layout(uint64_t count)
+{
+    uint64_t offset = HEADER_SIZE;
+    handles = nextColumn(offset, count, sizeof(uint64_t));
+    parents = nextColumn(offset, count, sizeof(uint64_t));
+    sizes = nextColumn(offset, count, sizeof(int64_t));
+    mtimes = nextColumn(offset, count, sizeof(int64_t));
+    ctimes = nextColumn(offset, count, sizeof(int64_t));
+    crcs = nextColumn(offset, count, 4 * sizeof(int32_t));
+    nameOffsets = nextColumn(offset, count, sizeof(uint64_t));
+    nameLengths = nextColumn(offset, count, sizeof(uint32_t));
+    types = nextColumn(offset, count, sizeof(uint8_t));
+    flags = nextColumn(offset, count, sizeof(uint8_t));
+    heap = offset;
+}
+
+void NodeTreeSnapshot::collect(const MegaClient& client, Columns& columns)
+{
+    const node_map& nodes = client.nodes;
+    size_t count = nodes.size();
+    columns.handles.reserve(count);
+    columns.parents.reserve(count);
+    columns.sizes.reserve(count);
+    columns.mtimes.reserve(count);
+    columns.ctimes.reserve(count);
+    columns.crcs.reserve(count);
+    columns.nameOffsets.reserve(count);
+    columns.nameLengths.reserve(count);
+    columns.types.reserve(count);
+    columns.flags.reserve(count);
+
+    static const string noName;
+    for (auto& it : nodes)
+    {
+        const Node* n = it.second;
+        auto name = n->attrs.map.find('n');
+        const string& nodeName = name != n->attrs.map.end() ? name->second : noName;
+
+        columns.handles.push_back(n->nodehandle);
+        columns.parents.push_back(n->parent ? n->parent->nodehandle : UNDEF);
+        columns.sizes.push_back(n->size);
+        columns.mtimes.push_back(n->mtime);
+        columns.ctimes.push_back(n->ctime);
+        columns.crcs.push_back(n->crc);
+        columns.nameOffsets.push_back(columns.heap.size());
+        columns.nameLengths.push_back(uint32_t(nodeName.size()));
+        columns.types.push_back(uint8_t(n->type));
+        columns.flags.push_back(uint8_t((n->isvalid ? 0x01 : 0) | (!n->attrstring ? 0x02 : 0)));
+        columns.heap.append(nodeName.c_str(), nodeName.size() + 1);
+    }
+
+    columns.scsn = client.scsn.text();
+}
+
+error NodeTreeSnapshot::write(FileSystemAccess& fsaccess, const Columns& columns, const LocalPath& path)
+{
+    LocalPath tmpPath = path;
+    tmpPath.append(LocalPath::fromPath(".tmp", fsaccess));
+    fsaccess.unlinklocal(tmpPath);
+
+    auto fa = fsaccess.newfileaccess();
+    if (!fa->fopen(tmpPath, false, true))
+    {
+        LOG_err << "Unable to create the node tree snapshot: " << tmpPath.toPath(fsaccess);
+        return API_EWRITE;
+    }
+
+    uint64_t nodeCount = columns.handles.size();
+    Layout layout(nodeCount);
+    bool ok = true;
+
+    // in slices of CHUNK rows, so that each write stays small whatever the size of the account
+    auto put = [&](uint64_t column, const void* data, size_t width) {
+        for (uint64_t row = 0; ok && row < nodeCount; row += CHUNK)
+        {
+            size_t rows = size_t(std::min<uint64_t>(CHUNK, nodeCount - row));
+            ok = fa->fwrite(static_cast<const byte*>(data) + row * width, unsigned(rows * width), m_off_t(column + row * width));
+        }
+    };
+
+    put(layout.handles, columns.handles.data(), sizeof(uint64_t));
+    put(layout.parents, columns.parents.data(), sizeof(uint64_t));
+    put(layout.sizes, columns.sizes.data(), sizeof(int64_t));
+    put(layout.mtimes, columns.mtimes.data(), sizeof(int64_t));
+    put(layout.ctimes, columns.ctimes.data(), sizeof(int64_t));
+    put(layout.crcs, columns.crcs.data(), 4 * sizeof(int32_t));
+    put(layout.nameOffsets, columns.nameOffsets.data(), sizeof(uint64_t));
+    put(layout.nameLengths, columns.nameLengths.data(), sizeof(uint32_t));
+    put(layout.types, columns.types.data(), sizeof(uint8_t));
+    put(layout.flags, columns.flags.data(), sizeof(uint8_t));
+
+    uint64_t heapSize = columns.heap.size();
+    for (uint64_t offset = 0; ok && offset < heapSize; offset += CHUNK * 64)
+    {
+        size_t bytes = size_t(std::min<uint64_t>(CHUNK * 64, heapSize - offset));
+        ok = fa->fwrite(reinterpret_cast<const byte*>(columns.heap.data()) + offset, unsigned(bytes), m_off_t(layout.heap + offset));
+    }
+
+    // the header goes last, so that the magic number is only there in complete files
+    byte header[HEADER_SIZE] = {};
+    uint32_t version = VERSION;
+    uint32_t headerSize = HEADER_SIZE;
+    int64_t now = m_time();
+    memcpy(header, MAGIC, sizeof MAGIC);
+    memcpy(header + 8, &version, sizeof version);
+    memcpy(header + 12, &headerSize, sizeof headerSize);
+    memcpy(header + 16, &nodeCount, sizeof nodeCount);
+    memcpy(header + 24, &heapSize, sizeof heapSize);
+    memcpy(header + 32, &now, sizeof now);
+    strncpy(reinterpret_cast<char*>(header + 40), columns.scsn.c_str(), 15);
+    ok = ok && fa->fwrite(header, HEADER_SIZE, 0);
+    fa.reset();
+
+    LocalPath target = path;
+    if (!ok || !fsaccess.renamelocal(tmpPath, target, true))
+    {
+        LOG_err << "Unable to write the node tree snapshot: " << path.toPath(fsaccess);
+        fsaccess.unlinklocal(tmpPath);
+        return API_EWRITE;
+    }
+
+    LOG_debug << "Node tree snapshot written: " << nodeCount << " nodes, " << heapSize << " bytes of names";
+    return API_OK;
+}
+
+error NodeTreeSnapshot::write(MegaClient& client, const LocalPath& path, uint64_t* count)
+{
+    Columns columns;
+    collect(client, columns);
+
+    error e = write(*client.fsaccess, columns, path);
+    if (!e && count)
+    {
+        *count = columns.handles.size();
+    }
+    return e;
+}
+
 MegaAchievementsDetails *MegaAchievementsDetailsPrivate::fromAchievementsDetails(AchievementsDetails *details)
 {
     return new MegaAchievementsDetailsPrivate(details);
@@ -64,6 +64,9 @@ const unsigned MegaClient::MAXTOTALTRANSFERS = 48;
 // maximum number of concurrent transfers (uploads or downloads)
 const unsigned MegaClient::MAXTRANSFERS = 32;
 
+// maximum number of queued transfers to open connections for in advance
+const unsigned MegaClient::MAXPRECONNECTLOOKAHEAD = 4;
+
 // maximum number of queued putfa before halting the upload queue
 const int MegaClient::MAXQUEUEDFA = 30;
 
@@ -76,6 +79,9 @@ static constexpr int FREQUENCY_HEARTBEAT_DS = 300;
 
 // //bin/SyncDebris/yyyy-mm-dd base folder name
 const char* const MegaClient::SYNCDEBRISFOLDERNAME = "SyncDebris";
+
+// full syncdown() passes are run at least this often (while remote changes arrive)
+const dstime MegaClient::SYNCDOWN_FULL_INTERVAL_DS = 6000;
 #endif
 
 // exported link marker
@@ -1188,6 +1194,8 @@ void MegaClient::init()
     syncextraretry = false;
     syncsup = true;
     syncdownrequired = false;
+    syncdownchanged = false;
+    syncdownfolders.clear();
     syncuprequired = false;
 
     if (syncscanstate)
@@ -2127,6 +2135,7 @@ void MegaClient::exec()
                     pendingcs = new HttpReq();
                     pendingcs->protect = true;
                     pendingcs->logname = clientname + "cs ";
+                    pendingcs->channel = NETCHANNEL_CS;
                     pendingcs_serverBusySent = false;
 
                     bool suppressSID = true;
@@ -2225,6 +2234,20 @@ void MegaClient::exec()
                     break;
                 }
 
+                if (scfirstdata == std::chrono::steady_clock::time_point())
+                {
+                    scfirstdata = std::chrono::steady_clock::now();
+                }
+
+                if (scstreamstarted)
+                {
+                    // the rest of a streamed response
+                    jsonsc.pos = pendingsc->data();
+                    scstreamlimit = nullptr;
+                    scstreamstalled = false;
+                    break;
+                }
+
                 if (*pendingsc->in.c_str() == '{')
                 {
                     insca = false;
@@ -2327,6 +2350,11 @@ void MegaClient::exec()
                 break;
 
             case REQ_INFLIGHT:
+                if (pendingsc->size() && scfirstdata == std::chrono::steady_clock::time_point())
+                {
+                    scfirstdata = std::chrono::steady_clock::now();
+                }
+
                 if (!pendingscTimedOut && Waiter::ds >= (pendingsc->lastdata + HttpIO::SCREQUESTTIMEOUT))
                 {
                     LOG_debug << "sc timeout expired";
@@ -2373,13 +2401,15 @@ void MegaClient::exec()
 
         // do not process the SC result until all preconfigured syncs are up and running
         // except if SC packets are required to complete a fetchnodes
-        if (!scpaused && jsonsc.pos && (syncsup || !statecurrent) && !syncdownrequired && !syncdownretry)
+        // (a streamed response is resumed last, jsonsc must not be left pointing into it)
+        if (!scpaused && (syncsup || !statecurrent) && !syncdownpending() && !syncdownretry && (jsonsc.pos || resumescstream()))
 #else
-        if (!scpaused && jsonsc.pos)
+        if (!scpaused && (jsonsc.pos || resumescstream()))
 #endif
         {
             // FIXME: reload in case of bad JSON
             bool r = procsc();
+            bool waiting = parkscstream();
 
             if (r)
             {
@@ -2388,10 +2418,11 @@ void MegaClient::exec()
                 btsc.reset();
             }
 #ifdef ENABLE_SYNC
-            else
+            else if (!waiting)
             {
                 // remote changes require immediate attention of syncdown()
-                syncdownrequired = true;
+                // (in the folders that changed, see notifypurge())
+                syncdownchanged = true;
                 syncactivity = true;
             }
 #endif
@@ -2404,6 +2435,7 @@ void MegaClient::exec()
                 assert(!fetchingnodes);
                 pendingscUserAlerts.reset(new HttpReq());
                 pendingscUserAlerts->logname = clientname + "sc50 ";
+                pendingscUserAlerts->channel = NETCHANNEL_SC;
                 pendingscUserAlerts->protect = true;
                 pendingscUserAlerts->posturl = httpio->APIURL;
                 pendingscUserAlerts->posturl.append("sc");  // notifications/useralerts on sc rather than wsc, no timeout
@@ -2416,6 +2448,7 @@ void MegaClient::exec()
             {
                 pendingsc.reset(new HttpReq());
                 pendingsc->logname = clientname + "sc ";
+                pendingsc->channel = NETCHANNEL_SC;
                 if (scnotifyurl.size())
                 {
                     pendingsc->posturl = scnotifyurl;
@@ -2433,6 +2466,12 @@ void MegaClient::exec()
 
                 pendingsc->type = REQ_JSON;
                 pendingsc->post(this);
+
+                scstreamscanner.reset();
+                scstreamstarted = false;
+                scstreamstalled = false;
+                scstreamlimit = nullptr;
+                scfirstdata = std::chrono::steady_clock::time_point();
             }
             jsonsc.pos = NULL;
         }
@@ -2576,15 +2615,23 @@ void MegaClient::exec()
                     {
                         LOG_debug << "Initial delayed scan: " << syncConfig.getLocalPath().toPath(*fsaccess);
 
+                        sync->startprescan(localPath);
+
                         if (sync->scan(&localPath, fa.get()))
                         {
                             syncsup = false;
                             sync->initializing = false;
                             LOG_debug << "Initial delayed scan finished. New / modified files: " << sync->dirnotify->notifyq[DirNotify::DIREVENTS].size();
+
+                            if (sync->dirnotify->notifyq[DirNotify::DIREVENTS].empty())
+                            {
+                                sync->endprescan();
+                            }
                         }
                         else
                         {
                             LOG_err << "Initial delayed scan failed";
+                            sync->endprescan();
                             syncErr = INITIAL_SCAN_FAILED;
                         }
 
@@ -2668,7 +2715,7 @@ void MegaClient::exec()
         // halt all syncing while the local filesystem is pending a lock-blocked operation
         // or while we are fetching nodes
         // FIXME: indicate by callback
-        if (!syncdownretry && !syncadding && statecurrent && !syncdownrequired && !fetchingnodes)
+        if (!syncdownretry && !syncadding && statecurrent && !syncdownpending() && !fetchingnodes)
         {
             // process active syncs, stop doing so while transient local fs ops are pending
             if (syncs.hasRunningSyncs() || syncactivity)
@@ -2677,7 +2724,7 @@ void MegaClient::exec()
                 for (int q = syncfslockretry ? DirNotify::RETRY : DirNotify::DIREVENTS; q >= DirNotify::DIREVENTS; q--)
                 {
                     syncs.forEachRunningSync([&](Sync* sync) {
-                        prevpending = prevpending || sync->dirnotify->notifyq[q].size();
+                        prevpending = prevpending || sync->dirnotify->notifyq[q].size() || sync->pendingfingerprints();
                     });
                     if (prevpending)
                     {
@@ -2713,6 +2760,21 @@ void MegaClient::exec()
                         }
                     }
                 });
+
+                // apply the fingerprints completed by the worker threads
+                // and the changes found by listing the tree again after the initial scan
+                syncs.forEachRunningSync([&](Sync* sync) {
+                    if (sync->procfingerprints())
+                    {
+                        syncops = true;
+                    }
+
+                    if (sync->procverifyscan())
+                    {
+                        syncops = true;
+                    }
+                });
+
                 if (EVER(mindelay))
                 {
                     syncextrabt.backoff(mindelay);
@@ -2736,7 +2798,8 @@ void MegaClient::exec()
                             if (sync->state() == SYNC_ACTIVE || sync->state() == SYNC_INITIALSCAN)
                             {
                                 // process items from the notifyq until depleted
-                                if (sync->dirnotify->notifyq[q].size())
+                                // (waiting for the worker threads if too many fingerprints are pending)
+                                if (sync->dirnotify->notifyq[q].size() && !sync->fingerprintbacklog())
                                 {
                                     dstime dsretry;
 
@@ -2785,8 +2848,14 @@ void MegaClient::exec()
                                     }
                                 }
 
-                                if (sync->state() == SYNC_INITIALSCAN && q == DirNotify::DIREVENTS && !sync->dirnotify->notifyq[q].size())
+                                if (sync->state() == SYNC_INITIALSCAN && q == DirNotify::DIREVENTS && !sync->dirnotify->notifyq[q].size()
+                                 && !sync->pendingfingerprints())
                                 {
+                                    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - sync->initialscanstart).count();
+                                    LOG_debug << "Initial scan finished. Files: " << sync->localnodes[FILENODE]
+                                              << "  Folders: " << sync->localnodes[FOLDERNODE] << "  Seconds: " << secs
+                                              << "  Files/s: " << (secs > 0 ? unsigned(sync->localnodes[FILENODE] / secs) : 0);
+
                                     sync->changestate(SYNC_ACTIVE, NO_SYNC_ERROR, true, true);
 
                                     // scan for items that were deleted while the sync was stopped
@@ -2819,7 +2888,8 @@ void MegaClient::exec()
                         Notification notification;
                         if (q == DirNotify::DIREVENTS)
                         {
-                            scanningpending += sync->dirnotify->notifyq[q].size();
+                            totalpending += sync->pendingfingerprints();
+                            scanningpending += sync->dirnotify->notifyq[q].size() + sync->pendingfingerprints();
                         }
                         else if (!syncfslockretry && sync->dirnotify->notifyq[DirNotify::RETRY].peekFront(notification))
                         {
@@ -2905,6 +2975,11 @@ void MegaClient::exec()
 
                             anyqueued = true;
                         }
+                        else if (sync->pendingfingerprints())
+                        {
+                            // (the worker threads wake us up when they complete)
+                            anyqueued = true;
+                        }
                     });
 
                     if (!anyqueued)
@@ -3066,12 +3141,20 @@ void MegaClient::exec()
                 syncdownrequired = true;
             }
 
-            if (syncdownrequired)
+            if (syncdownpending())
             {
+                // remote changes alone only need the folders where they happened,
+                // but a full pass is still run every now and then
+                bool full = syncdownrequired || Waiter::ds - syncdownfullds >= SYNCDOWN_FULL_INTERVAL_DS;
+                set<NodeHandle> folders;
+                folders.swap(syncdownfolders);
                 syncdownrequired = false;
+                syncdownchanged = false;
+
                 if (!fetchingnodes)
                 {
-                    LOG_verbose << "Running syncdown";
+                    LOG_verbose << "Running syncdown" << (full ? "" : " on changed folders: " + std::to_string(folders.size()));
+                    auto start = std::chrono::steady_clock::now();
                     bool success = true;
                     syncs.forEachRunningSync([&](Sync* sync) {
                         // make sure that the remote synced folder still exists
@@ -3088,8 +3171,20 @@ void MegaClient::exec()
                             LocalPath localpath = sync->localroot->localname;
                             if (sync->state() == SYNC_ACTIVE || sync->state() == SYNC_INITIALSCAN)
                             {
-                                LOG_debug << "Running syncdown on demand";
-                                if (!syncdown(sync->localroot.get(), localpath))
+                                bool synced;
+                                if (full || sync->state() == SYNC_INITIALSCAN || sync->isBackup())
+                                {
+                                    LOG_debug << "Running syncdown on demand";
+                                    CodeCounter::ScopeTimer ccst(performanceStats.syncdownFull);
+                                    synced = syncdown(sync->localroot.get(), localpath);
+                                }
+                                else
+                                {
+                                    CodeCounter::ScopeTimer ccst(performanceStats.syncdownChanged);
+                                    synced = syncdownchangedfolders(sync, folders);
+                                }
+
+                                if (!synced)
                                 {
                                     // a local filesystem item was locked - schedule periodic retry
                                     // and force a full rescan afterwards as the local item may
@@ -3103,6 +3198,14 @@ void MegaClient::exec()
                         }
                     });
 
+                    if (full)
+                    {
+                        syncdownfullds = Waiter::ds;
+                    }
+
+                    LOG_verbose << "Syncdown finished in "
+                                << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms";
+
                     // notify the app if a lock is being retried
                     if (success)
                     {
@@ -3137,6 +3240,11 @@ void MegaClient::exec()
 
         // Flush changes made to internal configs.
         syncs.syncConfigStoreFlush();
+
+        // Propagate and report the treestates changed in this cycle.
+        syncs.forEachRunningSync([](Sync* sync) {
+            sync->flushtreestates();
+        });
 #endif
 
         notifypurge();
@@ -3202,6 +3310,12 @@ void MegaClient::exec()
 
         httpio->updatedownloadspeed();
         httpio->updateuploadspeed();
+
+        // uploads completed while the last cs request was in flight
+        if (!pendingcs && !uploadbatches.empty())
+        {
+            putnodesflush();
+        }
     } while (httpio->doio() || execdirectreads() || (!pendingcs && reqs.cmdspending() && btcs.armed()) || looprequested);
 
 
@@ -3266,7 +3380,7 @@ int MegaClient::preparewait()
 #ifdef ENABLE_SYNC
     // sync directory scans in progress or still processing sc packet without having
     // encountered a locally locked item? don't wait.
-    if (syncactivity || syncdownrequired || (!scpaused && jsonsc.pos && (syncsup || !statecurrent) && !syncdownretry))
+    if (syncactivity || syncdownpending() || (!scpaused && jsonsc.pos && (syncsup || !statecurrent) && !syncdownretry))
     {
         nds = Waiter::ds;
     }
@@ -3311,6 +3425,12 @@ int MegaClient::preparewait()
         if (!pendingcs)
         {
             btcs.update(&nds);
+
+            // batched uploads to be put
+            if (!uploadbatches.empty())
+            {
+                nds = Waiter::ds;
+            }
         }
 
         // retry failed server-client requests
@@ -3390,7 +3510,7 @@ int MegaClient::preparewait()
 
         // retrying of transient failed read ops
         if (syncfslockretry && !syncdownretry && !syncadding
-                && statecurrent && !syncdownrequired && !syncfsopsfailed)
+                && statecurrent && !syncdownpending() && !syncfsopsfailed)
         {
             LOG_debug << "Waiting for a temporary error checking filesystem notification";
             syncfslockretrybt.update(&nds);
@@ -3412,6 +3532,14 @@ int MegaClient::preparewait()
         {
             syncextrabt.update(&nds);
         }
+
+        // treestates changed after this cycle's flush
+        syncs.forEachRunningSync([&](Sync* sync) {
+            if (!sync->treestatechanged.empty() || !sync->treestatefolders.empty())
+            {
+                nds = Waiter::ds;
+            }
+        });
 #endif
 
         // detect stuck network
@@ -3754,6 +3882,24 @@ void MegaClient::dispatchTransfers()
         TransferCategory(GET, SMALLFILE),
     };
 
+    // the transfers that didn't get a slot now are the next ones to start: connect to their storage hosts
+    // (if the URLs are already known) so that they don't pay for DNS, TCP and TLS setup when they do
+    auto preconnectqueued = [&nextInCategory]()
+    {
+        unsigned lookahead = MAXPRECONNECTLOOKAHEAD;
+        for (auto& candidates : nextInCategory)
+        {
+            for (Transfer* t : candidates)
+            {
+                if (!t->slot && t->tempurls.size() && lookahead)
+                {
+                    t->preconnect(true);
+                    lookahead--;
+                }
+            }
+        }
+    };
+
     DBTableTransactionCommitter committer(tctable);
 
     for (auto category : categoryOrder)
@@ -3762,6 +3908,7 @@ void MegaClient::dispatchTransfers()
         {
             if (!slotavail())
             {
+                preconnectqueued();
                 return;
             }
 
@@ -4011,6 +4158,11 @@ void MegaClient::dispatchTransfers()
                     if (nexttransfer->tempurls.size())
                     {
                         ts->transferbuf.setIsRaid(nexttransfer, nexttransfer->tempurls, nexttransfer->pos, ts->maxRequestSize);
+                        if (nexttransfer->type == PUT)
+                        {
+                            // connect while the first chunk is read and encrypted
+                            nexttransfer->preconnect();
+                        }
                         app->transfer_prepare(nexttransfer);
                     }
                     else
@@ -4381,6 +4533,7 @@ void MegaClient::locallogout(bool removecaches, bool keepSyncsConfigFile)
     purgenodesusersabortsc(false);
 
     reqs.clear();
+    uploadbatches.clear();
 
     delete pendingcs;
     pendingcs = NULL;
@@ -4648,8 +4801,25 @@ bool MegaClient::procsc()
 
     for (;;)
     {
+        if (scstreamlimit && jsonsc.pos >= scstreamlimit)
+        {
+            // the rest of the streamed response hasn't arrived yet
+#ifdef ENABLE_SYNC
+            if (newnodes)
+            {
+                applykeys();
+                return false;
+            }
+#endif
+            scstreamwaiting = true;
+            return false;
+        }
+
         if (!insca)
         {
+            // where this member starts, to leave it unparsed when stalling (see below)
+            const char* member = jsonsc.pos;
+
             switch (jsonsc.getnameid())
             {
                 case 'w':
@@ -4808,6 +4978,16 @@ bool MegaClient::procsc()
                     }
                     // fall through
                 default:
+                    if (scstreamlimit)
+                    {
+                        // not known to be complete (a top-level array may be only partly received):
+                        // wait for the whole response, and parse the member again from its name
+                        jsonsc.pos = member;
+                        scstreamstalled = true;
+                        scstreamwaiting = true;
+                        return false;
+                    }
+
                     if (!jsonsc.storeobject())
                     {
                         LOG_err << "Error parsing sc request";
@@ -4818,6 +4998,10 @@ bool MegaClient::procsc()
 
         if (insca)
         {
+#ifdef ENABLE_SYNC
+            // where this packet starts, to leave it unparsed when stalling (see 'd' below)
+            const char* packet = jsonsc.pos;
+#endif
             if (jsonsc.enterobject())
             {
                 // the "a" attribute is guaranteed to be the first in the object
@@ -4896,6 +5080,23 @@ bool MegaClient::procsc()
                                 break;
 
                             case 'd':
+#ifdef ENABLE_SYNC
+                                if (scstreamlimit && !fetchingnodes)
+                                {
+                                    // only the next packet tells whether this is a move, and it may not
+                                    // have arrived yet: rather than taking it for a deletion, which would
+                                    // send the local files to the debris, wait for the whole response
+                                    jsonsc.pos = packet;
+                                    scstreamstalled = true;
+                                    if (newnodes)
+                                    {
+                                        applykeys();
+                                        return false;
+                                    }
+                                    scstreamwaiting = true;
+                                    return false;
+                                }
+#endif
                                 // node deletion
                                 dn = sc_deltree();
 
@@ -5040,6 +5241,11 @@ bool MegaClient::procsc()
                 }
 
                 jsonsc.leaveobject();
+
+                if (nodenotify.size() && scnotifysince == std::chrono::steady_clock::time_point())
+                {
+                    scnotifysince = scfirstdata;
+                }
             }
             else
             {
@@ -5058,6 +5264,68 @@ bool MegaClient::procsc()
     }
 }
 
+// point jsonsc at the part of the in-flight sc response that can be parsed already
+bool MegaClient::resumescstream()
+{
+    if (!scstreaming || scstreamstalled || !pendingsc || pendingsc->status != REQ_INFLIGHT
+            || pendingscUserAlerts || loggingout)
+    {
+        return false;
+    }
+
+    const char* data = pendingsc->data();
+    size_t size = pendingsc->size();
+
+    if (!scstreamstarted && (!size || *data != '{'))
+    {
+        // nothing yet, or an error code: handled once complete
+        return false;
+    }
+
+    size_t limit = scstreamscanner.scan(data, size);
+    if (!limit)
+    {
+        return false;
+    }
+
+    if (!scstreamstarted)
+    {
+        LOG_debug << "Processing sc response while it arrives";
+        performanceStats.scStreamedResponses++;
+        scstreamstarted = true;
+        insca = false;
+        insca_notlast = false;
+        jsonsc.begin(data);
+        jsonsc.enterobject();
+    }
+    else
+    {
+        jsonsc.pos = data;
+    }
+
+    scstreamlimit = data + limit;
+    return true;
+}
+
+// drop the parsed part of an in-flight sc response, returns whether procsc() is waiting for more of it
+// note that action packets already applied are received again if the request fails before "sn"
+bool MegaClient::parkscstream()
+{
+    bool waiting = scstreamwaiting;
+    scstreamwaiting = false;
+
+    if (scstreamlimit && jsonsc.pos && pendingsc)
+    {
+        size_t parsed = size_t(jsonsc.pos - pendingsc->data());
+        pendingsc->purge(parsed);
+        scstreamscanner.consume(parsed);
+        jsonsc.pos = NULL;
+        scstreamlimit = nullptr;
+    }
+
+    return waiting;
+}
+
 // update the user's local state cache, on completion of the fetchnodes command
 // (note that if immediate-completion commands have been issued in the
 // meantime, the state of the affected nodes
@@ -7298,11 +7566,44 @@ void MegaClient::notifypurge(void)
     {
         applykeys();
 
+#ifdef ENABLE_SYNC
+        // the synced folders that the next syncdown() has to look at: the current
+        // and the previous parent of each changed node
+        if (syncs.hasRunningSyncs())
+        {
+            for (i = 0; i < t; i++)
+            {
+                Node* n = nodenotify[i];
+
+                if (n->parent && n->parent->localnode)
+                {
+                    syncdownfolders.insert(n->parent->nodeHandle());
+                }
+
+                if (n->localnode && n->localnode->parent && n->localnode->parent->node)
+                {
+                    syncdownfolders.insert(n->localnode->parent->node->nodeHandle());
+                }
+            }
+        }
+#endif
+
         if (!fetchingnodes)
         {
             app->nodes_updated(&nodenotify[0], t);
         }
 
+        if (scnotifysince != std::chrono::steady_clock::time_point())
+        {
+            // from the arrival of the action packets to their notification
+            uint64_t latency = uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - scnotifysince).count());
+            LOG_debug << "Action packets notified after " << latency << " ms";
+            performanceStats.scNotifications++;
+            performanceStats.scNotifyLatencyMs += latency;
+            performanceStats.scNotifyLatencyMaxMs = std::max(performanceStats.scNotifyLatencyMaxMs, latency);
+            scnotifysince = std::chrono::steady_clock::time_point();
+        }
+
 #ifdef ENABLE_SYNC
 
         //update sync root node location and trigger failing cases
@@ -7942,6 +8243,75 @@ void MegaClient::putnodes(NodeHandle h, vector<NewNode>&& newnodes, const char *
     reqs.add(new CommandPutNodes(this, h, NULL, move(newnodes), tag, PUTNODES_APP, cauth, move(resultFunction)));
 }
 
+// completed uploads are held while a cs request is in flight (they could
+// not be sent before it completes anyway), and then put with a single
+// putnodes per target folder instead of one each
+void MegaClient::putnodesbatch(NodeHandle h, putsource_t source, int tag, unique_ptr<NewNode> newnode)
+{
+    UploadBatch& batch = uploadbatches[std::make_pair(h, source)];
+
+#ifdef ENABLE_SYNC
+    if (source == PUTNODES_SYNC && batch.newnodes.empty())
+    {
+        // syncing is halted until the batch is put (see putnodes_sync_result())
+        syncadding++;
+    }
+#endif
+
+    batch.newnodes.push_back(move(newnode));
+    batch.tags.push_back(tag);
+
+    if (batch.newnodes.size() >= MAX_NEWNODES)
+    {
+        putnodesbatchsend(h, source, batch);
+        uploadbatches.erase(std::make_pair(h, source));
+    }
+}
+
+void MegaClient::putnodesflush()
+{
+    for (auto& it : uploadbatches)
+    {
+        putnodesbatchsend(it.first.first, it.first.second, it.second);
+    }
+
+    uploadbatches.clear();
+}
+
+void MegaClient::putnodesbatchsend(NodeHandle h, putsource_t source, UploadBatch& batch)
+{
+    vector<NewNode> nn;
+    nn.reserve(batch.newnodes.size());
+
+    for (auto& newnode : batch.newnodes)
+    {
+#ifdef ENABLE_SYNC
+        // (the LocalNode is linked to the NewNode sent, which is moved meanwhile)
+        LocalNode* l = newnode->localnode;
+        newnode->localnode.reset();
+#endif
+        nn.push_back(move(*newnode));
+#ifdef ENABLE_SYNC
+        if (l)
+        {
+            nn.back().localnode.crossref(l, &nn.back());
+        }
+#endif
+    }
+
+    if (nn.size() > 1)
+    {
+        LOG_debug << "Putting " << nn.size() << " uploads in " << h;
+    }
+
+    auto command = new CommandPutNodes(this, h, NULL, move(nn), batch.tags.front(), source, nullptr, nullptr);
+    if (batch.tags.size() > 1)
+    {
+        command->mUploadTags = move(batch.tags);
+    }
+    reqs.add(command);
+}
+
 // drop nodes into a user's inbox (must have RSA keypair)
 void MegaClient::putnodes(const char* user, vector<NewNode>&& newnodes, int tag)
 {
@@ -14170,6 +14540,33 @@ bool MegaClient::syncdown(LocalNode* l, LocalPath& localpath)
     return true;
 }
 
+// syncdown() of the given remote folders of the sync, without recursing into
+// the subfolders that were already synced (used when only remote changes are pending)
+bool MegaClient::syncdownchangedfolders(Sync* sync, const set<NodeHandle>& folders)
+{
+    bool success = true;
+
+    for (NodeHandle h : folders)
+    {
+        Node* n = nodeByHandle(h);
+
+        if (n && n->localnode && n->localnode->sync == sync)
+        {
+            LocalPath localpath = n->localnode->getLocalPath();
+
+            SyncdownContext cxt;
+            cxt.mRecursive = false;
+
+            if (!syncdown(n->localnode, localpath, cxt))
+            {
+                success = false;
+            }
+        }
+    }
+
+    return success;
+}
+
 bool MegaClient::syncdown(LocalNode* l, LocalPath& localpath, SyncdownContext& cxt)
 {
     // only use for LocalNodes with a corresponding and properly linked Node
@@ -14264,6 +14661,11 @@ bool MegaClient::syncdown(LocalNode* l, LocalPath& localpath, SyncdownContext& c
                     return l->sync->backupModified();
                 }
             }
+            else if (ll->type == FILENODE && ll->fingerprinting)
+            {
+                // compared once the local fingerprint is known
+                nchildren.erase(rit);
+            }
             else if (ll->type == FILENODE)
             {
                 if (ll->node != rit->second)
@@ -14322,14 +14724,16 @@ bool MegaClient::syncdown(LocalNode* l, LocalPath& localpath, SyncdownContext& c
             }
             else
             {
-                if (ll->node != rit->second)
+                bool linked = ll->node != rit->second;
+                if (linked)
                 {
                     ll->setnode(rit->second);
                     ll->sync->statecacheadd(ll);
                 }
 
-                // recurse into directories of equal name
-                if (!syncdown(ll, localpath, cxt) && success)
+                // recurse into directories of equal name (folders that were linked
+                // already are only examined again if their own children changed)
+                if ((cxt.mRecursive || linked) && !syncdown(ll, localpath, cxt) && success)
                 {
                     success = false;
                 }
@@ -14711,6 +15115,13 @@ bool MegaClient::syncup(LocalNode* l, dstime* nds, size_t& parentPending)
             continue;
         }
 
+        if (ll->fingerprinting)
+        {
+            // revisited once its fingerprint is known
+            insync = false;
+            continue;
+        }
+
         // UTF-8 converted local name
         string localname = ll->localname.toName(*fsaccess, l->sync->mFilesystemType);
         if (!localname.size() || !ll->name.size())
@@ -15035,7 +15446,7 @@ bool MegaClient::syncup(LocalNode* l, dstime* nds, size_t& parentPending)
                     if (t)
                     {
                         ll->sync->localbytes -= ll->size;
-                        ll->genfingerprint(fa.get());
+                        ll->sync->fingerprintcache->genfingerprint(*ll, fa.get());
                         ll->sync->localbytes += ll->size;
 
                         ll->sync->statecacheadd(ll);
@@ -15192,7 +15603,9 @@ bool MegaClient::syncup(LocalNode* l, dstime* nds)
 void MegaClient::syncupdate()
 {
     // split synccreate[] in separate subtrees and send off to putnodes() for
-    // creation on the server
+    // creation on the server, a single putnodes() for all the subtrees beneath
+    // the same existing node (synccreate[] is in parent-first order, and so
+    // is each subtree)
     unsigned i, start, end;
     SymmCipher tkey;
     string tattrstring;
@@ -15200,6 +15613,10 @@ void MegaClient::syncupdate()
     Node* n;
     LocalNode* l;
 
+    // subtrees [start, end) by the handle of their existing parent node
+    // (undefined if it has been deleted)
+    map<NodeHandle, vector<pair<unsigned, unsigned>>> subtrees;
+
     for (start = 0; start < synccreate.size(); start = end)
     {
         // determine length of distinct subtree beneath existing node
@@ -15211,125 +15628,146 @@ void MegaClient::syncupdate()
             }
         }
 
+        Node* parent = synccreate[start]->parent->node;
+        subtrees[parent ? parent->nodeHandle() : NodeHandle()].emplace_back(start, end);
+    }
+
+    for (auto& target : subtrees)
+    {
+        size_t count = 0;
+        for (auto& subtree : target.second)
+        {
+            count += subtree.second - subtree.first;
+        }
+
         // add nodes that can be created immediately: folders & existing files;
         // start uploads of new files
         vector<NewNode> nn;
-        nn.reserve(end - start);
+        nn.reserve(count);
 
         DBTableTransactionCommitter committer(tctable);
-        for (i = start; i < end; i++)
+        for (auto& subtree : target.second)
         {
-            n = NULL;
-            l = synccreate[i];
+            start = subtree.first;
+            end = subtree.second;
 
-            if (l->type == FILENODE)
+            for (i = start; i < end; i++)
             {
-                if (l->parent->node)
+                n = NULL;
+                l = synccreate[i];
+
+                if (l->type == FILENODE)
                 {
-                    l->h = l->parent->node->nodeHandle();
-                }
+                    if (l->parent->node)
+                    {
+                        l->h = l->parent->node->nodeHandle();
+                    }
 
-                l->previousNode = l->node;
-            }
+                    l->previousNode = l->node;
+                }
 
-            if (l->type == FOLDERNODE || (n = nodebyfingerprint(l)))
-            {
-                nn.resize(nn.size() + 1);
-                auto nnp = &nn.back();
+                if (l->type == FOLDERNODE || (n = nodebyfingerprint(l)))
+                {
+                    nn.resize(nn.size() + 1);
+                    auto nnp = &nn.back();
 
-                // create remote folder or copy file if it already exists
-                nnp->source = NEW_NODE;
-                nnp->type = l->type;
-                nnp->syncid = l->syncid;
-                nnp->localnode.crossref(l, nnp);  // also sets l->newnode to nnp
-                nnp->nodehandle = n ? n->nodehandle : l->syncid;
-                nnp->parenthandle = i > start ? l->parent->syncid : UNDEF;
+                    // create remote folder or copy file if it already exists
+                    nnp->source = NEW_NODE;
+                    nnp->type = l->type;
+                    nnp->syncid = l->syncid;
+                    nnp->localnode.crossref(l, nnp);  // also sets l->newnode to nnp
+                    nnp->nodehandle = n ? n->nodehandle : l->syncid;
+                    nnp->parenthandle = i > start ? l->parent->syncid : UNDEF;
 
-                if (n)
-                {
-                    // overwriting an existing remote node? tag it as the previous version or move to SyncDebris
-                    if (l->node && l->node->parent && l->node->parent->localnode)
+                    if (n)
                     {
-                        if (versions_disabled)
+                        // overwriting an existing remote node? tag it as the previous version or move to SyncDebris
+                        if (l->node && l->node->parent && l->node->parent->localnode)
                         {
-                            movetosyncdebris(l->node, l->sync->inshare);
+                            if (versions_disabled)
+                            {
+                                movetosyncdebris(l->node, l->sync->inshare);
+                            }
+                            else
+                            {
+                                nnp->ovhandle = l->node->nodehandle;
+                            }
                         }
-                        else
+
+                        // this is a file - copy, use original key & attributes
+                        // FIXME: move instead of creating a copy if it is in
+                        // rubbish to reduce node creation load
+                        nnp->nodekey = n->nodekey();
+                        tattrs.map = n->attrs.map;
+
+                        nameid rrname = AttrMap::string2nameid("rr");
+                        attr_map::iterator it = tattrs.map.find(rrname);
+                        if (it != tattrs.map.end())
                         {
-                            nnp->ovhandle = l->node->nodehandle;
+                            LOG_debug << "Removing rr attribute";
+                            tattrs.map.erase(it);
                         }
-                    }
-
-                    // this is a file - copy, use original key & attributes
-                    // FIXME: move instead of creating a copy if it is in
-                    // rubbish to reduce node creation load
-                    nnp->nodekey = n->nodekey();
-                    tattrs.map = n->attrs.map;
 
-                    nameid rrname = AttrMap::string2nameid("rr");
-                    attr_map::iterator it = tattrs.map.find(rrname);
-                    if (it != tattrs.map.end())
+                        LOG_debug << "Sync - creating remote file " << l->name << " by copying existing remote file";
+                    }
+                    else
                     {
-                        LOG_debug << "Removing rr attribute";
-                        tattrs.map.erase(it);
+                        // this is a folder - create, use fresh key & attributes
+                        nnp->nodekey.resize(FOLDERNODEKEYLENGTH);
+                        rng.genblock((byte*)nnp->nodekey.data(), FOLDERNODEKEYLENGTH);
+                        tattrs.map.clear();
                     }
 
-                    LOG_debug << "Sync - creating remote file " << l->name << " by copying existing remote file";
+                    // set new name, encrypt and attach attributes
+                    tattrs.map['n'] = l->name;
+                    tattrs.getjson(&tattrstring);
+                    tkey.setkey((const byte*)nnp->nodekey.data(), nnp->type);
+                    nnp->attrstring.reset(new string);
+                    makeattr(&tkey, nnp->attrstring, tattrstring.c_str());
+
+                    l->treestate(TREESTATE_SYNCING);
                 }
-                else
+                else if (l->type == FILENODE)
                 {
-                    // this is a folder - create, use fresh key & attributes
-                    nnp->nodekey.resize(FOLDERNODEKEYLENGTH);
-                    rng.genblock((byte*)nnp->nodekey.data(), FOLDERNODEKEYLENGTH);
-                    tattrs.map.clear();
-                }
+                    l->treestate(TREESTATE_PENDING);
 
-                // set new name, encrypt and attach attributes
-                tattrs.map['n'] = l->name;
-                tattrs.getjson(&tattrstring);
-                tkey.setkey((const byte*)nnp->nodekey.data(), nnp->type);
-                nnp->attrstring.reset(new string);
-                makeattr(&tkey, nnp->attrstring, tattrstring.c_str());
+                    // the overwrite will happen upon PUT completion
+                    nextreqtag();
+                    startxfer(PUT, l, committer);
 
-                l->treestate(TREESTATE_SYNCING);
-            }
-            else if (l->type == FILENODE)
-            {
-                l->treestate(TREESTATE_PENDING);
+                    l->sync->mUnifiedSync.mNextHeartbeat->adjustTransferCounts(1, 0, l->size, 0);
 
-                // the overwrite will happen upon PUT completion
-                nextreqtag();
-                startxfer(PUT, l, committer);
-
-                l->sync->mUnifiedSync.mNextHeartbeat->adjustTransferCounts(1, 0, l->size, 0);
-
-                LOG_debug << "Sync - sending file " << l->getLocalPath().toPath(*fsaccess);
+                    LOG_debug << "Sync - sending file " << l->getLocalPath().toPath(*fsaccess);
+                }
             }
+
+            // this assert fails for the case of two different files uploaded to the same path, and both putnodes occurring in the same exec()
+            assert(target.first.isUndef()
+                   || !synccreate[start]->newnode
+                   || synccreate[start]->type == FOLDERNODE
+                   || synccreate[start]->h == target.first); // if it's a file, it should match
         }
 
-        if (!nn.empty())
+        // add nodes unless parent node has been deleted
+        if (!nn.empty() && !target.first.isUndef() && nodeByHandle(target.first))
         {
-            // add nodes unless parent node has been deleted
-            LocalNode *localNode = synccreate[start];
-            if (localNode->parent->node)
-            {
-                syncadding++;
+            syncadding++;
 
-                // this assert fails for the case of two different files uploaded to the same path, and both putnodes occurring in the same exec()
-                assert(localNode->type == FOLDERNODE
-                       || localNode->h == localNode->parent->node->nodehandle); // if it's a file, it should match
+            if (target.second.size() > 1)
+            {
+                LOG_debug << "Sync - creating " << nn.size() << " nodes in " << target.second.size() << " subtrees beneath " << target.first;
+            }
 
-                auto nextTag = nextreqtag();
-                reqs.add(new CommandPutNodes(this,
-                                                localNode->parent->node->nodeHandle(),
-                                                NULL, move(nn),
-                                                nextTag, //assign a new unused reqtag
-                                                PUTNODES_SYNC,
-                                                nullptr,
-                                                nullptr));
+            auto nextTag = nextreqtag();
+            reqs.add(new CommandPutNodes(this,
+                                            target.first,
+                                            NULL, move(nn),
+                                            nextTag, //assign a new unused reqtag
+                                            PUTNODES_SYNC,
+                                            nullptr,
+                                            nullptr));
 
-                syncactivity = true;
-            }
+            syncactivity = true;
         }
     }
 
@@ -15688,6 +16126,17 @@ void MegaClient::putnodes_syncdebris_result(error, vector<NewNode>& nn)
 }
 #endif
 
+bool MegaClient::genfingerprint(FileFingerprint& fp, FileAccess* fa, const LocalPath& path)
+{
+#ifdef ENABLE_SYNC
+    if (Sync* sync = syncs.runningSyncContainingPath(path))
+    {
+        return sync->fingerprintcache->genfingerprint(fp, fa);
+    }
+#endif
+    return fp.genfingerprint(fa);
+}
+
 // inject file into transfer subsystem
 // if file's fingerprint is not valid, it will be obtained from the local file
 // (PUT) or the file's key (GET)
@@ -15704,7 +16153,7 @@ bool MegaClient::startxfer(direction_t d, File* f, DBTableTransactionCommitter&
 
                 if (fa->fopen(f->localname, d == PUT, d == GET))
                 {
-                    f->genfingerprint(fa.get());
+                    genfingerprint(*f, fa.get(), f->localname);
                 }
             }
 
@@ -15827,7 +16276,7 @@ bool MegaClient::startxfer(direction_t d, File* f, DBTableTransactionCommitter&
                 {
                     if (d == PUT)
                     {
-                        if (f->genfingerprint(fa.get()))
+                        if (genfingerprint(*f, fa.get(), t->localfilename))
                         {
                             LOG_warn << "The local file has been modified: " << localpath;
                             t->tempurls.clear();
@@ -15856,6 +16305,19 @@ bool MegaClient::startxfer(direction_t d, File* f, DBTableTransactionCommitter&
             {
                 t = new Transfer(this, d);
                 *(FileFingerprint*)t = *(FileFingerprint*)f;
+
+                // (resumed transfers keep the class they were saved with)
+                if (f->syncxfer)
+                {
+                    t->bwflow.bwclass = TRANSFERCLASS_SYNC;
+#ifdef ENABLE_SYNC
+                    // backups only upload, from their LocalNodes
+                    if (d == PUT && static_cast<LocalNode*>(f)->sync->isBackup())
+                    {
+                        t->bwflow.bwclass = TRANSFERCLASS_BACKUP;
+                    }
+#endif
+                }
             }
 
             t->skipserialization = donotpersist;
@@ -16420,6 +16882,35 @@ m_off_t MegaClient::getmaxuploadspeed()
     return httpio->getmaxuploadspeed();
 }
 
+void MegaClient::setbandwidthlimits(direction_t d, int bwclass, m_off_t minbps, m_off_t maxbps)
+{
+    if (bwclass == NUM_TRANSFERCLASSES)
+    {
+        bandwidthScheduler.settotallimit(d, maxbps);
+    }
+    else
+    {
+        bandwidthScheduler.setclasslimits(d, transferclass_t(bwclass), minbps, maxbps);
+    }
+
+    // let waiting slots re-evaluate the new budget
+    looprequested = true;
+}
+
+error MegaClient::settransferbandwidthclass(Transfer* t, transferclass_t bwclass, unsigned weight)
+{
+    if (!t || bwclass < 0 || bwclass >= NUM_TRANSFERCLASSES)
+    {
+        return API_EARGS;
+    }
+
+    LOG_debug << "Transfer " << t->tag << " moved to bandwidth class " << bwclass << " weight " << weight;
+    bandwidthScheduler.reclassify(t->type, t->bwflow, bwclass, weight);
+    transfercacheadd(t, nullptr);
+    looprequested = true;
+    return API_OK;
+}
+
 handle MegaClient::getovhandle(Node *parent, string *name)
 {
     handle ovhandle = UNDEF;
@@ -16710,13 +17201,17 @@ std::string MegaClient::PerformanceStats::report(bool reset, HttpIO* httpio, Wai
         << dispatchTransfers.report(reset) << "\n"
         << applyKeys.report(reset) << "\n"
         << scProcessingTime.report(reset) << "\n"
+        << syncdownFull.report(reset) << "\n"
+        << syncdownChanged.report(reset) << "\n"
         << csResponseProcessingTime.report(reset) << "\n"
         << " cs Request waiting time: " << csRequestWaitTime.report(reset) << "\n"
         << " cs requests sent/received: " << reqs.csRequestsSent << "/" << reqs.csRequestsCompleted << " batches: " << reqs.csBatchesSent << "/" << reqs.csBatchesReceived << "\n"
         << " transfers active time: " << transfersActiveTime.report(reset) << "\n"
         << " transfer starts/finishes: " << transferStarts << " " << transferFinishes << "\n"
         << " transfer temperror/fails: " << transferTempErrors << " " << transferFails << "\n"
-        << " nowait reason: immedate: " << prepwaitImmediate << " zero: " << prepwaitZero << " httpio: " << prepwaitHttpio << " fsaccess: " << prepwaitFsaccess << " nonzero waits: " << nonzeroWait << "\n";
+        << " nowait reason: immedate: " << prepwaitImmediate << " zero: " << prepwaitZero << " httpio: " << prepwaitHttpio << " fsaccess: " << prepwaitFsaccess << " nonzero waits: " << nonzeroWait << "\n"
+        << " sc streamed responses: " << scStreamedResponses << " notifications: " << scNotifications
+        << " latency total/max (ms): " << scNotifyLatencyMs << "/" << scNotifyLatencyMaxMs << "\n";
 #ifdef USE_CURL
     if (auto curlhttpio = dynamic_cast<CurlHttpIO*>(httpio))
     {
@@ -16741,6 +17236,7 @@ std::string MegaClient::PerformanceStats::report(bool reset, HttpIO* httpio, Wai
     {
         transferStarts = transferFinishes = transferTempErrors = transferFails = 0;
         prepwaitImmediate = prepwaitZero = prepwaitHttpio = prepwaitFsaccess = nonzeroWait = 0;
+        scStreamedResponses = scNotifications = scNotifyLatencyMs = scNotifyLatencyMaxMs = 0;
     }
     return s.str();
 }
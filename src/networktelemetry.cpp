@@ -0,0 +1,217 @@
+/**
+ * @file networktelemetry.cpp
+ * @brief Per-channel and per-host statistics of completed HTTP requests
+ *
+ * (c) 2013-2014 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/networktelemetry.h"
+#include "mega/json.h"
+#include "mega/utils.h"
+
+namespace mega {
+
+const int LatencyHistogram::BUCKETS;
+const size_t NetworkTelemetry::MAXHOSTS;
+
+void LatencyHistogram::add(int64_t us)
+{
+    if (us < 0)
+    {
+        return;
+    }
+
+    int b = 0;
+    while (b < BUCKETS - 1 && (us >> (b + 1)))
+    {
+        b++;
+    }
+
+    mBuckets[b]++;
+    mCount++;
+    mSum += us;
+    mMax = std::max(mMax, us);
+}
+
+void LatencyHistogram::reset()
+{
+    *this = LatencyHistogram();
+}
+
+int64_t LatencyHistogram::mean() const
+{
+    return mCount ? mSum / int64_t(mCount) : 0;
+}
+
+int64_t LatencyHistogram::percentile(double p) const
+{
+    if (!mCount)
+    {
+        return 0;
+    }
+
+    uint64_t target = uint64_t(p * double(mCount) + 0.5);
+    if (target < 1)
+    {
+        target = 1;
+    }
+
+    uint64_t seen = 0;
+    for (int b = 0; b < BUCKETS; b++)
+    {
+        seen += mBuckets[b];
+        if (seen >= target)
+        {
+            // the bucket's bound can't be above the largest sample
+            return std::min(mMax, (int64_t(2) << b) - 1);
+        }
+    }
+    return mMax;
+}
+
+void LatencyHistogram::tojson(JSONWriter& w, const char* name) const
+{
+    w.beginobject(name);
+    w.arg("n", m_off_t(mCount));
+    if (mCount)
+    {
+        w.arg("mean", m_off_t(mean()));
+        w.arg("p50", m_off_t(percentile(0.5)));
+        w.arg("p90", m_off_t(percentile(0.9)));
+        w.arg("p99", m_off_t(percentile(0.99)));
+        w.arg("max", m_off_t(mMax));
+    }
+    w.endobject();
+}
+
+void NetworkStats::add(const NetworkTiming& t)
+{
+    requests++;
+    if (t.failed)
+    {
+        failures++;
+    }
+    if (t.retry)
+    {
+        retries++;
+    }
+    bytesIn += t.bytesIn;
+    bytesOut += t.bytesOut;
+
+    if (t.newConnection)
+    {
+        // phases of connection setup only exist for new connections
+        newConnections++;
+        dns.add(t.dns);
+        connect.add(t.connect);
+        tls.add(t.tls);
+    }
+
+    if (!t.failed)
+    {
+        ttfb.add(t.ttfb);
+    }
+    total.add(t.total);
+}
+
+void NetworkStats::tojson(JSONWriter& w) const
+{
+    w.arg("requests", m_off_t(requests));
+    w.arg("failures", m_off_t(failures));
+    w.arg("retries", m_off_t(retries));
+    w.arg("connections", m_off_t(newConnections));
+    w.arg("in", bytesIn);
+    w.arg("out", bytesOut);
+    dns.tojson(w, "dns");
+    connect.tojson(w, "connect");
+    tls.tojson(w, "tls");
+    ttfb.tojson(w, "ttfb");
+    total.tojson(w, "total");
+}
+
+NetworkTelemetry::NetworkTelemetry()
+{
+    mSince = m_time();
+}
+
+void NetworkTelemetry::record(netchannel_t c, const string& host, const NetworkTiming& t)
+{
+    mChannels[c < NUM_NETCHANNELS ? c : NETCHANNEL_OTHER].add(t);
+
+    auto it = mHosts.find(host);
+    if (it == mHosts.end())
+    {
+        it = mHosts.emplace(mHosts.size() < MAXHOSTS && !host.empty() ? host : string("*"), NetworkStats()).first;
+    }
+    it->second.add(t);
+}
+
+void NetworkTelemetry::reset()
+{
+    for (auto& c : mChannels)
+    {
+        c = NetworkStats();
+    }
+    mHosts.clear();
+    mSince = m_time();
+}
+
+string NetworkTelemetry::tojson() const
+{
+    JSONWriter w;
+    w.beginobject();
+    w.arg("since", m_off_t(mSince));
+
+    w.beginobject("channels");
+    for (int c = 0; c < NUM_NETCHANNELS; c++)
+    {
+        if (mChannels[c].requests)
+        {
+            w.beginobject(channelname(netchannel_t(c)));
+            mChannels[c].tojson(w);
+            w.endobject();
+        }
+    }
+    w.endobject();
+
+    w.beginobject("hosts");
+    for (auto& h : mHosts)
+    {
+        w.beginobject(h.first.c_str());
+        h.second.tojson(w);
+        w.endobject();
+    }
+    w.endobject();
+
+    w.endobject();
+    return w.getstring();
+}
+
+const char* NetworkTelemetry::channelname(netchannel_t c)
+{
+    switch (c)
+    {
+        case NETCHANNEL_CS: return "cs";
+        case NETCHANNEL_SC: return "sc";
+        case NETCHANNEL_GET: return "get";
+        case NETCHANNEL_PUT: return "put";
+        case NETCHANNEL_FA: return "fa";
+        default: return "other";
+    }
+}
+
+} // namespace
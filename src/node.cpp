@@ -1345,6 +1345,7 @@ LocalNode::LocalNode()
 , reported{false}
 , checked{false}
 , needsRescan(false)
+, fingerprinting(false)
 {}
 
 // initialize fresh LocalNode object - must be called exactly once
@@ -1358,6 +1359,7 @@ void LocalNode::init(Sync* csync, nodetype_t ctype, LocalNode* cparent, const Lo
     created = false;
     reported = false;
     needsRescan = false;
+    fingerprinting = false;
     syncxfer = true;
     newnode.reset();
     parent_dbid = 0;
@@ -1399,7 +1401,7 @@ void LocalNode::init(Sync* csync, nodetype_t ctype, LocalNode* cparent, const Lo
     sync->localnodes[type]++;
 }
 
-// update treestates back to the root LocalNode, inform app about changes
+// update treestate, queueing the parent to be checked and the app to be informed
 void LocalNode::treestate(treestate_t newts)
 {
     if (!sync)
@@ -1409,36 +1411,23 @@ void LocalNode::treestate(treestate_t newts)
         return;
     }
 
-    if (newts != TREESTATE_NONE)
+    if (newts != TREESTATE_NONE && newts != ts)
     {
         ts = newts;
+        sync->client->syncs.mTreeStateChanges++;
     }
 
     if (ts != dts)
     {
-        sync->client->app->syncupdate_treestate(sync->getConfig(), getLocalPath(), ts, type);
+        sync->treestatechanged.insert(this);
     }
 
-    if (parent && ((newts == TREESTATE_NONE && ts != TREESTATE_NONE)
-                   || (ts != dts && (!(ts == TREESTATE_SYNCED && parent->ts == TREESTATE_SYNCED))
-                                 && (!(ts == TREESTATE_SYNCING && parent->ts == TREESTATE_SYNCING))
-                                 && (!(ts == TREESTATE_PENDING && (parent->ts == TREESTATE_PENDING
-                                                                   || parent->ts == TREESTATE_SYNCING))))))
+    // the parent is checked again once its children are up to date: even if
+    // this node flips state many times meanwhile, it is walked up only once
+    if (parent && ((newts == TREESTATE_NONE && ts != TREESTATE_NONE) || ts != dts))
     {
-        treestate_t state = TREESTATE_NONE;
-        if (newts != TREESTATE_NONE && ts == TREESTATE_SYNCING)
-        {
-            state = TREESTATE_SYNCING;
-        }
-        else
-        {
-            state = parent->checkstate();
-        }
-
-        parent->treestate(state);
+        sync->treestatefolders.insert(parent);
     }
-
-    dts = ts;
 }
 
 treestate_t LocalNode::checkstate()
@@ -1523,6 +1512,12 @@ void LocalNode::setfsid(handle newfsid, handlelocalnode_map& fsidnodes)
         }
 
         fsidnodes.erase(fsid_it);
+
+        // replaced by another file
+        if (type == FILENODE && sync->fingerprintcache)
+        {
+            sync->fingerprintcache->remove(fsid);
+        }
     }
 
     fsid = newfsid;
@@ -1567,6 +1562,11 @@ LocalNode::~LocalNode()
 
     newnode.reset();
 
+    if (fingerprinting)
+    {
+        sync->cancelfingerprint(this);
+    }
+
     if (sync->dirnotify.get())
     {
         // deactivate corresponding notifyq records
@@ -1580,6 +1580,12 @@ LocalNode::~LocalNode()
     if (fsid_it != sync->client->fsidnode.end())
     {
         sync->client->fsidnode.erase(fsid_it);
+
+        // and its fingerprint, unless the sync is only being shut down
+        if (type == FILENODE && !sync->mDestructorRunning && sync->fingerprintcache)
+        {
+            sync->fingerprintcache->remove(fsid);
+        }
     }
 
     sync->client->totalLocalNodes--;
@@ -1609,6 +1615,9 @@ LocalNode::~LocalNode()
         delete it++->second;
     }
 
+    sync->treestatechanged.erase(this);
+    sync->treestatefolders.erase(this);
+
     if (node && !sync->mDestructorRunning)
     {
         // move associated node to SyncDebris unless the sync is currently
@@ -587,6 +587,7 @@ bool PosixFileAccess::fopen(LocalPath& f, bool read, bool write, DirAccess* iter
 
             size = 0;
             mtime = statbuf.st_mtime;
+            ctime = statbuf.st_ctime;
             type = FOLDERNODE;
             fsid = (handle)statbuf.st_ino;
             fsidvalid = true;
@@ -658,6 +659,7 @@ bool PosixFileAccess::fopen(LocalPath& f, bool read, bool write, DirAccess* iter
             type = S_ISDIR(statbuf.st_mode) ? FOLDERNODE : FILENODE;
             size = (type == FILENODE || mIsSymLink) ? statbuf.st_size : 0;
             mtime = statbuf.st_mtime;
+            ctime = statbuf.st_ctime;
             // in the future we might want to add LINKNODE to type and set it here using S_ISLNK
             fsid = (handle)statbuf.st_ino;
             fsidvalid = true;
@@ -677,6 +679,207 @@ bool PosixFileAccess::fopen(LocalPath& f, bool read, bool write, DirAccess* iter
     return false;
 }
 
+#ifdef USE_FANOTIFY
+bool Fanotify::open()
+{
+    // (the queue isn't bounded to 16384 events, as a filesystem-wide mark overflows it
+    // easily and each overflow costs a rescan; CAP_SYS_ADMIN is required anyway)
+    mFd = fanotify_init(FAN_CLASS_NOTIF | FAN_REPORT_DFID_NAME | FAN_UNLIMITED_QUEUE | FAN_NONBLOCK | FAN_CLOEXEC,
+                        O_RDONLY | O_LARGEFILE);
+
+    if (mFd < 0)
+    {
+        // EPERM without CAP_SYS_ADMIN, EINVAL before Linux 5.9
+        LOG_debug << "fanotify not available, using inotify. Error code: " << errno;
+        return false;
+    }
+
+    return true;
+}
+
+bool Fanotify::mark(const LocalPath& path, uint64_t& fsid)
+{
+    struct statfs statfsbuf;
+    string p = path.platformEncoded();
+
+    if (mFd < 0 || statfs(p.c_str(), &statfsbuf))
+    {
+        return false;
+    }
+
+    static_assert(sizeof(statfsbuf.f_fsid) == sizeof(fsid), "unexpected fsid size");
+    memcpy(&fsid, &statfsbuf.f_fsid, sizeof fsid);
+
+    // events could not be attributed to the filesystem
+    if (!fsid)
+    {
+        return false;
+    }
+
+    auto it = mMarks.find(fsid);
+    if (it != mMarks.end())
+    {
+        it->second.refs++;
+        return true;
+    }
+
+    int mountfd = ::open(p.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (mountfd < 0)
+    {
+        return false;
+    }
+
+    if (fanotify_mark(mFd, FAN_MARK_ADD | FAN_MARK_FILESYSTEM,
+                      FAN_CREATE | FAN_DELETE | FAN_MOVED_FROM | FAN_MOVED_TO
+                      | FAN_CLOSE_WRITE | FAN_ONDIR,
+                      mountfd, nullptr))
+    {
+        // e.g. EXDEV for btrfs subvolumes, EOPNOTSUPP for filesystems without file handles
+        LOG_warn << "Unable to mark filesystem of " << p << " for fanotify. Error code: " << errno;
+        close(mountfd);
+        return false;
+    }
+
+    mMarks[fsid] = Mark{ mountfd, 1 };
+    return true;
+}
+
+void Fanotify::unmark(uint64_t fsid)
+{
+    auto it = mMarks.find(fsid);
+    if (it == mMarks.end() || --it->second.refs)
+    {
+        return;
+    }
+
+    fanotify_mark(mFd, FAN_MARK_REMOVE | FAN_MARK_FILESYSTEM,
+                  FAN_CREATE | FAN_DELETE | FAN_MOVED_FROM | FAN_MOVED_TO
+                  | FAN_CLOSE_WRITE | FAN_ONDIR,
+                  it->second.mountfd, nullptr);
+
+    close(it->second.mountfd);
+    mMarks.erase(it);
+}
+
+bool Fanotify::read(const Callback& f)
+{
+    static const char deleted[] = " (deleted)";
+    static const size_t deletedsize = sizeof(deleted) - 1;
+
+    bool complete = true;
+    alignas(fanotify_event_metadata) char buf[16384];
+    ssize_t l;
+
+    // handles are only cached within a batch, as directories can be renamed
+    mLastHandle.clear();
+
+    while ((l = ::read(mFd, buf, sizeof buf)) > 0)
+    {
+        fanotify_event_metadata* m = reinterpret_cast<fanotify_event_metadata*>(buf);
+
+        for (; FAN_EVENT_OK(m, l); m = FAN_EVENT_NEXT(m, l))
+        {
+            if (m->fd >= 0)
+            {
+                close(m->fd);
+            }
+
+            if (m->mask & FAN_Q_OVERFLOW)
+            {
+                complete = false;
+                continue;
+            }
+
+            fanotify_event_info_fid* info = reinterpret_cast<fanotify_event_info_fid*>(m + 1);
+
+            if (m->event_len < sizeof(*m) + sizeof(*info)
+             || info->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID_NAME)
+            {
+                continue;
+            }
+
+            uint64_t fsid;
+            memcpy(&fsid, &info->fsid, sizeof fsid);
+
+            auto it = mMarks.find(fsid);
+            if (it == mMarks.end())
+            {
+                continue;
+            }
+
+            file_handle* handle = reinterpret_cast<file_handle*>(info->handle);
+            const char* name = reinterpret_cast<const char*>(handle->f_handle + handle->handle_bytes);
+
+            // about the directory itself
+            if (!strcmp(name, "."))
+            {
+                continue;
+            }
+
+            string key(reinterpret_cast<const char*>(&fsid), sizeof fsid);
+            key.append(reinterpret_cast<const char*>(handle), sizeof(*handle) + handle->handle_bytes);
+
+            if (key != mLastHandle)
+            {
+                mLastHandle = std::move(key);
+                mLastPath.clear();
+
+                int fd = open_by_handle_at(it->second.mountfd, handle, O_PATH);
+                if (fd >= 0)
+                {
+                    char link[32];
+                    char target[PATH_MAX];
+                    snprintf(link, sizeof link, "/proc/self/fd/%d", fd);
+
+                    ssize_t n = readlink(link, target, sizeof target);
+                    if (n > 0 && size_t(n) < sizeof target)
+                    {
+                        mLastPath.assign(target, size_t(n));
+                    }
+                    close(fd);
+                }
+
+                if (mLastPath.size() > deletedsize
+                 && !mLastPath.compare(mLastPath.size() - deletedsize, deletedsize, deleted))
+                {
+                    mLastPath.clear();
+                }
+            }
+
+            // the directory is gone already (its own deletion is notified by its parent)
+            if (mLastPath.empty())
+            {
+                continue;
+            }
+
+            string path = mLastPath;
+            if (path.back() != '/')
+            {
+                path.push_back('/');
+            }
+            path.append(name);
+
+            f(path, m->mask);
+        }
+    }
+
+    return complete;
+}
+
+Fanotify::~Fanotify()
+{
+    for (auto& mark : mMarks)
+    {
+        close(mark.second.mountfd);
+    }
+
+    if (mFd >= 0)
+    {
+        close(mFd);
+    }
+}
+#endif
+
 PosixFileSystemAccess::PosixFileSystemAccess(int fseventsfd)
 {
     assert(sizeof(off_t) == 8);
@@ -714,6 +917,13 @@ PosixFileSystemAccess::PosixFileSystemAccess(int fseventsfd)
     }
 #endif
 
+#if defined(USE_FANOTIFY) && defined(ENABLE_SYNC)
+    if (fanotify.open())
+    {
+        notifyfailed = false;
+    }
+#endif
+
 #ifdef __MACH__
 #if __LP64__
     typedef struct fsevent_clone_args {
@@ -829,12 +1039,31 @@ void PosixFileSystemAccess::addevents(Waiter* w, int /*flags*/)
 
         pw->bumpmaxfd(notifyfd);
     }
+
+#ifdef USE_FANOTIFY
+    if (fanotify.fd() >= 0)
+    {
+        PosixWaiter* pw = (PosixWaiter*)w;
+
+        MEGA_FD_SET(fanotify.fd(), &pw->rfds);
+        MEGA_FD_SET(fanotify.fd(), &pw->ignorefds);
+
+        pw->bumpmaxfd(fanotify.fd());
+    }
+#endif
 }
 
 // read all pending inotify events and queue them for processing
 int PosixFileSystemAccess::checkevents(Waiter* w)
 {
     int r = 0;
+#if defined(USE_FANOTIFY) && defined(ENABLE_SYNC)
+    if (fanotify.fd() >= 0 && MEGA_FD_ISSET(fanotify.fd(), &((PosixWaiter*)w)->rfds))
+    {
+        r |= checkfanotifyevents();
+    }
+#endif
+
     if (notifyfd < 0)
     {
         return r;
@@ -1126,6 +1355,103 @@ int PosixFileSystemAccess::checkevents(Waiter* w)
     return r;
 }
 
+#if defined(USE_FANOTIFY) && defined(ENABLE_SYNC)
+// read all pending fanotify events and queue those below a sync root for processing
+int PosixFileSystemAccess::checkfanotifyevents()
+{
+    int r = 0;
+
+    // the running sync whose root contains `path`, unless it is in its debris folder
+    auto syncof = [this](const string& path, size_t& rootsize) -> Sync*
+    {
+        Sync* found = nullptr;
+
+        client->syncs.forEachRunningSync_shortcircuit([&](Sync* sync) {
+            PosixDirNotify* dn = static_cast<PosixDirNotify*>(sync->dirnotify.get());
+            const string& root = dn->fanotifyroot;
+
+            if (!dn->fanotify
+             || path.size() <= root.size()
+             || path.compare(0, root.size(), root)
+             || path[root.size()] != '/')
+            {
+                return true;
+            }
+
+            const string& ignore = dn->ignore.localpath;
+            size_t i = root.size() + 1;
+
+            if (path.compare(i, ignore.size(), ignore)
+             || (path.size() > i + ignore.size() && path[i + ignore.size()] != '/'))
+            {
+                found = sync;
+                rootsize = root.size();
+            }
+            return false;
+        });
+
+        return found;
+    };
+
+    auto notify = [&r](Sync* sync, const string& path, size_t rootsize)
+    {
+        const char* relative = path.c_str() + rootsize + 1;
+
+        LOG_debug << "Filesystem notification. Root: " << sync->localroot->name << "   Path: " << relative;
+        sync->dirnotify->notify(DirNotify::DIREVENTS,
+                                sync->localroot.get(),
+                                LocalPath::fromPlatformEncoded(relative));
+
+        r |= Waiter::NEEDEXEC;
+    };
+
+    // skip the FAN_MOVED_FROM of moves within a sync, if followed by the FAN_MOVED_TO
+    Sync* fromsync = nullptr;
+    string frompath;
+    size_t fromrootsize = 0;
+
+    bool complete = fanotify.read([&](const string& path, uint64_t mask) {
+        size_t rootsize = 0;
+        Sync* sync = syncof(path, rootsize);
+
+        if (fromsync && !(sync == fromsync && (mask & FAN_MOVED_TO)))
+        {
+            // not followed by its target, so was actually a deletion
+            notify(fromsync, frompath, fromrootsize);
+        }
+        fromsync = nullptr;
+
+        if (!sync)
+        {
+            return;
+        }
+
+        if (mask & FAN_MOVED_FROM)
+        {
+            fromsync = sync;
+            frompath = path;
+            fromrootsize = rootsize;
+        }
+        else
+        {
+            notify(sync, path, rootsize);
+        }
+    });
+
+    if (fromsync)
+    {
+        notify(fromsync, frompath, fromrootsize);
+    }
+
+    if (!complete)
+    {
+        notifyerr = true;
+    }
+
+    return r;
+}
+#endif
+
 // generate unique local filename in the same fs as relatedpath
 void PosixFileSystemAccess::tmpnamelocal(LocalPath& localname) const
 {
@@ -1276,7 +1602,6 @@ void PosixFileSystemAccess::emptydirlocal(LocalPath& name, dev_t basedev)
     dirent* d;
     int removed;
     struct stat statbuf;
-    PosixFileSystemAccess pfsa;
 #ifdef USE_IOS
     const string namestr = adjustBasePath(name);
 #else
@@ -1829,8 +2154,26 @@ PosixDirNotify::PosixDirNotify(const LocalPath& localbasepath, const LocalPath&
     fsaccess = NULL;
 }
 
+PosixDirNotify::~PosixDirNotify()
+{
+#ifdef USE_FANOTIFY
+    if (fanotify && fsaccess)
+    {
+        fsaccess->fanotify.unmark(fanotifyfsid);
+    }
+#endif
+}
+
 void PosixDirNotify::addnotify(LocalNode* l, const LocalPath& path)
 {
+#ifdef USE_FANOTIFY
+    // the whole filesystem is watched already
+    if (fanotify)
+    {
+        return;
+    }
+#endif
+
 #ifdef USE_INOTIFY
     int wd;
 
@@ -1912,6 +2255,22 @@ DirNotify* PosixFileSystemAccess::newdirnotify(const LocalPath& localpath, const
 
     dirnotify->fsaccess = this;
 
+#ifdef USE_FANOTIFY
+    if (fanotify.fd() >= 0)
+    {
+        if (char* root = realpath(localpath.localpath.c_str(), nullptr))
+        {
+            dirnotify->fanotifyroot = root;
+            free(root);
+
+            dirnotify->fanotify = fanotify.mark(localpath, dirnotify->fanotifyfsid);
+        }
+
+        LOG_info << "Filesystem notifications for " << localpath.localpath << ": "
+                 << (dirnotify->fanotify ? "fanotify" : "inotify");
+    }
+#endif
+
     return dirnotify;
 }
 #endif
@@ -2059,7 +2418,6 @@ bool PosixDirAccess::dnext(LocalPath& path, LocalPath& name, bool followsymlinks
 
     dirent* d;
     struct stat &statbuf = currentItemStat;
-    PosixFileSystemAccess pfsa;
 
     while ((d = readdir(dp)))
     {
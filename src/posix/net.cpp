@@ -758,6 +758,7 @@ void CurlHttpIO::processcurlevents(direction_t d)
 CurlHttpIO::~CurlHttpIO()
 {
     disconnecting = true;
+    droppreconnects();
 #ifdef MEGA_USE_C_ARES
     ares_destroy(ares);
 #endif
@@ -821,6 +822,7 @@ void CurlHttpIO::disconnect()
 {
     LOG_debug << "Reinitializing the network layer";
     disconnecting = true;
+    droppreconnects();
     assert(!numconnections[API] && !numconnections[GET] && !numconnections[PUT]);
 
 #ifdef MEGA_USE_C_ARES
@@ -968,6 +970,330 @@ bool CurlHttpIO::cacheresolvedurls(const std::vector<string>& urls, std::vector<
     return true;
 }
 
+const unsigned CurlHttpIO::MAX_PRECONNECTS_PER_HOST = 4;
+
+// a bit less than the time cURL keeps idle connections around
+const dstime CurlHttpIO::PRECONNECT_IDLE_DS = 600;
+
+#ifdef MEGA_USE_C_ARES
+struct PreconnectDNSContext
+{
+    CurlHttpIO* httpio;
+    string hostname;
+    int pending;
+};
+#endif
+
+bool CurlHttpIO::preconnect(direction_t d, const string& url, unsigned connections)
+{
+    if ((d != GET && d != PUT) || disconnecting)
+    {
+        return false;
+    }
+
+    if (proxyurl.size())
+    {
+        // the connection that matters is the one to the proxy, and cURL keeps it alive already
+        return false;
+    }
+
+    string scheme, hostname;
+    int port;
+    if (!crackurl(&url, &scheme, &hostname, &port))
+    {
+        return false;
+    }
+
+    PreconnectHost& host = preconnecthosts[hostname];
+    if (host.scheme[d] != scheme || host.port[d] != port)
+    {
+        // connections opened to another port can't be reused
+        host.scheme[d] = scheme;
+        host.port[d] = port;
+        host.pending[d] = 0;
+        host.idle[d].clear();
+    }
+
+    // forget connections that have been idle for too long, the server will have closed them
+    while (!host.idle[d].empty() && Waiter::ds - host.idle[d].front() > PRECONNECT_IDLE_DS)
+    {
+        host.idle[d].pop_front();
+    }
+
+    unsigned wanted = std::min(connections, MAX_PRECONNECTS_PER_HOST);
+    unsigned available = host.pending[d] + host.inflight[d] + unsigned(host.idle[d].size());
+    if (wanted > available)
+    {
+        host.pending[d] += wanted - available;
+    }
+
+    launchpreconnects(hostname);
+    return true;
+}
+
+void CurlHttpIO::launchpreconnects(const string& hostname)
+{
+    auto it = preconnecthosts.find(hostname);
+    if (it == preconnecthosts.end() || it->second.resolving)
+    {
+        return;
+    }
+    PreconnectHost& host = it->second;
+
+    string hostip;
+#ifdef MEGA_USE_C_ARES
+    auto dnsit = dnscache.find(hostname);
+    if (dnsit != dnscache.end())
+    {
+        CurlDNSEntry& dnsEntry = dnsit->second;
+        if (ipv6requestsenabled && dnsEntry.ipv6.size() && !dnsEntry.isIPv6Expired())
+        {
+            hostip = "[" + dnsEntry.ipv6 + "]";
+        }
+        else if (dnsEntry.ipv4.size() && !dnsEntry.isIPv4Expired())
+        {
+            hostip = dnsEntry.ipv4;
+        }
+    }
+
+    if (hostip.empty())
+    {
+        LOG_debug << "Prefetching IP address for " << hostname;
+        host.resolving = true;
+
+        // set the number of answers upfront, c-ares may complete synchronously
+        PreconnectDNSContext* ctx = new PreconnectDNSContext{ this, hostname, ipv6requestsenabled ? 2 : 1 };
+        if (ipv6requestsenabled)
+        {
+            ares_gethostbyname(ares, hostname.c_str(), PF_INET6, preconnect_dns_callback, ctx);
+        }
+        ares_gethostbyname(ares, hostname.c_str(), PF_INET, preconnect_dns_callback, ctx);
+        return;
+    }
+#else
+    hostip = hostname;
+#endif
+
+    for (direction_t d : { GET, PUT })
+    {
+        for (; host.pending[d]; host.pending[d]--)
+        {
+            CURL* curl = curl_easy_init();
+            if (!curl)
+            {
+                LOG_err << "Unable to open connection in advance to " << hostname;
+                host.pending[d] = 0;
+                break;
+            }
+
+            PreconnectRequest& request = preconnecting[curl];
+            request = PreconnectRequest{ this, hostname, d, nullptr };
+
+            string url = host.scheme[d] + "://" + hostip + ":" + std::to_string(host.port[d]) + "/";
+            request.headers = curl_slist_append(NULL, ("Host: " + hostname).c_str());
+
+            // a HEAD request without CURLOPT_FAILONERROR, so that any reply leaves the connection open
+            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+            curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, request.headers);
+            curl_easy_setopt(curl, CURLOPT_USERAGENT, useragent.c_str());
+            curl_easy_setopt(curl, CURLOPT_SHARE, curlsh);
+            curl_easy_setopt(curl, CURLOPT_NOSIGNAL, true);
+            curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, HttpIO::CONNECTTIMEOUT / 10);
+            curl_easy_setopt(curl, CURLOPT_TIMEOUT, HttpIO::CONNECTTIMEOUT / 5);
+            curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+            curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE,  90L);
+            curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 60L);
+            curl_easy_setopt(curl, CURLOPT_SOCKOPTFUNCTION, preconnect_sockopt_callback);
+            curl_easy_setopt(curl, CURLOPT_SOCKOPTDATA, (void*)&request);
+
+            // same TLS settings as transfer requests (see send_request()), otherwise cURL won't reuse the connection
+            curl_easy_setopt(curl, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2 | CURL_SSLVERSION_MAX_TLSv1_2);
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0);
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0);
+            curl_easy_setopt(curl, CURLOPT_CAINFO, NULL);
+            curl_easy_setopt(curl, CURLOPT_CAPATH, NULL);
+
+            LOG_debug << "Opening connection in advance to " << hostname << " (" << hostip << ") for " << (d == GET ? "downloads" : "uploads");
+
+            host.inflight[d]++;
+            curl_multi_add_handle(curlm[d], curl);
+            statechange = true;
+        }
+    }
+
+    prunepreconnecthost(it);
+}
+
+void CurlHttpIO::finishpreconnect(CURL* curl, bool ok)
+{
+    auto it = preconnecting.find(curl);
+    if (it == preconnecting.end())
+    {
+        return;
+    }
+
+    direction_t d = it->second.d;
+    auto hostit = preconnecthosts.find(it->second.hostname);
+    if (hostit != preconnecthosts.end())
+    {
+        PreconnectHost& host = hostit->second;
+        host.inflight[d]--;
+
+        if (ok)
+        {
+            LOG_debug << "Connection opened in advance to " << hostit->first;
+            host.idle[d].push_back(Waiter::ds);
+            preconnectsopened[d]++;
+        }
+        else
+        {
+            LOG_debug << "Unable to open connection in advance to " << hostit->first;
+        }
+
+        prunepreconnecthost(hostit);
+    }
+
+    curl_slist_free_all(it->second.headers);
+    preconnecting.erase(it);
+}
+
+void CurlHttpIO::claimpreconnect(CurlHttpContext* httpctx)
+{
+    direction_t d = httpctx->d;
+    if (d != GET && d != PUT)
+    {
+        return;
+    }
+
+    auto it = preconnecthosts.find(httpctx->hostname);
+    if (it == preconnecthosts.end() || it->second.port[d] != httpctx->port)
+    {
+        return;
+    }
+    PreconnectHost& host = it->second;
+
+    while (!host.idle[d].empty() && Waiter::ds - host.idle[d].front() > PRECONNECT_IDLE_DS)
+    {
+        host.idle[d].pop_front();
+    }
+
+    if (!host.idle[d].empty())
+    {
+        // both requests go to curlm[d], so cURL should take the connection from its cache
+        // (recordtelemetry() checks that it actually did)
+        LOG_debug << "Expecting to reuse connection opened in advance to " << httpctx->hostname;
+        host.idle[d].pop_front();
+        httpctx->preconnected = true;
+    }
+    else if (host.pending[d])
+    {
+        // this request opens the connection by itself
+        host.pending[d]--;
+    }
+
+    prunepreconnecthost(it);
+}
+
+void CurlHttpIO::prunepreconnecthost(std::map<string, PreconnectHost>::iterator it)
+{
+    PreconnectHost& host = it->second;
+    for (direction_t d : { GET, PUT })
+    {
+        while (!host.idle[d].empty() && Waiter::ds - host.idle[d].front() > PRECONNECT_IDLE_DS)
+        {
+            host.idle[d].pop_front();
+        }
+    }
+
+    if (!host.resolving && !host.pending[GET] && !host.pending[PUT]
+            && !host.inflight[GET] && !host.inflight[PUT]
+            && host.idle[GET].empty() && host.idle[PUT].empty())
+    {
+        preconnecthosts.erase(it);
+    }
+}
+
+void CurlHttpIO::recordtelemetry(CURL* curl, HttpReq* req)
+{
+    NetworkTiming t;
+    t.failed = req->status != REQ_SUCCESS;
+
+    // the same HttpReq is sent again after failures, by the engine or by the IPv4 fallback below
+    t.retry = req->retry;
+    req->retry = t.failed;
+
+    long connects = 0;
+    if (curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &connects) == CURLE_OK)
+    {
+        t.newConnection = connects > 0;
+    }
+
+    // cURL reports times from the start of the request, each including the previous phases
+#if LIBCURL_VERSION_NUM >= 0x073d00 // At least cURL 7.61.0
+    curl_off_t namelookup = 0, connect = 0, appconnect = 0, starttransfer = 0, total = 0;
+    curl_off_t sizein = 0, sizeout = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &namelookup);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &appconnect);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &starttransfer);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &sizein);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_UPLOAD_T, &sizeout);
+#else
+    double namelookup = 0, connect = 0, appconnect = 0, starttransfer = 0, total = 0;
+    double sizein = 0, sizeout = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME, &namelookup);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &appconnect);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &starttransfer);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD, &sizein);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_UPLOAD, &sizeout);
+    namelookup *= 1000000;
+    connect *= 1000000;
+    appconnect *= 1000000;
+    starttransfer *= 1000000;
+    total *= 1000000;
+#endif
+
+    if (t.newConnection && connect > 0)
+    {
+        t.dns = int64_t(namelookup);
+        t.connect = int64_t(connect - namelookup);
+        if (appconnect >= connect)
+        {
+            t.tls = int64_t(appconnect - connect);
+        }
+    }
+    if (starttransfer > 0)
+    {
+        t.ttfb = int64_t(starttransfer);
+    }
+    t.total = int64_t(total);
+    t.bytesIn = m_off_t(sizein);
+    t.bytesOut = m_off_t(sizeout);
+
+    CurlHttpContext* httpctx = (CurlHttpContext*)req->httpiohandle;
+    if (httpctx && httpctx->preconnected && !t.newConnection)
+    {
+        preconnectsclaimed[httpctx->d]++;
+    }
+    telemetry.record(req->channel, httpctx ? httpctx->hostname : string(), t);
+}
+
+void CurlHttpIO::droppreconnects()
+{
+    for (auto& p : preconnecting)
+    {
+        curl_multi_remove_handle(curlm[p.second.d], p.first);
+        curl_easy_cleanup(p.first);
+        curl_slist_free_all(p.second.headers);
+    }
+    preconnecting.clear();
+    preconnecthosts.clear();
+}
+
 // wake up from cURL I/O
 void CurlHttpIO::addevents(Waiter* w, int)
 {
@@ -1420,6 +1746,67 @@ struct curl_slist* CurlHttpIO::clone_curl_slist(struct curl_slist* inlist)
     return outlist;
 }
 
+#ifdef MEGA_USE_C_ARES
+void CurlHttpIO::preconnect_dns_callback(void* arg, int status, int, struct hostent* host)
+{
+    PreconnectDNSContext* ctx = (PreconnectDNSContext*)arg;
+    CurlHttpIO* httpio = ctx->httpio;
+
+    if (status == ARES_SUCCESS && host && host->h_addr_list[0])
+    {
+        char ip[INET6_ADDRSTRLEN];
+        mega_inet_ntop(host->h_addrtype, host->h_addr_list[0], ip, sizeof(ip));
+
+        LOG_debug << "Prefetched IP for " << ctx->hostname << ": " << ip;
+
+        CurlDNSEntry& dnsEntry = httpio->dnscache[ctx->hostname];
+        if (host->h_addrtype == PF_INET6)
+        {
+            dnsEntry.ipv6 = ip;
+            dnsEntry.ipv6timestamp = Waiter::ds;
+        }
+        else
+        {
+            dnsEntry.ipv4 = ip;
+            dnsEntry.ipv4timestamp = Waiter::ds;
+        }
+    }
+
+    if (--ctx->pending)
+    {
+        return;
+    }
+
+    string hostname = move(ctx->hostname);
+    delete ctx;
+
+    if (status == ARES_EDESTRUCTION)
+    {
+        return;
+    }
+
+    auto it = httpio->preconnecthosts.find(hostname);
+    if (it == httpio->preconnecthosts.end())
+    {
+        return;
+    }
+
+    it->second.resolving = false;
+
+    auto dnsit = httpio->dnscache.find(hostname);
+    if (httpio->disconnecting || dnsit == httpio->dnscache.end() || (dnsit->second.ipv4.empty() && dnsit->second.ipv6.empty()))
+    {
+        // the first request will try again
+        LOG_warn << "Unable to prefetch IP address for " << hostname;
+        it->second.pending[GET] = it->second.pending[PUT] = 0;
+        httpio->prunepreconnecthost(it);
+        return;
+    }
+
+    httpio->launchpreconnects(hostname);
+}
+#endif
+
 void CurlHttpIO::send_request(CurlHttpContext* httpctx)
 {
     CurlHttpIO* httpio = httpctx->httpio;
@@ -1624,6 +2011,7 @@ void CurlHttpIO::send_request(CurlHttpContext* httpctx)
             }
         }
 
+        httpio->claimpreconnect(httpctx);
         httpio->numconnections[httpctx->d]++;
         curl_multi_add_handle(httpio->curlm[httpctx->d], curl);
         httpctx->curl = curl;
@@ -2285,9 +2673,10 @@ bool CurlHttpIO::multidoio(CURLM *curlmhandle)
                 }
 
                 // check httpstatus and response length
+                // (bufpos counts all data received, including what a streaming consumer already purged)
                 req->status = (req->httpstatus == 200
                                && (req->contentlength < 0
-                                   || req->contentlength == (req->buf ? req->bufpos : (int)req->in.size())))
+                                   || req->contentlength == req->bufpos))
                         ? REQ_SUCCESS : REQ_FAILURE;
 
                 if (req->status == REQ_SUCCESS)
@@ -2312,6 +2701,11 @@ bool CurlHttpIO::multidoio(CURLM *curlmhandle)
                 req->status = REQ_FAILURE;
             }
 
+            if (msg->msg == CURLMSG_DONE)
+            {
+                recordtelemetry(msg->easy_handle, req);
+            }
+
             statechange = true;
 
             if (req->status == REQ_FAILURE && !req->httpstatus)
@@ -2387,6 +2781,7 @@ bool CurlHttpIO::multidoio(CURLM *curlmhandle)
         else
         {
             req = NULL;
+            finishpreconnect(msg->easy_handle, msg->msg == CURLMSG_DONE && msg->data.result == CURLE_OK);
         }
 
         curl_multi_remove_handle(curlmhandle, msg->easy_handle);
@@ -2738,6 +3133,33 @@ int CurlHttpIO::sockopt_callback(void *clientp, curl_socket_t, curlsocktype)
     return CURL_SOCKOPT_OK;
 }
 
+// same as sockopt_callback(), for the HEAD requests that open connections in advance
+int CurlHttpIO::preconnect_sockopt_callback(void *clientp, curl_socket_t, curlsocktype)
+{
+#ifdef MEGA_USE_C_ARES
+    PreconnectRequest* request = (PreconnectRequest*)clientp;
+    CurlHttpIO* httpio = request->httpio;
+    auto dnsit = httpio->dnscache.find(request->hostname);
+    auto it = httpio->preconnecthosts.find(request->hostname);
+    if (!httpio->disconnecting && dnsit != httpio->dnscache.end() && dnsit->second.mNeedsResolvingAgain
+            && it != httpio->preconnecthosts.end() && !it->second.resolving)
+    {
+        dnsit->second.mNeedsResolvingAgain = false;
+        it->second.resolving = true;
+
+        LOG_debug << "Resolving IP address for " << request->hostname << " during connection in advance";
+        PreconnectDNSContext* ctx = new PreconnectDNSContext{ httpio, request->hostname, httpio->ipv6requestsenabled ? 2 : 1 };
+        if (httpio->ipv6requestsenabled)
+        {
+            ares_gethostbyname(httpio->ares, request->hostname.c_str(), PF_INET6, preconnect_dns_callback, ctx);
+        }
+        ares_gethostbyname(httpio->ares, request->hostname.c_str(), PF_INET, preconnect_dns_callback, ctx);
+    }
+#endif
+
+    return CURL_SOCKOPT_OK;
+}
+
 int CurlHttpIO::api_socket_callback(CURL *e, curl_socket_t s, int what, void *userp, void *socketp)
 {
     return socket_callback(e, s, what, userp, socketp, API);
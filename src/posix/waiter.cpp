@@ -153,14 +153,12 @@ int PosixWaiter::wait()
     uint8_t buf;
     bool external = false;
 
+    // reset after emptying it, a notification in between only causes an extra wakeup
+    while (read(m_pipe[0], &buf, sizeof buf) > 0)
     {
-        std::lock_guard<std::mutex> g(mMutex);
-        while (read(m_pipe[0], &buf, sizeof buf) > 0)
-        {
-            external = true;
-        }
-        alreadyNotified = false;
+        external = true;
     }
+    alreadyNotified.store(false);
 
     // timeout or error
     if (external || numfd <= 0)
@@ -188,11 +186,10 @@ int PosixWaiter::wait()
 
 void PosixWaiter::notify()
 {
-    std::lock_guard<std::mutex> g(mMutex);
-    if (!alreadyNotified)
+    // without a lock, as app threads notify for every request and transfer they queue
+    if (!alreadyNotified.exchange(true))
     {
         write(m_pipe[1], "0", 1);
-        alreadyNotified = true;
     }
 }
 } // namespace
@@ -19,6 +19,7 @@
  * program.
  */
 #include <cctype>
+#include <chrono>
 #include <type_traits>
 #include <unordered_set>
 
@@ -39,6 +40,9 @@ const int Sync::EXTRA_SCANNING_DELAY_DS = 150;
 const int Sync::FILE_UPDATE_DELAY_DS = 30;
 const int Sync::FILE_UPDATE_MAX_DELAY_SECS = 60;
 const dstime Sync::RECENT_VERSION_INTERVAL_SECS = 10800;
+const unsigned Sync::PRESCAN_THREADS = 4;
+const size_t Sync::MAX_PENDING_FINGERPRINTS = 256;
+const unsigned Sync::SCANNING_BATCH_MS = 50;
 
 namespace {
 
@@ -140,7 +144,7 @@ void hashCombineFingerprint(LightFileFingerprint& ffp, const LightFileFingerprin
 }
 
 // Combines the fingerprints of all file nodes in the given map
-bool combinedFingerprint(LightFileFingerprint& ffp, const localnode_map& nodeMap)
+bool combinedFingerprint(LightFileFingerprint& ffp, const LocalNodeChildren& nodeMap)
 {
     bool success = false;
     for (const auto& nodePair : nodeMap)
@@ -917,6 +921,28 @@ Sync::Sync(UnifiedSync& us, const char* cdebris,
             readstatecache();
         }
     }
+
+    fingerprintcache = std::make_shared<LocalFingerprintCache>();
+    if (client->dbaccess)
+    {
+        fingerprinttable.reset(client->dbaccess->open(client->rng, *client->fsaccess, fingerprinttablename(getConfig().getBackupId(), client->me)));
+        if (fingerprinttable)
+        {
+            // kept as they are: files deleted meanwhile, whose fsids may have been reused,
+            // are told apart by their ctime when looked up
+            fingerprintcache->load(*fingerprinttable, client->key);
+        }
+    }
+}
+
+string Sync::fingerprinttablename(handle backupId, handle me)
+{
+    handle tableid[2] = { backupId, me };
+    string dbname;
+
+    dbname.resize(sizeof tableid * 4 / 3 + 3);
+    dbname.resize(Base64::btoa((byte*)tableid, sizeof tableid, (char*)dbname.c_str()));
+    return "fp_" + dbname;
 }
 
 Sync::~Sync()
@@ -924,6 +950,18 @@ Sync::~Sync()
     // must be set to prevent remote mass deletion while rootlocal destructor runs
     mDestructorRunning = true;
 
+    // stop listing folders in the background
+    prescan.reset();
+    verifyscan.reset();
+
+    // and fingerprinting
+    for (auto& job : fingerprintjobs)
+    {
+        job.second->cancelled = true;
+        job.second->node->fingerprinting = false;
+    }
+    fingerprintjobs.clear();
+
     // unlock tmp lock
     tmpfa.reset();
 
@@ -940,6 +978,12 @@ Sync::~Sync()
     // Close the database so that deleting localnodes will not remove them
     statecachetable.reset();
 
+    if (fingerprinttable)
+    {
+        fingerprintcache->save(*fingerprinttable, client->key);
+        fingerprinttable.reset();
+    }
+
     client->syncactivity = true;
 
     {
@@ -1139,6 +1183,11 @@ void Sync::statecacheadd(LocalNode* l)
 
 void Sync::cachenodes()
 {
+    if (fingerprinttable)
+    {
+        fingerprintcache->save(*fingerprinttable, client->key);
+    }
+
     // Purge the queues if we have no state cache.
     if (!statecachetable)
     {
@@ -1188,6 +1237,59 @@ void Sync::cachenodes()
     }
 }
 
+void Sync::flushtreestates()
+{
+    // each pass updates the folders whose children changed, queueing their
+    // parents for the next one, so that a folder is checked once per level
+    while (!treestatefolders.empty())
+    {
+        set<LocalNode*> folders;
+        folders.swap(treestatefolders);
+
+        for (LocalNode* l : folders)
+        {
+            treestate_t state = l->checkstate();
+            if (state != l->ts)
+            {
+                l->treestate(state);
+            }
+        }
+    }
+
+    vector<pair<LocalPath, treestate_t>> batch;
+
+    for (LocalNode* l : treestatechanged)
+    {
+        if (l->ts == l->dts)
+        {
+            // changed back since the last report
+            continue;
+        }
+
+        if (l->type == FOLDERNODE || !client->syncs.mTreeStateFoldersOnly)
+        {
+            if (client->syncs.mTreeStateBatched)
+            {
+                batch.emplace_back(l->getLocalPath(), l->ts);
+            }
+            else
+            {
+                client->app->syncupdate_treestate(getConfig(), l->getLocalPath(), l->ts, l->type);
+            }
+            client->syncs.mTreeStateNotifications++;
+        }
+
+        l->dts = l->ts;
+    }
+
+    treestatechanged.clear();
+
+    if (!batch.empty())
+    {
+        client->app->syncupdate_treestates(getConfig(), batch);
+    }
+}
+
 void Sync::changestate(syncstate_t newstate, SyncError newSyncError, bool newEnableFlag, bool notifyApp)
 {
     auto& config = getConfig();
@@ -1324,9 +1426,6 @@ bool Sync::scan(LocalPath* localpath, FileAccess* fa)
     }
     if (!localdebris.isContainingPathOf(*localpath))
     {
-        DirAccess* da;
-        LocalPath localname;
-        string name;
         bool success;
 
         if (SimpleLogger::logCurrentLevel >= logDebug)
@@ -1334,52 +1433,345 @@ bool Sync::scan(LocalPath* localpath, FileAccess* fa)
             LOG_debug << "Scanning folder: " << localpath->toPath(*client->fsaccess);
         }
 
-        da = client->fsaccess->newdiraccess();
-
-        // scan the dir, mark all items with a unique identifier
-        if ((success = da->dopen(localpath, fa, false)))
+        auto visit = [&](const LocalPath& localname, DirAccess* iteratingDir, const ScannedEntry* scanned)
         {
-            while (da->dnext(*localpath, localname, client->followsymlinks))
-            {
-                name = localname.toName(*client->fsaccess, mFilesystemType);
+            string name = localname.toName(*client->fsaccess, mFilesystemType);
 
-                ScopedLengthRestore restoreLen(*localpath);
-                localpath->appendWithSeparator(localname, false);
+            ScopedLengthRestore restoreLen(*localpath);
+            localpath->appendWithSeparator(localname, false);
 
-                // check if this record is to be ignored
-                if (client->app->sync_syncable(this, name.c_str(), *localpath))
+            // what the listing already knows about the entry, for size-based exclusions
+            // (otherwise the entry is only opened by checkpath())
+            nodetype_t type = TYPE_UNKNOWN;
+            m_off_t size = -1;
+            if (scanned)
+            {
+                type = scanned->type;
+                size = scanned->size;
+            }
+            else if (iteratingDir && client->app->sync_syncable_needs_size())
+            {
+                auto fa = client->fsaccess->newfileaccess(false);
+                if (fa->fopen(*localpath, false, false, iteratingDir))
+                {
+                    type = fa->type;
+                    size = fa->size;
+                }
+            }
+
+            // check if this record is to be ignored
+            if (client->app->sync_syncable(this, name.c_str(), *localpath, type, size))
+            {
+                // skip the sync's debris folder
+                if (!localdebris.isContainingPathOf(*localpath))
                 {
-                    // skip the sync's debris folder
-                    if (!localdebris.isContainingPathOf(*localpath))
+                    LocalNode *l = NULL;
+                    if (initializing)
                     {
-                        LocalNode *l = NULL;
-                        if (initializing)
-                        {
-                            // preload all cached LocalNodes
-                            l = checkpath(NULL, localpath, nullptr, nullptr, false, da);
-                        }
+                        // preload all cached LocalNodes
+                        l = checkpath(NULL, localpath, nullptr, nullptr, false, iteratingDir, scanned);
+                    }
 
-                        if (!l || l == (LocalNode*)~0)
-                        {
-                            // new record: place in notification queue
-                            dirnotify->notify(DirNotify::DIREVENTS, NULL, LocalPath(*localpath));
-                        }
+                    if (!l || l == (LocalNode*)~0)
+                    {
+                        // new record: place in notification queue
+                        dirnotify->notify(DirNotify::DIREVENTS, NULL, LocalPath(*localpath));
                     }
                 }
-                else
+            }
+            else
+            {
+                LOG_debug << "Excluded: " << name;
+            }
+        };
+
+        unique_ptr<ScannedFolder> listed;
+        if (prescan)
+        {
+            listed = prescan->take(*localpath);
+        }
+
+        if (listed)
+        {
+            // already listed in the background
+            success = true;
+            for (const ScannedEntry& entry : listed->entries)
+            {
+                visit(entry.name, nullptr, entry.valid ? &entry : nullptr);
+            }
+        }
+        else
+        {
+            unique_ptr<DirAccess> da(client->fsaccess->newdiraccess());
+            LocalPath localname;
+
+            // scan the dir, mark all items with a unique identifier
+            if ((success = da->dopen(localpath, fa, false)))
+            {
+                while (da->dnext(*localpath, localname, client->followsymlinks))
                 {
-                    LOG_debug << "Excluded: " << name;
+                    visit(localname, da.get(), nullptr);
                 }
             }
         }
 
-        delete da;
-
         return success;
     }
     else return false;
 }
 
+void Sync::startprescan(const LocalPath& root)
+{
+    initialscanstart = std::chrono::steady_clock::now();
+
+    if (!PRESCAN_THREADS)
+    {
+        return;
+    }
+
+    // (no need to wake up the client: scan() never waits for the listings)
+    prescan.reset(new ParallelDirScanner(*client->fsaccess, nullptr, PRESCAN_THREADS, client->followsymlinks));
+
+    LocalPath debrisPath = localdebris;
+    prescan->start(root, [debrisPath](const LocalPath& path)
+    {
+        return debrisPath.isContainingPathOf(path);
+    });
+}
+
+void Sync::endprescan()
+{
+    if (prescan)
+    {
+        ParallelDirScanner::Stats stats = prescan->stats();
+        LOG_debug << "Background listing ended. Folders: " << stats.folders << "  Entries: " << stats.entries
+                  << "  Failed: " << stats.failedFolders;
+        prescan.reset();
+
+        if (!initializing)
+        {
+            // every folder is watched by now
+            verifyscan.reset(new ParallelDirScanner(*client->fsaccess, client->waiter, PRESCAN_THREADS, client->followsymlinks));
+
+            LocalPath debrisPath = localdebris;
+            verifyscan->start(localroot->getLocalPath(), [debrisPath](const LocalPath& path)
+            {
+                return debrisPath.isContainingPathOf(path);
+            });
+        }
+    }
+}
+
+bool Sync::procverifyscan()
+{
+    if (!verifyscan)
+    {
+        return false;
+    }
+
+    // (what completes after this is left for the next call)
+    bool done = verifyscan->done();
+    bool changed = false;
+
+    while (unique_ptr<ScannedFolder> folder = verifyscan->next())
+    {
+        // (a folder without LocalNode is new or excluded, and its parent tells which)
+        LocalNode* parent = localnodebypath(nullptr, folder->path);
+        if (!parent || parent->type != FOLDERNODE)
+        {
+            continue;
+        }
+
+        LocalPath path = folder->path;
+        set<LocalNode*> listed;
+
+        for (const ScannedEntry& entry : folder->entries)
+        {
+            ScopedLengthRestore restoreLen(path);
+            path.appendWithSeparator(entry.name, false);
+
+            LocalPath name = entry.name;
+            LocalNode* l = parent->childbyname(&name);
+            if (l)
+            {
+                listed.insert(l);
+
+                if (entry.valid && l->type == entry.type
+                    && (l->type != FILENODE || (l->size == entry.size && l->mtime == entry.mtime)))
+                {
+                    continue;
+                }
+            }
+            else if (localdebris.isContainingPathOf(path)
+                     || !client->app->sync_syncable(this, name.toName(*client->fsaccess, mFilesystemType).c_str(), path,
+                                                    entry.type, entry.valid ? entry.size : -1))
+            {
+                continue;
+            }
+
+            dirnotify->notify(DirNotify::DIREVENTS, NULL, LocalPath(path));
+            changed = true;
+        }
+
+        // and the vanished ones
+        for (auto& child : parent->children)
+        {
+            if (!listed.count(child.second))
+            {
+                dirnotify->notify(DirNotify::DIREVENTS, NULL, child.second->getLocalPath());
+                changed = true;
+            }
+        }
+    }
+
+    if (done)
+    {
+        ParallelDirScanner::Stats stats = verifyscan->stats();
+        LOG_debug << "Background listing verified. Folders: " << stats.folders << "  Entries: " << stats.entries
+                  << "  Failed: " << stats.failedFolders;
+        verifyscan.reset();
+    }
+
+    return changed;
+}
+
+void Sync::requestfingerprint(LocalNode* l, const LocalPath& path, bool newnode)
+{
+    auto job = std::make_shared<SyncFingerprintJob>();
+    job->node = l;
+    job->path = path;
+    job->fingerprint = *l;
+    job->newnode = newnode;
+
+    shared_ptr<SyncFingerprintJob>& current = fingerprintjobs[l];
+    if (current)
+    {
+        // changed again before the previous fingerprint was applied
+        current->cancelled = true;
+        job->newnode = job->newnode || current->newnode;
+    }
+    current = job;
+    l->fingerprinting = true;
+
+    FileSystemAccess* fsaccess = client->fsaccess;
+    auto done = fingerprintsdone;
+    auto cache = fingerprintcache;
+
+    client->mAsyncQueue.push([job, fsaccess, done, cache](SymmCipher&)
+    {
+        if (job->cancelled)
+        {
+            return;
+        }
+
+        auto fa = fsaccess->newfileaccess(false);
+        if (fa->fopen(job->path, true, false))
+        {
+            job->changed = cache->genfingerprint(job->fingerprint, fa.get());
+        }
+        else
+        {
+            // as genfingerprint() does for files that can't be read
+            job->fingerprint.size = -1;
+            job->changed = true;
+        }
+
+        done->pushBack(shared_ptr<SyncFingerprintJob>(job));
+    }, false);
+}
+
+void Sync::cancelfingerprint(LocalNode* l)
+{
+    auto it = fingerprintjobs.find(l);
+    if (it != fingerprintjobs.end())
+    {
+        it->second->cancelled = true;
+        fingerprintjobs.erase(it);
+    }
+    l->fingerprinting = false;
+}
+
+bool Sync::procfingerprints()
+{
+    if (fingerprintsdone->empty())
+    {
+        return false;
+    }
+
+    bool applied = false;
+    DBTableTransactionCommitter committer(client->tctable);
+
+    shared_ptr<SyncFingerprintJob> job;
+    while (fingerprintsdone->popFront(job))
+    {
+        // (the node may no longer exist)
+        if (job->cancelled)
+        {
+            continue;
+        }
+
+        LocalNode* l = job->node;
+        auto it = fingerprintjobs.find(l);
+        assert(it != fingerprintjobs.end() && it->second == job);
+        fingerprintjobs.erase(it);
+        l->fingerprinting = false;
+
+        LocalPath path = l->getLocalPath();
+        if (path != job->path)
+        {
+            // moved or renamed meanwhile
+            requestfingerprint(l, path, job->newnode);
+            continue;
+        }
+
+        // from here on, as checkpath() does for a synchronous fingerprint
+        if (l->size > 0)
+        {
+            localbytes -= l->size;
+        }
+
+        *static_cast<FileFingerprint*>(l) = job->fingerprint;
+
+        if (l->size > 0)
+        {
+            localbytes += l->size;
+        }
+
+        if (job->changed)
+        {
+            l->bumpnagleds();
+            l->deleted = false;
+        }
+
+        if (job->newnode)
+        {
+            LOG_debug << "Sync - local file addition detected: " << path.toPath(*client->fsaccess);
+        }
+        else if (job->changed)
+        {
+            LOG_debug << "Sync - local file change detected: " << path.toPath(*client->fsaccess);
+            client->stopxfer(l, &committer);
+        }
+
+        if (job->newnode || job->changed)
+        {
+            statecacheadd(l);
+
+            if (isnetwork)
+            {
+                LOG_debug << "Queueing extra fs notification for new file";
+                dirnotify->notify(DirNotify::EXTRA, NULL, std::move(path));
+            }
+
+            client->syncactivity = true;
+        }
+
+        applied = true;
+    }
+
+    return applied;
+}
+
 // check local path - if !localname, localpath is relative to l, with l == NULL
 // being the root of the sync
 // if localname is set, localpath is absolute and localname its last component
@@ -1387,7 +1779,7 @@ bool Sync::scan(LocalPath* localpath, FileAccess* fa)
 // path references a existing FILENODE: returns node
 // otherwise, returns NULL
 // empty input_localpath means to process l rather than a named subitem of l (for scan propagation purposes with folderNeedsRescan flag)
-LocalNode* Sync::checkpath(LocalNode* l, LocalPath* input_localpath, string* const localname, dstime *backoffds, bool wejustcreatedthisfolder, DirAccess* iteratingDir)
+LocalNode* Sync::checkpath(LocalNode* l, LocalPath* input_localpath, string* const localname, dstime *backoffds, bool wejustcreatedthisfolder, DirAccess* iteratingDir, const ScannedEntry* scanned, bool deferfingerprint)
 {
     LocalNode* ll = l;
     bool newnode = false, changed = false;
@@ -1492,7 +1884,18 @@ LocalNode* Sync::checkpath(LocalNode* l, LocalPath* input_localpath, string* con
 
         // match cached LocalNode state during initial/rescan to prevent costly re-fingerprinting
         // (just compare the fsids, sizes and mtimes to detect changes)
-        if (fa->fopen(*localpathNew, false, false, iteratingDir))
+        bool opened;
+        if (scanned)
+        {
+            scanned->setmetadata(*fa);
+            opened = true;
+        }
+        else
+        {
+            opened = fa->fopen(*localpathNew, false, false, iteratingDir);
+        }
+
+        if (opened)
         {
             if (cl && fa->fsidvalid && fa->fsid == cl->fsid)
             {
@@ -1509,7 +1912,8 @@ LocalNode* Sync::checkpath(LocalNode* l, LocalPath* input_localpath, string* con
 
                     if (l->type == FOLDERNODE)
                     {
-                        scan(localpathNew, fa.get());
+                        // (metadata from the prescan leaves fa unopened)
+                        scan(localpathNew, scanned ? nullptr : fa.get());
                     }
                     else
                     {
@@ -1645,9 +2049,21 @@ LocalNode* Sync::checkpath(LocalNode* l, LocalPath* input_localpath, string* con
                                 l->setfsid(fa->fsid, client->fsidnode);
                             }
 
+                            if (deferfingerprint)
+                            {
+                                // the change is processed by procfingerprints()
+                                requestfingerprint(l, *localpathNew, false);
+                                return l;
+                            }
+
+                            if (l->fingerprinting)
+                            {
+                                cancelfingerprint(l);
+                            }
+
                             m_off_t dsize = l->size > 0 ? l->size : 0;
 
-                            if (l->genfingerprint(fa.get()) && l->size >= 0)
+                            if (fingerprintcache->genfingerprint(*l, fa.get()) && l->size >= 0)
                             {
                                 localbytes -= dsize - l->size;
                             }
@@ -1951,12 +2367,25 @@ LocalNode* Sync::checkpath(LocalNode* l, LocalPath* input_localpath, string* con
                         l->setfsid(fa->fsid, client->fsidnode);
                     }
 
+                    if (deferfingerprint)
+                    {
+                        // addition or change are processed by procfingerprints()
+                        requestfingerprint(l, *localpathNew, newnode);
+                        l->needsRescan = false;
+                        return l;
+                    }
+
+                    if (l->fingerprinting)
+                    {
+                        cancelfingerprint(l);
+                    }
+
                     if (l->size > 0)
                     {
                         localbytes -= l->size;
                     }
 
-                    if (l->genfingerprint(fa.get()))
+                    if (fingerprintcache->genfingerprint(*l, fa.get()))
                     {
                         changed = true;
                         l->bumpnagleds();
@@ -2107,6 +2536,11 @@ dstime Sync::procscanq(int q)
     dstime dsmin = Waiter::ds - SCANNING_DELAY_DS;
     LocalNode* l;
 
+    // with worker threads available, files are fingerprinted in the background
+    // and notifications are processed in batches of up to SCANNING_BATCH_MS
+    bool deferfingerprint = client->mAsyncQueue.threaded();
+    auto batchend = std::chrono::steady_clock::now() + std::chrono::milliseconds(SCANNING_BATCH_MS);
+
     Notification notification;
     while (dirnotify->notifyq[q].popFront(notification))
     {
@@ -2129,7 +2563,7 @@ dstime Sync::procscanq(int q)
             dstime backoffds = 0;
             LOG_verbose << "Checkpath: " << notification.path.toPath(*client->fsaccess);
 
-            l = checkpath(l, &notification.path, NULL, &backoffds, false, nullptr);
+            l = checkpath(l, &notification.path, NULL, &backoffds, false, nullptr, nullptr, deferfingerprint);
             if (backoffds)
             {
                 LOG_verbose << "Scanning deferred during " << backoffds << " ds";
@@ -2155,12 +2589,25 @@ dstime Sync::procscanq(int q)
             LOG_debug << "Notification skipped: " << utf8path;
         }
 
-        // we return control to the application in case a filenode was added
-        // (in order to avoid lengthy blocking episodes due to multiple
-        // consecutive fingerprint calculations)
-        // or if new nodes are being added due to a copy/delete operation
-        if ((l && l != (LocalNode*)~0 && l->type == FILENODE) || client->syncadding)
+        // we return control to the application if new nodes are being added
+        // due to a copy/delete operation
+        if (client->syncadding)
+        {
+            break;
+        }
+
+        if (deferfingerprint)
         {
+            // or when the batch is over, or enough files are waiting for their fingerprint
+            if (fingerprintbacklog() || std::chrono::steady_clock::now() >= batchend)
+            {
+                break;
+            }
+        }
+        else if (l && l != (LocalNode*)~0 && l->type == FILENODE)
+        {
+            // or in case a filenode was added (in order to avoid lengthy blocking
+            // episodes due to multiple consecutive fingerprint calculations)
             break;
         }
     }
@@ -2170,6 +2617,18 @@ dstime Sync::procscanq(int q)
         if (q == DirNotify::DIREVENTS)
         {
             client->syncactivity = true;
+
+            uint64_t coalesced = dirnotify->notifyq[DirNotify::DIREVENTS].coalesced()
+                               + dirnotify->notifyq[DirNotify::RETRY].coalesced()
+                               + dirnotify->notifyq[DirNotify::EXTRA].coalesced();
+            if (coalesced != coalescedlogged)
+            {
+                LOG_debug << "Filesystem notifications coalesced: " << coalesced - coalescedlogged << "  Total: " << coalesced;
+                coalescedlogged = coalesced;
+            }
+
+            // every folder found by the initial scan has been scanned
+            endprescan();
         }
     }
     else if (dirnotify->notifyq[!q].empty())
@@ -2444,12 +2903,19 @@ error UnifiedSync::startSync(MegaClient* client, const char* debris, LocalPath*
 
     LOG_debug << "Initial scan sync: " << mConfig.getLocalPath().toPath(*client->fsaccess);
 
+    mSync->startprescan(rootpath);
+
     if (mSync->scan(&rootpath, openedLocalFolder.get()))
     {
         client->syncsup = false;
         mSync->initializing = false;
         LOG_debug << "Initial scan finished. New / modified files: " << mSync->dirnotify->notifyq[DirNotify::DIREVENTS].size();
 
+        if (mSync->dirnotify->notifyq[DirNotify::DIREVENTS].empty())
+        {
+            mSync->endprescan();
+        }
+
         // Sync constructor now receives the syncConfig as reference, to be able to write -at least- fingerprints for new syncs
         client->syncs.saveSyncConfig(mConfig);
     }
@@ -3403,6 +3869,18 @@ Sync* Syncs::runningSyncByBackupId(handle backupId) const
     return nullptr;
 }
 
+Sync* Syncs::runningSyncContainingPath(const LocalPath& path) const
+{
+    for (auto& s : mSyncVec)
+    {
+        if (s->mSync && s->mSync->localroot->localname.isContainingPathOf(path))
+        {
+            return s->mSync.get();
+        }
+    }
+    return nullptr;
+}
+
 SyncConfig* Syncs::syncConfigByBackupId(handle backupId) const
 {
     for (auto& s : mSyncVec)
@@ -3639,6 +4117,20 @@ void Syncs::removeSyncByIndex(size_t index)
 
         mSyncConfigStore->markDriveDirty(mSyncVec[index]->mConfig.mExternalDrivePath);
 
+        // the fingerprints are kept while the sync is disabled, but not beyond
+        if (mClient.dbaccess)
+        {
+            string dbname = Sync::fingerprinttablename(mSyncVec[index]->mConfig.getBackupId(), mClient.me);
+            if (mClient.dbaccess->probe(*mClient.fsaccess, dbname))
+            {
+                unique_ptr<DbTable> table(mClient.dbaccess->open(mClient.rng, *mClient.fsaccess, dbname));
+                if (table)
+                {
+                    table->remove();
+                }
+            }
+        }
+
         // call back before actual removal (intermediate layer may need to make a temp copy to call client app)
         auto& config = mSyncVec[index]->mConfig;
         mClient.app->sync_removed(config);
@@ -196,6 +196,11 @@ bool Transfer::serialize(string *d)
     d->append((const char*)&s, sizeof(s));
     d->append((const char*)&priority, sizeof(priority));
     d->append("", 1);
+
+    // (after the version byte, so that older versions ignore them)
+    char bwclass = static_cast<char>(bwflow.bwclass);
+    d->append(&bwclass, sizeof(bwclass));
+    d->append((const char*)&bwflow.weight, sizeof(bwflow.weight));
     return true;
 }
 
@@ -355,6 +360,21 @@ Transfer *Transfer::unserialize(MegaClient *client, string *d, transfer_map* tra
     }
     ptr++;
 
+    // (not present in the transfers saved by older versions)
+    if (ptr + sizeof(char) + sizeof(unsigned) <= end)
+    {
+        char bwclass = MemAccess::get<char>(ptr);
+        ptr += sizeof(char);
+        unsigned weight = MemAccess::get<unsigned>(ptr);
+        ptr += sizeof(unsigned);
+
+        if (bwclass >= 0 && bwclass < NUM_TRANSFERCLASSES && weight)
+        {
+            t->bwflow.bwclass = transferclass_t(bwclass);
+            t->bwflow.weight = weight;
+        }
+    }
+
     t->chunkmacs.calcprogress(t->size, t->pos, t->progresscompleted);
 
     transfers[type].insert(pair<FileFingerprint*, Transfer*>(t, t));
@@ -366,6 +386,32 @@ SymmCipher *Transfer::transfercipher()
     return client->getRecycledTemporaryTransferCipher(transferkey.data());
 }
 
+string Transfer::posturl(const string& tempurl) const
+{
+    string url = tempurl;
+    if (((type == GET && client->usealtdownport) || (type == PUT && client->usealtupport))
+            && !memcmp(url.c_str(), "http:", 5))
+    {
+        size_t index = url.find("/", 8);
+        if (index != string::npos && url.find(":", 8) == string::npos)
+        {
+            url.insert(index, ":8080");
+        }
+    }
+    return url;
+}
+
+void Transfer::preconnect(bool queued)
+{
+    // as many connections as TransferSlot::createconnectionsonce() will use
+    unsigned connections = (queued || tempurls.size() == RAIDPARTS) ? 1 : (size > 131072 ? unsigned(client->connections[type]) : 1);
+
+    for (const string& url : tempurls)
+    {
+        client->httpio->preconnect(type, posturl(url), connections);
+    }
+}
+
 void Transfer::removeTransferFile(error e, File* f, DBTableTransactionCommitter* committer)
 {
     Transfer *transfer = f->transfer;
@@ -1361,6 +1407,9 @@ bool DirectReadSlot::doio()
 
                     dr->drbuf.submitBuffer(connectionNum, np);
 
+                    // a single request reads the whole range, so it's accounted as the data arrives
+                    dr->drn->client->bandwidthScheduler.consume(GET, bwflow, n, Waiter::ds);
+
                     if (req->httpio)
                     {
                         req->httpio->lastdata = Waiter::ds;
@@ -1594,10 +1643,14 @@ DirectReadSlot::DirectReadSlot(DirectRead* cdr)
         reqs.push_back(new HttpReq(true));
         reqs.back()->status = REQ_READY;
         reqs.back()->type = REQ_BINARY;
+        reqs.back()->channel = NETCHANNEL_GET;
     }
 
     drs_it = dr->drn->client->drss.insert(dr->drn->client->drss.end(), this);
 
+    bwflow.bwclass = TRANSFERCLASS_STREAMING;
+    dr->drn->client->bandwidthScheduler.activate(GET, bwflow);
+
     dr->drn->partiallen = 0;
     dr->drn->partialstarttime = Waiter::ds;
 }
@@ -1605,6 +1658,7 @@ DirectReadSlot::DirectReadSlot(DirectRead* cdr)
 DirectReadSlot::~DirectReadSlot()
 {
     dr->drn->client->drss.erase(drs_it);
+    dr->drn->client->bandwidthScheduler.deactivate(GET, bwflow);
 
     LOG_debug << "Deleting DirectReadSlot";
     for (size_t i = reqs.size(); i--; )
@@ -97,6 +97,8 @@ TransferSlot::TransferSlot(Transfer* ctransfer)
 
     slots_it = transfer->client->tslots.end();
 
+    transfer->client->bandwidthScheduler.activate(transfer->type, transfer->bwflow);
+
     maxRequestSize = MAX_REQ_SIZE;
 #if defined(_WIN32) && !defined(WINDOWS_PHONE)
     MEMORYSTATUSEX statex;
@@ -275,6 +277,8 @@ TransferSlot::~TransferSlot()
 
     transfer->slot = NULL;
 
+    transfer->client->bandwidthScheduler.deactivate(transfer->type, transfer->bwflow);
+
     if (slots_it != transfer->client->tslots.end())
     {
         // advance main loop iterator if deleting next in line
@@ -546,6 +550,7 @@ void TransferSlot::doio(MegaClient* client, DBTableTransactionCommitter& committ
     }
 
     dstime backoff = 0;
+    bool throttled = false;
     m_off_t p = 0;
     bool earliestUploadCompleted = false;
 
@@ -591,6 +596,12 @@ void TransferSlot::doio(MegaClient* client, DBTableTransactionCommitter& committ
                     m_off_t delta = mReqSpeeds[i].requestProgressed(reqs[i]->transferred(client));
                     mTransferSpeed.calculateSpeed(delta);
 
+                    if (ttfb < 0 && reqs[i]->transferred(client) > 0)
+                    {
+                        ttfb = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - firstrequesttime).count();
+                        LOG_debug << "Time to first byte: " << ttfb << " ms";
+                    }
+
                     p += reqs[i]->transferred(client);
 
                     assert(reqs[i]->lastdata != NEVER);
@@ -1101,7 +1112,17 @@ void TransferSlot::doio(MegaClient* client, DBTableTransactionCommitter& committ
             {
                 bool newInputBufferSupplied = false;
                 bool pauseConnectionInputForRaid = false;
-                std::pair<m_off_t, m_off_t> posrange = transferbuf.nextNPosForConnection(i, maxRequestSize, connections, newInputBufferSupplied, pauseConnectionInputForRaid, client->httpio->uploadSpeed);
+
+                // keep requests small enough for the bandwidth scheduler to pace them
+                m_off_t reqSizeLimit = maxRequestSize;
+                m_off_t uploadSpeed = client->httpio->uploadSpeed;
+                if (m_off_t bwlimit = client->bandwidthScheduler.requestsizelimit(transfer->type, transfer->bwflow))
+                {
+                    reqSizeLimit = std::min<m_off_t>(reqSizeLimit, bwlimit);
+                    uploadSpeed = std::min<m_off_t>(uploadSpeed, bwlimit / 2);
+                }
+
+                std::pair<m_off_t, m_off_t> posrange = transferbuf.nextNPosForConnection(i, reqSizeLimit, connections, newInputBufferSupplied, pauseConnectionInputForRaid, uploadSpeed);
 
                 // we might have a raid-reassembled block to write, or a previously loaded block, or a skip block to process.
                 bool newOutputBufferSupplied = false;
@@ -1174,26 +1195,7 @@ void TransferSlot::doio(MegaClient* client, DBTableTransactionCommitter& committ
 
                     if (prepare)
                     {
-                        string finaltempurl = transferbuf.tempURL(i);
-                        if (transfer->type == GET && client->usealtdownport
-                                && !memcmp(finaltempurl.c_str(), "http:", 5))
-                        {
-                            size_t index = finaltempurl.find("/", 8);
-                            if(index != string::npos && finaltempurl.find(":", 8) == string::npos)
-                            {
-                                finaltempurl.insert(index, ":8080");
-                            }
-                        }
-
-                        if (transfer->type == PUT && client->usealtupport
-                                && !memcmp(finaltempurl.c_str(), "http:", 5))
-                        {
-                            size_t index = finaltempurl.find("/", 8);
-                            if(index != string::npos && finaltempurl.find(":", 8) == string::npos)
-                            {
-                                finaltempurl.insert(index, ":8080");
-                            }
-                        }
+                        string finaltempurl = transfer->posturl(transferbuf.tempURL(i));
 
                         reqs[i]->prepare(finaltempurl.c_str(), transfer->transfercipher(),
                                                                transfer->ctriv,
@@ -1269,6 +1271,19 @@ void TransferSlot::doio(MegaClient* client, DBTableTransactionCommitter& committ
         {
             if ((reqs[i]->status == REQ_PREPARED) && !backoff)
             {
+                if (!client->bandwidthScheduler.admit(transfer->type, transfer->bwflow, reqs[i]->size, Waiter::ds))
+                {
+                    // over the bandwidth budget for its class: try again shortly
+                    backoff = client->bandwidthScheduler.retryin(transfer->type, transfer->bwflow);
+                    throttled = true;
+                    continue;
+                }
+
+                if (firstrequesttime == std::chrono::steady_clock::time_point())
+                {
+                    firstrequesttime = std::chrono::steady_clock::now();
+                }
+
                 mReqSpeeds[i].requestStarted();
                 reqs[i]->minspeed = true;
                 reqs[i]->post(client);
@@ -1307,8 +1322,14 @@ void TransferSlot::doio(MegaClient* client, DBTableTransactionCommitter& committ
         progress();
     }
 
+    if (throttled && std::none_of(reqs.begin(), reqs.end(), [](const std::shared_ptr<HttpReqXfer>& req)
+            { return req && req->status == REQ_INFLIGHT; }))
+    {
+        lastthrottled = Waiter::ds;
+    }
+
     assert(lastdata != NEVER);
-    if (Waiter::ds - lastdata >= XFERTIMEOUT && !failure)
+    if (Waiter::ds - std::max(lastdata, lastthrottled) >= XFERTIMEOUT && !failure)
     {
         LOG_warn << "Failed chunk(s) due to a timeout: no data moved for " << (XFERTIMEOUT/10) << " seconds" ;
         failure = true;
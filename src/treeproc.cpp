@@ -118,9 +118,27 @@ void LocalTreeProcMove::proc(MegaClient*, LocalNode* localnode)
 {
     if (newsync != localnode->sync)
     {
+        // a pending fingerprint is applied by the new sync
+        bool fingerprinting = localnode->fingerprinting;
+        bool newnode = false;
+        if (fingerprinting)
+        {
+            auto it = localnode->sync->fingerprintjobs.find(localnode);
+            newnode = it != localnode->sync->fingerprintjobs.end() && it->second->newnode;
+            localnode->sync->cancelfingerprint(localnode);
+        }
+
         localnode->sync->statecachedel(localnode);
+        localnode->sync->treestatechanged.erase(localnode);
+        localnode->sync->treestatefolders.erase(localnode);
         localnode->sync = newsync;
         newsync->statecacheadd(localnode);
+
+        if (fingerprinting)
+        {
+            // (if the path is not final yet, procfingerprints() requests it again)
+            newsync->requestfingerprint(localnode, localnode->getLocalPath(), newnode);
+        }
     }
 
     if (recreate)
@@ -2492,6 +2492,55 @@ void MegaClientAsyncQueue::asyncThreadLoop()
     }
 }
 
+void SharedMutex::lock()
+{
+    std::unique_lock<std::mutex> g(mMutex);
+    mWaitingWriters++;
+    mCondition.wait(g, [this]() { return !mWriter && !mReaders; });
+    mWaitingWriters--;
+    mWriter = true;
+}
+
+bool SharedMutex::try_lock()
+{
+    std::lock_guard<std::mutex> g(mMutex);
+    if (mWriter || mReaders)
+    {
+        return false;
+    }
+    mWriter = true;
+    return true;
+}
+
+void SharedMutex::unlock()
+{
+    {
+        std::lock_guard<std::mutex> g(mMutex);
+        mWriter = false;
+    }
+    mCondition.notify_all();
+}
+
+void SharedMutex::lock_shared()
+{
+    std::unique_lock<std::mutex> g(mMutex);
+    mCondition.wait(g, [this]() { return !mWriter && !mWaitingWriters; });
+    mReaders++;
+}
+
+void SharedMutex::unlock_shared()
+{
+    bool last;
+    {
+        std::lock_guard<std::mutex> g(mMutex);
+        last = !--mReaders;
+    }
+    if (last)
+    {
+        mCondition.notify_all();
+    }
+}
+
 bool islchex(const int c)
 {
     return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
@@ -649,6 +649,7 @@ bool WinFileAccess::fopen_impl(LocalPath& namePath, bool read, bool write, bool
     }
 
     mtime = FileTime_to_POSIX(&fad.ftLastWriteTime);
+    ctime = FileTime_to_POSIX(&fad.ftCreationTime);
 
 #ifdef WINDOWS_PHONE
     if (!write && (fsidvalid = !!GetFileInformationByHandleEx(hFile, FileIdInfo, &bhfi, sizeof(bhfi))))
@@ -0,0 +1,136 @@
+/**
+ * @file MockServer_test.cpp
+ * @brief offline tests of a MegaApi against the in-process mock server
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#include "megaapi.h"
+#include "../tool/mockserver/mockserver.h"
+
+using namespace mega;
+
+namespace {
+
+// generous, the whole exchange takes a fraction of a second on loopback
+const int TIMEOUT_MS = 60000;
+
+} // anonymous
+
+// a MegaApi and the mock server it talks to, which runs on its own thread
+class MockServerTest
+  : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        config.folders = 2;
+        config.filesPerFolder = 3;
+        config.fileSize = 100000;
+        config.scHold = std::chrono::seconds(1);
+
+        server.reset(new mt::MockServer(asio_service, config));
+        serverThread = std::thread([this]() { asio_service.run(); });
+
+        MegaApi::setLogLevel(MegaApi::LOG_LEVEL_ERROR);
+        api.reset(new MegaApi("mockservertest", (const char*)nullptr, "mockservertest"));
+        api->changeApiUrl(server->apiUrl().c_str(), true);
+    }
+
+    void TearDown() override
+    {
+        api.reset();
+
+        server->Stop();
+        asio_service.stop();
+        serverThread.join();
+    }
+
+    // 0 if it finished with API_OK within the timeout
+    int login()
+    {
+        SynchronousRequestListener listener;
+        api->fastLogin(server->account().session().c_str(), &listener);
+        return listener.trywait(TIMEOUT_MS) ? -1 : listener.getError()->getErrorCode();
+    }
+
+    int fetchnodes()
+    {
+        SynchronousRequestListener listener;
+        api->fetchNodes(&listener);
+        return listener.trywait(TIMEOUT_MS) ? -1 : listener.getError()->getErrorCode();
+    }
+
+    mt::MockServerConfig config;
+    asio::io_service asio_service;
+    std::unique_ptr<mt::MockServer> server;
+    std::thread serverThread;
+    std::unique_ptr<MegaApi> api;
+}; // MockServerTest
+
+TEST_F(MockServerTest, loginAndFetchnodes)
+{
+    ASSERT_EQ(login(), MegaError::API_OK);
+    ASSERT_EQ(fetchnodes(), MegaError::API_OK);
+
+    std::unique_ptr<MegaNode> root(api->getRootNode());
+    ASSERT_TRUE(root);
+    ASSERT_EQ(api->getNumChildFolders(root.get()), int(config.folders));
+
+    std::unique_ptr<MegaNode> folder(api->getNodeByPath("/folder1"));
+    ASSERT_TRUE(folder);
+    ASSERT_EQ(api->getNumChildFiles(folder.get()), int(config.filesPerFolder));
+}
+
+TEST_F(MockServerTest, download)
+{
+    ASSERT_EQ(login(), MegaError::API_OK);
+    ASSERT_EQ(fetchnodes(), MegaError::API_OK);
+
+    std::unique_ptr<MegaNode> file(api->getNodeByPath("/folder0/file0.bin"));
+    ASSERT_TRUE(file);
+    ASSERT_EQ(file->getSize(), config.fileSize);
+
+    const char* path = "mockservertest_download.bin";
+    std::remove(path);
+
+    SynchronousTransferListener listener;
+    api->startDownload(file.get(), path, &listener);
+    ASSERT_EQ(listener.trywait(TIMEOUT_MS), 0);
+    ASSERT_EQ(listener.getError()->getErrorCode(), MegaError::API_OK);
+
+    std::string data;
+    {
+        std::ifstream in(path, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    std::remove(path);
+
+    // the content the mock server encrypted, as decrypted and MAC-checked by the client
+    ASSERT_EQ(m_off_t(data.size()), config.fileSize);
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        ASSERT_EQ(data[i], char(i * 31 + (i >> 12))) << "at " << i;
+    }
+}
@@ -0,0 +1,131 @@
+/**
+ * @file tests/tool/allocationcounter.cpp
+ * @brief Allocations made by the benchmarks
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "allocationcounter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> gAllocations(0);
+std::atomic<int64_t> gAllocated(0);
+
+// (keeps the size in front of each block, so that it is known when freed)
+const size_t HEADER = alignof(std::max_align_t);
+
+void* allocate(size_t size)
+{
+    char* p = static_cast<char*>(std::malloc(size + HEADER));
+    if (!p)
+    {
+        return nullptr;
+    }
+    *reinterpret_cast<size_t*>(p) = size;
+    gAllocations++;
+    gAllocated += int64_t(size);
+    return p + HEADER;
+}
+
+void deallocate(void* p)
+{
+    if (p)
+    {
+        char* block = static_cast<char*>(p) - HEADER;
+        gAllocated -= int64_t(*reinterpret_cast<size_t*>(block));
+        std::free(block);
+    }
+}
+
+} // anonymous
+
+namespace mt {
+
+uint64_t allocationCount()
+{
+    return gAllocations;
+}
+
+int64_t allocatedBytes()
+{
+    return gAllocated;
+}
+
+} // mt
+
+// every form is replaced, so that no block reaches a deallocation function that
+// doesn't know about the header
+void* operator new(size_t size)
+{
+    void* p = allocate(size);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    deallocate(p);
+}
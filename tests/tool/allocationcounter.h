@@ -0,0 +1,37 @@
+/**
+ * @file tests/tool/allocationcounter.h
+ * @brief Allocations made by the benchmarks
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace mt {
+
+// Counted by the operator new/delete replaced in allocationcounter.cpp, so only for
+// the benchmarks linked with it (the others don't pay for the counting).
+
+// allocations made, by any thread
+uint64_t allocationCount();
+
+// bytes allocated and not freed yet, by any thread
+int64_t allocatedBytes();
+
+} // mt
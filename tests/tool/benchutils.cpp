@@ -0,0 +1,60 @@
+/**
+ * @file tests/tool/benchutils.cpp
+ * @brief Accounts built in memory for the benchmarks
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "benchutils.h"
+
+namespace mt {
+
+std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app, mega::FileSystemAccess& fsaccess, const char* useragent)
+{
+    struct HttpIo : mega::HttpIO
+    {
+        void addevents(mega::Waiter*, int) override {}
+        void post(mega::HttpReq*, const char* = NULL, unsigned = 0) override {}
+        void cancel(mega::HttpReq*) override {}
+        m_off_t postpos(void*) override { return 0; }
+        bool doio(void) override { return false; }
+        void setuseragent(std::string*) override {}
+    };
+
+    auto httpio = new HttpIo;
+
+    auto deleter = [httpio](mega::MegaClient* client)
+    {
+        delete client;
+        delete httpio;
+    };
+
+    return std::shared_ptr<mega::MegaClient>(new mega::MegaClient(&app, nullptr, httpio, &fsaccess, nullptr, nullptr, "XXX", useragent, 0), deleter);
+}
+
+mega::Node* makeNode(mega::MegaClient& client, mega::handle h, mega::handle parent, mega::nodetype_t type, const std::string& name)
+{
+    using namespace mega;
+
+    node_vector dp;
+    Node* n = new Node(&client, &dp, h, parent, type, type == FILENODE ? 1000 + m_off_t(h) : -1, UNDEF, nullptr, 1600000000); // owned by the client
+    n->setkey(reinterpret_cast<const byte*>(std::string(type == FILENODE ? FILENODEKEYLENGTH : FOLDERNODEKEYLENGTH, 'X').data()));
+    n->attrs.map['n'] = name;
+    return n;
+}
+
+} // mt
@@ -0,0 +1,37 @@
+/**
+ * @file tests/tool/benchutils.h
+ * @brief Accounts built in memory for the benchmarks
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mega.h"
+
+namespace mt {
+
+// a client that sends nothing to the servers, for the nodes built with makeNode()
+std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app, mega::FileSystemAccess& fsaccess, const char* useragent);
+
+// a node owned by `client`, named `name`; files get a size derived from their handle
+mega::Node* makeNode(mega::MegaClient& client, mega::handle h, mega::handle parent, mega::nodetype_t type, const std::string& name);
+
+} // mt
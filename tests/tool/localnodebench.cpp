@@ -0,0 +1,121 @@
+/**
+ * @file tests/tool/localnodebench.cpp
+ * @brief Memory used by the LocalNode tree of a synthetic sync
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "mega/heartbeats.h"
+#include "allocationcounter.h"
+#include "benchutils.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace mega;
+using std::cout;
+using std::endl;
+
+namespace {
+
+const unsigned FILES_PER_FOLDER = 1000;
+
+typedef std::chrono::steady_clock clock_type;
+
+LocalNode* makeLocalNode(Sync& sync, LocalNode& parent, nodetype_t type, const string& name, handle fsid)
+{
+    LocalPath path = parent.getLocalPath();
+    path.appendWithSeparator(LocalPath::fromPath(name, *sync.client->fsaccess), true);
+
+    LocalNode* l = new LocalNode;
+    l->init(&sync, type, &parent, path, nullptr);
+    l->setfsid(fsid, sync.client->fsidnode);
+    l->size = 1000 + m_off_t(fsid);
+    l->mtime = 1600000000 + m_time_t(fsid);
+    return l;
+}
+
+void usage()
+{
+    cout << "usage: tool_localnodebench [options]\n"
+         << "  --files <n>  files in the synthetic tree (default: 1000000), "
+         << FILES_PER_FOLDER << " per folder\n"
+         << "\n"
+         << "Nothing is written to disk: the tree is only built in memory." << endl;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    unsigned files = 1000000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(argv[i], "--files") && value) files = unsigned(atoi(value)), i++;
+        else { usage(); return 1; }
+    }
+
+    SimpleLogger::setLogLevel(logError);
+
+    MegaApp app;
+    FSACCESS_CLASS fsaccess;
+    auto client = mt::makeClient(app, fsaccess, "localnodebench");
+
+    // (a root that does not exist, so that no folder is watched)
+    LocalPath root = LocalPath::fromPath("/nonexistent/localnodebench", fsaccess);
+    LocalPath debris = LocalPath::fromPath(".debris", fsaccess);
+    Node* rootnode = mt::makeNode(*client, 1, UNDEF, FOLDERNODE, "localnodebench");
+
+    SyncConfig config(root, "localnodebench", NodeHandle().set6byte(rootnode->nodehandle), string(), 0, LocalPath());
+    unique_ptr<UnifiedSync> us(new UnifiedSync(*client, config));
+    us->mSync.reset(new Sync(*us, nullptr, &debris, rootnode, false));
+    us->mSync->state() = SYNC_CANCELED;
+    Sync& sync = *us->mSync;
+
+    int64_t before = mt::allocatedBytes();
+    auto start = clock_type::now();
+
+    unsigned folders = 0;
+    LocalNode* folder = nullptr;
+    for (unsigned i = 0; i < files; i++)
+    {
+        if (!(i % FILES_PER_FOLDER))
+        {
+            // (fsids after the ones of the files)
+            folder = makeLocalNode(sync, *sync.localroot, FOLDERNODE, "folder " + std::to_string(folders), handle(files + folders));
+            folders++;
+        }
+
+        // (long enough not to fit in the strings themselves, as most real names)
+        makeLocalNode(sync, *folder, FILENODE, "IMG_" + std::to_string(20200000 + i) + "_holidays.jpg", handle(i));
+    }
+
+    double secs = std::chrono::duration<double>(clock_type::now() - start).count();
+    int64_t used = mt::allocatedBytes() - before;
+    unsigned nodes = files + folders;
+
+    cout << "LocalNodes: " << nodes << " (" << files << " files, " << folders << " folders) built in " << secs << " s" << endl;
+    cout << "sizeof(LocalNode): " << sizeof(LocalNode) << endl;
+    cout << "Allocated: " << used << " bytes, " << (nodes ? used / nodes : 0) << " per LocalNode" << endl;
+
+    // (the LocalNodes are deleted with the sync)
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file main.cpp
+ * @brief local stand-in for the MEGA API and storage servers
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <cstring>
+#include <iostream>
+#include "mockserver.h"
+
+using std::cout;
+using std::endl;
+
+namespace {
+
+void usage()
+{
+    cout << "usage: tool_mockserver [options]\n"
+         << "  --port <n>             listening port (default: any)\n"
+         << "  --folders <n>          folders below the root (default: 10)\n"
+         << "  --files <n>            files per folder (default: 100)\n"
+         << "  --filesize <bytes>     size of each file (default: 1048576)\n"
+         << "  --raid                 serve downloads as CloudRAID parts\n"
+         << "  --latency <ms>         delay added to every response\n"
+         << "  --bandwidth <bytes/s>  per-connection limit for storage transfers\n"
+         << "  --verbose              print a line per request\n";
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    mt::MockServerConfig config;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(arg, "--raid")) config.raid = true;
+        else if (!strcmp(arg, "--verbose")) config.verbose = true;
+        else if (!value) { usage(); return 1; }
+        else if (!strcmp(arg, "--port")) config.port = uint16_t(atoi(value)), i++;
+        else if (!strcmp(arg, "--folders")) config.folders = unsigned(atoi(value)), i++;
+        else if (!strcmp(arg, "--files")) config.filesPerFolder = unsigned(atoi(value)), i++;
+        else if (!strcmp(arg, "--filesize")) config.fileSize = atoll(value), i++;
+        else if (!strcmp(arg, "--latency")) config.latency = std::chrono::milliseconds(atoi(value)), i++;
+        else if (!strcmp(arg, "--bandwidth")) config.bytesPerSecond = size_t(atoll(value)), i++;
+        else { usage(); return 1; }
+    }
+
+    try
+    {
+        asio::io_service asio_service;
+        mt::MockServer server(asio_service, config);
+
+        cout << "Mock account with " << server.account().nodeCount() << " nodes\n"
+             << "API URL: " << server.apiUrl() << "  (megacli: apiurl " << server.apiUrl() << " 1)\n"
+             << "Session: " << server.account().session() << "  (megacli: login " << server.account().session() << ")" << endl;
+
+        asio_service.run();
+    }
+    catch (std::exception& e)
+    {
+        cout << "Mock server exception: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
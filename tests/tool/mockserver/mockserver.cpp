@@ -0,0 +1,943 @@
+/**
+ * @file mockserver.cpp
+ * @brief local stand-in for the MEGA API and storage servers
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mockserver.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+using std::cout;
+using std::endl;
+using std::map;
+using std::string;
+using std::to_string;
+using std::vector;
+using namespace ::mega;
+
+namespace mt {
+
+namespace {
+
+const char* EMAIL = "mock@mega.invalid";
+
+string b64handle(handle h, int len)
+{
+    char buf[16];
+    Base64::btoa((const byte*)&h, len, buf);
+    return buf;
+}
+
+// query parameter `name` of a request path, or an empty string
+string queryParam(const string& path, const string& name)
+{
+    size_t q = path.find('?');
+    while (q != string::npos)
+    {
+        size_t start = q + 1;
+        size_t end = path.find('&', start);
+        if (!path.compare(start, name.size() + 1, name + "="))
+        {
+            start += name.size() + 1;
+            return path.substr(start, end == string::npos ? string::npos : end - start);
+        }
+        q = end;
+    }
+    return string();
+}
+
+} // anonymous
+
+MockAccount::MockAccount(const MockServerConfig& c)
+    : config(c)
+{
+    byte k[SymmCipher::KEYLENGTH];
+    rng.genblock(k, sizeof k);
+    masterKey.setkey(k);
+
+    sid.resize(MegaClient::SIDLEN);
+    rng.genblock((byte*)sid.data(), sid.size());
+
+    me = 0;
+    rng.genblock((byte*)&me, MegaClient::USERHANDLE);
+
+    // same as MegaClient::setkeypair()
+    AsymmCipher asymkey;
+    CryptoPP::Integer pubkints[AsymmCipher::PUBKEY];
+    asymkey.genkeypair(rng, asymkey.key, pubkints, 2048);
+    AsymmCipher::serializeintarray(pubkints, AsymmCipher::PUBKEY, &pubk);
+    AsymmCipher::serializeintarray(asymkey.key, AsymmCipher::PRIVKEY, &privk);
+
+    size_t t = privk.size();
+    privk.resize((t + SymmCipher::BLOCKSIZE - 1) & - SymmCipher::BLOCKSIZE);
+    rng.genblock((byte*)privk.data() + t, privk.size() - t);
+    masterKey.ecb_encrypt((byte*)privk.data(), (byte*)privk.data(), privk.size());
+
+    handle root = addNode(UNDEF, ROOTNODE, string(), 0);
+    addNode(UNDEF, INCOMINGNODE, string(), 0);
+    addNode(UNDEF, RUBBISHNODE, string(), 0);
+
+    for (unsigned i = 0; i < config.folders; i++)
+    {
+        handle folder = addNode(root, FOLDERNODE, "folder" + to_string(i), 0);
+
+        for (unsigned j = 0; j < config.filesPerFolder; j++)
+        {
+            addNode(folder, FILENODE, "file" + to_string(j) + ".bin", config.fileSize);
+        }
+    }
+}
+
+string MockAccount::session() const
+{
+    string s((const char*)masterKey.key, sizeof masterKey.key);
+    s.append(sid);
+    return Base64::btoa(s);
+}
+
+void MockAccount::setStorageUrl(const string& url)
+{
+    storageUrl = url;
+}
+
+string MockAccount::currentScsn() const
+{
+    return b64handle(scsn, sizeof scsn);
+}
+
+handle MockAccount::addNode(handle parent, nodetype_t type, const string& name, m_off_t size)
+{
+    MockNode n;
+    n.h = nextHandle++;
+    n.parent = parent;
+    n.type = type;
+    n.size = type == FILENODE ? size : -1;
+    n.blob = 0;
+    n.ts = m_time();
+
+    if (type == FILENODE || type == FOLDERNODE)
+    {
+        byte key[FILENODEKEYLENGTH];
+        size_t keylen = SymmCipher::KEYLENGTH;
+
+        if (type == FILENODE)
+        {
+            n.blob = blobFor(size);
+            memcpy(key, blobs[n.blob].key, sizeof key);
+            keylen = sizeof key;
+        }
+        else
+        {
+            rng.genblock(key, keylen);
+        }
+
+        n.attrs = encryptAttrs(key, type, "\"n\":\"" + name + "\"");
+
+        n.key.resize(keylen);
+        masterKey.ecb_encrypt(key, (byte*)n.key.data(), keylen);
+    }
+
+    nodeIndex[n.h] = nodes.size();
+    nodes.push_back(std::move(n));
+    return nodes.back().h;
+}
+
+// files of the same size share their key and data, so that big trees are cheap to set up
+size_t MockAccount::blobFor(m_off_t size)
+{
+    auto it = blobBySize.find(size);
+    if (it != blobBySize.end())
+    {
+        return it->second;
+    }
+
+    Blob b;
+    byte transferkey[SymmCipher::KEYLENGTH];
+    int64_t ctriv;
+    rng.genblock(transferkey, sizeof transferkey);
+    rng.genblock((byte*)&ctriv, sizeof ctriv);
+
+    // deterministic content, encrypted and MAC'd the same way as uploads
+    b.data.resize(size_t((size + SymmCipher::BLOCKSIZE - 1) & - SymmCipher::BLOCKSIZE));
+    for (size_t i = 0; i < size_t(size); i++)
+    {
+        b.data[i] = char(i * 31 + (i >> 12));
+    }
+
+    SymmCipher cipher;
+    cipher.setkey(transferkey);
+    chunkmac_map macs;
+    if (size)
+    {
+        EncryptBufferByChunks eb((byte*)b.data.data(), &cipher, &macs, ctriv);
+        string suffix;
+        eb.encrypt(0, size, suffix);
+    }
+    b.data.resize(size_t(size));
+    int64_t metamac = macs.macsmac(&cipher);
+
+    // nodekey layout: transferkey ^ (ctriv, metamac), ctriv, metamac
+    memcpy(b.key, transferkey, SymmCipher::KEYLENGTH);
+    MemAccess::set<int64_t>(b.key + SymmCipher::KEYLENGTH, ctriv);
+    MemAccess::set<int64_t>(b.key + SymmCipher::KEYLENGTH + sizeof ctriv, metamac);
+    SymmCipher::xorblock(b.key + SymmCipher::KEYLENGTH, b.key);
+
+    if (config.raid)
+    {
+        // part 0 holds the parity of each line, parts 1-5 its sectors
+        for (unsigned p = 0; p < RAIDPARTS; p++)
+        {
+            b.parts.emplace_back(size_t(RaidBufferManager::raidPartSize(p, size)), '\0');
+        }
+
+        for (size_t pos = 0; pos < size_t(size); pos += RAIDSECTOR)
+        {
+            size_t sector = pos / RAIDSECTOR;
+            size_t partpos = sector / (RAIDPARTS - 1) * RAIDSECTOR;
+            size_t len = std::min<size_t>(RAIDSECTOR, size_t(size) - pos);
+            string& part = b.parts[1 + sector % (RAIDPARTS - 1)];
+            string& parity = b.parts[0];
+
+            memcpy(&part[partpos], &b.data[pos], len);
+            for (size_t i = 0; i < len && partpos + i < parity.size(); i++)
+            {
+                parity[partpos + i] ^= b.data[pos + i];
+            }
+        }
+    }
+
+    blobBySize[size] = blobs.size();
+    blobs.push_back(std::move(b));
+    return blobs.size() - 1;
+}
+
+// same as MegaClient::makeattr()
+string MockAccount::encryptAttrs(const byte* key, nodetype_t type, const string& json)
+{
+    string buf = "MEGA{" + json + "}";
+    buf.resize((buf.size() + SymmCipher::KEYLENGTH - 1) & - SymmCipher::KEYLENGTH, '\0');
+
+    SymmCipher cipher;
+    cipher.setkey(key, type);
+    cipher.cbc_encrypt((byte*)buf.data(), buf.size());
+
+    return Base64::btoa(buf);
+}
+
+void MockAccount::writeNode(JSONWriter& w, const MockNode& n) const
+{
+    w.beginobject();
+    w.arg("h", n.h, MegaClient::NODEHANDLE);
+    if (!ISUNDEF(n.parent))
+    {
+        w.arg("p", n.parent, MegaClient::NODEHANDLE);
+    }
+    w.arg("u", me, MegaClient::USERHANDLE);
+    w.arg("t", m_off_t(n.type));
+    if (n.type == FILENODE || n.type == FOLDERNODE)
+    {
+        w.arg("a", n.attrs);
+        w.arg("k", b64handle(me, MegaClient::USERHANDLE) + ":" + Base64::btoa(n.key));
+    }
+    if (n.type == FILENODE)
+    {
+        w.arg("s", n.size);
+    }
+    w.arg("ts", n.ts);
+    w.endobject();
+}
+
+string MockAccount::processCommands(const string& body)
+{
+    JSON json(body);
+    string results = "[";
+
+    if (!json.enterarray())
+    {
+        return to_string(API_EARGS);
+    }
+
+    while (json.enterobject())
+    {
+        JSON cmd = json;
+        string a;
+
+        for (nameid name; (name = json.getnameid()) != EOO; )
+        {
+            if (!(name == 'a' ? json.storeobject(&a) : json.storeobject()))
+            {
+                return to_string(API_EARGS);
+            }
+        }
+        json.leaveobject();
+
+        string result;
+        if (a == "us") result = login(cmd);
+        else if (a == "ug") result = getUserData(cmd);
+        else if (a == "f") result = fetchNodes(cmd);
+        else if (a == "g") result = getFile(cmd);
+        else if (a == "u") result = putFile(cmd);
+        else if (a == "p") result = putNodes(cmd);
+        else if (a == "log") result = to_string(API_OK);
+        else result = to_string(API_ENOENT);
+
+        if (config.verbose)
+        {
+            cout << "command " << a << ": " << result.substr(0, 80) << endl;
+        }
+
+        results.append(results.size() > 1 ? "," : "");
+        results.append(result);
+    }
+
+    return results + "]";
+}
+
+string MockAccount::login(JSON&)
+{
+    // resumption of the session returned by session(): no "k" or "csid" needed
+    JSONWriter w;
+    w.beginobject();
+    w.arg("u", me, MegaClient::USERHANDLE);
+    w.arg_B64("privk", privk);
+    w.arg("ach", m_off_t(0));
+    w.endobject();
+    return w.getstring();
+}
+
+string MockAccount::getUserData(JSON&)
+{
+    JSONWriter w;
+    w.beginobject();
+    w.arg("u", me, MegaClient::USERHANDLE);
+    w.arg("email", EMAIL);
+    w.arg("since", m_off_t(nodes.front().ts));
+    w.arg_B64("pubk", pubk);
+    w.endobject();
+    return w.getstring();
+}
+
+string MockAccount::fetchNodes(JSON&)
+{
+    JSONWriter w;
+    w.beginobject();
+    w.beginarray("f");
+    for (const MockNode& n : nodes)
+    {
+        writeNode(w, n);
+    }
+    w.endarray();
+    w.beginarray("ok");
+    w.endarray();
+    w.beginarray("s");
+    w.endarray();
+    w.arg("sn", currentScsn());
+    w.endobject();
+    return w.getstring();
+}
+
+string MockAccount::getFile(JSON& cmd)
+{
+    handle h = UNDEF;
+    for (nameid name; (name = cmd.getnameid()) != EOO; )
+    {
+        if (name == 'n')
+        {
+            h = cmd.gethandle(MegaClient::NODEHANDLE);
+        }
+        else if (!cmd.storeobject())
+        {
+            return to_string(API_EARGS);
+        }
+    }
+
+    auto it = nodeIndex.find(h);
+    if (it == nodeIndex.end() || nodes[it->second].type != FILENODE)
+    {
+        return to_string(API_ENOENT);
+    }
+    const MockNode& n = nodes[it->second];
+    string url = storageUrl + "dl/" + to_string(n.blob);
+
+    JSONWriter w;
+    w.beginobject();
+    w.arg("s", n.size);
+    w.arg("at", n.attrs);
+    if (blobs[n.blob].parts.empty())
+    {
+        w.arg("g", url);
+        w.beginarray("ip");
+        w.element("127.0.0.1");
+        w.element("::1");
+        w.endarray();
+    }
+    else
+    {
+        w.beginarray("g");
+        for (unsigned p = 0; p < RAIDPARTS; p++)
+        {
+            w.element(url + "/" + to_string(p));
+        }
+        w.endarray();
+        w.beginarray("ip");
+        for (unsigned p = 0; p < RAIDPARTS; p++)
+        {
+            w.element("127.0.0.1");
+            w.element("::1");
+        }
+        w.endarray();
+    }
+    w.arg("ts", n.ts);
+    w.arg("tl", m_off_t(0));
+    w.endobject();
+    return w.getstring();
+}
+
+string MockAccount::putFile(JSON& cmd)
+{
+    m_off_t size = -1;
+    for (nameid name; (name = cmd.getnameid()) != EOO; )
+    {
+        if (name == 's')
+        {
+            size = cmd.getint();
+        }
+        else if (!cmd.storeobject())
+        {
+            return to_string(API_EARGS);
+        }
+    }
+
+    if (size < 0)
+    {
+        return to_string(API_EARGS);
+    }
+
+    handle id = nextHandle++;
+    uploads[id].size = size;
+
+    JSONWriter w;
+    w.beginobject();
+    w.arg("p", storageUrl + "ul/" + b64handle(id, MegaClient::NODEHANDLE));
+    w.endobject();
+    return w.getstring();
+}
+
+string MockAccount::putNodes(JSON& cmd)
+{
+    handle target = UNDEF;
+    string origin, newnodes;
+    for (nameid name; (name = cmd.getnameid()) != EOO; )
+    {
+        bool ok = true;
+        switch (name)
+        {
+            case 't':
+                target = cmd.gethandle(MegaClient::NODEHANDLE);
+                break;
+            case 'i':
+                ok = cmd.storeobject(&origin);
+                break;
+            case 'n':
+                ok = cmd.storeobject(&newnodes);
+                break;
+            default:
+                ok = cmd.storeobject();
+        }
+
+        if (!ok)
+        {
+            return to_string(API_EARGS);
+        }
+    }
+
+    if (nodeIndex.find(target) == nodeIndex.end())
+    {
+        return to_string(API_ENOENT);
+    }
+
+    // parents may refer to the temporary handles of nodes earlier in the same batch
+    map<string, handle> added;
+    vector<size_t> created;
+
+    JSON nn(newnodes);
+    if (!nn.enterarray())
+    {
+        return to_string(API_EARGS);
+    }
+
+    while (nn.enterobject())
+    {
+        string h, p, a, k;
+        nodetype_t type = TYPE_UNKNOWN;
+        for (nameid name; (name = nn.getnameid()) != EOO; )
+        {
+            switch (name)
+            {
+                case 'h': nn.storeobject(&h); break;
+                case 'p': nn.storeobject(&p); break;
+                case 't': type = nodetype_t(nn.getint()); break;
+                case 'a': nn.storeobject(&a); break;
+                case 'k': nn.storeobject(&k); break;
+                default: nn.storeobject();
+            }
+        }
+        nn.leaveobject();
+
+        MockNode n;
+        n.h = nextHandle++;
+        n.parent = p.size() && added.count(p) ? added[p] : target;
+        n.type = type;
+        n.size = -1;
+        n.blob = 0;
+        n.attrs = a;
+        n.key = Base64::atob(k);
+        n.ts = m_time();
+
+        if (type == FILENODE)
+        {
+            auto it = uploadTokens.find(h);
+            if (it == uploadTokens.end())
+            {
+                return to_string(API_ENOENT);
+            }
+            n.blob = it->second;
+            n.size = m_off_t(blobs[n.blob].data.size());
+        }
+        else if (type != FOLDERNODE)
+        {
+            return to_string(API_EARGS);
+        }
+
+        added[h] = n.h;
+        nodeIndex[n.h] = nodes.size();
+        created.push_back(nodes.size());
+        nodes.push_back(std::move(n));
+    }
+
+    JSONWriter w;
+    w.beginobject();
+    w.beginarray("f");
+    for (size_t i : created)
+    {
+        writeNode(w, nodes[i]);
+    }
+    w.endarray();
+    w.endobject();
+
+    // the same nodes as an action packet, which the originating client will skip
+    JSONWriter packet;
+    packet.beginobject();
+    packet.arg("a", "t");
+    if (origin.size())
+    {
+        packet.arg("i", origin);
+    }
+    packet.arg("t", w.getstring(), 0);
+    packet.arg("ou", me, MegaClient::USERHANDLE);
+    packet.endobject();
+    packets.emplace_back(++scsn, packet.getstring());
+
+    return w.getstring();
+}
+
+string MockAccount::actionPackets(const string& sn) const
+{
+    uint64_t from = 0;
+    if (Base64::atob(sn.c_str(), (byte*)&from, sizeof from) != sizeof from || from >= scsn)
+    {
+        return string();
+    }
+
+    string response = "{\"a\":[";
+    bool first = true;
+    for (auto& p : packets)
+    {
+        if (p.first > from)
+        {
+            response.append(first ? "" : ",");
+            response.append(p.second);
+            first = false;
+        }
+    }
+    return response + "],\"sn\":\"" + currentScsn() + "\"}";
+}
+
+bool MockAccount::download(const string& path, string& data) const
+{
+    // <id>/<from>-<to> or <id>/<part>/<from>-<to>, <to> inclusive
+    unsigned long id = 0, part = 0;
+    unsigned long long from = 0, to = 0;
+    const Blob* b = nullptr;
+    const string* source = nullptr;
+
+    if (sscanf(path.c_str(), "/dl/%lu/%lu/%llu-%llu", &id, &part, &from, &to) == 4)
+    {
+        if (id >= blobs.size() || part >= blobs[id].parts.size()) return false;
+        b = &blobs[id];
+        source = &b->parts[part];
+    }
+    else if (sscanf(path.c_str(), "/dl/%lu/%llu-%llu", &id, &from, &to) == 3)
+    {
+        if (id >= blobs.size()) return false;
+        b = &blobs[id];
+        source = &b->data;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (from >= source->size() || to < from)
+    {
+        data.clear();
+        return true;
+    }
+
+    data = source->substr(size_t(from), size_t(std::min<unsigned long long>(to + 1, source->size()) - from));
+    return true;
+}
+
+bool MockAccount::upload(const string& path, const string& data, string& response)
+{
+    // <id>/<pos>
+    size_t slash = path.find('/', 4);
+    if (path.compare(0, 4, "/ul/") || slash == string::npos)
+    {
+        return false;
+    }
+
+    handle id = 0;
+    if (Base64::atob(path.substr(4, slash - 4).c_str(), (byte*)&id, MegaClient::NODEHANDLE) != MegaClient::NODEHANDLE)
+    {
+        return false;
+    }
+
+    auto it = uploads.find(id);
+    if (it == uploads.end())
+    {
+        return false;
+    }
+
+    Upload& u = it->second;
+    m_off_t pos = atoll(path.c_str() + slash + 1);
+    if (pos < 0 || pos + m_off_t(data.size()) > u.size)
+    {
+        return false;
+    }
+
+    if (u.data.size() < size_t(u.size))
+    {
+        u.data.resize(size_t(u.size));
+    }
+    u.data.replace(size_t(pos), data.size(), data);
+    u.chunks[pos] = data.size();
+
+    m_off_t received = 0;
+    for (auto& c : u.chunks)
+    {
+        received += m_off_t(c.second);
+    }
+
+    response.clear();
+    if (received >= u.size)
+    {
+        // the uploaded (encrypted) data can be downloaded again from the new node
+        Blob b;
+        memset(b.key, 0, sizeof b.key);
+        b.data = std::move(u.data);
+        blobs.push_back(std::move(b));
+
+        response.resize(NewNode::UPLOADTOKENLEN);
+        rng.genblock((byte*)response.data(), response.size());
+        uploadTokens[Base64::btoa(response)] = blobs.size() - 1;
+        uploads.erase(it);
+    }
+    return true;
+}
+
+struct MockServer::Connection
+{
+    asio::ip::tcp::socket socket;
+    asio::steady_timer timer;
+    asio::streambuf inbuf;
+
+    string method, path, body;
+    size_t contentLength = 0;
+
+    string out;
+    size_t sent = 0;
+    bool throttled = false;
+
+    explicit Connection(asio::io_service& as) : socket(as), timer(as) {}
+};
+
+MockServer::MockServer(asio::io_service& as, const MockServerConfig& c)
+    : asio_service(as)
+    , config(c)
+    , mAccount(c)
+    , asio_acceptor(as)
+{
+    // both IPv4 and IPv6, as `g` responses give the client an address of each kind
+    asio::ip::tcp::endpoint endpoint(asio::ip::tcp::v6(), c.port);
+    asio_acceptor.open(endpoint.protocol());
+    asio_acceptor.set_option(asio::ip::v6_only(false));
+    asio_acceptor.set_option(asio::ip::tcp::acceptor::reuse_address(true));
+    asio_acceptor.bind(endpoint);
+    asio_acceptor.listen();
+
+    mAccount.setStorageUrl(apiUrl());
+    StartAccepting();
+}
+
+uint16_t MockServer::port() const
+{
+    return asio_acceptor.local_endpoint().port();
+}
+
+string MockServer::apiUrl() const
+{
+    return "http://127.0.0.1:" + to_string(port()) + "/";
+}
+
+void MockServer::Stop()
+{
+    asio_service.post([this]() {
+        asio_acceptor.close();
+        stopped = true;
+    });
+}
+
+void MockServer::StartAccepting()
+{
+    if (stopped) return;
+    auto c = std::make_shared<Connection>(asio_service);
+    asio_acceptor.async_accept(c->socket, [this, c](const asio::error_code& ec) {
+        if (stopped) return;
+        if (!ec)
+        {
+            c->socket.set_option(asio::ip::tcp::no_delay(true));
+            ReadRequest(c);
+        }
+        StartAccepting();
+    });
+}
+
+void MockServer::ReadRequest(std::shared_ptr<Connection> c)
+{
+    if (stopped) return;
+    asio::async_read_until(c->socket, c->inbuf, "\r\n\r\n", [this, c](const asio::error_code& ec, std::size_t n) {
+        if (stopped || ec) return;
+
+        string headers(asio::buffers_begin(c->inbuf.data()), asio::buffers_begin(c->inbuf.data()) + n);
+        c->inbuf.consume(n);
+
+        size_t sp1 = headers.find(' ');
+        size_t sp2 = headers.find(' ', sp1 + 1);
+        if (sp1 == string::npos || sp2 == string::npos)
+        {
+            c->socket.close();
+            return;
+        }
+        c->method = headers.substr(0, sp1);
+        c->path = headers.substr(sp1 + 1, sp2 - sp1 - 1);
+        c->body.clear();
+        c->contentLength = 0;
+
+        tolower_string(headers);
+        size_t cl = headers.find("\r\ncontent-length:");
+        if (cl != string::npos)
+        {
+            c->contentLength = size_t(atoll(headers.c_str() + cl + 17));
+        }
+
+        c->throttled = Throttled(c->path);
+        ReadBody(c);
+    });
+}
+
+void MockServer::ReadBody(std::shared_ptr<Connection> c)
+{
+    if (stopped) return;
+
+    size_t buffered = std::min(c->inbuf.size(), c->contentLength - c->body.size());
+    c->body.append(asio::buffers_begin(c->inbuf.data()), asio::buffers_begin(c->inbuf.data()) + buffered);
+    c->inbuf.consume(buffered);
+
+    if (c->body.size() == c->contentLength)
+    {
+        return Dispatch(c);
+    }
+
+    size_t n = c->contentLength - c->body.size();
+    if (c->throttled)
+    {
+        n = std::min(n, std::max<size_t>(config.bytesPerSecond / 10, 1));
+    }
+
+    asio::async_read(c->socket, c->inbuf, asio::transfer_exactly(n), [this, c](const asio::error_code& ec, std::size_t) {
+        if (stopped || ec) return;
+        if (!c->throttled)
+        {
+            return ReadBody(c);
+        }
+        c->timer.expires_from_now(std::chrono::milliseconds(100));
+        c->timer.async_wait([this, c](const asio::error_code& ec) { if (!ec) ReadBody(c); });
+    });
+}
+
+void MockServer::Dispatch(std::shared_ptr<Connection> c)
+{
+    string route = c->path.substr(0, c->path.find('?'));
+
+    if (config.verbose)
+    {
+        cout << c->method << " " << route << " (" << c->body.size() << " bytes)" << endl;
+    }
+
+    if (route == "/cs")
+    {
+        Respond(c, 200, mAccount.processCommands(c->body));
+
+        // new nodes are also action packets
+        NotifyActionPackets();
+    }
+    else if (route == "/sc" || route == "/wsc")
+    {
+        if (queryParam(c->path, "c").size())
+        {
+            // no user alerts
+            Respond(c, 200, "{\"c\":[],\"u\":[]}");
+        }
+        else
+        {
+            WaitForActionPackets(c, queryParam(c->path, "sn"));
+        }
+    }
+    else if (!route.compare(0, 4, "/dl/"))
+    {
+        string data;
+        bool found = mAccount.download(route, data);
+        Respond(c, found ? 200 : 404, std::move(data), true);
+    }
+    else if (!route.compare(0, 4, "/ul/"))
+    {
+        string token;
+        bool found = mAccount.upload(route, c->body, token);
+        Respond(c, found ? 200 : 404, std::move(token), true);
+    }
+    else
+    {
+        Respond(c, 404, string());
+    }
+}
+
+void MockServer::Respond(std::shared_ptr<Connection> c, int status, string&& body, bool binary)
+{
+    ostringstream s;
+    s << "HTTP/1.1 " << status << (status == 200 ? " OK" : " Not Found") << "\r\n"
+      << "Content-Type: " << (binary ? "application/octet-stream" : "application/json") << "\r\n"
+      << "Content-Length: " << body.size() << "\r\n"
+      << "Access-Control-Allow-Origin: *\r\n"
+      << "Connection: keep-alive\r\n\r\n";
+
+    c->out = s.str();
+    c->out.append(body);
+    c->sent = 0;
+
+    if (config.latency.count() <= 0)
+    {
+        return SendMore(c);
+    }
+
+    c->timer.expires_from_now(config.latency);
+    c->timer.async_wait([this, c](const asio::error_code& ec) { if (!ec) SendMore(c); });
+}
+
+void MockServer::SendMore(std::shared_ptr<Connection> c)
+{
+    if (stopped) return;
+
+    if (c->sent == c->out.size())
+    {
+        c->out.clear();
+        return ReadRequest(c);
+    }
+
+    size_t n = c->out.size() - c->sent;
+    if (c->throttled)
+    {
+        // slices every 100 ms, as TcpRelay does
+        n = std::min(n, std::max<size_t>(config.bytesPerSecond / 10, 1));
+    }
+
+    asio::async_write(c->socket, asio::buffer(c->out.data() + c->sent, n), [this, c](const asio::error_code& ec, std::size_t written) {
+        if (stopped || ec) return;
+        c->sent += written;
+        if (!c->throttled || c->sent == c->out.size())
+        {
+            return SendMore(c);
+        }
+        c->timer.expires_from_now(std::chrono::milliseconds(100));
+        c->timer.async_wait([this, c](const asio::error_code& ec) { if (!ec) SendMore(c); });
+    });
+}
+
+void MockServer::WaitForActionPackets(std::shared_ptr<Connection> c, const string& sn)
+{
+    string packets = mAccount.actionPackets(sn);
+    if (packets.size())
+    {
+        return Respond(c, 200, std::move(packets));
+    }
+
+    // hold the request until there is something new, like the real servers do
+    waitingSc.push_back(c);
+    c->timer.expires_from_now(config.scHold);
+    c->timer.async_wait([this, c](const asio::error_code& ec) {
+        if (ec) return;
+        waitingSc.erase(std::remove_if(waitingSc.begin(), waitingSc.end(),
+                                       [&c](const std::weak_ptr<Connection>& w) { return w.lock() == c; }),
+                        waitingSc.end());
+        Respond(c, 200, "{\"sn\":\"" + mAccount.currentScsn() + "\"}");
+    });
+}
+
+void MockServer::NotifyActionPackets()
+{
+    auto waiting = std::move(waitingSc);
+    waitingSc.clear();
+
+    for (auto& w : waiting)
+    {
+        if (auto c = w.lock())
+        {
+            c->timer.cancel();
+            WaitForActionPackets(c, queryParam(c->path, "sn"));
+        }
+    }
+}
+
+bool MockServer::Throttled(const string& path) const
+{
+    return config.bytesPerSecond && (!path.compare(0, 4, "/dl/") || !path.compare(0, 4, "/ul/"));
+}
+
+} // namespace mt
@@ -0,0 +1,184 @@
+/**
+ * @file mockserver.h
+ * @brief local stand-in for the MEGA API and storage servers
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#pragma once
+#include <asio.hpp>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mega.h>
+
+namespace mt {
+
+struct MockServerConfig
+{
+    // listening port (0: any free port)
+    uint16_t port = 0;
+
+    // synthetic tree: `folders` folders below the root, each with `filesPerFolder` files of `fileSize` bytes
+    unsigned folders = 10;
+    unsigned filesPerFolder = 100;
+    m_off_t fileSize = 1024 * 1024;
+
+    // serve downloads as 6 CloudRAID parts
+    bool raid = false;
+
+    // delay added to every response
+    std::chrono::milliseconds latency{0};
+
+    // per-connection limit for storage transfers, in both directions (0: unlimited)
+    size_t bytesPerSecond = 0;
+
+    // how long an sc request is held open when there is nothing new
+    std::chrono::seconds scHold{20};
+
+    // print a line per request
+    bool verbose = false;
+};
+
+// The account, its node tree and its stored file data, independent of the network side.
+// Requests are answered in the same JSON formats as the real servers, for the subset of
+// commands that MegaClient needs to resume a session, fetch nodes, download and upload.
+class MockAccount
+{
+public:
+    explicit MockAccount(const MockServerConfig& config);
+
+    // session to resume with MegaApi::fastLogin()
+    std::string session() const;
+
+    // base URL of the storage servers, set once the port is known
+    void setStorageUrl(const std::string& url);
+
+    // body of a `cs` request (a JSON array of commands): the JSON array of results
+    std::string processCommands(const std::string& body);
+
+    // `sc` response with the action packets after `sn`, or empty if there are none
+    std::string actionPackets(const std::string& sn) const;
+    std::string currentScsn() const;
+
+    // storage: data for "/dl/<id>[/<part>]/<from>-<to>"; uploads via "/ul/<id>/<pos>"
+    bool download(const std::string& path, std::string& data) const;
+    bool upload(const std::string& path, const std::string& data, std::string& response);
+
+    size_t nodeCount() const { return nodes.size(); }
+
+private:
+    struct Blob
+    {
+        mega::byte key[mega::FILENODEKEYLENGTH];
+        std::string data;
+        std::vector<std::string> parts;
+    };
+
+    struct MockNode
+    {
+        mega::handle h;
+        mega::handle parent;
+        mega::nodetype_t type;
+        m_off_t size;
+        std::string key;
+        std::string attrs;
+        size_t blob;
+        mega::m_time_t ts;
+    };
+
+    struct Upload
+    {
+        m_off_t size = 0;
+        std::string data;
+        std::map<m_off_t, size_t> chunks;
+    };
+
+    MockServerConfig config;
+    mega::PrnGen rng;
+
+    mega::SymmCipher masterKey;
+    std::string sid;
+    mega::handle me;
+    std::string privk, pubk;
+
+    std::vector<MockNode> nodes;
+    std::map<mega::handle, size_t> nodeIndex;
+    mega::handle nextHandle = 1;
+
+    std::map<m_off_t, size_t> blobBySize;
+    std::vector<Blob> blobs;
+
+    std::map<mega::handle, Upload> uploads;
+    std::map<std::string, size_t> uploadTokens;
+
+    uint64_t scsn = 1;
+    std::deque<std::pair<uint64_t, std::string>> packets;
+
+    std::string storageUrl;
+
+    mega::handle addNode(mega::handle parent, mega::nodetype_t type, const std::string& name, m_off_t size);
+    size_t blobFor(m_off_t size);
+    std::string encryptAttrs(const mega::byte* key, mega::nodetype_t type, const std::string& json);
+    void writeNode(mega::JSONWriter& w, const MockNode& n) const;
+
+    std::string login(mega::JSON& cmd);
+    std::string getUserData(mega::JSON& cmd);
+    std::string fetchNodes(mega::JSON& cmd);
+    std::string getFile(mega::JSON& cmd);
+    std::string putFile(mega::JSON& cmd);
+    std::string putNodes(mega::JSON& cmd);
+};
+
+// Serves a MockAccount over HTTP, on 127.0.0.1 in the URLs it hands out.  All work is done
+// on the thread that runs the io_service, so the account needs no locking.
+class MockServer
+{
+public:
+    MockServer(asio::io_service& as, const MockServerConfig& config);
+
+    uint16_t port() const;
+    std::string apiUrl() const;
+    MockAccount& account() { return mAccount; }
+
+    void Stop();
+
+private:
+    struct Connection;
+
+    asio::io_service& asio_service;
+    MockServerConfig config;
+    MockAccount mAccount;
+    asio::ip::tcp::acceptor asio_acceptor;
+    std::vector<std::weak_ptr<Connection>> waitingSc;
+    bool stopped = false;
+
+    void StartAccepting();
+    void ReadRequest(std::shared_ptr<Connection> c);
+    void ReadBody(std::shared_ptr<Connection> c);
+    void Dispatch(std::shared_ptr<Connection> c);
+    void Respond(std::shared_ptr<Connection> c, int status, std::string&& body, bool binary = false);
+    void SendMore(std::shared_ptr<Connection> c);
+    void WaitForActionPackets(std::shared_ptr<Connection> c, const std::string& sn);
+    void NotifyActionPackets();
+    bool Throttled(const std::string& path) const;
+};
+
+} // namespace mt
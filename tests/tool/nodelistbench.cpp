@@ -0,0 +1,102 @@
+/**
+ * @file tests/tool/nodelistbench.cpp
+ * @brief Cost of listing the children of a big folder as MegaNodeList and MegaNodeInfoList
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "megaapi_impl.h"
+#include "allocationcounter.h"
+#include "benchutils.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace mega;
+using std::cout;
+using std::endl;
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+// the time, allocations and peak memory taken to build and delete a list
+template<typename F>
+void measure(const char* what, F build)
+{
+    uint64_t allocations = mt::allocationCount();
+    int64_t before = mt::allocatedBytes();
+    auto start = clock_type::now();
+
+    auto list = build();
+    int64_t used = mt::allocatedBytes() - before;
+    list.reset();
+
+    double secs = std::chrono::duration<double>(clock_type::now() - start).count();
+    cout << what << ": " << secs << " s, " << mt::allocationCount() - allocations << " allocations, "
+         << used << " bytes" << endl;
+}
+
+void usage()
+{
+    cout << "usage: tool_nodelistbench [options]\n"
+         << "  --files <n>  children of the synthetic folder (default: 200000)\n"
+         << "\n"
+         << "Nothing is sent to the servers: the folder is only built in memory." << endl;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    unsigned files = 200000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(argv[i], "--files") && value) files = unsigned(atoi(value)), i++;
+        else { usage(); return 1; }
+    }
+
+    SimpleLogger::setLogLevel(logError);
+
+    MegaApp app;
+    FSACCESS_CLASS fsaccess;
+    auto client = mt::makeClient(app, fsaccess, "nodelistbench");
+
+    Node* folder = mt::makeNode(*client, 1, UNDEF, FOLDERNODE, "folder");
+    for (unsigned i = 0; i < files; i++)
+    {
+        // (long enough not to fit in the strings themselves, as most real names)
+        mt::makeNode(*client, handle(i + 2), folder->nodehandle, FILENODE, "IMG_" + std::to_string(20200000 + i) + "_holidays.jpg");
+    }
+
+    node_vector children(folder->children.begin(), folder->children.end());
+    cout << "Children: " << children.size() << endl;
+
+    measure("MegaNodeList", [&]() {
+        return unique_ptr<MegaNodeList>(new MegaNodeListPrivate(children.data(), int(children.size())));
+    });
+
+    measure("MegaNodeInfoList", [&]() {
+        return unique_ptr<MegaNodeInfoList>(new MegaNodeInfoListPrivate(children.data(), children.size()));
+    });
+
+    return 0;
+}
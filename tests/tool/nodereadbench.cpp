@@ -0,0 +1,185 @@
+/**
+ * @file tests/tool/nodereadbench.cpp
+ * @brief Latency of node queries from other threads while the SDK is transferring
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "megaapi.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+
+using namespace mega;
+using std::cout;
+using std::endl;
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+bool succeeded(SynchronousRequestListener& listener, const char* what)
+{
+    listener.wait();
+    if (listener.getError()->getErrorCode() != MegaError::API_OK)
+    {
+        cout << what << " failed: " << listener.getError()->getErrorString() << endl;
+        return false;
+    }
+    return true;
+}
+
+void collect(MegaApi& api, MegaNode* parent, vector<MegaHandle>& folders, vector<MegaHandle>& files)
+{
+    folders.push_back(parent->getHandle());
+
+    unique_ptr<MegaNodeList> children(api.getChildren(parent, MegaApi::ORDER_NONE));
+    for (int i = 0; i < children->size(); i++)
+    {
+        MegaNode* child = children->get(i);
+        if (child->isFile())
+        {
+            files.push_back(child->getHandle());
+        }
+        else
+        {
+            collect(api, child, folders, files);
+        }
+    }
+}
+
+// latencies of getNodeByHandle() and getChildren() on random nodes, in microseconds
+vector<double> query(MegaApi& api, const vector<MegaHandle>& folders, const vector<MegaHandle>& files,
+                     unsigned threads, double seconds)
+{
+    vector<vector<double>> latencies(threads);
+    vector<std::thread> readers;
+    auto end = clock_type::now() + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(seconds));
+
+    for (unsigned t = 0; t < threads; t++)
+    {
+        readers.emplace_back([&, t]() {
+            std::mt19937 rng(t);
+            while (clock_type::now() < end)
+            {
+                auto start = clock_type::now();
+                unique_ptr<MegaNode> folder(api.getNodeByHandle(folders[rng() % folders.size()]));
+                unique_ptr<MegaNode> file(api.getNodeByHandle(files.empty() ? UNDEF : files[rng() % files.size()]));
+                unique_ptr<MegaNodeList> children(api.getChildren(folder.get(), MegaApi::ORDER_DEFAULT_ASC));
+                latencies[t].push_back(std::chrono::duration<double, std::micro>(clock_type::now() - start).count());
+            }
+        });
+    }
+
+    vector<double> all;
+    for (unsigned t = 0; t < threads; t++)
+    {
+        readers[t].join();
+        all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+    }
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+void report(const char* what, const vector<double>& latencies)
+{
+    auto percentile = [&](double p) {
+        return latencies.empty() ? 0 : latencies[std::min(latencies.size() - 1, size_t(p * double(latencies.size())))];
+    };
+
+    cout << what << ": " << latencies.size() << " queries, p50 " << percentile(0.5) << " us, p90 " << percentile(0.9)
+         << " us, p99 " << percentile(0.99) << " us, max " << (latencies.empty() ? 0 : latencies.back()) << " us" << endl;
+}
+
+void usage()
+{
+    cout << "usage: tool_nodereadbench <folder> <apiurl> <session> [options]\n"
+         << "  --threads <n>   threads querying the nodes (default: 4)\n"
+         << "  --seconds <n>   duration of each round of queries (default: 10)\n"
+         << "\n"
+         << "Queries random nodes while the whole account is downloaded to <folder>, first\n"
+         << "with the SDK lock and then with MegaApi::setConcurrentNodeQueries enabled.\n"
+         << "Intended to be run against tool_mockserver, whose API URL and session it prints." << endl;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        usage();
+        return 1;
+    }
+
+    unsigned threads = 4;
+    double seconds = 10;
+
+    for (int i = 4; i < argc; i++)
+    {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(argv[i], "--threads") && value) threads = unsigned(std::max(1, atoi(value))), i++;
+        else if (!strcmp(argv[i], "--seconds") && value) seconds = std::max(1.0, atof(value)), i++;
+        else { usage(); return 1; }
+    }
+
+    MegaApi::setLogLevel(MegaApi::LOG_LEVEL_ERROR);
+    MegaApi api("nodereadbench", (const char*)nullptr, "nodereadbench");
+    api.changeApiUrl(argv[2], true);
+
+    SynchronousRequestListener login;
+    api.fastLogin(argv[3], &login);
+    if (!succeeded(login, "Login"))
+    {
+        return 1;
+    }
+
+    SynchronousRequestListener fetch;
+    api.fetchNodes(&fetch);
+    if (!succeeded(fetch, "Fetchnodes"))
+    {
+        return 1;
+    }
+
+    unique_ptr<MegaNode> root(api.getRootNode());
+    vector<MegaHandle> folders;
+    vector<MegaHandle> files;
+    collect(api, root.get(), folders, files);
+    cout << "Nodes: " << folders.size() << " folders, " << files.size() << " files" << endl;
+
+    // keeps the SDK thread busy with transfers during both rounds
+    string target = argv[1];
+    if (target.back() != '/' && target.back() != '\\')
+    {
+        target.push_back('/');
+    }
+    api.startDownload(root.get(), target.c_str(), nullptr);
+
+    report("With the SDK lock", query(api, folders, files, threads, seconds));
+
+    api.setConcurrentNodeQueries(true);
+    report("Concurrent", query(api, folders, files, threads, seconds));
+
+    api.cancelTransfers(MegaTransfer::TYPE_DOWNLOAD);
+    return 0;
+}
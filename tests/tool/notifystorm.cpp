@@ -0,0 +1,268 @@
+/**
+ * @file tests/tool/notifystorm.cpp
+ * @brief Event storm harness for the Linux filesystem notification backends
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <poll.h>
+#include <thread>
+
+using namespace mega;
+using std::cout;
+using std::endl;
+
+namespace {
+
+const unsigned FOLDERS_PER_GROUP = 100;
+
+typedef std::chrono::steady_clock clock_type;
+
+double since(clock_type::time_point start)
+{
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// <root>/gN/fN, FOLDERS_PER_GROUP folders per group
+vector<string> createTree(const string& root, unsigned folders)
+{
+    vector<string> paths{ root };
+    mkdir(root.c_str(), 0700);
+
+    for (unsigned g = 0; paths.size() <= folders; g++)
+    {
+        string group = root + "/g" + std::to_string(g);
+        mkdir(group.c_str(), 0700);
+        paths.push_back(group);
+
+        for (unsigned f = 0; f < FOLDERS_PER_GROUP && paths.size() <= folders; f++)
+        {
+            string folder = group + "/f" + std::to_string(f);
+            mkdir(folder.c_str(), 0700);
+            paths.push_back(folder);
+        }
+    }
+    return paths;
+}
+
+// what a sync generates: files created, written, renamed and deleted all over the tree
+void storm(const vector<string>& folders, unsigned operations, unsigned thread, std::atomic<unsigned>& generated)
+{
+    for (unsigned i = 0; i < operations; i++)
+    {
+        const string& folder = folders[(i * 7919 + thread * 104729) % folders.size()];
+        string name = folder + "/storm." + std::to_string(thread) + "." + std::to_string(i);
+
+        int fd = open(name.c_str(), O_CREAT | O_WRONLY, 0600);
+        if (fd < 0)
+        {
+            continue;
+        }
+        if (write(fd, "data", 4) != 4) { }
+        close(fd);                                  // create, close_write
+
+        string renamed = name + ".renamed";
+        rename(name.c_str(), renamed.c_str());      // moved_from, moved_to
+        unlink(renamed.c_str());                    // delete
+
+        generated += 5;
+    }
+}
+
+struct Received
+{
+    uint64_t events = 0;
+    uint64_t overflows = 0;
+};
+
+void readInotify(int fd, Received& received)
+{
+    alignas(inotify_event) char buf[65536];
+    ssize_t l;
+
+    while ((l = read(fd, buf, sizeof buf)) > 0)
+    {
+        for (ssize_t p = 0; p < l; )
+        {
+            inotify_event* in = reinterpret_cast<inotify_event*>(buf + p);
+            if (in->mask & IN_Q_OVERFLOW)
+            {
+                received.overflows++;
+            }
+            else
+            {
+                received.events++;
+            }
+            p += sizeof(inotify_event) + in->len;
+        }
+    }
+}
+
+#ifdef USE_FANOTIFY
+void readFanotify(Fanotify& fanotify, const string& root, Received& received)
+{
+    // as PosixFileSystemAccess does: only what is below the root counts
+    bool complete = fanotify.read([&](const string& path, uint32_t) {
+        if (path.size() > root.size() && !path.compare(0, root.size(), root) && path[root.size()] == '/')
+        {
+            received.events++;
+        }
+    });
+
+    if (!complete)
+    {
+        received.overflows++;
+    }
+}
+#endif
+
+void usage()
+{
+    cout << "usage: tool_notifystorm <folder> [options]\n"
+         << "  --folders <n>     folders in the synthetic tree (default: 10000)\n"
+         << "  --operations <n>  create/write/rename/delete cycles per thread (default: 10000)\n"
+         << "  --threads <n>     threads generating events (default: 4)\n"
+         << "\n"
+         << "fanotify needs CAP_SYS_ADMIN: run as root to compare both backends.\n"
+         << "Raise fs.inotify.max_user_watches for trees larger than its value." << endl;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        usage();
+        return 1;
+    }
+
+    unsigned folders = 10000;
+    unsigned operations = 10000;
+    unsigned threads = 4;
+
+    for (int i = 2; i < argc; i++)
+    {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(argv[i], "--folders") && value) folders = unsigned(atoi(value)), i++;
+        else if (!strcmp(argv[i], "--operations") && value) operations = unsigned(atoi(value)), i++;
+        else if (!strcmp(argv[i], "--threads") && value) threads = unsigned(atoi(value)), i++;
+        else { usage(); return 1; }
+    }
+
+    vector<string> tree = createTree(argv[1], folders);
+    cout << "Created " << tree.size() << " folders" << endl;
+
+    char* real = realpath(argv[1], nullptr);
+    string root = real ? real : argv[1];
+    free(real);
+
+    // registration, as the syncs do it: one watch per folder, or one mark
+    int inotifyfd = inotify_init1(IN_NONBLOCK);
+    auto start = clock_type::now();
+    unsigned watched = 0;
+
+    for (const string& folder : tree)
+    {
+        if (inotify_add_watch(inotifyfd, folder.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM
+                              | IN_MOVED_TO | IN_CLOSE_WRITE | IN_EXCL_UNLINK | IN_ONLYDIR) >= 0)
+        {
+            watched++;
+        }
+    }
+    cout << "inotify: " << watched << " of " << tree.size() << " folders watched in " << since(start) << " s" << endl;
+
+#ifdef USE_FANOTIFY
+    FSACCESS_CLASS fsaccess;
+    Fanotify fanotify;
+    uint64_t fsid = 0;
+
+    start = clock_type::now();
+    bool marked = fanotify.open() && fanotify.mark(LocalPath::fromPath(root, fsaccess), fsid);
+    cout << "fanotify: " << (marked ? "filesystem marked in " + std::to_string(since(start)) + " s" : string("unavailable")) << endl;
+#else
+    cout << "fanotify: not built" << endl;
+#endif
+
+    // the storm, read concurrently as the client thread would
+    std::atomic<unsigned> generated(0);
+    std::atomic<unsigned> running(threads);
+    vector<std::thread> generators;
+
+    start = clock_type::now();
+    for (unsigned t = 0; t < threads; t++)
+    {
+        generators.emplace_back([&, t]() {
+            storm(tree, operations, t, generated);
+            running--;
+        });
+    }
+
+    Received inotifyReceived;
+    Received fanotifyReceived;
+
+    for (bool draining = false; ; )
+    {
+        vector<pollfd> fds{ { inotifyfd, POLLIN, 0 } };
+#ifdef USE_FANOTIFY
+        if (marked)
+        {
+            fds.push_back({ fanotify.fd(), POLLIN, 0 });
+        }
+#endif
+        int ready = poll(fds.data(), nfds_t(fds.size()), 100);
+
+        readInotify(inotifyfd, inotifyReceived);
+#ifdef USE_FANOTIFY
+        if (marked)
+        {
+            readFanotify(fanotify, root, fanotifyReceived);
+        }
+#endif
+
+        if (draining && ready <= 0)
+        {
+            break;
+        }
+        draining = !running;
+    }
+
+    for (auto& generator : generators)
+    {
+        generator.join();
+    }
+
+    double secs = since(start);
+    cout << "Generated " << generated << " events in " << secs << " s" << endl;
+    cout << "inotify: " << inotifyReceived.events << " events, " << inotifyReceived.overflows << " overflows" << endl;
+#ifdef USE_FANOTIFY
+    if (marked)
+    {
+        // (queued events of the same entry are merged, so fewer are expected)
+        cout << "fanotify: " << fanotifyReceived.events << " events, " << fanotifyReceived.overflows << " overflows" << endl;
+    }
+#endif
+
+    close(inotifyfd);
+    return 0;
+}
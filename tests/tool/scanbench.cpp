@@ -0,0 +1,186 @@
+/**
+ * @file tests/tool/scanbench.cpp
+ * @brief Benchmark of directory tree traversal for sync scans
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "mega/dirscanner.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace mega;
+using std::cout;
+using std::endl;
+
+namespace {
+
+const unsigned FILES_PER_FOLDER = 1000;
+const unsigned FOLDERS_PER_FOLDER = 100;
+
+LocalPath child(const LocalPath& parent, const string& name, FileSystemAccess& fsaccess)
+{
+    LocalPath p = parent;
+    p.appendWithSeparator(LocalPath::fromPath(name, fsaccess), false);
+    return p;
+}
+
+// <root>/gN/fN/<FILES_PER_FOLDER empty files>, FOLDERS_PER_FOLDER folders per group
+bool createTree(FileSystemAccess& fsaccess, const LocalPath& root, uint64_t entries)
+{
+    LocalPath rootPath = root;
+    fsaccess.mkdirlocal(rootPath, false);
+
+    uint64_t created = 0;
+    for (unsigned g = 0; created < entries; g++)
+    {
+        LocalPath group = child(root, "g" + std::to_string(g), fsaccess);
+        fsaccess.mkdirlocal(group, false);
+        created++;
+
+        for (unsigned f = 0; f < FOLDERS_PER_FOLDER && created < entries; f++)
+        {
+            LocalPath folder = child(group, "f" + std::to_string(f), fsaccess);
+            fsaccess.mkdirlocal(folder, false);
+            created++;
+
+            for (unsigned i = 0; i < FILES_PER_FOLDER && created < entries; i++)
+            {
+                LocalPath file = child(folder, std::to_string(i) + ".dat", fsaccess);
+                auto fa = fsaccess.newfileaccess(false);
+                if (!fa->fopen(file, false, true))
+                {
+                    cout << "Unable to create " << file.toPath(fsaccess) << endl;
+                    return false;
+                }
+                created++;
+            }
+        }
+
+        cout << "\rCreated " << created << " entries" << std::flush;
+    }
+    cout << endl;
+    return true;
+}
+
+// what Sync::scan() does on the client thread: list each folder, open each entry
+uint64_t walkSequential(FileSystemAccess& fsaccess, const LocalPath& root)
+{
+    uint64_t entries = 0;
+    std::deque<LocalPath> pending{ root };
+
+    while (!pending.empty())
+    {
+        LocalPath path = pending.front();
+        pending.pop_front();
+
+        unique_ptr<DirAccess> da(fsaccess.newdiraccess());
+        if (!da->dopen(&path, nullptr, false))
+        {
+            continue;
+        }
+
+        LocalPath name;
+        nodetype_t type;
+        while (da->dnext(path, name, false, &type))
+        {
+            ScopedLengthRestore restore(path);
+            path.appendWithSeparator(name, false);
+
+            auto fa = fsaccess.newfileaccess(false);
+            if (fa->fopen(path, false, false, da.get()) && fa->type == FOLDERNODE)
+            {
+                pending.push_back(path);
+            }
+            entries++;
+        }
+    }
+    return entries;
+}
+
+uint64_t walkParallel(FileSystemAccess& fsaccess, const LocalPath& root, unsigned threads)
+{
+    ParallelDirScanner scanner(fsaccess, nullptr, threads, false);
+    scanner.start(root);
+
+    // consume as the sync would, so that the buffer limit is exercised
+    while (scanner.wait())
+    {
+        while (scanner.next()) { }
+    }
+    return scanner.stats().entries;
+}
+
+template<class F>
+void measure(const char* name, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    uint64_t entries = f();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    cout << name << ": " << entries << " entries in " << secs << " s ("
+         << uint64_t(secs > 0 ? double(entries) / secs : 0) << " entries/s)" << endl;
+}
+
+void usage()
+{
+    cout << "usage: tool_scanbench <folder> [options]\n"
+         << "  --create <entries>  first create a synthetic tree of that many entries (e.g. 1000000)\n"
+         << "  --threads <n>       threads of the parallel scanner (default: 4)\n"
+         << "\n"
+         << "For cold-cache numbers, drop the OS caches before each run\n"
+         << "(Linux: sync; echo 3 > /proc/sys/vm/drop_caches)." << endl;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        usage();
+        return 1;
+    }
+
+    uint64_t create = 0;
+    unsigned threads = 4;
+
+    for (int i = 2; i < argc; i++)
+    {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(argv[i], "--create") && value) create = strtoull(value, nullptr, 10), i++;
+        else if (!strcmp(argv[i], "--threads") && value) threads = unsigned(atoi(value)), i++;
+        else { usage(); return 1; }
+    }
+
+    FSACCESS_CLASS fsaccess;
+    LocalPath root = LocalPath::fromPath(argv[1], fsaccess);
+
+    if (create && !createTree(fsaccess, root, create))
+    {
+        return 1;
+    }
+
+    measure("sequential", [&]() { return walkSequential(fsaccess, root); });
+    measure("parallel, 1 thread", [&]() { return walkParallel(fsaccess, root, 1); });
+    measure(("parallel, " + std::to_string(threads) + " threads").c_str(), [&]() { return walkParallel(fsaccess, root, threads); });
+
+    return 0;
+}
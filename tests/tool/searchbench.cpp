@@ -0,0 +1,164 @@
+/**
+ * @file tests/tool/searchbench.cpp
+ * @brief Download throughput while searches run, synchronous and asynchronous
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "megaapi.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace mega;
+using std::cout;
+using std::endl;
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+enum Mode { NO_SEARCHES, SYNCHRONOUS, ASYNCHRONOUS };
+
+bool succeeded(SynchronousRequestListener& listener, const char* what)
+{
+    listener.wait();
+    if (listener.getError()->getErrorCode() != MegaError::API_OK)
+    {
+        cout << what << " failed: " << listener.getError()->getErrorString() << endl;
+        return false;
+    }
+    return true;
+}
+
+// downloaded bytes per second while `threads` search the whole account in a loop
+void measure(MegaApi& api, MegaNode& root, const char* what, Mode mode, const string& search, unsigned threads, double seconds)
+{
+    std::atomic<unsigned> searches(0);
+    std::atomic<bool> stop(false);
+    vector<std::thread> searchers;
+
+    for (unsigned t = 0; mode != NO_SEARCHES && t < threads; t++)
+    {
+        searchers.emplace_back([&]() {
+            while (!stop)
+            {
+                if (mode == SYNCHRONOUS)
+                {
+                    unique_ptr<MegaNodeList> results(api.search(&root, search.c_str(), nullptr, true, MegaApi::ORDER_DEFAULT_ASC));
+                }
+                else
+                {
+                    SynchronousRequestListener listener;
+                    api.searchAsync(&root, search.c_str(), nullptr, true, MegaApi::ORDER_DEFAULT_ASC, 1000, &listener);
+                    listener.wait();
+                }
+                searches++;
+            }
+        });
+    }
+
+    long long before = api.getTotalDownloadedBytes();
+    auto start = clock_type::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    long long downloaded = api.getTotalDownloadedBytes() - before;
+    double secs = std::chrono::duration<double>(clock_type::now() - start).count();
+
+    stop = true;
+    for (auto& t : searchers)
+    {
+        t.join();
+    }
+
+    cout << what << ": " << double(downloaded) / secs / 1024 / 1024 << " MB/s downloaded, "
+         << searches << " searches" << endl;
+}
+
+void usage()
+{
+    cout << "usage: tool_searchbench <folder> <apiurl> <session> [options]\n"
+         << "  --search <text>  searched in the names of the whole account (default: a)\n"
+         << "  --threads <n>    threads searching in a loop (default: 4)\n"
+         << "  --seconds <n>    duration of each round (default: 10)\n"
+         << "\n"
+         << "Downloads the whole account to <folder> while it searches, first without searches,\n"
+         << "then with MegaApi::search and then with MegaApi::searchAsync. The account should\n"
+         << "be big enough for the download to last the three rounds.\n"
+         << "Intended to be run against tool_mockserver, whose API URL and session it prints." << endl;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        usage();
+        return 1;
+    }
+
+    string search = "a";
+    unsigned threads = 4;
+    double seconds = 10;
+
+    for (int i = 4; i < argc; i++)
+    {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(argv[i], "--search") && value) search = value, i++;
+        else if (!strcmp(argv[i], "--threads") && value) threads = unsigned(std::max(1, atoi(value))), i++;
+        else if (!strcmp(argv[i], "--seconds") && value) seconds = std::max(1.0, atof(value)), i++;
+        else { usage(); return 1; }
+    }
+
+    MegaApi::setLogLevel(MegaApi::LOG_LEVEL_ERROR);
+    MegaApi api("searchbench", (const char*)nullptr, "searchbench");
+    api.changeApiUrl(argv[2], true);
+
+    SynchronousRequestListener login;
+    api.fastLogin(argv[3], &login);
+    if (!succeeded(login, "Login"))
+    {
+        return 1;
+    }
+
+    SynchronousRequestListener fetch;
+    api.fetchNodes(&fetch);
+    if (!succeeded(fetch, "Fetchnodes"))
+    {
+        return 1;
+    }
+
+    unique_ptr<MegaNode> root(api.getRootNode());
+
+    string target = argv[1];
+    if (target.back() != '/' && target.back() != '\\')
+    {
+        target.push_back('/');
+    }
+    api.startDownload(root.get(), target.c_str(), nullptr);
+
+    measure(api, *root, "Without searches", NO_SEARCHES, search, threads, seconds);
+    measure(api, *root, "MegaApi::search", SYNCHRONOUS, search, threads, seconds);
+    measure(api, *root, "MegaApi::searchAsync", ASYNCHRONOUS, search, threads, seconds);
+
+    api.cancelTransfers(MegaTransfer::TYPE_DOWNLOAD);
+    return 0;
+}
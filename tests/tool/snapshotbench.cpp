@@ -0,0 +1,134 @@
+/**
+ * @file tests/tool/snapshotbench.cpp
+ * @brief Time taken to export the node tree of a big account as a snapshot file
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "megaapi_impl.h"
+#include "benchutils.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace mega;
+using std::cout;
+using std::endl;
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+// with a fingerprint, which the snapshot includes
+Node* makeNode(MegaClient& client, handle h, handle parent, nodetype_t type, const string& name)
+{
+    Node* n = mt::makeNode(client, h, parent, type, name);
+    if (type == FILENODE)
+    {
+        n->mtime = 1600000000;
+        n->crc = {{ int32_t(h), 1, 2, 3 }};
+        n->isvalid = true;
+    }
+    return n;
+}
+
+void usage()
+{
+    cout << "usage: tool_snapshotbench <file> [options]\n"
+         << "  --nodes <n>    nodes of the synthetic account (default: 1000000)\n"
+         << "  --folder <n>   files in each folder (default: 1000)\n"
+         << "\n"
+         << "Writes the snapshot of MegaApi::exportNodeTree to <file> and compares it with\n"
+         << "copying every node as a MegaNode, as apps iterating the MegaApi getters do.\n"
+         << "Nothing is sent to the servers: the account is only built in memory, which takes\n"
+         << "around 1 GB per million nodes (so 10M nodes need a big machine)." << endl;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        usage();
+        return 1;
+    }
+
+    unsigned nodes = 1000000;
+    unsigned perFolder = 1000;
+
+    for (int i = 2; i < argc; i++)
+    {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(argv[i], "--nodes") && value) nodes = unsigned(std::max(1, atoi(value))), i++;
+        else if (!strcmp(argv[i], "--folder") && value) perFolder = unsigned(std::max(1, atoi(value))), i++;
+        else { usage(); return 1; }
+    }
+
+    SimpleLogger::setLogLevel(logError);
+
+    MegaApp app;
+    FSACCESS_CLASS fsaccess;
+    auto client = mt::makeClient(app, fsaccess, "snapshotbench");
+
+    Node* root = makeNode(*client, 1, UNDEF, ROOTNODE, "");
+    Node* folder = nullptr;
+    handle next = 2;
+    while (client->nodes.size() < nodes)
+    {
+        if (!folder || folder->children.size() == perFolder)
+        {
+            folder = makeNode(*client, next, root->nodehandle, FOLDERNODE, "folder " + std::to_string(next));
+        }
+        else
+        {
+            makeNode(*client, next, folder->nodehandle, FILENODE, "IMG_" + std::to_string(20200000 + next) + "_holidays.jpg");
+        }
+        next++;
+    }
+    cout << "Nodes: " << client->nodes.size() << endl;
+
+    auto start = clock_type::now();
+    uint64_t count = 0;
+    error e = NodeTreeSnapshot::write(*client, LocalPath::fromPath(argv[1], fsaccess), &count);
+    double secs = std::chrono::duration<double>(clock_type::now() - start).count();
+    if (e)
+    {
+        cout << "Snapshot failed: " << e << endl;
+        return 1;
+    }
+
+    auto fa = fsaccess.newfileaccess();
+    auto path = LocalPath::fromPath(argv[1], fsaccess);
+    m_off_t size = fa->fopen(path) ? fa->size : 0;
+    cout << "Snapshot: " << secs << " s, " << count << " nodes, " << size << " bytes, "
+         << double(count) / secs << " nodes/s" << endl;
+
+    start = clock_type::now();
+    m_off_t total = 0;
+    for (auto& it : client->nodes)
+    {
+        unique_ptr<MegaNode> node(MegaNodePrivate::fromNode(it.second));
+        total += node->getSize();
+    }
+    secs = std::chrono::duration<double>(clock_type::now() - start).count();
+    cout << "MegaNode copies: " << secs << " s (total size " << total << ")" << endl;
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file tests/tool/sortbench.cpp
+ * @brief Time taken to sort many nodes by name
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "megaapi_impl.h"
+#include "benchutils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace mega;
+using std::cout;
+using std::endl;
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+template<typename F>
+double seconds(F f)
+{
+    auto start = clock_type::now();
+    f();
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+void usage()
+{
+    cout << "usage: tool_sortbench [options]\n"
+         << "  --nodes <n>  nodes to sort (default: 100000 and then 1000000)\n"
+         << "\n"
+         << "Nothing is sent to the servers: the nodes are only built in memory." << endl;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    vector<unsigned> counts = { 100000, 1000000 };
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(argv[i], "--nodes") && value) counts = { unsigned(atoi(value)) }, i++;
+        else { usage(); return 1; }
+    }
+
+    SimpleLogger::setLogLevel(logError);
+
+    for (unsigned count : counts)
+    {
+        MegaApp app;
+        FSACCESS_CLASS fsaccess;
+        auto client = mt::makeClient(app, fsaccess, "sortbench");
+
+        // different names as in a camera folder, with some folders, in random order
+        Node* folder = mt::makeNode(*client, 1, UNDEF, FOLDERNODE, "folder");
+        for (unsigned i = 0; i < count; i++)
+        {
+            mt::makeNode(*client, handle(i + 2), folder->nodehandle, i % 20 ? FILENODE : FOLDERNODE,
+                     (i % 2 ? "IMG_" : "img ") + std::to_string(20200000 + i) + (i % 3 ? "_holidays.jpg" : " (" + std::to_string(i % 100) + ").JPG"));
+        }
+        node_vector nodes(folder->children.begin(), folder->children.end());
+        std::shuffle(nodes.begin(), nodes.end(), std::mt19937(1));
+
+        cout << "Nodes: " << nodes.size() << endl;
+
+        for (int order : { MegaApi::ORDER_DEFAULT_ASC, MegaApi::ORDER_DEFAULT_DESC })
+        {
+            const char* name = order == MegaApi::ORDER_DEFAULT_ASC ? "ORDER_DEFAULT_ASC" : "ORDER_DEFAULT_DESC";
+
+            node_vector compared = nodes;
+            double comparing = seconds([&]() {
+                std::sort(compared.begin(), compared.end(), MegaApiImpl::getComparatorFunction(order, *client));
+            });
+
+            node_vector keyed = nodes;
+            double keying = seconds([&]() {
+                MegaApiImpl::sortByComparatorFunction(keyed, order, *client);
+            });
+
+            cout << "  " << name << ": " << comparing << " s comparing the names, " << keying << " s with keys"
+                 << (compared == keyed ? "" : " (DIFFERENT ORDER)") << endl;
+        }
+    }
+
+    return 0;
+}
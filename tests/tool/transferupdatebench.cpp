@@ -0,0 +1,168 @@
+/**
+ * @file tests/tool/transferupdatebench.cpp
+ * @brief Download time and transfer callbacks with different update policies
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "megaapi.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace mega;
+using std::cout;
+using std::endl;
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+// counts the progress callbacks, spending some time in each like an app updating its UI
+struct ProgressListener : MegaListener
+{
+    std::chrono::microseconds work;
+    std::atomic<unsigned> updates{ 0 };
+    std::atomic<unsigned> batches{ 0 };
+    std::atomic<unsigned> batched{ 0 };
+
+    explicit ProgressListener(unsigned workUs) : work(workUs) {}
+
+    void onTransferUpdate(MegaApi*, MegaTransfer*) override
+    {
+        updates++;
+        std::this_thread::sleep_for(work);
+    }
+
+    void onTransfersUpdate(MegaApi*, MegaTransferList* transfers) override
+    {
+        batches++;
+        batched += unsigned(transfers->size());
+        std::this_thread::sleep_for(work);
+    }
+};
+
+bool succeeded(SynchronousRequestListener& listener, const char* what)
+{
+    listener.wait();
+    if (listener.getError()->getErrorCode() != MegaError::API_OK)
+    {
+        cout << what << " failed: " << listener.getError()->getErrorString() << endl;
+        return false;
+    }
+    return true;
+}
+
+void measure(MegaApi& api, MegaNode& root, const string& folder, const char* what,
+             int intervalMs, long long bytes, bool batched, unsigned workUs)
+{
+    {
+        FSACCESS_CLASS fsaccess;
+        LocalPath path = LocalPath::fromPath(folder, fsaccess);
+        fsaccess.mkdirlocal(path, false);
+    }
+
+    ProgressListener progress(workUs);
+    api.addListener(&progress);
+    api.setTransferUpdatePolicy(intervalMs, bytes, batched);
+
+    SynchronousTransferListener download;
+    auto start = clock_type::now();
+    api.startDownload(&root, (folder + '/').c_str(), &download);
+    download.wait();
+    double secs = std::chrono::duration<double>(clock_type::now() - start).count();
+
+    api.removeListener(&progress);
+    unique_ptr<char[]> stats(api.getTransferUpdateStats());
+
+    cout << what << ": " << (download.getError()->getErrorCode() == MegaError::API_OK ? "completed" : "failed")
+         << " in " << secs << " s, " << progress.updates << " onTransferUpdate, " << progress.batches
+         << " onTransfersUpdate with " << progress.batched << " transfers, stats " << stats.get() << endl;
+}
+
+void usage()
+{
+    cout << "usage: tool_transferupdatebench <folder> <apiurl> <session> [options]\n"
+         << "  --interval <ms>  minimum interval between progress updates of a transfer (default: 500)\n"
+         << "  --bytes <n>      minimum bytes between progress updates of a transfer (default: 0)\n"
+         << "  --work <us>      time spent by the app in each callback (default: 100)\n"
+         << "\n"
+         << "Downloads the whole account to a new subfolder of <folder> in each round, first\n"
+         << "reporting every progress update, then with MegaApi::setTransferUpdatePolicy and\n"
+         << "then with the updates batched too. An account with many small files shows the\n"
+         << "overhead of the callbacks best.\n"
+         << "Intended to be run against tool_mockserver, whose API URL and session it prints." << endl;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        usage();
+        return 1;
+    }
+
+    int interval = 500;
+    long long bytes = 0;
+    unsigned work = 100;
+
+    for (int i = 4; i < argc; i++)
+    {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(argv[i], "--interval") && value) interval = std::max(0, atoi(value)), i++;
+        else if (!strcmp(argv[i], "--bytes") && value) bytes = std::max(0LL, atoll(value)), i++;
+        else if (!strcmp(argv[i], "--work") && value) work = unsigned(std::max(0, atoi(value))), i++;
+        else { usage(); return 1; }
+    }
+
+    MegaApi::setLogLevel(MegaApi::LOG_LEVEL_ERROR);
+    MegaApi api("transferupdatebench", (const char*)nullptr, "transferupdatebench");
+    api.changeApiUrl(argv[2], true);
+
+    SynchronousRequestListener login;
+    api.fastLogin(argv[3], &login);
+    if (!succeeded(login, "Login"))
+    {
+        return 1;
+    }
+
+    SynchronousRequestListener fetch;
+    api.fetchNodes(&fetch);
+    if (!succeeded(fetch, "Fetchnodes"))
+    {
+        return 1;
+    }
+
+    unique_ptr<MegaNode> root(api.getRootNode());
+
+    string target = argv[1];
+    if (target.back() == '/' || target.back() == '\\')
+    {
+        target.pop_back();
+    }
+
+    measure(api, *root, target + "/every", "Every update", 0, 0, false, work);
+    measure(api, *root, target + "/throttled", "Throttled", interval, bytes, false, work);
+    measure(api, *root, target + "/batched", "Throttled and batched", interval, bytes, true, work);
+    return 0;
+}
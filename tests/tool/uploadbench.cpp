@@ -0,0 +1,170 @@
+/**
+ * @file tests/tool/uploadbench.cpp
+ * @brief End-to-end time of a folder upload of many small files
+ *
+ * (c) 2013-2021 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "megaapi.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace mega;
+using std::cout;
+using std::endl;
+
+namespace {
+
+LocalPath child(const LocalPath& parent, const string& name, FileSystemAccess& fsaccess)
+{
+    LocalPath p = parent;
+    p.appendWithSeparator(LocalPath::fromPath(name, fsaccess), false);
+    return p;
+}
+
+// folder N in folder (N - 1) / fanout, so that the tree is log(folders) deep,
+// with `perFolder` small files of different content in each
+bool createTree(FileSystemAccess& fsaccess, const LocalPath& root, unsigned files, unsigned perFolder, unsigned fanout)
+{
+    LocalPath rootPath = root;
+    fsaccess.mkdirlocal(rootPath, false);
+
+    vector<LocalPath> folders;
+    for (unsigned i = 0; i < files; i++)
+    {
+        if (!(i % perFolder))
+        {
+            size_t n = folders.size();
+            folders.push_back(child(n ? folders[(n - 1) / fanout] : root, "d" + std::to_string(n), fsaccess));
+            fsaccess.mkdirlocal(folders.back(), false);
+        }
+
+        LocalPath file = child(folders.back(), std::to_string(i) + ".txt", fsaccess);
+        string content = "file " + std::to_string(i) + "\n";
+
+        auto fa = fsaccess.newfileaccess(false);
+        if (!fa->fopen(file, false, true) || !fa->fwrite(reinterpret_cast<const byte*>(content.data()), unsigned(content.size()), 0))
+        {
+            cout << "Unable to create " << file.toPath(fsaccess) << endl;
+            return false;
+        }
+
+        if (!((i + 1) % 1000))
+        {
+            cout << "\rCreated " << i + 1 << " files" << std::flush;
+        }
+    }
+
+    cout << "\rCreated " << files << " files in " << folders.size() << " folders" << endl;
+    return true;
+}
+
+bool succeeded(SynchronousRequestListener& listener, const char* what)
+{
+    listener.wait();
+    if (listener.getError()->getErrorCode() != MegaError::API_OK)
+    {
+        cout << what << " failed: " << listener.getError()->getErrorString() << endl;
+        return false;
+    }
+    return true;
+}
+
+void usage()
+{
+    cout << "usage: tool_uploadbench <folder> <apiurl> <session> [options]\n"
+         << "  --create <files>  first create a synthetic tree of that many files (e.g. 100000)\n"
+         << "  --perfolder <n>   files per folder of the synthetic tree (default: 100)\n"
+         << "  --fanout <n>      subfolders per folder of the synthetic tree (default: 2)\n"
+         << "\n"
+         << "Intended to be run against tool_mockserver, whose API URL and session it prints\n"
+         << "(its --latency option shows the effect of the number of requests)." << endl;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        usage();
+        return 1;
+    }
+
+    unsigned create = 0;
+    unsigned perFolder = 100;
+    unsigned fanout = 2;
+
+    for (int i = 4; i < argc; i++)
+    {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(argv[i], "--create") && value) create = unsigned(atoi(value)), i++;
+        else if (!strcmp(argv[i], "--perfolder") && value) perFolder = unsigned(std::max(1, atoi(value))), i++;
+        else if (!strcmp(argv[i], "--fanout") && value) fanout = unsigned(std::max(1, atoi(value))), i++;
+        else { usage(); return 1; }
+    }
+
+    {
+        FSACCESS_CLASS fsaccess;
+        if (create && !createTree(fsaccess, LocalPath::fromPath(argv[1], fsaccess), create, perFolder, fanout))
+        {
+            return 1;
+        }
+    }
+
+    MegaApi::setLogLevel(MegaApi::LOG_LEVEL_ERROR);
+    MegaApi api("uploadbench", (const char*)nullptr, "uploadbench");
+    api.changeApiUrl(argv[2], true);
+
+    SynchronousRequestListener login;
+    api.fastLogin(argv[3], &login);
+    if (!succeeded(login, "Login"))
+    {
+        return 1;
+    }
+
+    SynchronousRequestListener fetch;
+    api.fetchNodes(&fetch);
+    if (!succeeded(fetch, "Fetchnodes"))
+    {
+        return 1;
+    }
+
+    unique_ptr<MegaNode> root(api.getRootNode());
+    SynchronousTransferListener upload;
+
+    auto start = std::chrono::steady_clock::now();
+    api.startUpload(argv[1], root.get(), &upload);
+    upload.wait();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    cout << "Upload " << (upload.getError()->getErrorCode() == MegaError::API_OK ? "completed" : "failed")
+         << " in " << secs << " s" << endl;
+
+    // (a folder transfer has no node handle of its own)
+    unique_ptr<MegaNode> uploaded(api.getChildNode(root.get(), upload.getTransfer()->getFileName()));
+    if (uploaded)
+    {
+        cout << "Uploaded: " << api.getNumChildFiles(uploaded.get()) << " files at the top, "
+             << api.getSize(uploaded.get()) << " bytes in total" << endl;
+    }
+
+    return 0;
+}
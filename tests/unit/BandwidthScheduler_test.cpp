@@ -0,0 +1,180 @@
+/**
+ * (c) 2021 by Mega Limited, Wellsford, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mega/bandwidthscheduler.h>
+
+using namespace mega;
+
+namespace {
+
+// simulate `seconds` of greedy requests of `reqsize` bytes from each flow (at most 100 per flow per ds),
+// returns bytes admitted per flow
+std::vector<m_off_t> simulate(BandwidthScheduler& s, direction_t d, std::vector<BandwidthFlow*> flows, m_off_t reqsize, int seconds)
+{
+    std::vector<m_off_t> sent(flows.size(), 0);
+    for (dstime now = 1; now <= dstime(seconds * 10); ++now)
+    {
+        for (size_t i = 0; i < flows.size(); ++i)
+        {
+            for (int n = 100; n-- && s.admit(d, *flows[i], reqsize, now); )
+            {
+                sent[i] += reqsize;
+            }
+        }
+    }
+    return sent;
+}
+
+}
+
+TEST(BandwidthScheduler, unlimitedAdmitsEverything)
+{
+    BandwidthScheduler s;
+    BandwidthFlow f;
+    s.activate(GET, f);
+
+    EXPECT_FALSE(s.limited(GET));
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(s.admit(GET, f, 16 * 1024 * 1024, 1));
+    }
+    EXPECT_EQ(s.requestsizelimit(GET, f), 0);
+}
+
+TEST(BandwidthScheduler, classCeilingIsHonoured)
+{
+    BandwidthScheduler s;
+    s.setclasslimits(PUT, TRANSFERCLASS_BACKUP, 0, 100000);
+
+    BandwidthFlow backup;
+    backup.bwclass = TRANSFERCLASS_BACKUP;
+    BandwidthFlow interactive;
+    s.activate(PUT, backup);
+    s.activate(PUT, interactive);
+
+    auto sent = simulate(s, PUT, { &backup, &interactive }, 10000, 60);
+
+    // within one burst + one request of the configured rate
+    EXPECT_LE(sent[0], 100000 * 61 + 10000);
+    EXPECT_GE(sent[0], 100000 * 59);
+
+    // other classes are not affected
+    EXPECT_GT(sent[1], sent[0] * 10);
+}
+
+TEST(BandwidthScheduler, weightsWithinClass)
+{
+    BandwidthScheduler s;
+    s.setclasslimits(GET, TRANSFERCLASS_SYNC, 0, 300000);
+
+    BandwidthFlow a, b;
+    a.bwclass = b.bwclass = TRANSFERCLASS_SYNC;
+    b.weight = 2;
+    s.activate(GET, a);
+    s.activate(GET, b);
+
+    auto sent = simulate(s, GET, { &a, &b }, 5000, 100);
+
+    EXPECT_NEAR(double(sent[1]) / double(sent[0]), 2.0, 0.1);
+    EXPECT_LE(sent[0] + sent[1], 300000 * 101 + 10000);
+}
+
+TEST(BandwidthScheduler, priorityAndGuaranteeUnderTotalLimit)
+{
+    BandwidthScheduler s;
+    s.settotallimit(PUT, 1000000);
+    s.setclasslimits(PUT, TRANSFERCLASS_BACKUP, 100000, 0);
+
+    BandwidthFlow interactive, backup;
+    backup.bwclass = TRANSFERCLASS_BACKUP;
+    s.activate(PUT, interactive);
+    s.activate(PUT, backup);
+
+    auto sent = simulate(s, PUT, { &interactive, &backup }, 10000, 60);
+
+    // interactive gets most of the total, backup keeps its guaranteed minimum
+    EXPECT_GE(sent[0], 800000 * 60);
+    EXPECT_GE(sent[1], 95000 * 60);
+    EXPECT_LE(sent[0] + sent[1], 1100000 * 61);
+}
+
+TEST(BandwidthScheduler, reclassifyAtRuntime)
+{
+    BandwidthScheduler s;
+    s.setclasslimits(GET, TRANSFERCLASS_BACKUP, 0, 50000);
+
+    BandwidthFlow f;
+    f.bwclass = TRANSFERCLASS_BACKUP;
+    s.activate(GET, f);
+
+    auto limited = simulate(s, GET, { &f }, 10000, 10);
+    EXPECT_LE(limited[0], 50000 * 11 + 10000);
+
+    s.reclassify(GET, f, TRANSFERCLASS_INTERACTIVE, 3);
+    EXPECT_EQ(f.bwclass, TRANSFERCLASS_INTERACTIVE);
+    EXPECT_EQ(f.weight, 3u);
+    EXPECT_TRUE(f.active);
+    EXPECT_TRUE(s.admit(GET, f, 10000000, 200));
+    EXPECT_TRUE(s.admit(GET, f, 10000000, 200));
+
+    s.deactivate(GET, f);
+    EXPECT_FALSE(f.active);
+}
+
+TEST(BandwidthScheduler, retryHintAndRequestSize)
+{
+    BandwidthScheduler s;
+    s.setclasslimits(GET, TRANSFERCLASS_INTERACTIVE, 0, 100000);
+
+    BandwidthFlow f;
+    s.activate(GET, f);
+
+    EXPECT_EQ(s.requestsizelimit(GET, f), 200000);
+
+    EXPECT_TRUE(s.admit(GET, f, 1000000, 1));
+    EXPECT_FALSE(s.admit(GET, f, 1000000, 1));
+    EXPECT_EQ(s.retryin(GET, f), BandwidthScheduler::MAX_WAIT_DS);
+}
+
+TEST(BandwidthScheduler, streamsUseUpTheTotal)
+{
+    BandwidthScheduler s;
+    s.settotallimit(GET, 1000000);
+
+    BandwidthFlow stream, sync;
+    stream.bwclass = TRANSFERCLASS_STREAMING;
+    sync.bwclass = TRANSFERCLASS_SYNC;
+    s.activate(GET, stream);
+    s.activate(GET, sync);
+
+    // the stream can't be held back, the sync transfer gets what it leaves
+    m_off_t sent = 0;
+    for (dstime now = 1; now <= 600; ++now)
+    {
+        s.consume(GET, stream, 60000, now);
+        for (int n = 100; n-- && s.admit(GET, sync, 10000, now); )
+        {
+            sent += 10000;
+        }
+    }
+
+    EXPECT_GE(sent, 350000 * 60);
+    EXPECT_LE(sent, 450000 * 60);
+}
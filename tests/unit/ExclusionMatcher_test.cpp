@@ -0,0 +1,107 @@
+/**
+ * (c) 2021 by Mega Limited, Wellsford, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mega/exclusionmatcher.h>
+#include "mega.h"
+
+using namespace mega;
+
+namespace {
+
+class Matcher
+{
+public:
+    Matcher(const std::vector<std::string>& names, const std::vector<std::string>& paths)
+        : root(LocalPath::fromPath("/sync", fsaccess))
+    {
+        matcher.set(names, paths, fsaccess);
+    }
+
+    bool excluded(const std::string& path)
+    {
+        return matcher.excluded(root, LocalPath::fromPath(path, fsaccess), fsaccess);
+    }
+
+    FSACCESS_CLASS fsaccess;
+    LocalPath root;
+    ExclusionMatcher matcher;
+};
+
+} // anonymous
+
+TEST(ExclusionMatcher, wildcardMatch)
+{
+    ASSERT_TRUE(wildcardMatch("file.tmp", "*.tmp"));
+    ASSERT_TRUE(wildcardMatch("file.tmp", "f?le.*"));
+    ASSERT_TRUE(wildcardMatch("abcabc", "*bc*c"));
+    ASSERT_FALSE(wildcardMatch("file.txt", "*.tmp"));
+    ASSERT_FALSE(wildcardMatch("file", "file?"));
+}
+
+TEST(ExclusionMatcher, names)
+{
+    Matcher m({ "Thumbs.db", ".*", "*~", "~$*.doc?", "*.tmp" }, {});
+
+    ASSERT_TRUE(m.excluded("/sync/a/Thumbs.db"));
+    ASSERT_FALSE(m.excluded("/sync/a/thumbs.db.bak"));
+    ASSERT_TRUE(m.excluded("/sync/.git/config"));   // any component
+    ASSERT_TRUE(m.excluded("/sync/a/notes~"));
+    ASSERT_TRUE(m.excluded("/sync/~$report.docx"));
+    ASSERT_FALSE(m.excluded("/sync/~$report.pdf"));
+    ASSERT_TRUE(m.excluded("/sync/a.tmp"));
+    ASSERT_FALSE(m.excluded("/sync/a.tmpx"));
+    ASSERT_FALSE(m.excluded("/sync/a/b/c"));
+
+    // only the components below the root
+    ASSERT_FALSE(m.excluded("/sync"));
+    ASSERT_FALSE(m.excluded("/other/.hidden"));
+}
+
+TEST(ExclusionMatcher, nonAsciiNames)
+{
+    Matcher m({ "caf\xc3\xa9*" }, {});
+
+    ASSERT_TRUE(m.excluded("/sync/caf\xc3\xa9s"));
+    ASSERT_FALSE(m.excluded("/sync/cafe"));
+}
+
+TEST(ExclusionMatcher, paths)
+{
+    Matcher m({}, { "/sync/a", "/sync/b/", "/sync/c/*.log" });
+
+    ASSERT_TRUE(m.excluded("/sync/a"));
+    ASSERT_TRUE(m.excluded("/sync/a/x/y"));
+    ASSERT_FALSE(m.excluded("/sync/ab"));           // a sibling, not below
+    ASSERT_FALSE(m.excluded("/sync"));
+    ASSERT_TRUE(m.excluded("/sync/b/x"));           // with a trailing separator
+    ASSERT_FALSE(m.excluded("/sync/b"));
+    ASSERT_FALSE(m.excluded("/sync/bc"));
+    ASSERT_TRUE(m.excluded("/sync/c/x.log"));
+    ASSERT_FALSE(m.excluded("/sync/c/x.txt"));
+}
+
+TEST(ExclusionMatcher, clear)
+{
+    Matcher m({ "*" }, { "/sync" });
+    ASSERT_TRUE(m.excluded("/sync/a"));
+
+    m.matcher.clear();
+    ASSERT_FALSE(m.excluded("/sync/a"));
+}
@@ -0,0 +1,81 @@
+/**
+ * (c) 2021 by Mega Limited, Wellsford, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mega/json.h>
+
+using namespace mega;
+
+namespace {
+
+const std::string response = "{\"w\":\"https://x/y\",\"a\":[{\"a\":\"u\",\"n\":\"h1\"},{\"a\":\"d\",\"n\":\"]}\\\"\"}],\"sn\":\"abc\"}";
+
+} // anonymous
+
+TEST(JSONStreamScanner, nothingSafeUntilFirstMemberIsComplete)
+{
+    JSONStreamScanner s;
+    ASSERT_EQ(s.scan(response.data(), 10), 0u);
+}
+
+TEST(JSONStreamScanner, safeAfterMembersAndPackets)
+{
+    JSONStreamScanner s;
+
+    // after "w" and before "a"
+    size_t comma = response.find(",\"a\"");
+    ASSERT_EQ(s.scan(response.data(), comma + 3), comma);
+
+    // after the first packet
+    size_t first = response.find("},{") + 1;
+    ASSERT_EQ(s.scan(response.data(), first + 2), first);
+
+    // the second packet has brackets and an escaped quote in a string
+    size_t second = response.find("}],") + 1;
+    ASSERT_EQ(s.scan(response.data(), second - 1), first);
+    ASSERT_EQ(s.scan(response.data(), second + 1), second);
+
+    // "sn" is only known to be complete when the response is
+    ASSERT_EQ(s.scan(response.data(), response.size()), response.find(",\"sn\""));
+}
+
+TEST(JSONStreamScanner, consumeKeepsOffsetsRelative)
+{
+    JSONStreamScanner s;
+
+    size_t first = response.find("},{") + 1;
+    ASSERT_EQ(s.scan(response.data(), first + 1), first);
+
+    s.consume(first);
+
+    std::string rest = response.substr(first);
+    size_t second = rest.find("}],") + 1;
+    ASSERT_EQ(s.scan(rest.data(), rest.size()), rest.find(",\"sn\""));
+    ASSERT_GT(rest.find(",\"sn\""), second);
+}
+
+TEST(JSONStreamScanner, reset)
+{
+    JSONStreamScanner s;
+    s.scan(response.data(), response.size() / 2);
+    s.reset();
+
+    size_t comma = response.find(",\"a\"");
+    ASSERT_EQ(s.scan(response.data(), comma + 1), comma);
+}
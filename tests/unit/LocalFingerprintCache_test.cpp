@@ -0,0 +1,259 @@
+/**
+ * (c) 2021 by Mega Limited, Wellsford, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mega/fingerprintcache.h>
+#include <mega/db.h>
+
+#include "DefaultedDbTable.h"
+#include "DefaultedFileAccess.h"
+
+using namespace mega;
+
+namespace {
+
+class MockFileAccess : public mt::DefaultedFileAccess
+{
+public:
+    MockFileAccess(handle fsid, m_time_t mtime, std::string content, m_time_t ctime = 0)
+    : mContent{std::move(content)}
+    {
+        this->fsid = fsid;
+        this->fsidvalid = fsid != UNDEF;
+        this->type = FILENODE;
+        this->size = m_off_t(mContent.size());
+        this->mtime = mtime;
+        this->ctime = ctime;
+    }
+
+    bool sysstat(m_time_t* curr_mtime, m_off_t* curr_size) override
+    {
+        *curr_mtime = mtime;
+        *curr_size = size;
+        return true;
+    }
+
+    bool sysopen(bool) override
+    {
+        return true;
+    }
+
+    bool sysread(byte* buffer, unsigned size, m_off_t offset) override
+    {
+        reads++;
+        memcpy(buffer, mContent.data() + offset, size);
+        return true;
+    }
+
+    void sysclose() override
+    {}
+
+    unsigned reads = 0;
+
+private:
+    const std::string mContent;
+};
+
+class MockDbTable : public mt::DefaultedDbTable
+{
+public:
+    MockDbTable(PrnGen& rng)
+        : mt::DefaultedDbTable(rng, false)
+    {}
+
+    void rewind() override
+    {
+        mIt = mRecords.begin();
+    }
+    bool next(uint32_t* id, std::string* data) override
+    {
+        if (mIt == mRecords.end())
+        {
+            return false;
+        }
+        *id = mIt->first;
+        *data = mIt->second;
+        ++mIt;
+        return true;
+    }
+    bool put(uint32_t id, char* data, unsigned size) override
+    {
+        mRecords[id].assign(data, size);
+        return true;
+    }
+    bool del(uint32_t id) override
+    {
+        return mRecords.erase(id) > 0;
+    }
+    void begin() override
+    {}
+    void commit() override
+    {}
+    bool inTransaction() const override
+    {
+        return false;
+    }
+
+    std::map<uint32_t, std::string> mRecords;
+
+private:
+    std::map<uint32_t, std::string>::iterator mIt;
+};
+
+} // anonymous
+
+TEST(LocalFingerprintCache, cachedFingerprintsAreNotRead)
+{
+    LocalFingerprintCache cache;
+
+    MockFileAccess first(1, 100, std::string(1000, 'a'));
+    FileFingerprint fp;
+    ASSERT_TRUE(cache.genfingerprint(fp, &first));
+    ASSERT_GT(first.reads, 0u);
+
+    // same fsid, size and mtime: the cached crc, even if the content differs
+    MockFileAccess second(1, 100, std::string(1000, 'b'));
+    FileFingerprint cached;
+    ASSERT_TRUE(cache.genfingerprint(cached, &second));
+    ASSERT_EQ(second.reads, 0u);
+    ASSERT_EQ(cached, fp);
+    ASSERT_TRUE(cached.isvalid);
+
+    // unchanged, as for FileFingerprint::genfingerprint()
+    ASSERT_FALSE(cache.genfingerprint(cached, &second));
+
+    LocalFingerprintCache::Stats stats = cache.stats();
+    ASSERT_EQ(stats.hits, 2u);
+    ASSERT_EQ(stats.misses, 1u);
+    ASSERT_EQ(stats.entries, 1u);
+}
+
+TEST(LocalFingerprintCache, changedFilesAreRead)
+{
+    LocalFingerprintCache cache;
+    FileFingerprint fp;
+
+    MockFileAccess original(1, 100, std::string(1000, 'a'));
+    cache.genfingerprint(fp, &original);
+
+    MockFileAccess touched(1, 101, std::string(1000, 'a'));
+    ASSERT_TRUE(cache.genfingerprint(fp, &touched));
+    ASSERT_GT(touched.reads, 0u);
+    ASSERT_EQ(fp.mtime, 101);
+
+    MockFileAccess resized(1, 101, std::string(999, 'a'));
+    ASSERT_TRUE(cache.genfingerprint(fp, &resized));
+    ASSERT_GT(resized.reads, 0u);
+
+    // a later file that reused the fsid, with the same size and mtime
+    MockFileAccess recreated(1, 101, std::string(999, 'b'), 1);
+    ASSERT_TRUE(cache.genfingerprint(fp, &recreated));
+    ASSERT_GT(recreated.reads, 0u);
+
+    // and without fsid, always
+    MockFileAccess nofsid(UNDEF, 101, std::string(999, 'a'));
+    ASSERT_FALSE(cache.genfingerprint(fp, &nofsid));
+    ASSERT_GT(nofsid.reads, 0u);
+
+    ASSERT_EQ(cache.stats().hits, 0u);
+    ASSERT_EQ(cache.stats().entries, 1u);
+}
+
+TEST(LocalFingerprintCache, savedAndLoaded)
+{
+    PrnGen rng;
+    SymmCipher key;
+    byte keydata[SymmCipher::KEYLENGTH] = { 1, 2, 3 };
+    key.setkey(keydata);
+
+    MockDbTable table(rng);
+    FileFingerprint fp;
+
+    {
+        LocalFingerprintCache cache;
+        MockFileAccess fa1(1, 100, std::string(1000, 'a'));
+        MockFileAccess fa2(2, 100, std::string(2000, 'b'));
+        cache.genfingerprint(fp, &fa1);
+        cache.genfingerprint(fp, &fa2);
+        cache.save(table, key);
+        ASSERT_EQ(table.mRecords.size(), 2u);
+
+        // only the updated record is written again, in its row
+        MockFileAccess touched(2, 101, std::string(2000, 'b'));
+        cache.genfingerprint(fp, &touched);
+        cache.save(table, key);
+        ASSERT_EQ(table.mRecords.size(), 2u);
+    }
+
+    LocalFingerprintCache cache;
+    cache.load(table, key);
+    ASSERT_EQ(cache.stats().entries, 2u);
+
+    MockFileAccess fa(2, 101, std::string(2000, 'c'));
+    FileFingerprint loaded;
+    cache.genfingerprint(loaded, &fa);
+    ASSERT_EQ(fa.reads, 0u);
+    ASSERT_EQ(loaded, fp);
+}
+
+TEST(LocalFingerprintCache, removedRecords)
+{
+    PrnGen rng;
+    SymmCipher key;
+    byte keydata[SymmCipher::KEYLENGTH] = { 1, 2, 3 };
+    key.setkey(keydata);
+
+    MockDbTable table(rng);
+    FileFingerprint fp;
+
+    {
+        LocalFingerprintCache cache;
+        for (handle fsid = 1; fsid <= 3; fsid++)
+        {
+            MockFileAccess fa(fsid, 100, std::string(1000, 'a'));
+            cache.genfingerprint(fp, &fa);
+        }
+        cache.save(table, key);
+        ASSERT_EQ(table.mRecords.size(), 3u);
+
+        // a deleted file: its fsid may come back with other contents
+        cache.remove(1);
+        MockFileAccess reused(1, 100, std::string(1000, 'b'));
+        FileFingerprint other;
+        cache.genfingerprint(other, &reused);
+        ASSERT_GT(reused.reads, 0u);
+        ASSERT_FALSE(other == fp);
+
+        cache.remove(1);
+        cache.save(table, key);
+        ASSERT_EQ(table.mRecords.size(), 2u);
+    }
+
+    // the records of files deleted while the sync was disabled are kept, their fsids
+    // being told apart by ctime if reused
+    LocalFingerprintCache cache;
+    cache.load(table, key);
+    ASSERT_EQ(cache.stats().entries, 2u);
+
+    MockFileAccess reused(3, 100, std::string(1000, 'b'), 1);
+    FileFingerprint other;
+    cache.genfingerprint(other, &reused);
+    ASSERT_GT(reused.reads, 0u);
+    ASSERT_FALSE(other == fp);
+}
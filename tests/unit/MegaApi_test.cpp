@@ -17,6 +17,7 @@
  */
 
 #include <atomic>
+#include <fstream>
 #include <memory>
 #include <thread>
 
@@ -26,6 +27,8 @@
 #include <megaapi.h>
 #include <megaapi_impl.h>
 
+#include "utils.h"
+
 using namespace std;
 using namespace mega;
 
@@ -43,8 +46,65 @@ unique_ptr<MegaStringList> createMegaStringList(const vector<const char*>& data)
     return unique_ptr<MegaStringList>(new MegaStringListPrivate(std::move(list)));
 }
 
+// a folder of its own in the temp dir, removed with its content at the end of the test
+class TempFolder
+{
+public:
+    TempFolder(FSACCESS_CLASS& fsaccess, const string& name)
+        : fsaccess(fsaccess)
+    {
+#ifdef _WIN32
+        const char* tmp = getenv("TEMP");
+#else
+        const char* tmp = getenv("TMPDIR");
+#endif
+        path = LocalPath::fromPath(tmp && *tmp ? tmp : "/tmp", fsaccess);
+        path.appendWithSeparator(LocalPath::fromPath(name, fsaccess), false);
+
+        fsaccess.emptydirlocal(path);
+        fsaccess.rmdirlocal(path);
+        fsaccess.mkdirlocal(path, false);
+    }
+
+    ~TempFolder()
+    {
+        fsaccess.emptydirlocal(path);
+        fsaccess.rmdirlocal(path);
+    }
+
+    LocalPath file(const string& name) const
+    {
+        LocalPath p = path;
+        p.appendWithSeparator(LocalPath::fromPath(name, fsaccess), false);
+        return p;
+    }
+
+    FSACCESS_CLASS& fsaccess;
+    LocalPath path;
+};
+
 } // anonymous
 
+// a client without network, for the tests of the classes that work on its nodes
+class MegaApiClientTest
+  : public ::testing::Test
+{
+public:
+    MegaApiClientTest()
+      : client(mt::makeClient(app, fsaccess))
+    {
+    }
+
+    Node& makeNode(nodetype_t type, handle h, Node* parent = nullptr)
+    {
+        return mt::makeNode(*client, type, h, parent);
+    }
+
+    MegaApp app;
+    FSACCESS_CLASS fsaccess;
+    shared_ptr<MegaClient> client;
+}; // MegaApiClientTest
+
 TEST(MegaApi, MegaStringList_get_and_size_happyPath)
 {
     const vector<const char*> data{
@@ -192,6 +252,412 @@ TEST(MegaApi, MegaStringTable_copy_emptyStringTable)
     ASSERT_EQ(nullptr, copiedStringTable->get(0));
 }
 
+TEST_F(MegaApiClientTest, MegaNodeInfoList_get_happyPath)
+{
+    Node& folder = makeNode(FOLDERNODE, 1);
+    Node& file = makeNode(FILENODE, 2, &folder);
+    file.attrs.map['n'] = "foo.jpg";
+    file.attrs.map[AttrMap::string2nameid("fav")] = "1";
+    file.attrs.map[AttrMap::string2nameid("lbl")] = "4";
+    file.size = 1000;
+    file.mtime = 1600000000;
+    file.fileattrstring = "1:0*AAAAAAAAAAA";
+    Node& subfolder = makeNode(FOLDERNODE, 3, &folder);
+    subfolder.attrs.map['n'] = "bar";
+
+    Node* nodes[] = { &file, &subfolder };
+    MegaNodeInfoListPrivate list(nodes, 2);
+    auto copiedList = unique_ptr<MegaNodeInfoList>{list.copy()};
+
+    ASSERT_EQ(2, copiedList->size());
+    ASSERT_EQ(MegaHandle(2), copiedList->getHandle(0));
+    ASSERT_EQ(MegaHandle(1), copiedList->getParentHandle(0));
+    ASSERT_EQ(MegaNode::TYPE_FILE, copiedList->getType(0));
+    ASSERT_EQ(string{"foo.jpg"}, string{copiedList->getName(0)});
+    ASSERT_EQ(1000, copiedList->getSize(0));
+    ASSERT_EQ(1600000000, copiedList->getModificationTime(0));
+    ASSERT_EQ(MegaNode::NODE_LBL_GREEN, copiedList->getLabel(0));
+    ASSERT_TRUE(copiedList->isFavourite(0));
+    ASSERT_TRUE(copiedList->hasThumbnail(0));
+    ASSERT_FALSE(copiedList->hasPreview(0));
+
+    ASSERT_EQ(MegaNode::TYPE_FOLDER, copiedList->getType(1));
+    ASSERT_EQ(string{"bar"}, string{copiedList->getName(1)});
+    ASSERT_EQ(MegaNode::NODE_LBL_UNKNOWN, copiedList->getLabel(1));
+    ASSERT_FALSE(copiedList->isFavourite(1));
+
+    ASSERT_EQ(INVALID_HANDLE, copiedList->getHandle(2));
+    ASSERT_EQ(nullptr, copiedList->getName(-1));
+}
+
+TEST_F(MegaApiClientTest, MegaNodeChangeList_onlyChangedFields)
+{
+    Node& folder = makeNode(FOLDERNODE, 1);
+    Node& file = makeNode(FILENODE, 2, &folder);
+    file.attrs.map['n'] = "foo.jpg";
+    file.size = 1000;
+    file.mtime = 1600000000;
+    file.changed.newnode = true;
+    Node& subfolder = makeNode(FOLDERNODE, 3, &folder);
+    subfolder.attrs.map['n'] = "bar";
+    subfolder.changed.parent = true;
+
+    Node* nodes[] = { &file, &subfolder };
+    MegaNodeChangeListPrivate withFields(nodes, 2, true, false);
+    auto copiedList = unique_ptr<MegaNodeChangeList>{withFields.copy()};
+
+    ASSERT_EQ(2, copiedList->size());
+    ASSERT_FALSE(copiedList->isLast());
+    ASSERT_EQ(MegaHandle(2), copiedList->getHandle(0));
+    ASSERT_EQ(MegaHandle(1), copiedList->getParentHandle(0));
+    ASSERT_EQ(MegaNode::CHANGE_TYPE_NEW, copiedList->getChanges(0));
+    ASSERT_EQ(MegaNode::TYPE_FILE, copiedList->getType(0));
+    ASSERT_EQ(string{"foo.jpg"}, string{copiedList->getName(0)});
+    ASSERT_EQ(1000, copiedList->getSize(0));
+    ASSERT_EQ(1600000000, copiedList->getModificationTime(0));
+
+    // moved: the new parent, but not the unchanged name
+    ASSERT_EQ(MegaHandle(3), copiedList->getHandle(1));
+    ASSERT_EQ(MegaHandle(1), copiedList->getParentHandle(1));
+    ASSERT_EQ(MegaNode::CHANGE_TYPE_PARENT, copiedList->getChanges(1));
+    ASSERT_EQ(nullptr, copiedList->getName(1));
+    ASSERT_EQ(-1, copiedList->getSize(1));
+
+    MegaNodeChangeListPrivate withoutFields(nodes, 2, false, true);
+    ASSERT_TRUE(withoutFields.isLast());
+    ASSERT_EQ(MegaNode::CHANGE_TYPE_NEW, withoutFields.getChanges(0));
+    ASSERT_EQ(nullptr, withoutFields.getName(0));
+    ASSERT_EQ(-1, withoutFields.getSize(0));
+
+    ASSERT_EQ(INVALID_HANDLE, withoutFields.getHandle(2));
+    ASSERT_EQ(0, withoutFields.getChanges(-1));
+}
+
+TEST(MegaApi, TransferBatch_sharedOrPerFileTargets)
+{
+    TransferBatch uploads;
+    uploads.localPaths = { "a", "b", "c" };
+    uploads.handles = { 7 };
+    ASSERT_EQ(3u, uploads.size());
+    ASSERT_EQ(string{"c"}, uploads.localPath(2));
+    ASSERT_EQ(handle(7), uploads.nodeHandle(2));
+
+    TransferBatch downloads;
+    downloads.handles = { 1, 2 };
+    downloads.localPaths = { "/tmp/" };
+    ASSERT_EQ(2u, downloads.size());
+    ASSERT_EQ(handle(2), downloads.nodeHandle(1));
+    ASSERT_EQ(string{"/tmp/"}, downloads.localPath(1));
+
+    // pushed at once, but queued in order like one by one
+    TransferQueue queue;
+    vector<MegaTransferPrivate*> transfers;
+    for (int i = 0; i < 3; i++)
+    {
+        transfers.push_back(new MegaTransferPrivate(MegaTransfer::TYPE_DOWNLOAD));
+    }
+    queue.push(transfers);
+    ASSERT_EQ(3, queue.getLastPushedTag());
+    for (auto transfer : transfers)
+    {
+        unique_ptr<MegaTransferPrivate> popped(queue.pop());
+        ASSERT_EQ(transfer, popped.get());
+    }
+    ASSERT_EQ(nullptr, queue.pop());
+}
+
+TEST_F(MegaApiClientTest, NodeTreeSnapshot_columnsAndNames)
+{
+    Node& root = makeNode(ROOTNODE, 1);
+    Node& file = makeNode(FILENODE, 3, &root);
+    file.attrs.map['n'] = "foo.jpg";
+    file.size = 1000;
+    file.mtime = 1600000000;
+    file.crc = {{ 1, 2, 3, 4 }};
+    file.isvalid = true;
+    Node& folder = makeNode(FOLDERNODE, 2, &root);
+    folder.attrs.map['n'] = "bar";
+
+    TempFolder tmp(fsaccess, "MegaApi_test_snapshot");
+    auto path = tmp.file("nodetree.snapshot");
+    uint64_t count = 0;
+    ASSERT_EQ(API_OK, NodeTreeSnapshot::write(*client, path, &count));
+    ASSERT_EQ(3u, count);
+
+    string data;
+    {
+        std::ifstream in(path.toPath(fsaccess).c_str(), std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    auto at = [&data](uint64_t offset) { return data.data() + offset; };
+    auto u64 = [&at](uint64_t offset) { uint64_t v; memcpy(&v, at(offset), sizeof v); return v; };
+    auto u32 = [&at](uint64_t offset) { uint32_t v; memcpy(&v, at(offset), sizeof v); return v; };
+
+    ASSERT_EQ(0, memcmp(at(0), NodeTreeSnapshot::MAGIC, 8));
+    ASSERT_EQ(1u, u32(8));
+    ASSERT_EQ(3u, u64(16));
+    ASSERT_EQ(u64(24), strlen("") + strlen("bar") + strlen("foo.jpg") + 3);
+
+    // in handle order, and the columns where the layout says, padded to 8 bytes
+    NodeTreeSnapshot::Layout layout(3);
+    ASSERT_EQ(NodeTreeSnapshot::HEADER_SIZE + 24u, layout.parents);
+    ASSERT_EQ(layout.flags + 8, layout.heap);
+    ASSERT_EQ(layout.heap + u64(24), data.size());
+
+    ASSERT_EQ(handle(1), u64(layout.handles));
+    ASSERT_EQ(handle(2), u64(layout.handles + 8));
+    ASSERT_EQ(handle(3), u64(layout.handles + 16));
+    ASSERT_EQ(UNDEF, u64(layout.parents));
+    ASSERT_EQ(handle(1), u64(layout.parents + 16));
+    ASSERT_EQ(1000u, u64(layout.sizes + 16));
+    ASSERT_EQ(1600000000u, u64(layout.mtimes + 16));
+    ASSERT_EQ(3u, u32(layout.crcs + 2 * 16 + 8));
+    ASSERT_EQ(FOLDERNODE, *at(layout.types + 1));
+    ASSERT_EQ(0x03, *at(layout.flags + 2));
+    ASSERT_EQ(0x02, *at(layout.flags + 1));
+
+    ASSERT_EQ(0u, u32(layout.nameLengths));
+    ASSERT_EQ(string{"bar"}, string{at(layout.heap + u64(layout.nameOffsets + 8))});
+    ASSERT_EQ(7u, u32(layout.nameLengths + 8));
+    ASSERT_EQ(string{"foo.jpg"}, string{at(layout.heap + u64(layout.nameOffsets + 16))});
+}
+
+TEST_F(MegaApiClientTest, MegaNodeReplica_followsUpdates)
+{
+    Node& folder = makeNode(FOLDERNODE, 1);
+    Node& subfolder = makeNode(FOLDERNODE, 2, &folder);
+    Node& file = makeNode(FILENODE, 3, &folder);
+    subfolder.attrs.map['n'] = "b";
+    file.attrs.map['n'] = "a";
+
+    MegaNodeReplica replica;
+    replica.rebuild(*client);
+
+    unique_ptr<MegaNodeList> children{replica.getChildren(1, MegaApi::ORDER_DEFAULT_ASC)};
+    ASSERT_EQ(2, children->size());
+    ASSERT_EQ(MegaHandle(2), children->get(0)->getHandle());    // folders first
+    ASSERT_EQ(MegaHandle(3), children->get(1)->getHandle());
+    ASSERT_EQ(1, replica.getNumChildren(1, MegaNode::TYPE_FILE));
+    ASSERT_EQ(nullptr, replica.getChildren(1, MegaApi::ORDER_SIZE_ASC));
+
+    // moved into the subfolder and renamed
+    file.setparent(&subfolder);
+    file.attrs.map['n'] = "c";
+    Node* changed[] = { &file };
+    replica.update(changed, 1);
+
+    ASSERT_EQ(1, replica.getNumChildren(1, MegaNode::TYPE_UNKNOWN));
+    unique_ptr<MegaNode> parent{replica.getParentNode(3)};
+    ASSERT_EQ(MegaHandle(2), parent->getHandle());
+    unique_ptr<MegaNode> node{replica.getNodeByHandle(3)};
+    ASSERT_EQ(string{"c"}, string{node->getName()});
+
+    file.changed.removed = true;
+    replica.update(changed, 1);
+    ASSERT_EQ(nullptr, replica.getNodeByHandle(3));
+    ASSERT_EQ(0, replica.getNumChildren(2, MegaNode::TYPE_UNKNOWN));
+
+    replica.clear();
+    ASSERT_EQ(nullptr, replica.getNodeByHandle(1));
+}
+
+TEST_F(MegaApiClientTest, MegaNodeReplica_updatesDontWaitForTraversals)
+{
+    Node& folder = makeNode(FOLDERNODE, 1);
+    Node& file = makeNode(FILENODE, 2, &folder);
+    file.attrs.map['n'] = "a";
+
+    MegaNodeReplica replica;
+    replica.rebuild(*client);
+
+    int visited = 0;
+    replica.forEachNode(1, true, [&](MegaNode& node)
+    {
+        visited++;
+
+        // a batch arriving during the traversal neither waits nor changes it
+        file.attrs.map['n'] = "b";
+        Node* changed[] = { &file };
+        std::thread sdk([&]() { replica.update(changed, 1); });
+        sdk.join();
+
+        EXPECT_FALSE(replica.current());
+        EXPECT_EQ(string{"a"}, string{node.getName()});
+        return true;
+    });
+    ASSERT_EQ(1, visited);
+
+    // applied once the traversal ended, without waiting for another batch
+    ASSERT_TRUE(replica.current());
+    unique_ptr<MegaNode> node{replica.getNodeByHandle(2)};
+    ASSERT_EQ(string{"b"}, string{node->getName()});
+}
+
+TEST_F(MegaApiClientTest, NodeQueryWorker_searchesInPages)
+{
+    Node& folder = makeNode(FOLDERNODE, 1);
+    Node& subfolder = makeNode(FOLDERNODE, 2, &folder);
+    subfolder.attrs.map['n'] = "sub";
+    for (handle h = 3; h < 8; h++)
+    {
+        Node& file = makeNode(FILENODE, h, h % 2 ? &folder : &subfolder);
+        file.attrs.map['n'] = "File" + std::to_string(10 - h);
+    }
+
+    MegaNodeReplica replica;
+    replica.rebuild(*client);
+
+    std::mutex mutex;
+    std::condition_variable notified;
+    NodeQueryWorker worker(replica, [&]() { notified.notify_all(); });
+
+    // the results until the last one
+    auto results = [&](NodeQueryWorker::Query query)
+    {
+        worker.push(std::move(query));
+
+        vector<NodeQueryWorker::Result> received;
+        std::unique_lock<std::mutex> g(mutex);
+        while (received.empty() || !received.back().finished)
+        {
+            NodeQueryWorker::Result result;
+            if (worker.pop(result))
+            {
+                received.push_back(std::move(result));
+            }
+            else
+            {
+                notified.wait_for(g, std::chrono::milliseconds(10));
+            }
+        }
+        return received;
+    };
+
+    NodeQueryWorker::Query query;
+    query.search = true;
+    query.node = 1;
+    query.name = "file";
+    query.order = MegaApi::ORDER_DEFAULT_ASC;
+    query.pageSize = 2;
+
+    auto received = results(query);
+    ASSERT_EQ(4u, received.size());     // 2 + 2 + 1, and the end
+    ASSERT_EQ(2, received[0].page->size());
+    ASSERT_EQ(string{"File3"}, string{received[0].page->get(0)->getName()});
+    ASSERT_EQ(string{"File7"}, string{received[2].page->get(0)->getName()});
+    ASSERT_EQ(5, received[0].total);
+    ASSERT_EQ(API_OK, received[3].e);
+    ASSERT_EQ(5, received[3].total);
+
+    // not recursive, and without sorting
+    query.recursive = false;
+    query.order = MegaApi::ORDER_NONE;
+    received = results(query);
+    ASSERT_EQ(3u, received.size());
+    ASSERT_EQ(3, received[2].delivered);
+
+    // the children, including folders
+    query.search = false;
+    query.name.clear();
+    received = results(query);
+    ASSERT_EQ(4, received.back().total);
+
+    unique_ptr<MegaCancelToken> cancelToken{MegaCancelToken::createInstance()};
+    cancelToken->cancel();
+    query.cancelToken = cancelToken.get();
+    received = results(query);
+    ASSERT_EQ(1u, received.size());
+    ASSERT_EQ(API_EINCOMPLETE, received[0].e);
+
+    query.cancelToken = nullptr;
+    query.node = 20;
+    received = results(query);
+    ASSERT_EQ(API_ENOENT, received.back().e);
+}
+
+TEST_F(MegaApiClientTest, SortedChildrenCache_pagesAndInvalidation)
+{
+    Node& folder = makeNode(FOLDERNODE, 1);
+    vector<Node*> files;
+    for (handle h = 2; h < 12; h++)
+    {
+        files.push_back(&makeNode(FILENODE, h, &folder));
+        files.back()->attrs.map['n'] = "file" + std::to_string(h);
+    }
+
+    SortedChildrenCache cache;
+    node_vector* children = &cache.get(*client, &folder, MegaApi::ORDER_DEFAULT_ASC);
+    ASSERT_EQ(10u, children->size());
+    ASSERT_EQ(string{"file2"}, string{(*children)[0]->displayname()});
+    ASSERT_EQ(string{"file10"}, string{(*children)[8]->displayname()});    // natural order
+
+    // the same list for the next page, and the page resumes where the previous one ended
+    ASSERT_EQ(children, &cache.get(*client, &folder, MegaApi::ORDER_DEFAULT_ASC));
+    string cursor = SortedChildrenCache::cursor(*children, 3);
+    ASSERT_EQ(3u, SortedChildrenCache::resume(*children, cursor.c_str()));
+
+    // unrelated changes keep the list
+    Node& other = makeNode(FILENODE, 20);
+    Node* changed[] = { &other };
+    cache.invalidate(changed, 1);
+    ASSERT_EQ(children, &cache.get(*client, &folder, MegaApi::ORDER_DEFAULT_ASC));
+
+    // after removing a child of the first page, the next one still starts after "file4"
+    changed[0] = files[0];
+    files[0]->changed.removed = true;
+    cache.invalidate(changed, 1);
+    files[0]->setparent(nullptr);
+    children = &cache.get(*client, &folder, MegaApi::ORDER_DEFAULT_ASC);
+    ASSERT_EQ(9u, children->size());
+    size_t position = SortedChildrenCache::resume(*children, cursor.c_str());
+    ASSERT_EQ(2u, position);
+    ASSERT_EQ(string{"file5"}, string{(*children)[position]->displayname()});
+
+    ASSERT_EQ(0u, SortedChildrenCache::resume(*children, "invalid"));
+}
+
+TEST(MegaApi, naturalsorting_key_ordersAsNaturalCompare)
+{
+    const vector<string> names = {
+        "", "a", "A", "b", "a1", "a01", "a2", "a10", "a1b", "a 1", "a_1", "1", "9", "10", "007", "1a",
+        "IMG_20200101.jpg", "img_20191231.JPG", "~file", "file (2)", "file (10)", "file.txt", "file",
+        "99999999999999999999999", "99999999999999999999998", "\xc3\xa9t\xc3\xa9", "\x01", "/", ":" };
+
+    for (const string& i : names)
+    {
+        for (const string& j : names)
+        {
+            int expected = naturalsorting_compare(i.c_str(), j.c_str());
+            int actual = naturalsorting_key(i.c_str()).compare(naturalsorting_key(j.c_str()));
+            ASSERT_EQ(expected < 0, actual < 0) << "'" << i << "' vs '" << j << "'";
+            ASSERT_EQ(expected > 0, actual > 0) << "'" << i << "' vs '" << j << "'";
+        }
+    }
+}
+
+TEST_F(MegaApiClientTest, sortByComparatorFunction_byNameAsComparators)
+{
+    Node& folder = makeNode(FOLDERNODE, 1);
+    node_vector children;
+    const char* names[] = { "b10", "B2", "a", "b2.txt", "10", "9", "c", "A1" };
+    for (handle h = 0; h < 8; h++)
+    {
+        children.push_back(&makeNode(h % 3 ? FILENODE : FOLDERNODE, h + 2, &folder));
+        children.back()->attrs.map['n'] = names[h];
+    }
+
+    for (int order : { MegaApi::ORDER_DEFAULT_ASC, MegaApi::ORDER_DEFAULT_DESC })
+    {
+        node_vector expected = children;
+        std::sort(expected.begin(), expected.end(), MegaApiImpl::getComparatorFunction(order, *client));
+
+        node_vector actual = children;
+        MegaApiImpl::sortByComparatorFunction(actual, order, *client);
+        ASSERT_EQ(expected, actual);
+    }
+}
+
 TEST(MegaApi, getMimeType)
 {
     vector<thread> threads;
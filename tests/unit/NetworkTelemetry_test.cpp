@@ -0,0 +1,116 @@
+/**
+ * (c) 2021 by Mega Limited, Wellsford, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mega/networktelemetry.h>
+
+using namespace mega;
+
+namespace {
+
+NetworkTiming timing(int64_t ttfb, bool newConnection = false, bool failed = false)
+{
+    NetworkTiming t;
+    t.newConnection = newConnection;
+    t.failed = failed;
+    if (newConnection)
+    {
+        t.dns = 100;
+        t.connect = 1000;
+        t.tls = 2000;
+    }
+    t.ttfb = ttfb;
+    t.total = ttfb + 10;
+    t.bytesIn = 10;
+    t.bytesOut = 5;
+    return t;
+}
+
+} // anonymous
+
+TEST(NetworkTelemetry, histogramPercentiles)
+{
+    LatencyHistogram h;
+    ASSERT_EQ(h.percentile(0.5), 0);
+
+    for (int i = 0; i < 90; i++) h.add(100);    // bucket [64, 128)
+    for (int i = 0; i < 10; i++) h.add(5000);   // bucket [4096, 8192)
+    h.add(-1);                                  // not available: ignored
+
+    ASSERT_EQ(h.count(), 100u);
+    ASSERT_EQ(h.max(), 5000);
+    ASSERT_EQ(h.mean(), (90 * 100 + 10 * 5000) / 100);
+    ASSERT_EQ(h.percentile(0.5), 127);
+    ASSERT_EQ(h.percentile(0.9), 127);
+    ASSERT_EQ(h.percentile(0.99), 5000);    // capped by the maximum
+
+    h.reset();
+    ASSERT_EQ(h.count(), 0u);
+}
+
+TEST(NetworkTelemetry, channelsAndHosts)
+{
+    NetworkTelemetry t;
+    t.record(NETCHANNEL_CS, "g.api.mega.co.nz", timing(50000, true));
+    t.record(NETCHANNEL_CS, "g.api.mega.co.nz", timing(40000));
+    t.record(NETCHANNEL_GET, "gfs270n001.userstorage.mega.co.nz", timing(30000, true, true));
+    NetworkTiming retried = timing(20000);
+    retried.retry = true;
+    t.record(NETCHANNEL_GET, "gfs270n001.userstorage.mega.co.nz", retried);
+
+    const NetworkStats& cs = t.channel(NETCHANNEL_CS);
+    ASSERT_EQ(cs.requests, 2u);
+    ASSERT_EQ(cs.newConnections, 1u);
+    ASSERT_EQ(cs.connect.count(), 1u);
+    ASSERT_EQ(cs.ttfb.count(), 2u);
+    ASSERT_EQ(cs.bytesIn, 20);
+
+    ASSERT_EQ(cs.retries, 0u);
+
+    const NetworkStats& get = t.channel(NETCHANNEL_GET);
+    ASSERT_EQ(get.failures, 1u);
+    ASSERT_EQ(get.retries, 1u);
+    ASSERT_EQ(get.ttfb.count(), 1u);    // no first byte for failed requests
+    ASSERT_EQ(get.total.count(), 2u);
+
+    ASSERT_EQ(t.hosts().size(), 2u);
+    ASSERT_EQ(t.hosts().at("g.api.mega.co.nz").requests, 2u);
+
+    std::string json = t.tojson();
+    ASSERT_NE(json.find("\"cs\":{\"requests\":2,"), std::string::npos);
+    ASSERT_NE(json.find("\"get\":{\"requests\":2,\"failures\":1,\"retries\":1,"), std::string::npos);
+    ASSERT_EQ(json.find("\"put\":{"), std::string::npos);
+
+    t.reset();
+    ASSERT_EQ(t.channel(NETCHANNEL_CS).requests, 0u);
+    ASSERT_TRUE(t.hosts().empty());
+}
+
+TEST(NetworkTelemetry, hostLimit)
+{
+    NetworkTelemetry t;
+    for (size_t i = 0; i < NetworkTelemetry::MAXHOSTS + 10; i++)
+    {
+        t.record(NETCHANNEL_PUT, "host" + std::to_string(i), timing(1000));
+    }
+
+    ASSERT_EQ(t.hosts().size(), NetworkTelemetry::MAXHOSTS + 1);
+    ASSERT_EQ(t.hosts().at("*").requests, 10u);
+    ASSERT_EQ(t.channel(NETCHANNEL_PUT).requests, NetworkTelemetry::MAXHOSTS + 10);
+}
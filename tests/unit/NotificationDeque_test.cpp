@@ -0,0 +1,126 @@
+/**
+ * (c) 2021 by Mega Limited, Wellsford, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mega/filesystem.h>
+
+using namespace mega;
+
+namespace {
+
+// only used as keys
+LocalNode* const folder = reinterpret_cast<LocalNode*>(0x1000);
+LocalNode* const other = reinterpret_cast<LocalNode*>(0x2000);
+
+void push(NotificationDeque& q, dstime ts, LocalNode* ln, const std::string& path)
+{
+    q.pushBack(Notification(ts, LocalPath::fromPlatformEncoded(path), ln));
+}
+
+std::string popPath(NotificationDeque& q, dstime* ts = nullptr)
+{
+    Notification n;
+    if (!q.popFront(n))
+    {
+        return "<empty>";
+    }
+    if (ts)
+    {
+        *ts = n.timestamp;
+    }
+    return n.path.platformEncoded();
+}
+
+} // anonymous
+
+TEST(NotificationDeque, repeatedNotificationsKeepTheLatestTimestamp)
+{
+    NotificationDeque q;
+    push(q, 10, folder, "a");
+    push(q, 11, folder, "b");
+    push(q, 12, folder, "a");
+    push(q, 13, other, "a");    // another folder: not a repeat
+
+    ASSERT_EQ(q.size(), 3u);
+    ASSERT_EQ(q.coalesced(), 1u);
+
+    dstime ts;
+    ASSERT_EQ(popPath(q), "b");
+    ASSERT_EQ(popPath(q, &ts), "a");
+    ASSERT_EQ(ts, 12);
+    ASSERT_EQ(popPath(q), "a");
+    ASSERT_TRUE(q.empty());
+    ASSERT_EQ(popPath(q), "<empty>");
+}
+
+TEST(NotificationDeque, immediateNotificationsStay)
+{
+    NotificationDeque q;
+    push(q, 0, folder, "a");
+    push(q, 11, folder, "b");
+    push(q, 12, folder, "a");
+
+    dstime ts = 1;
+    ASSERT_EQ(popPath(q, &ts), "a");
+    ASSERT_EQ(ts, 0);
+    ASSERT_EQ(popPath(q), "b");
+    ASSERT_TRUE(q.empty());
+}
+
+TEST(NotificationDeque, folderRescanCoversItsChildren)
+{
+    NotificationDeque q;
+    push(q, 10, folder, "a");
+    push(q, 10, other, "a");
+    push(q, 0, folder, "");     // rescan: drops "a"
+    push(q, 11, folder, "b");   // and covers what comes next
+
+    ASSERT_EQ(q.size(), 2u);
+    ASSERT_EQ(q.coalesced(), 2u);
+
+    Notification n;
+    ASSERT_TRUE(q.peekFront(n));
+    ASSERT_EQ(n.localnode, other);
+    ASSERT_EQ(popPath(q), "a");
+    ASSERT_EQ(popPath(q), "");
+    ASSERT_TRUE(q.empty());
+
+    // once the rescan is processed, children are queued again
+    push(q, 12, folder, "b");
+    ASSERT_EQ(q.size(), 1u);
+}
+
+TEST(NotificationDeque, unpoppedAndReplacedNodes)
+{
+    NotificationDeque q;
+    push(q, 10, folder, "a");
+
+    Notification n;
+    ASSERT_TRUE(q.popFront(n));
+    q.unpopFront(n);
+    push(q, 11, folder, "a");   // merged into the unpopped one
+    ASSERT_EQ(q.size(), 1u);
+
+    q.replaceLocalNodePointers(folder, other);
+    push(q, 12, other, "a");
+    ASSERT_EQ(q.size(), 1u);
+    ASSERT_TRUE(q.peekFront(n));
+    ASSERT_EQ(n.localnode, other);
+    ASSERT_EQ(n.timestamp, 12);
+}
@@ -0,0 +1,135 @@
+/**
+ * (c) 2021 by Mega Limited, Wellsford, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mega/dirscanner.h>
+#include "mega.h"
+
+using namespace mega;
+
+namespace {
+
+// root/{d0,d1,d2}/{f0..f4, sub/{f0..f4}}
+class ScanTree
+{
+public:
+    ScanTree()
+        : root(LocalPath::fromPath("dirscanner_test", fsaccess))
+    {
+        fsaccess.emptydirlocal(root);
+        fsaccess.rmdirlocal(root);
+        fsaccess.mkdirlocal(root, false);
+
+        for (int d = 0; d < 3; d++)
+        {
+            LocalPath folder = path(root, "d" + std::to_string(d));
+            fsaccess.mkdirlocal(folder, false);
+            addfiles(folder);
+
+            LocalPath sub = path(folder, "sub");
+            fsaccess.mkdirlocal(sub, false);
+            addfiles(sub);
+        }
+    }
+
+    ~ScanTree()
+    {
+        fsaccess.emptydirlocal(root);
+        fsaccess.rmdirlocal(root);
+    }
+
+    LocalPath path(const LocalPath& parent, const std::string& name)
+    {
+        LocalPath p = parent;
+        p.appendWithSeparator(LocalPath::fromPath(name, fsaccess), false);
+        return p;
+    }
+
+    FSACCESS_CLASS fsaccess;
+    LocalPath root;
+
+private:
+    void addfiles(const LocalPath& folder)
+    {
+        for (int f = 0; f < 5; f++)
+        {
+            LocalPath file = path(folder, "f" + std::to_string(f));
+            auto fa = fsaccess.newfileaccess(false);
+            ASSERT_TRUE(fa->fopen(file, false, true));
+            ASSERT_TRUE(fa->fwrite((const byte*)"data", 4, 0));
+        }
+    }
+};
+
+} // anonymous
+
+TEST(ParallelDirScanner, walksWholeTree)
+{
+    ScanTree tree;
+
+    ParallelDirScanner scanner(tree.fsaccess, nullptr, 3, false);
+    scanner.start(tree.root);
+
+    std::map<LocalPath, std::unique_ptr<ScannedFolder>> folders;
+    while (scanner.wait())
+    {
+        while (auto folder = scanner.next())
+        {
+            folders[folder->path] = std::move(folder);
+        }
+    }
+
+    ASSERT_TRUE(scanner.done());
+    ASSERT_EQ(folders.size(), 7u);
+    ASSERT_EQ(scanner.stats().entries, 3u + 3 * (5 + 1) + 3 * 5);
+
+    const ScannedFolder& d1 = *folders.at(tree.path(tree.root, "d1"));
+    ASSERT_EQ(d1.entries.size(), 6u);
+    for (const ScannedEntry& entry : d1.entries)
+    {
+        ASSERT_TRUE(entry.valid);
+        ASSERT_TRUE(entry.fsidvalid);
+        ASSERT_EQ(entry.type, entry.name == LocalPath::fromPath("sub", tree.fsaccess) ? FOLDERNODE : FILENODE);
+        ASSERT_EQ(entry.size, entry.type == FILENODE ? 4 : 0);
+    }
+}
+
+TEST(ParallelDirScanner, prunedAndDiscardedFolders)
+{
+    ScanTree tree;
+    LocalPath pruned = tree.path(tree.root, "d0");
+
+    ParallelDirScanner scanner(tree.fsaccess, nullptr, 1, false);
+
+    // asked for before it has been listed: never delivered
+    ASSERT_FALSE(scanner.take(tree.root));
+
+    scanner.start(tree.root, [&](const LocalPath& p) { return p == pruned; });
+
+    // let everything complete
+    while (!scanner.done())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    ASSERT_FALSE(scanner.take(pruned));
+    ASSERT_TRUE(scanner.take(tree.path(tree.root, "d1")));
+    ASSERT_FALSE(scanner.take(tree.path(tree.root, "d1")));
+    ASSERT_EQ(scanner.stats().folders, 5u);
+}
@@ -55,11 +55,24 @@ public:
         return mNotSyncablePaths.find(localpath) == mNotSyncablePaths.end();
     }
 
+    void syncupdate_treestate(const mega::SyncConfig&, const mega::LocalPath& path, mega::treestate_t ts, mega::nodetype_t) override
+    {
+        mTreeStates.emplace_back(path, ts);
+    }
+
+    void syncupdate_treestates(const mega::SyncConfig&, const std::vector<std::pair<mega::LocalPath, mega::treestate_t>>& states) override
+    {
+        mTreeStateBatches.push_back(states);
+    }
+
     void addNotSyncablePath(const mega::LocalPath& path)
     {
         mNotSyncablePaths.insert(path);
     }
 
+    std::vector<std::pair<mega::LocalPath, mega::treestate_t>> mTreeStates;
+    std::vector<std::vector<std::pair<mega::LocalPath, mega::treestate_t>>> mTreeStateBatches;
+
 private:
     std::set<mega::LocalPath> mNotSyncablePaths;
 };
@@ -326,11 +339,102 @@ void test_computeReversePathMatchScore()
 
 }
 
+TEST(Sync, localNodeChildren)
+{
+    // only used as values
+    mega::LocalNode* const a = reinterpret_cast<mega::LocalNode*>(0x1000);
+    mega::LocalNode* const b = reinterpret_cast<mega::LocalNode*>(0x2000);
+
+    auto nameA = LocalPath::fromPlatformEncoded("a");
+    auto nameB = LocalPath::fromPlatformEncoded("b");
+
+    // as for files: nothing allocated, lookups fail
+    mega::LocalNodeChildren children;
+    ASSERT_TRUE(children.empty());
+    ASSERT_TRUE(children.begin() == children.end());
+    ASSERT_TRUE(children.find(&nameA) == children.end());
+    children.erase(&nameA);
+    ASSERT_EQ(children.size(), 0u);
+
+    children[&nameB] = b;
+    children[&nameA] = a;
+    ASSERT_EQ(children.size(), 2u);
+    ASSERT_EQ(children.find(&nameB)->second, b);
+
+    // iterators stay valid while other children are erased, as with a map
+    auto it = children.begin();
+    ASSERT_EQ(it->second, a);
+    children.erase(&nameB);
+    ASSERT_TRUE(++it == children.end());
+    children.erase(&nameA);
+    ASSERT_TRUE(children.empty());
+    ASSERT_TRUE(children.find(&nameA) == children.end());
+}
+
 TEST(Sync, computeReverseMatchScore_oneByteSeparator)
 {
     test_computeReversePathMatchScore();
 }
 
+TEST(Sync, flushtreestates_coalescesChanges)
+{
+    Fixture fx{"d"};
+
+    mega::LocalNode& ld = *fx.mSync->localroot;
+    auto ld_0 = mt::makeLocalNode(*fx.mSync, ld, mega::FOLDERNODE, "d_0");
+    auto lf_0_0 = mt::makeLocalNode(*fx.mSync, *ld_0, mega::FILENODE, "f_0_0");
+    auto lf_0_1 = mt::makeLocalNode(*fx.mSync, *ld_0, mega::FILENODE, "f_0_1");
+
+    // nothing reported nor propagated until the flush
+    lf_0_0->treestate(mega::TREESTATE_PENDING);
+    lf_0_0->treestate(mega::TREESTATE_SYNCING);
+    lf_0_1->treestate(mega::TREESTATE_SYNCED);
+    ASSERT_TRUE(fx.mApp.mTreeStates.empty());
+    ASSERT_EQ(ld_0->ts, mega::TREESTATE_NONE);
+
+    fx.mSync->flushtreestates();
+    ASSERT_EQ(ld_0->ts, mega::TREESTATE_SYNCING);
+    ASSERT_EQ(ld.ts, mega::TREESTATE_SYNCING);
+    ASSERT_EQ(fx.mApp.mTreeStates.size(), 4u);
+
+    // only the latest state, and only the files and folders that changed
+    fx.mApp.mTreeStates.clear();
+    lf_0_0->treestate(mega::TREESTATE_PENDING);
+    lf_0_0->treestate(mega::TREESTATE_SYNCED);
+    lf_0_1->treestate(mega::TREESTATE_SYNCED);
+    fx.mSync->flushtreestates();
+    ASSERT_EQ(fx.mApp.mTreeStates.size(), 3u);
+    for (auto& state : fx.mApp.mTreeStates)
+    {
+        ASSERT_EQ(state.second, mega::TREESTATE_SYNCED);
+    }
+
+    // and of the folders only, if so configured
+    fx.mApp.mTreeStates.clear();
+    fx.mClient->syncs.mTreeStateFoldersOnly = true;
+    lf_0_1->treestate(mega::TREESTATE_PENDING);
+    fx.mSync->flushtreestates();
+    ASSERT_EQ(fx.mApp.mTreeStates.size(), 2u);
+    ASSERT_EQ(fx.mApp.mTreeStates[0].second, mega::TREESTATE_PENDING);
+    ASSERT_EQ(fx.mClient->syncs.mTreeStateNotifications, 9u);
+
+    // and all at once, if so configured
+    fx.mApp.mTreeStates.clear();
+    fx.mClient->syncs.mTreeStateFoldersOnly = false;
+    fx.mClient->syncs.mTreeStateBatched = true;
+    lf_0_0->treestate(mega::TREESTATE_SYNCING);
+    lf_0_1->treestate(mega::TREESTATE_SYNCED);
+    fx.mSync->flushtreestates();
+    ASSERT_TRUE(fx.mApp.mTreeStates.empty());
+    ASSERT_EQ(fx.mApp.mTreeStateBatches.size(), 1u);
+    ASSERT_EQ(fx.mApp.mTreeStateBatches[0].size(), 4u);
+    ASSERT_EQ(fx.mClient->syncs.mTreeStateNotifications, 13u);
+
+    // (nothing if nothing changed)
+    fx.mSync->flushtreestates();
+    ASSERT_EQ(fx.mApp.mTreeStateBatches.size(), 1u);
+}
+
 /*TEST(Sync, assignFilesystemIds_whenFilesystemFingerprintsMatchLocalNodes)
 {
     Fixture fx{"d"};
@@ -44,6 +44,8 @@ void checkTransfers(const mega::Transfer& exp, const mega::Transfer& act)
     ASSERT_EQ(exp.tempurls, act.tempurls);
     ASSERT_EQ(exp.state, act.state);
     ASSERT_EQ(exp.priority, act.priority);
+    ASSERT_EQ(exp.bwflow.bwclass, act.bwflow.bwclass);
+    ASSERT_EQ(exp.bwflow.weight, act.bwflow.weight);
 }
 
 }
@@ -76,6 +78,8 @@ TEST(Transfer, serialize_unserialize)
     };
     tf.state = mega::TRANSFERSTATE_PAUSED;
     tf.priority = 4;
+    tf.bwflow.bwclass = mega::TRANSFERCLASS_BACKUP;
+    tf.bwflow.weight = 5;
 
     std::string d;
     ASSERT_TRUE(tf.serialize(&d));
@@ -17,6 +17,8 @@
  */
 
 #include <array>
+#include <atomic>
+#include <thread>
 #include <tuple>
 
 #include <gtest/gtest.h>
@@ -42,6 +44,110 @@ TEST(utils, hashCombine_integer)
 #endif
 }
 
+TEST(utils, sharedMutex_readersShareWritersExclude)
+{
+    mega::SharedMutex m;
+    std::atomic<bool> written{false};
+
+    // any number of readers at the same time
+    m.lock_shared();
+    m.lock_shared();
+
+    std::thread writer([&]() {
+        std::lock_guard<mega::SharedMutex> g(m);
+        written = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_FALSE(written);
+    m.unlock_shared();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_FALSE(written);
+    m.unlock_shared();
+
+    writer.join();
+    ASSERT_TRUE(written);
+
+    // and readers again once the writer is done
+    mega::SharedLockGuard g(m);
+}
+
+TEST(utils, boundedMpscQueue_keepsEachProducerOrder)
+{
+    mega::BoundedMpscQueue<int> q(4);
+    int value;
+    ASSERT_FALSE(q.tryPop(value));
+
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(q.tryPush(i));
+    }
+    ASSERT_FALSE(q.tryPush(4));
+
+    size_t position;
+    ASSERT_TRUE(q.tryPop(value, &position));
+    ASSERT_EQ(0, value);
+    ASSERT_EQ(1u, position);
+    ASSERT_TRUE(q.tryPush(4));
+    ASSERT_EQ(5u, q.pushed());
+
+    for (int i = 1; i <= 4; i++)
+    {
+        ASSERT_TRUE(q.tryPop(value));
+        ASSERT_EQ(i, value);
+    }
+    ASSERT_FALSE(q.tryPop(value));
+
+    // popPushed() gets everything pushed before the call, with its position
+    ASSERT_TRUE(q.tryPush(5));
+    ASSERT_TRUE(q.tryPush(6));
+    std::vector<std::pair<int, size_t>> popped;
+    q.popPushed([&popped](int v, size_t p) { popped.emplace_back(v, p); });
+    ASSERT_EQ(2u, popped.size());
+    ASSERT_EQ(5, popped[0].first);
+    ASSERT_EQ(6u, popped[0].second);
+    ASSERT_EQ(6, popped[1].first);
+    ASSERT_EQ(7u, popped[1].second);
+    ASSERT_FALSE(q.tryPop(value));
+
+    // producers retry while full, the consumer gets every value once and in order per producer
+    const int producers = 4;
+    const int values = 20000;
+    mega::BoundedMpscQueue<int> shared(64);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&shared, p]() {
+            for (int i = 0; i < values; i++)
+            {
+                while (!shared.tryPush(p * values + i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::array<int, producers> next{};
+    int outOfOrder = 0;
+    for (int popped = 0; popped < producers * values; )
+    {
+        if (shared.tryPop(value))
+        {
+            int p = value / values;
+            outOfOrder += next[p]++ != value % values;
+            popped++;
+        }
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    ASSERT_EQ(0, outOfOrder);
+    ASSERT_FALSE(shared.tryPop(value));
+}
+
 TEST(CharacterSet, IterateUtf8)
 {
     using mega::unicodeCodepointIterator;